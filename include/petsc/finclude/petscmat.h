@@ -94,6 +94,15 @@
 #define MATAIJSELL         'aijsell'
 #define MATSEQAIJSELL      'seqaijsell'
 #define MATMPIAIJSELL      'mpiaijsell'
+#define MATAIJOMP          'aijomp'
+#define MATSEQAIJOMP       'seqaijomp'
+#define MATMPIAIJOMP       'mpiaijomp'
+#define MATAIJSINGLE       'aijsingle'
+#define MATSEQAIJSINGLE    'seqaijsingle'
+#define MATMPIAIJSINGLE    'mpiaijsingle'
+#define MATAIJDELTA        'aijdelta'
+#define MATSEQAIJDELTA     'seqaijdelta'
+#define MATMPIAIJDELTA     'mpiaijdelta'
 #define MATAIJMKL          'aijmkl'
 #define MATSEQAIJMKL       'seqaijmkl'
 #define MATMPIAIJMKL       'mpiaijmkl'
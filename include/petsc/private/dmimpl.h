@@ -194,6 +194,8 @@ struct _p_DM {
   MatType                 mattype;  /* type of matrix created with DMCreateMatrix() */
   PetscInt                bs;
   ISLocalToGlobalMapping  ltogmap;
+  IS                      localinterior,localboundary; /* owned entries of the local vectors that are not ghost points of other processes, and those that are */
+  IS                      localowned,globalowned;      /* all the owned entries of the local vectors and their offsets in the global vectors */
   PetscBool               prealloc_only; /* Flag indicating the DMCreateMatrix() should only preallocate, not fill the matrix */
   PetscBool               structure_only; /* Flag indicating the DMCreateMatrix() create matrix structure without values */
   PetscInt                levelup,leveldown;  /* if the DM has been obtained by refining (or coarsening) this indicates how many times that process has been used to generate this DM */
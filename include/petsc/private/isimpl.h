@@ -34,6 +34,7 @@ struct _ISOps {
   PetscErrorCode (*setblocksize)(IS,PetscInt);
   PetscErrorCode (*contiguous)(IS,PetscInt,PetscInt,PetscInt*,PetscBool*);
   PetscErrorCode (*locate)(IS,PetscInt,PetscInt *);
+  PetscErrorCode (*compress)(IS,IS*);
 };
 
 struct _p_IS {
@@ -3,6 +3,15 @@
 
 #include <petscsys.h>
 
+/*
+   With PETSC_USE_AVX512_KERNELS the block kernels for block size 2 to 8 hold one column of the
+   (column oriented) block in a single masked AVX-512 register, see PetscKernel_v_gets_A_times_w_AVX512_Private()
+*/
+#if defined(PETSC_USE_AVX512_KERNELS) && defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+#define PETSC_KERNEL_USE_AVX512_BLOCK 1
+#include <immintrin.h>
+#endif
+
 #define PetscKernel_v_gets_A_times_w_1_exp(v,A,w,exp) \
 do {                                                  \
   v[0] exp A[0]*w[0];                                 \
@@ -67,26 +76,78 @@ do {
   v[6] exp A[6]*w[0] + A[13]*w[1] + A[20]*w[2] + A[27]*w[3] + A[34]*w[4] + A[41]*w[5] + A[48]*w[6]; \
 } while (0)
 
+#define PetscKernel_v_gets_A_times_w_8_exp(v,A,w,exp)                                                            \
+do {                                                                                                             \
+  v[0] exp A[0]*w[0] + A[8] *w[1] + A[16]*w[2] + A[24]*w[3] + A[32]*w[4] + A[40]*w[5] + A[48]*w[6] + A[56]*w[7]; \
+  v[1] exp A[1]*w[0] + A[9] *w[1] + A[17]*w[2] + A[25]*w[3] + A[33]*w[4] + A[41]*w[5] + A[49]*w[6] + A[57]*w[7]; \
+  v[2] exp A[2]*w[0] + A[10]*w[1] + A[18]*w[2] + A[26]*w[3] + A[34]*w[4] + A[42]*w[5] + A[50]*w[6] + A[58]*w[7]; \
+  v[3] exp A[3]*w[0] + A[11]*w[1] + A[19]*w[2] + A[27]*w[3] + A[35]*w[4] + A[43]*w[5] + A[51]*w[6] + A[59]*w[7]; \
+  v[4] exp A[4]*w[0] + A[12]*w[1] + A[20]*w[2] + A[28]*w[3] + A[36]*w[4] + A[44]*w[5] + A[52]*w[6] + A[60]*w[7]; \
+  v[5] exp A[5]*w[0] + A[13]*w[1] + A[21]*w[2] + A[29]*w[3] + A[37]*w[4] + A[45]*w[5] + A[53]*w[6] + A[61]*w[7]; \
+  v[6] exp A[6]*w[0] + A[14]*w[1] + A[22]*w[2] + A[30]*w[3] + A[38]*w[4] + A[46]*w[5] + A[54]*w[6] + A[62]*w[7]; \
+  v[7] exp A[7]*w[0] + A[15]*w[1] + A[23]*w[2] + A[31]*w[3] + A[39]*w[4] + A[47]*w[5] + A[55]*w[6] + A[63]*w[7]; \
+} while (0)
+
 #define PetscKernel_v_gets_A_times_w_1(v,A,w) PetscKernel_v_gets_A_times_w_1_exp(v,A,w,=)
+#define PetscKernel_v_gets_v_plus_A_times_w_1(v,A,w) PetscKernel_v_gets_A_times_w_1_exp(v,A,w,+=)
+#define PetscKernel_v_gets_v_minus_A_times_w_1(v,A,w) PetscKernel_v_gets_A_times_w_1_exp(v,A,w,-=)
+
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+/* v = A w (op 0), v += A w (op 1) or v -= A w (op -1) for a bs x bs block A stored by columns, bs <= 8 */
+PETSC_STATIC_INLINE void PetscKernel_v_gets_A_times_w_AVX512_Private(PetscInt bs,PetscScalar *v,const MatScalar *A,const PetscScalar *w,PetscInt op)
+{
+  const __mmask8 mask = (__mmask8)((1<<bs)-1);
+  __m512d        vec_v = _mm512_setzero_pd();
+  PetscInt       c;
+
+  for (c=0; c<bs; c++) vec_v = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask,A+c*bs),_mm512_set1_pd(w[c]),vec_v);
+  if (op > 0)      vec_v = _mm512_add_pd(_mm512_maskz_loadu_pd(mask,v),vec_v);
+  else if (op < 0) vec_v = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask,v),vec_v);
+  _mm512_mask_storeu_pd(v,mask,vec_v);
+}
+#define PetscKernel_v_gets_A_times_w_2(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(2,(v),(A),(w),0)
+#define PetscKernel_v_gets_A_times_w_3(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(3,(v),(A),(w),0)
+#define PetscKernel_v_gets_A_times_w_4(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(4,(v),(A),(w),0)
+#define PetscKernel_v_gets_A_times_w_5(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(5,(v),(A),(w),0)
+#define PetscKernel_v_gets_A_times_w_6(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(6,(v),(A),(w),0)
+#define PetscKernel_v_gets_A_times_w_7(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(7,(v),(A),(w),0)
+#define PetscKernel_v_gets_A_times_w_8(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(8,(v),(A),(w),0)
+#define PetscKernel_v_gets_v_plus_A_times_w_2(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(2,(v),(A),(w),1)
+#define PetscKernel_v_gets_v_plus_A_times_w_3(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(3,(v),(A),(w),1)
+#define PetscKernel_v_gets_v_plus_A_times_w_4(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(4,(v),(A),(w),1)
+#define PetscKernel_v_gets_v_plus_A_times_w_5(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(5,(v),(A),(w),1)
+#define PetscKernel_v_gets_v_plus_A_times_w_6(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(6,(v),(A),(w),1)
+#define PetscKernel_v_gets_v_plus_A_times_w_7(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(7,(v),(A),(w),1)
+#define PetscKernel_v_gets_v_plus_A_times_w_8(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(8,(v),(A),(w),1)
+#define PetscKernel_v_gets_v_minus_A_times_w_2(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(2,(v),(A),(w),-1)
+#define PetscKernel_v_gets_v_minus_A_times_w_3(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(3,(v),(A),(w),-1)
+#define PetscKernel_v_gets_v_minus_A_times_w_4(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(4,(v),(A),(w),-1)
+#define PetscKernel_v_gets_v_minus_A_times_w_5(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(5,(v),(A),(w),-1)
+#define PetscKernel_v_gets_v_minus_A_times_w_6(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(6,(v),(A),(w),-1)
+#define PetscKernel_v_gets_v_minus_A_times_w_7(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(7,(v),(A),(w),-1)
+#define PetscKernel_v_gets_v_minus_A_times_w_8(v,A,w) PetscKernel_v_gets_A_times_w_AVX512_Private(8,(v),(A),(w),-1)
+#else
 #define PetscKernel_v_gets_A_times_w_2(v,A,w) PetscKernel_v_gets_A_times_w_2_exp(v,A,w,=)
 #define PetscKernel_v_gets_A_times_w_3(v,A,w) PetscKernel_v_gets_A_times_w_3_exp(v,A,w,=)
 #define PetscKernel_v_gets_A_times_w_4(v,A,w) PetscKernel_v_gets_A_times_w_4_exp(v,A,w,=)
 #define PetscKernel_v_gets_A_times_w_5(v,A,w) PetscKernel_v_gets_A_times_w_5_exp(v,A,w,=)
 #define PetscKernel_v_gets_A_times_w_6(v,A,w) PetscKernel_v_gets_A_times_w_6_exp(v,A,w,=)
 #define PetscKernel_v_gets_A_times_w_7(v,A,w) PetscKernel_v_gets_A_times_w_7_exp(v,A,w,=)
-#define PetscKernel_v_gets_v_plus_A_times_w_1(v,A,w) PetscKernel_v_gets_A_times_w_1_exp(v,A,w,+=)
+#define PetscKernel_v_gets_A_times_w_8(v,A,w) PetscKernel_v_gets_A_times_w_8_exp(v,A,w,=)
 #define PetscKernel_v_gets_v_plus_A_times_w_2(v,A,w) PetscKernel_v_gets_A_times_w_2_exp(v,A,w,+=)
 #define PetscKernel_v_gets_v_plus_A_times_w_3(v,A,w) PetscKernel_v_gets_A_times_w_3_exp(v,A,w,+=)
 #define PetscKernel_v_gets_v_plus_A_times_w_4(v,A,w) PetscKernel_v_gets_A_times_w_4_exp(v,A,w,+=)
 #define PetscKernel_v_gets_v_plus_A_times_w_5(v,A,w) PetscKernel_v_gets_A_times_w_5_exp(v,A,w,+=)
 #define PetscKernel_v_gets_v_plus_A_times_w_6(v,A,w) PetscKernel_v_gets_A_times_w_6_exp(v,A,w,+=)
 #define PetscKernel_v_gets_v_plus_A_times_w_7(v,A,w) PetscKernel_v_gets_A_times_w_7_exp(v,A,w,+=)
-#define PetscKernel_v_gets_v_minus_A_times_w_1(v,A,w) PetscKernel_v_gets_A_times_w_1_exp(v,A,w,-=)
+#define PetscKernel_v_gets_v_plus_A_times_w_8(v,A,w) PetscKernel_v_gets_A_times_w_8_exp(v,A,w,+=)
 #define PetscKernel_v_gets_v_minus_A_times_w_2(v,A,w) PetscKernel_v_gets_A_times_w_2_exp(v,A,w,-=)
 #define PetscKernel_v_gets_v_minus_A_times_w_3(v,A,w) PetscKernel_v_gets_A_times_w_3_exp(v,A,w,-=)
 #define PetscKernel_v_gets_v_minus_A_times_w_4(v,A,w) PetscKernel_v_gets_A_times_w_4_exp(v,A,w,-=)
 #define PetscKernel_v_gets_v_minus_A_times_w_5(v,A,w) PetscKernel_v_gets_A_times_w_5_exp(v,A,w,-=)
 #define PetscKernel_v_gets_v_minus_A_times_w_6(v,A,w) PetscKernel_v_gets_A_times_w_6_exp(v,A,w,-=)
 #define PetscKernel_v_gets_v_minus_A_times_w_7(v,A,w) PetscKernel_v_gets_A_times_w_7_exp(v,A,w,-=)
+#define PetscKernel_v_gets_v_minus_A_times_w_8(v,A,w) PetscKernel_v_gets_A_times_w_8_exp(v,A,w,-=)
+#endif
 
 #endif
@@ -20,6 +20,7 @@ struct _KSPOps {
                                                           calculates the residual in a
                                                           user-provided area.  */
   PetscErrorCode (*solve)(KSP);                        /* actual solver */
+  PetscErrorCode (*matsolve)(KSP,Mat,Mat);             /* solver for several right-hand sides at once */
   PetscErrorCode (*setup)(KSP);
   PetscErrorCode (*setfromoptions)(PetscOptionItems*,KSP);
   PetscErrorCode (*publishoptions)(KSP);
@@ -330,6 +331,7 @@ PETSC_STATIC_INLINE PetscErrorCode KSP_PCApplyBAorABTranspose(KSP ksp,Vec x,Vec
 PETSC_EXTERN PetscLogEvent KSP_GMRESOrthogonalization;
 PETSC_EXTERN PetscLogEvent KSP_SetUp;
 PETSC_EXTERN PetscLogEvent KSP_Solve;
+PETSC_EXTERN PetscLogEvent KSP_MatSolve;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_0;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_1;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_2;
@@ -341,6 +343,9 @@ PETSC_EXTERN PetscLogEvent KSP_Solve_FS_U;
 
 PETSC_INTERN PetscErrorCode MatGetSchurComplement_Basic(Mat,IS,IS,IS,IS,MatReuse,Mat*,MatSchurComplementAinvType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode PCPreSolveChangeRHS(PC,PetscBool*);
+PETSC_INTERN PetscErrorCode KSPMatMatMult_Private(Mat,Mat,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode KSPBlockCholesky_Private(PetscInt,const PetscScalar*,PetscInt,const PetscReal*,PetscReal,PetscScalar*,PetscInt,PetscInt*,PetscReal*,PetscInt*);
+PETSC_INTERN PetscErrorCode KSPBlockConverged_Private(KSP,PetscInt,const PetscReal[],const PetscReal[]);
 
 /*MC
    KSPCheckDot - Checks if the result of a dot product used by the corresponding KSP contains Inf or NaN. These indicate that the previous 
@@ -827,6 +827,16 @@ PETSC_EXTERN PetscErrorCode PetscSplitReductionGet(MPI_Comm,PetscSplitReduction*
 PETSC_EXTERN PetscErrorCode PetscSplitReductionEnd(PetscSplitReduction*);
 PETSC_EXTERN PetscErrorCode PetscSplitReductionExtend(PetscSplitReduction*);
 
+/*
+   PetscPragmaOMP(omp parallel for ...) becomes the OpenMP pragma when PETSc is built with OpenMP and vanishes otherwise,
+   so that loops shared among threads still compile (and run serially) without OpenMP
+*/
+#if defined(PETSC_HAVE_OPENMP)
+#  define PetscPragmaOMP(...) _Pragma(#__VA_ARGS__)
+#else
+#  define PetscPragmaOMP(...)
+#endif
+
 #if !defined(PETSC_SKIP_SPINLOCK)
 #if defined(PETSC_HAVE_THREADSAFETY)
 #  if defined(PETSC_HAVE_CONCURRENCYKIT)
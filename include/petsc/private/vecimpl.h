@@ -134,6 +134,7 @@ struct _p_Vec {
   PetscLayout            map;
   void                   *data;     /* implementation-specific data */
   PetscBool              array_gotten;
+  PetscInt               narrays;      /* arrays obtained with VecGetArray() or VecGetArrayRead() and not yet restored, or restored with NULL */
   VecStash               stash,bstash; /* used for storing off-proc values during assembly */
   PetscBool              petscnative;  /* means the ->data starts with VECHEADER and can use VecGetArrayFast()*/
   PetscInt               lock;         /* lock state. vector can be free (=0), locked for read (>0) or locked for write(<0) */
@@ -181,8 +182,26 @@ PETSC_EXTERN PetscLogEvent VEC_CUDACopyToGPU;
 PETSC_EXTERN PetscLogEvent VEC_CUDACopyFromGPU;
 PETSC_EXTERN PetscLogEvent VEC_CUDACopyToGPUSome;
 PETSC_EXTERN PetscLogEvent VEC_CUDACopyFromGPUSome;
+PETSC_EXTERN PetscLogEvent VEC_LazyApply;
+PETSC_EXTERN PetscLogEvent VEC_PoolHit;
+PETSC_EXTERN PetscLogEvent VEC_PoolMiss;
 
 PETSC_EXTERN PetscErrorCode VecView_Seq(Vec,PetscViewer);
+
+/* deferred evaluation of the pointwise vector operations, see VecSetLazyEvaluation() */
+typedef enum {VEC_LAZY_SET,VEC_LAZY_SCALE,VEC_LAZY_COPY,VEC_LAZY_AXPY,VEC_LAZY_AYPX,VEC_LAZY_AXPBY,VEC_LAZY_AXPBYPCZ,VEC_LAZY_WAXPY,VEC_LAZY_POINTWISEMULT} VecLazyOpType;
+PETSC_INTERN PetscInt       VecLazyNumOps;
+PETSC_INTERN PetscErrorCode VecLazyFlush_Private(Vec);
+PETSC_INTERN PetscErrorCode VecLazyRecord_Private(VecLazyOpType,Vec,Vec,Vec,PetscScalar,PetscScalar,PetscScalar,PetscBool*);
+PETSC_INTERN PetscErrorCode VecLazyNormLocal_Private(Vec,PetscReal*,PetscBool*);
+PETSC_INTERN PetscErrorCode VecLazyDotLocal_Private(Vec,Vec,PetscScalar*,PetscBool*);
+PETSC_INTERN PetscErrorCode VecLazyNorm_Private(Vec,NormType,PetscReal*,PetscBool*);
+PETSC_INTERN PetscErrorCode VecLazyDot_Private(Vec,Vec,PetscScalar*,PetscBool*);
+#define VecLazyFlush(v) (VecLazyNumOps ? VecLazyFlush_Private(v) : 0)
+
+/* reuse of the arrays of destroyed vectors, see VecSetArrayPoolSize() */
+PETSC_INTERN PetscErrorCode VecPoolGet_Private(PetscInt,PetscScalar**);
+PETSC_INTERN PetscErrorCode VecPoolRestore_Private(PetscInt,PetscScalar**);
 #if defined(PETSC_HAVE_VIENNACL)
 PETSC_EXTERN PetscErrorCode VecViennaCLAllocateCheckHost(Vec v);
 PETSC_EXTERN PetscErrorCode VecViennaCLCopyFromGPU(Vec v);
@@ -200,7 +219,8 @@ PETSC_EXTERN PetscErrorCode VecCUDACopyFromGPU(Vec v);
 #define VECHEADER                          \
   PetscScalar *array;                      \
   PetscScalar *array_allocated;                        /* if the array was allocated by PETSc this is its pointer */  \
-  PetscScalar *unplacedarray;                           /* if one called VecPlaceArray(), this is where it stashed the original */
+  PetscScalar *unplacedarray;                           /* if one called VecPlaceArray(), this is where it stashed the original */ \
+  PetscInt    array_pooled;                             /* length of array_allocated if it can go back to the pool of VecSetArrayPoolSize(), else 0 */
 
 /* Lock a vector for exclusive read&write access */
 #if defined(PETSC_USE_DEBUG)
@@ -322,6 +342,7 @@ PETSC_EXTERN PetscBool      VecTaggerRegisterAllCalled;
 PETSC_EXTERN PetscErrorCode VecTaggerRegisterAll(void);
 PETSC_EXTERN PetscErrorCode VecTaggerComputeIS_FromBoxes(VecTagger,Vec,IS*);
 PETSC_EXTERN PetscMPIInt Petsc_Reduction_keyval;
+PETSC_EXTERN PetscMPIInt Petsc_VecLazy_keyval;
 
 PETSC_EXTERN PetscErrorCode PetscLayoutMapLocal(PetscLayout,PetscInt,const PetscInt[],PetscInt*,PetscInt**,PetscInt**);
 
@@ -89,6 +89,8 @@ PETSC_EXTERN PetscErrorCode ISSetBlockSize(IS,PetscInt);
 PETSC_EXTERN PetscErrorCode ISStrideGetInfo(IS,PetscInt *,PetscInt*);
 
 PETSC_EXTERN PetscErrorCode ISToGeneral(IS);
+PETSC_EXTERN PetscErrorCode ISCompress(IS);
+PETSC_EXTERN PetscErrorCode ISCreateCompressed(IS,IS*);
 
 PETSC_EXTERN PetscErrorCode ISDuplicate(IS,IS*);
 PETSC_EXTERN PetscErrorCode ISCopy(IS,IS);
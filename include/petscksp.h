@@ -38,6 +38,8 @@ typedef const char* KSPType;
 #define KSPPIPECG     "pipecg"
 #define KSPPIPECGRR   "pipecgrr"
 #define KSPPIPELCG     "pipelcg"
+#define KSPSCG        "scg"
+#define KSPDCG        "dcg"
 #define   KSPCGNE       "cgne"
 #define   KSPCGNASH     "nash"
 #define   KSPCGSTCG     "stcg"
@@ -50,6 +52,8 @@ typedef const char* KSPType;
 #define   KSPLGMRES     "lgmres"
 #define   KSPDGMRES     "dgmres"
 #define   KSPPGMRES     "pgmres"
+#define   KSPSGMRES     "sgmres"
+#define   KSPGCRODR     "gcrodr"
 #define KSPTCQMR      "tcqmr"
 #define KSPBCGS       "bcgs"
 #define   KSPIBCGS      "ibcgs"
@@ -72,6 +76,7 @@ typedef const char* KSPType;
 #define KSPGCR        "gcr"
 #define KSPPIPEGCR    "pipegcr"
 #define KSPTSIRM      "tsirm"
+#define KSPMPIR       "mpir"
 #define KSPCGLS       "cgls"
 #define KSPFETIDP     "fetidp"
 
@@ -87,6 +92,7 @@ PETSC_EXTERN PetscErrorCode KSPSetUp(KSP);
 PETSC_EXTERN PetscErrorCode KSPSetUpOnBlocks(KSP);
 PETSC_EXTERN PetscErrorCode KSPSolve(KSP,Vec,Vec);
 PETSC_EXTERN PetscErrorCode KSPSolveTranspose(KSP,Vec,Vec);
+PETSC_EXTERN PetscErrorCode KSPMatSolve(KSP,Mat,Mat);
 PETSC_EXTERN PetscErrorCode KSPReset(KSP);
 PETSC_EXTERN PetscErrorCode KSPResetViewers(KSP);
 PETSC_EXTERN PetscErrorCode KSPDestroy(KSP*);
@@ -201,6 +207,70 @@ PETSC_EXTERN PetscErrorCode KSPPIPEGCRGetTruncationType(KSP,KSPFCDTruncationType
 PETSC_EXTERN PetscErrorCode KSPPIPEGCRSetUnrollW(KSP,PetscBool);
 PETSC_EXTERN PetscErrorCode KSPPIPEGCRGetUnrollW(KSP,PetscBool*);
 
+/*E
+
+  KSPSStepBasisType - The polynomial basis of the Krylov spaces built by the s-step (communication-avoiding) methods
+
+  KSP_SSTEP_BASIS_MONOMIAL uses the powers of the operator, its condition number grows exponentially with s
+  KSP_SSTEP_BASIS_NEWTON uses products of shifted operators, with the shifts given by eigenvalue estimates
+  KSP_SSTEP_BASIS_CHEBYSHEV uses the Chebyshev polynomials of an interval enclosing the (real) spectrum
+
+   Level: intermediate
+.seealso : KSPSCG,KSPSGMRES,KSPSCGSetBasisType(),KSPSGMRESSetBasisType()
+
+E*/
+typedef enum {KSP_SSTEP_BASIS_MONOMIAL,KSP_SSTEP_BASIS_NEWTON,KSP_SSTEP_BASIS_CHEBYSHEV} KSPSStepBasisType;
+PETSC_EXTERN const char *const KSPSStepBasisTypes[];
+
+PETSC_EXTERN PetscErrorCode KSPSCGSetSteps(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSCGSetBasisType(KSP,KSPSStepBasisType);
+PETSC_EXTERN PetscErrorCode KSPSCGSetEigenvalueEstimates(KSP,PetscReal,PetscReal);
+PETSC_EXTERN PetscErrorCode KSPSGMRESSetSteps(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSGMRESSetBasisType(KSP,KSPSStepBasisType);
+
+/*E
+
+  KSPMPIRPCType - The single precision preconditioner of the inner solves of KSPMPIR
+
+  KSP_MPIR_PC_NONE applies no preconditioner
+  KSP_MPIR_PC_JACOBI divides by the diagonal
+  KSP_MPIR_PC_SOR applies one symmetric SOR sweep on the diagonal block of the local rows
+  KSP_MPIR_PC_ILU applies the ILU(0) factorization of the diagonal block of the local rows
+
+   Level: intermediate
+.seealso : KSPMPIR,KSPMPIRSetInnerPCType()
+
+E*/
+typedef enum {KSP_MPIR_PC_NONE,KSP_MPIR_PC_JACOBI,KSP_MPIR_PC_SOR,KSP_MPIR_PC_ILU} KSPMPIRPCType;
+PETSC_EXTERN const char *const KSPMPIRPCTypes[];
+
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+PETSC_EXTERN PetscErrorCode KSPMPIRSetInnerPCType(KSP,KSPMPIRPCType);
+PETSC_EXTERN PetscErrorCode KSPMPIRSetInnerTolerances(KSP,PetscReal,PetscInt);
+#endif
+
+/*E
+
+  KSPDCGSpaceType - The origin of the deflation space of KSPDCG
+
+  KSP_DCG_SPACE_USER uses the space given with KSPDCGSetDeflationSpace()
+  KSP_DCG_SPACE_SUBDOMAIN uses one constant vector per block of PCBJACOBI, per subdomain of PCASM, or per process
+  KSP_DCG_SPACE_MG uses the columns of the finest interpolation of PCMG or PCGAMG, the aggregates of PCGAMG
+  KSP_DCG_SPACE_RITZ uses Ritz vectors of the smallest eigenvalues computed during the first solve
+
+   Level: intermediate
+.seealso : KSPDCG,KSPDCGSetSpaceType(),KSPDCGSetDeflationSpace()
+
+E*/
+typedef enum {KSP_DCG_SPACE_USER,KSP_DCG_SPACE_SUBDOMAIN,KSP_DCG_SPACE_MG,KSP_DCG_SPACE_RITZ} KSPDCGSpaceType;
+PETSC_EXTERN const char *const KSPDCGSpaceTypes[];
+
+PETSC_EXTERN PetscErrorCode KSPDCGSetSpaceType(KSP,KSPDCGSpaceType);
+PETSC_EXTERN PetscErrorCode KSPDCGSetDeflationSpace(KSP,Mat);
+PETSC_EXTERN PetscErrorCode KSPDCGGetDeflationSpace(KSP,Mat*);
+PETSC_EXTERN PetscErrorCode KSPDCGSetRitz(KSP,PetscInt,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPDCGGetCoarseKSP(KSP,KSP*);
+
 PETSC_EXTERN PetscErrorCode KSPGMRESSetRestart(KSP, PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGMRESGetRestart(KSP, PetscInt*);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetHapTol(KSP,PetscReal);
@@ -216,6 +286,10 @@ PETSC_EXTERN PetscErrorCode KSPLGMRESSetConstant(KSP);
 
 PETSC_EXTERN PetscErrorCode KSPPIPEFGMRESSetShift(KSP,PetscScalar);
 
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRestart(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRecycleDimension(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRGetRecycleDimension(KSP,PetscInt*,PetscInt*);
+
 PETSC_EXTERN PetscErrorCode KSPGCRSetRestart(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGCRGetRestart(KSP,PetscInt*);
 PETSC_EXTERN PetscErrorCode KSPGCRSetModifyPC(KSP,PetscErrorCode (*)(KSP,PetscInt,PetscReal,void*),void*,PetscErrorCode(*)(void*));
@@ -16,17 +16,22 @@ PETSC_EXTERN PetscClassId PETSCSF_CLASSID;
    Level: beginner
 
    Notes:
-    The two approaches provided are
+    The approaches provided are
 $     PETSCSFBASIC which uses MPI 1 message passing to perform the communication and
 $     PETSCSFWINDOW which uses MPI 2 one-sided operations to perform the communication, this may be more efficient,
 $                   but may not be available for all MPI distributions. In particular OpenMPI has bugs in its one-sided
 $                   operations that prevent its use.
+$     PETSCSFNEIGHBOR which uses MPI 3 neighborhood collectives on the message passing pattern of PETSCSFBASIC,
+$                   one collective replaces the messages to the individual ranks.
+$     PETSCSFNODE which combines the messages between two shared-memory nodes into one message between their first ranks.
 
 .seealso: PetscSFSetType(), PetscSF
 J*/
 typedef const char *PetscSFType;
 #define PETSCSFBASIC  "basic"
 #define PETSCSFWINDOW "window"
+#define PETSCSFNEIGHBOR "neighbor"
+#define PETSCSFNODE   "node"
 
 /*E
     PetscSFWindowSyncType - Type of synchronization for PETSCSFWINDOW
@@ -1195,6 +1195,13 @@ PETSC_EXTERN PetscErrorCode PetscMallocClear(void);
 PETSC_EXTERN PetscErrorCode PetscMallocSetDRAM(void);
 PETSC_EXTERN PetscErrorCode PetscMallocResetDRAM(void);
 
+PETSC_EXTERN const char *const PetscMallocPagesTypes[];
+PETSC_EXTERN PetscErrorCode PetscMallocSetPagesPolicy(PetscClassId,PetscMallocPagesType,PetscBool);
+PETSC_EXTERN PetscErrorCode PetscMallocSetPagesThreshold(size_t);
+PETSC_EXTERN PetscErrorCode PetscMallocPagesSetFromOptions(PetscClassId,const char[]);
+PETSC_EXTERN PetscErrorCode PetscMallocPushClass(PetscClassId);
+PETSC_EXTERN PetscErrorCode PetscMallocPopClass(void);
+
 #define MPIU_PETSCLOGDOUBLE  MPI_DOUBLE
 #define MPIU_2PETSCLOGDOUBLE MPI_2DOUBLE_PRECISION
 
@@ -1205,6 +1212,8 @@ PETSC_EXTERN PetscErrorCode PetscMallocDump(FILE *);
 PETSC_EXTERN PetscErrorCode PetscMallocDumpLog(FILE *);
 PETSC_EXTERN PetscErrorCode PetscMallocGetCurrentUsage(PetscLogDouble *);
 PETSC_EXTERN PetscErrorCode PetscMallocGetMaximumUsage(PetscLogDouble *);
+PETSC_EXTERN PetscErrorCode PetscMallocPushMaximumUsage(int);
+PETSC_EXTERN PetscErrorCode PetscMallocPopMaximumUsage(int,PetscLogDouble*);
 PETSC_EXTERN PetscErrorCode PetscMallocDebug(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscMallocGetDebug(PetscBool*);
 PETSC_EXTERN PetscErrorCode PetscMallocValidate(int,const char[],const char[]);
@@ -510,6 +510,8 @@ $  PETSC_BUILDTWOSIDED_IBARRIER - nonblocking algorithm based on MPI_Issend and
 $      Proved communication-optimal in Hoefler, Siebert, and Lumsdaine (2010). Requires MPI-3.
 $  PETSC_BUILDTWOSIDED_REDSCATTER - similar to above, but use more optimized function
 $      that only communicates the part of the reduction that is necessary.  Requires MPI-2.
+$  PETSC_BUILDTWOSIDED_HIERARCHICAL - the messages are combined on the first rank of each shared
+$      memory node before the nonblocking algorithm, which then involves fewer and larger messages. Requires MPI-3.
 
    Level: developer
 
@@ -519,10 +521,24 @@ typedef enum {
   PETSC_BUILDTWOSIDED_NOTSET = -1,
   PETSC_BUILDTWOSIDED_ALLREDUCE = 0,
   PETSC_BUILDTWOSIDED_IBARRIER = 1,
-  PETSC_BUILDTWOSIDED_REDSCATTER = 2
+  PETSC_BUILDTWOSIDED_REDSCATTER = 2,
+  PETSC_BUILDTWOSIDED_HIERARCHICAL = 3
   /* Updates here must be accompanied by updates in finclude/petscsys.h and the string array in mpits.c */
 } PetscBuildTwoSidedType;
 
+/*E
+    PetscMallocPagesType - type of the pages of the large allocations, see PetscMallocSetPagesPolicy()
+
+$  PETSC_MALLOC_PAGES_DEFAULT - the pages of the heap
+$  PETSC_MALLOC_PAGES_TRANSPARENT - the allocation is aligned to 2MB and the kernel is advised to use transparent huge pages
+$  PETSC_MALLOC_PAGES_HUGETLB - explicit 2MB pages, which must be reserved by the system administrator
+
+   Level: advanced
+
+.seealso: PetscMallocSetPagesPolicy(), PetscMallocSetPagesThreshold()
+E*/
+typedef enum {PETSC_MALLOC_PAGES_DEFAULT = 0,PETSC_MALLOC_PAGES_TRANSPARENT = 1,PETSC_MALLOC_PAGES_HUGETLB = 2} PetscMallocPagesType;
+
 /*E
   InsertMode - Whether entries are inserted or added into vectors or matrices
 
@@ -248,6 +248,9 @@ PETSC_EXTERN PetscErrorCode VecCopy(Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecSetRandom(Vec,PetscRandom);
 PETSC_EXTERN PetscErrorCode VecSet(Vec,PetscScalar);
 PETSC_EXTERN PetscErrorCode VecSetInf(Vec);
+PETSC_EXTERN PetscErrorCode VecSetLazyEvaluation(MPI_Comm,PetscBool);
+PETSC_EXTERN PetscErrorCode VecLazyEvaluationFlush(MPI_Comm);
+PETSC_EXTERN PetscErrorCode VecSetArrayPoolSize(PetscInt);
 PETSC_EXTERN PetscErrorCode VecSwap(Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPY(Vec,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPBY(Vec,PetscScalar,PetscScalar,Vec);
@@ -566,6 +569,8 @@ PETSC_EXTERN PetscErrorCode VecGhostRestoreLocalForm(Vec,Vec*);
 PETSC_EXTERN PetscErrorCode VecGhostIsLocalForm(Vec,Vec,PetscBool*);
 PETSC_EXTERN PetscErrorCode VecGhostUpdateBegin(Vec,InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecGhostUpdateEnd(Vec,InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecGhostGetInteriorIS(Vec,IS*,IS*);
+PETSC_EXTERN PetscErrorCode VecGhostUpdateCompute(Vec,InsertMode,ScatterMode,PetscErrorCode (*)(Vec,IS,void*),void*);
 
 PETSC_EXTERN PetscErrorCode VecConjugate(Vec);
 PETSC_EXTERN PetscErrorCode VecImaginaryPart(Vec);
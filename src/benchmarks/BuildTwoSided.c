@@ -0,0 +1,140 @@
+static char help[] = "Times PetscCommBuildTwoSided() and PetscSFSetUp() with each -build_twosided algorithm on a random sparse communication graph.\n\
+  -degree <k>  : number of random ranks each rank sends to\n\
+  -n <n>       : number of leaves referencing each of these ranks in the PetscSF\n\
+  -nroots <m>  : number of roots on each rank\n\
+  -nrepeat <r> : number of setups timed for each algorithm\n\n";
+
+#include <petscsf.h>
+#include <petsctime.h>
+
+/* degree distinct random ranks other than rank */
+static PetscErrorCode CreateGraph(PetscRandom rand,PetscMPIInt rank,PetscMPIInt size,PetscInt degree,PetscMPIInt *nto,PetscMPIInt **toranks)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,k = 0;
+  PetscReal      r;
+
+  PetscFunctionBeginUser;
+  degree = PetscMin(degree,size-1);
+  ierr   = PetscMalloc1(degree,toranks);CHKERRQ(ierr);
+  while (k < degree) {
+    PetscMPIInt q;
+    ierr = PetscRandomGetValueReal(rand,&r);CHKERRQ(ierr);
+    q    = (PetscMPIInt)(r*size) % size;
+    if (q == rank) continue;
+    for (i=0; i<k; i++) if ((*toranks)[i] == q) break;
+    if (i == k) (*toranks)[k++] = q;
+  }
+  ierr = PetscMPIIntCast(degree,nto);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TimeBuildTwoSided(PetscMPIInt nto,const PetscMPIInt *toranks,PetscInt nrepeat,PetscLogDouble *time)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    nfrom,*fromranks,*todata,*fromdata,i;
+  PetscLogDouble t0,t1;
+  PetscInt       r;
+
+  PetscFunctionBeginUser;
+  ierr = PetscMalloc1(nto,&todata);CHKERRQ(ierr);
+  for (i=0; i<nto; i++) todata[i] = i;
+  *time = 0.0;
+  for (r=0; r<nrepeat; r++) {
+    ierr   = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr   = PetscTime(&t0);CHKERRQ(ierr);
+    ierr   = PetscCommBuildTwoSided(PETSC_COMM_WORLD,1,MPI_INT,nto,toranks,todata,&nfrom,&fromranks,&fromdata);CHKERRQ(ierr);
+    ierr   = PetscTime(&t1);CHKERRQ(ierr);
+    *time += t1-t0;
+    ierr   = PetscFree(fromranks);CHKERRQ(ierr);
+    ierr   = PetscFree(fromdata);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(todata);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* n leaves referencing random roots of each of the ranks of the graph */
+static PetscErrorCode TimeSFSetUp(PetscRandom rand,PetscMPIInt nto,const PetscMPIInt *toranks,PetscInt n,PetscInt nroots,PetscInt nrepeat,PetscLogDouble *time)
+{
+  PetscErrorCode ierr;
+  PetscSF        sf;
+  PetscSFNode    *remote;
+  PetscReal      v;
+  PetscLogDouble t0,t1;
+  PetscInt       i,j,r;
+
+  PetscFunctionBeginUser;
+  *time = 0.0;
+  for (r=0; r<nrepeat; r++) {
+    ierr = PetscMalloc1(nto*n,&remote);CHKERRQ(ierr);
+    for (i=0; i<nto; i++) {
+      for (j=0; j<n; j++) {
+        ierr = PetscRandomGetValueReal(rand,&v);CHKERRQ(ierr);
+        remote[i*n+j].rank  = toranks[i];
+        remote[i*n+j].index = (PetscInt)(v*nroots) % nroots;
+      }
+    }
+    ierr   = PetscSFCreate(PETSC_COMM_WORLD,&sf);CHKERRQ(ierr);
+    ierr   = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+    ierr   = PetscSFSetGraph(sf,nroots,nto*n,NULL,PETSC_OWN_POINTER,remote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+    ierr   = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr   = PetscTime(&t0);CHKERRQ(ierr);
+    ierr   = PetscSFSetUp(sf);CHKERRQ(ierr);
+    ierr   = PetscTime(&t1);CHKERRQ(ierr);
+    *time += t1-t0;
+    ierr   = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscBuildTwoSidedType types[4];
+  PetscRandom            rand;
+  PetscMPIInt            rank,size,nto,*toranks;
+  PetscInt               degree = 8,n = 100,nroots = 1000,nrepeat = 10,ntypes = 0,t;
+  PetscLogDouble         tbts,tsf,times[2],maxtimes[2];
+  PetscErrorCode         ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-degree",&degree,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nroots",&nroots,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrepeat",&nrepeat,NULL);CHKERRQ(ierr);
+  if (nroots < 1) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"Number of roots %D must be positive",nroots);
+
+  types[ntypes++] = PETSC_BUILDTWOSIDED_ALLREDUCE;
+#if defined(PETSC_HAVE_MPI_IBARRIER) || defined(PETSC_HAVE_MPIX_IBARRIER)
+  types[ntypes++] = PETSC_BUILDTWOSIDED_IBARRIER;
+#endif
+#if defined(PETSC_HAVE_MPI_REDUCE_SCATTER_BLOCK)
+  types[ntypes++] = PETSC_BUILDTWOSIDED_REDSCATTER;
+#endif
+#if (defined(PETSC_HAVE_MPI_IBARRIER) || defined(PETSC_HAVE_MPIX_IBARRIER)) && defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  types[ntypes++] = PETSC_BUILDTWOSIDED_HIERARCHICAL;
+#endif
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetSeed(rand,(unsigned long)rank+1);CHKERRQ(ierr);
+  ierr = PetscRandomSeed(rand);CHKERRQ(ierr);
+  ierr = CreateGraph(rand,rank,size,degree,&nto,&toranks);CHKERRQ(ierr);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%d ranks sending to %d ranks each, %D leaves per rank in the PetscSF\n",size,nto,nto*n);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%14s %22s %16s\n","algorithm","BuildTwoSided (sec)","SFSetUp (sec)");CHKERRQ(ierr);
+  for (t=0; t<ntypes; t++) {
+    ierr = PetscCommBuildTwoSidedSetType(PETSC_COMM_WORLD,types[t]);CHKERRQ(ierr);
+    ierr = TimeBuildTwoSided(nto,toranks,nrepeat,&tbts);CHKERRQ(ierr);
+    ierr = TimeSFSetUp(rand,nto,toranks,n,nroots,nrepeat,&tsf);CHKERRQ(ierr);
+    times[0] = tbts/nrepeat;
+    times[1] = tsf/nrepeat;
+    ierr = MPIU_Allreduce(times,maxtimes,2,MPIU_PETSCLOGDOUBLE,MPI_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%14s %22e %16e\n",PetscBuildTwoSidedTypes[types[t]],maxtimes[0],maxtimes[1]);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree(toranks);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,91 @@
+static char help[] = "Measures the thread scaling of MatMult() and MatMultTranspose() for MATSEQAIJOMP.\n\
+  -n <n>       : grid points in each direction of the Laplacian\n\
+  -dim <2,3>   : dimension of the Laplacian\n\
+  -maxthreads  : largest number of threads tried, the number of threads is doubled starting from 1\n\
+  -nrepeat <r> : number of products timed for each number of threads\n\n";
+
+#include <petscmat.h>
+#include <petsctime.h>
+
+/* 5 point (dim 2) or 7 point (dim 3) Laplacian on an n^dim grid */
+static PetscErrorCode CreateLaplacian(PetscInt n,PetscInt dim,Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscInt       N = dim == 2 ? n*n : n*n*n,row,i,j,k,c,col[7];
+  PetscScalar    v[7];
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,N,2*dim+1,NULL,A);CHKERRQ(ierr);
+  for (row=0; row<N; row++) {
+    i = row % n; j = (row / n) % n; k = row / (n*n);
+    c = 0;
+    col[c] = row; v[c++] = 2.0*dim;
+    if (i > 0)   {col[c] = row-1; v[c++] = -1.0;}
+    if (i < n-1) {col[c] = row+1; v[c++] = -1.0;}
+    if (j > 0)   {col[c] = row-n; v[c++] = -1.0;}
+    if (j < n-1) {col[c] = row+n; v[c++] = -1.0;}
+    if (dim == 3) {
+      if (k > 0)   {col[c] = row-n*n; v[c++] = -1.0;}
+      if (k < n-1) {col[c] = row+n*n; v[c++] = -1.0;}
+    }
+    ierr = MatSetValues(*A,1,&row,c,col,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A,B;
+  Vec            x,y;
+  MatInfo        info;
+  PetscInt       n = 300,dim = 2,maxthreads = 8,nrepeat = 50,N,nt,r;
+  PetscLogDouble t0,t1,tmult,ttrans,tmult1 = 0.0,ttrans1 = 0.0;
+  char           str[16];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-maxthreads",&maxthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrepeat",&nrepeat,NULL);CHKERRQ(ierr);
+  if (dim != 2 && dim != 3) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Dimension %D must be 2 or 3",dim);
+
+  ierr = CreateLaplacian(n,dim,&A);CHKERRQ(ierr);
+  ierr = MatGetInfo(A,MAT_LOCAL,&info);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+  ierr = MatGetSize(A,&N,NULL);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%D rows, %g nonzeros\n",N,info.nz_used);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%8s %14s %10s %8s %14s %10s %8s\n","threads","MatMult (sec)","Gflop/s","speedup","Transp. (sec)","Gflop/s","speedup");CHKERRQ(ierr);
+
+  for (nt=1; nt<=maxthreads; nt*=2) {
+    /* the number of threads is read when the matrix is converted, which also places the arrays with -mat_aijomp_first_touch */
+    ierr = PetscSNPrintf(str,sizeof(str),"%D",nt);CHKERRQ(ierr);
+    ierr = PetscOptionsSetValue(NULL,"-mat_aijomp_threads",str);CHKERRQ(ierr);
+    ierr = MatConvert(A,MATSEQAIJOMP,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+
+    ierr = MatMult(B,x,y);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (r=0; r<nrepeat; r++) {ierr = MatMult(B,x,y);CHKERRQ(ierr);}
+    ierr  = PetscTime(&t1);CHKERRQ(ierr);
+    tmult = (t1-t0)/nrepeat;
+
+    ierr = MatMultTranspose(B,x,y);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (r=0; r<nrepeat; r++) {ierr = MatMultTranspose(B,x,y);CHKERRQ(ierr);}
+    ierr   = PetscTime(&t1);CHKERRQ(ierr);
+    ttrans = (t1-t0)/nrepeat;
+
+    if (nt == 1) {tmult1 = tmult; ttrans1 = ttrans;}
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%8D %14e %10.3f %8.2f %14e %10.3f %8.2f\n",nt,tmult,2.0e-9*info.nz_used/tmult,tmult1/tmult,ttrans,2.0e-9*info.nz_used/ttrans,ttrans1/ttrans);CHKERRQ(ierr);
+    ierr = MatDestroy(&B);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,126 @@
+static char help[] = "Compares the level scheduled triangular solves (-mat_solve_levels) of ILU and ICC factors with the sequential ones.\n\
+  -n <n>       : grid points in each direction of the Laplacian\n\
+  -dim <2,3>   : dimension of the Laplacian\n\
+  -levels <k>  : levels of fill of the factors\n\
+  -maxthreads  : largest number of threads tried, the number of threads is doubled starting from 1\n\
+  -nrepeat <r> : number of solves timed for each number of threads\n\n";
+
+#include <petscmat.h>
+#include <petsctime.h>
+
+/* 5 point (dim 2) or 7 point (dim 3) Laplacian on an n^dim grid */
+static PetscErrorCode CreateLaplacian(PetscInt n,PetscInt dim,Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscInt       N = dim == 2 ? n*n : n*n*n,row,i,j,k,c,col[7];
+  PetscScalar    v[7];
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,N,2*dim+1,NULL,A);CHKERRQ(ierr);
+  for (row=0; row<N; row++) {
+    i = row % n; j = (row / n) % n; k = row / (n*n);
+    c = 0;
+    col[c] = row; v[c++] = 2.0*dim;
+    if (i > 0)   {col[c] = row-1; v[c++] = -1.0;}
+    if (i < n-1) {col[c] = row+1; v[c++] = -1.0;}
+    if (j > 0)   {col[c] = row-n; v[c++] = -1.0;}
+    if (j < n-1) {col[c] = row+n; v[c++] = -1.0;}
+    if (dim == 3) {
+      if (k > 0)   {col[c] = row-n*n; v[c++] = -1.0;}
+      if (k < n-1) {col[c] = row+n*n; v[c++] = -1.0;}
+    }
+    ierr = MatSetValues(*A,1,&row,c,col,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Factors A with ILU or ICC; the solve levels are chosen by the options when the factor is created */
+static PetscErrorCode Factor(Mat A,MatFactorType ftype,IS row,IS col,MatFactorInfo *info,Mat *F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,F);CHKERRQ(ierr);
+  if (ftype == MAT_FACTOR_ILU) {
+    ierr = MatILUFactorSymbolic(*F,A,row,col,info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(*F,A,info);CHKERRQ(ierr);
+  } else {
+    ierr = MatICCFactorSymbolic(*F,A,row,info);CHKERRQ(ierr);
+    ierr = MatCholeskyFactorNumeric(*F,A,info);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TimeSolve(Mat F,Vec b,Vec x,PetscInt nrepeat,PetscLogDouble *time)
+{
+  PetscErrorCode ierr;
+  PetscLogDouble t0,t1;
+  PetscInt       r;
+
+  PetscFunctionBeginUser;
+  ierr  = MatSolve(F,b,x);CHKERRQ(ierr);
+  ierr  = PetscTime(&t0);CHKERRQ(ierr);
+  for (r=0; r<nrepeat; r++) {ierr = MatSolve(F,b,x);CHKERRQ(ierr);}
+  ierr  = PetscTime(&t1);CHKERRQ(ierr);
+  *time = (t1-t0)/nrepeat;
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A,F;
+  Vec            x,b;
+  IS             row,col;
+  MatFactorInfo  info;
+  MatFactorType  ftypes[2] = {MAT_FACTOR_ILU,MAT_FACTOR_ICC};
+  PetscInt       n = 300,dim = 2,levels = 0,maxthreads = 8,nrepeat = 50,nt,f;
+  PetscLogDouble tserial,t;
+  char           str[16];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-levels",&levels,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-maxthreads",&maxthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrepeat",&nrepeat,NULL);CHKERRQ(ierr);
+  if (dim != 2 && dim != 3) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Dimension %D must be 2 or 3",dim);
+
+  ierr = CreateLaplacian(n,dim,&A);CHKERRQ(ierr);
+  ierr = MatGetOrdering(A,MATORDERINGNATURAL,&row,&col);CHKERRQ(ierr);
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.fill   = 1.0 + levels;
+  info.levels = levels;
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  for (f=0; f<2; f++) {
+    ierr = PetscOptionsClearValue(NULL,"-mat_solve_levels");CHKERRQ(ierr);
+    ierr = Factor(A,ftypes[f],row,col,&info,&F);CHKERRQ(ierr);
+    ierr = TimeSolve(F,b,x,nrepeat,&tserial);CHKERRQ(ierr);
+    ierr = MatDestroy(&F);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s(%D) sequential MatSolve() %e sec\n",MatFactorTypes[ftypes[f]],levels,tserial);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%8s %14s %8s\n","threads","levels (sec)","speedup");CHKERRQ(ierr);
+
+    ierr = PetscOptionsSetValue(NULL,"-mat_solve_levels",NULL);CHKERRQ(ierr);
+    for (nt=1; nt<=maxthreads; nt*=2) {
+      /* the number of threads is read when the factor is created */
+      ierr = PetscSNPrintf(str,sizeof(str),"%D",nt);CHKERRQ(ierr);
+      ierr = PetscOptionsSetValue(NULL,"-mat_solve_levels_threads",str);CHKERRQ(ierr);
+      ierr = Factor(A,ftypes[f],row,col,&info,&F);CHKERRQ(ierr);
+      ierr = TimeSolve(F,b,x,nrepeat,&t);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%8D %14e %8.2f\n",nt,t,tserial/t);CHKERRQ(ierr);
+      ierr = MatDestroy(&F);CHKERRQ(ierr);
+    }
+  }
+
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,141 @@
+static char help[] = "Times the vector operations of CG and BiCGStab iterations with and without the deferred evaluation (-vec_lazy_evaluation).\n\
+  -n <n>       : local length of the vectors\n\
+  -nrepeat <r> : number of iterations timed\n\n";
+
+/*
+   The matrix is replaced by a diagonal (VecPointwiseMult()) so that only vector operations are timed; the
+   coefficients are fixed so that the iterations do not depend on the computed reductions.
+
+   The modeled memory traffic counts the vectors streamed (read or written) per iteration:
+
+   CG        w = D p; (p,w); x += a p; r -= a w; |r|; p = r + b p
+     one pass per operation         3 + 2 + 3 + 3 + 1 + 3                                          = 15
+     fused                          (p = r + b p, w = D p, (p,w)): 5, (x += a p, r -= a w, |r|): 6  = 11
+
+   BiCGStab  v = D p; (rh,v); s = r - a v; t = D s; (t,s); |t|; x += a p + o s; r = s - o t; (rh,r); |r|;
+             p = r + b (p - o v)
+     one pass per operation         3 + 2 + 3 + 3 + 2 + 1 + 4 + 3 + 2 + 1 + 4                     = 28
+     fused                          (p update, v = D p, (rh,v)): 7, (s, t = D s, (t,s)): 5, |t|: 1,
+                                    (x, r, (rh,r)): 7, |r|: 1                                        = 21
+
+   The second reduction of a VecDotBegin()/VecNormBegin() pair is computed by its own pass.
+*/
+
+#include <petscvec.h>
+#include <petsctime.h>
+
+static PetscErrorCode CGIterations(PetscInt nrepeat,Vec D,Vec x,Vec r,Vec p,Vec w,PetscReal *rnorm)
+{
+  PetscErrorCode ierr;
+  PetscScalar    pw;
+  PetscInt       i;
+
+  PetscFunctionBeginUser;
+  for (i=0; i<nrepeat; i++) {
+    ierr = VecPointwiseMult(w,D,p);CHKERRQ(ierr);
+    ierr = VecDot(p,w,&pw);CHKERRQ(ierr);
+    ierr = VecAXPY(x,0.1,p);CHKERRQ(ierr);
+    ierr = VecAXPY(r,-0.1,w);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,rnorm);CHKERRQ(ierr);
+    ierr = VecAYPX(p,0.5,r);CHKERRQ(ierr);
+  }
+  ierr = VecLazyEvaluationFlush(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode BiCGStabIterations(PetscInt nrepeat,Vec D,Vec x,Vec r,Vec rh,Vec p,Vec v,Vec s,Vec t,PetscReal *rnorm)
+{
+  PetscErrorCode ierr;
+  PetscScalar    rhv,ts,rhr;
+  PetscReal      tnorm;
+  PetscInt       i;
+
+  PetscFunctionBeginUser;
+  for (i=0; i<nrepeat; i++) {
+    ierr = VecPointwiseMult(v,D,p);CHKERRQ(ierr);
+    ierr = VecDot(rh,v,&rhv);CHKERRQ(ierr);
+    ierr = VecWAXPY(s,-0.1,v,r);CHKERRQ(ierr);
+    ierr = VecPointwiseMult(t,D,s);CHKERRQ(ierr);
+    ierr = VecDotBegin(t,s,&ts);CHKERRQ(ierr);
+    ierr = VecNormBegin(t,NORM_2,&tnorm);CHKERRQ(ierr);
+    ierr = VecDotEnd(t,s,&ts);CHKERRQ(ierr);
+    ierr = VecNormEnd(t,NORM_2,&tnorm);CHKERRQ(ierr);
+    ierr = VecAXPBYPCZ(x,0.1,0.2,1.0,p,s);CHKERRQ(ierr);
+    ierr = VecWAXPY(r,-0.2,t,s);CHKERRQ(ierr);
+    ierr = VecDotBegin(rh,r,&rhr);CHKERRQ(ierr);
+    ierr = VecNormBegin(r,NORM_2,rnorm);CHKERRQ(ierr);
+    ierr = VecDotEnd(rh,r,&rhr);CHKERRQ(ierr);
+    ierr = VecNormEnd(r,NORM_2,rnorm);CHKERRQ(ierr);
+    ierr = VecAXPBYPCZ(p,1.0,-0.1,0.5,r,v);CHKERRQ(ierr);
+  }
+  ierr = VecLazyEvaluationFlush(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            D,x,r,rh,p,v,s,t;
+  PetscInt       n = 1000000,nrepeat = 20,lazy;
+  PetscLogDouble t0,t1,time[2][2];
+  PetscReal      rnorm[2][2],bytes;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrepeat",&nrepeat,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetInterval(rand,0.5,1.0);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&D);CHKERRQ(ierr);
+  ierr = VecSetSizes(D,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(D);CHKERRQ(ierr);
+  ierr = VecSetRandom(D,rand);CHKERRQ(ierr);
+  ierr = VecDuplicate(D,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(D,&r);CHKERRQ(ierr);
+  ierr = VecDuplicate(D,&rh);CHKERRQ(ierr);
+  ierr = VecDuplicate(D,&p);CHKERRQ(ierr);
+  ierr = VecDuplicate(D,&v);CHKERRQ(ierr);
+  ierr = VecDuplicate(D,&s);CHKERRQ(ierr);
+  ierr = VecDuplicate(D,&t);CHKERRQ(ierr);
+  ierr = VecSetRandom(rh,rand);CHKERRQ(ierr);
+
+  for (lazy=0; lazy<2; lazy++) {
+    ierr = VecSetLazyEvaluation(PETSC_COMM_WORLD,(PetscBool)lazy);CHKERRQ(ierr);
+
+    ierr = VecSet(x,0.0);CHKERRQ(ierr);
+    ierr = VecCopy(rh,r);CHKERRQ(ierr);
+    ierr = VecCopy(rh,p);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    ierr = CGIterations(nrepeat,D,x,r,p,v,&rnorm[0][lazy]);CHKERRQ(ierr);
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    time[0][lazy] = (t1-t0)/nrepeat;
+
+    ierr = VecSet(x,0.0);CHKERRQ(ierr);
+    ierr = VecCopy(rh,r);CHKERRQ(ierr);
+    ierr = VecCopy(rh,p);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    ierr = BiCGStabIterations(nrepeat,D,x,r,rh,p,v,s,t,&rnorm[1][lazy]);CHKERRQ(ierr);
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    time[1][lazy] = (t1-t0)/nrepeat;
+  }
+  ierr = VecSetLazyEvaluation(PETSC_COMM_WORLD,PETSC_FALSE);CHKERRQ(ierr);
+
+  bytes = (PetscReal)n*sizeof(PetscScalar);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Local length %D, time per iteration and modeled memory traffic per process\n",n);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"CG       one pass per operation %g s (%g MB), fused %g s (%g MB), speedup %g\n",time[0][0],15*bytes/1.e6,time[0][1],11*bytes/1.e6,time[0][0]/time[0][1]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"BiCGStab one pass per operation %g s (%g MB), fused %g s (%g MB), speedup %g\n",time[1][0],28*bytes/1.e6,time[1][1],21*bytes/1.e6,time[1][0]/time[1][1]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Relative difference of the residual norms: CG %g BiCGStab %g\n",(double)(PetscAbsReal(rnorm[0][1]-rnorm[0][0])/rnorm[0][0]),(double)(PetscAbsReal(rnorm[1][1]-rnorm[1][0])/rnorm[1][0]));CHKERRQ(ierr);
+
+  ierr = VecDestroy(&D);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&rh);CHKERRQ(ierr);
+  ierr = VecDestroy(&p);CHKERRQ(ierr);
+  ierr = VecDestroy(&v);CHKERRQ(ierr);
+  ierr = VecDestroy(&s);CHKERRQ(ierr);
+  ierr = VecDestroy(&t);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,162 @@
+
+static char help[] = "Tests DMGetLocalInteriorIS() and DMGlobalToLocalCompute() on a DMDA and a DMPlex.\n\n";
+
+#include <petscdmda.h>
+#include <petscdmplex.h>
+
+typedef struct {
+  PetscBool plex;
+  Vec       y;      /* local vector with the result */
+} AppCtx;
+
+/* 5-point Laplacian on a DMDA, or the sum of the differences with the neighbors through the faces on a DMPlex */
+static PetscErrorCode Laplacian(DM dm,Vec l,IS is,void *ctx)
+{
+  AppCtx            *user = (AppCtx*)ctx;
+  PetscErrorCode    ierr;
+  const PetscScalar *x;
+  PetscScalar       *y;
+  const PetscInt    *idx;
+  PetscInt          k,m,i;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetArrayRead(l,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(user->y,&y);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(is,&m);CHKERRQ(ierr);
+  ierr = ISGetIndices(is,&idx);CHKERRQ(ierr);
+  if (user->plex) {
+    PetscInt cStart,cEnd,c,f,s,nf,ns;
+    const PetscInt *faces,*cells;
+
+    ierr = DMPlexGetHeightStratum(dm,0,&cStart,&cEnd);CHKERRQ(ierr);
+    for (k=0; k<m; k++) {
+      i    = idx[k];
+      c    = cStart+i;
+      y[i] = 0.0;
+      ierr = DMPlexGetConeSize(dm,c,&nf);CHKERRQ(ierr);
+      ierr = DMPlexGetCone(dm,c,&faces);CHKERRQ(ierr);
+      for (f=0; f<nf; f++) {
+        ierr = DMPlexGetSupportSize(dm,faces[f],&ns);CHKERRQ(ierr);
+        ierr = DMPlexGetSupport(dm,faces[f],&cells);CHKERRQ(ierr);
+        for (s=0; s<ns; s++) if (cells[s] != c) y[i] += x[cells[s]-cStart] - x[i];
+      }
+    }
+  } else {
+    PetscInt M,N,gxs,gys,gxm,ii,jj;
+
+    ierr = DMDAGetInfo(dm,NULL,&M,&N,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+    ierr = DMDAGetGhostCorners(dm,&gxs,&gys,NULL,&gxm,NULL,NULL);CHKERRQ(ierr);
+    for (k=0; k<m; k++) {
+      i    = idx[k];
+      ii   = gxs + i%gxm;
+      jj   = gys + i/gxm;
+      y[i] = 4.0*x[i];
+      if (ii > 0)   y[i] -= x[i-1];
+      if (ii < M-1) y[i] -= x[i+1];
+      if (jj > 0)   y[i] -= x[i-gxm];
+      if (jj < N-1) y[i] -= x[i+gxm];
+    }
+  }
+  ierr = ISRestoreIndices(is,&idx);CHKERRQ(ierr);
+  ierr = VecRestoreArray(user->y,&y);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(l,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CreatePlex(MPI_Comm comm,DM *dm)
+{
+  PetscErrorCode ierr;
+  DM             dmDist;
+  PetscSection   section;
+  PetscInt       faces[2] = {4,4},cStart,cEnd,c,pStart,pEnd;
+
+  PetscFunctionBeginUser;
+  ierr = DMPlexCreateBoxMesh(comm,2,PETSC_FALSE,faces,NULL,NULL,NULL,PETSC_TRUE,dm);CHKERRQ(ierr);
+  ierr = DMPlexDistribute(*dm,1,NULL,&dmDist);CHKERRQ(ierr);
+  if (dmDist) {
+    ierr = DMDestroy(dm);CHKERRQ(ierr);
+    *dm  = dmDist;
+  }
+  ierr = DMPlexGetChart(*dm,&pStart,&pEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(*dm,0,&cStart,&cEnd);CHKERRQ(ierr);
+  ierr = PetscSectionCreate(comm,&section);CHKERRQ(ierr);
+  ierr = PetscSectionSetChart(section,pStart,pEnd);CHKERRQ(ierr);
+  for (c=cStart; c<cEnd; c++) {ierr = PetscSectionSetDof(section,c,1);CHKERRQ(ierr);}
+  ierr = PetscSectionSetUp(section);CHKERRQ(ierr);
+  ierr = DMSetSection(*dm,section);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&section);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  DM             dm;
+  AppCtx         user;
+  Vec            g,l,y;
+  IS             interior,boundary;
+  PetscScalar    *a;
+  PetscInt       n,rstart,k,sizes[2];
+  PetscReal      norm;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  user.plex = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-plex",&user.plex,NULL);CHKERRQ(ierr);
+  if (user.plex) {
+    ierr = CreatePlex(PETSC_COMM_WORLD,&dm);CHKERRQ(ierr);
+  } else {
+    ierr = DMDACreate2d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,DM_BOUNDARY_NONE,DMDA_STENCIL_STAR,8,8,PETSC_DECIDE,PETSC_DECIDE,1,1,NULL,NULL,&dm);CHKERRQ(ierr);
+    ierr = DMSetFromOptions(dm);CHKERRQ(ierr);
+    ierr = DMSetUp(dm);CHKERRQ(ierr);
+  }
+  ierr = DMCreateGlobalVector(dm,&g);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(dm,&l);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(dm,&user.y);CHKERRQ(ierr);
+  ierr = VecDuplicate(user.y,&y);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(g,&rstart,NULL);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(g,&n);CHKERRQ(ierr);
+  ierr = VecGetArray(g,&a);CHKERRQ(ierr);
+  for (k=0; k<n; k++) a[k] = (PetscScalar)((rstart+k)*(rstart+k));
+  ierr = VecRestoreArray(g,&a);CHKERRQ(ierr);
+
+  ierr = DMGetLocalInteriorIS(dm,&interior,&boundary);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(interior,&sizes[0]);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(boundary,&sizes[1]);CHKERRQ(ierr);
+  if (sizes[0]+sizes[1] != n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"The interior and the boundary do not cover the owned entries");
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,sizes,2,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Interior %D boundary %D\n",sizes[0],sizes[1]);CHKERRQ(ierr);
+
+  /* the overlapped evaluation, then the one after the complete update */
+  ierr = DMGlobalToLocalCompute(dm,g,INSERT_VALUES,l,Laplacian,&user);CHKERRQ(ierr);
+  ierr = VecCopy(user.y,y);CHKERRQ(ierr);
+  ierr = VecSet(user.y,0.0);CHKERRQ(ierr);
+  ierr = VecSet(l,0.0);CHKERRQ(ierr);
+  ierr = DMGlobalToLocal(dm,g,INSERT_VALUES,l);CHKERRQ(ierr);
+  ierr = Laplacian(dm,l,interior,&user);CHKERRQ(ierr);
+  ierr = Laplacian(dm,l,boundary,&user);CHKERRQ(ierr);
+  ierr = VecAXPY(y,-1.0,user.y);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&norm,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Difference of the results %g\n",(double)norm);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&user.y);CHKERRQ(ierr);
+  ierr = VecDestroy(&l);CHKERRQ(ierr);
+  ierr = VecDestroy(&g);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: da
+      nsize: 4
+
+   test:
+      suffix: plex
+      nsize: 2
+      args: -plex
+
+TEST*/
@@ -85,7 +85,9 @@ int main(int argc,char **argv)
   ierr = VecAXPY(local_copy,-1.0,local);CHKERRQ(ierr);
   ierr = VecNorm(local_copy,NORM_MAX,&work);CHKERRQ(ierr);
   ierr = MPI_Allreduce(&work,&norm,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
-  ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of difference %g should be zero\n",(double)norm);CHKERRQ(ierr);
+  /* the test harness ignores the floating point numbers of the output, so the outcome is printed in words */
+  if (norm == 0.0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of difference is zero\n");CHKERRQ(ierr);}
+  else {ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of difference %g should be zero\n",(double)norm);CHKERRQ(ierr);}
 
   ierr = VecDestroy(&local_copy);CHKERRQ(ierr);
   ierr = VecDestroy(&local);CHKERRQ(ierr);
@@ -114,4 +116,24 @@ int main(int argc,char **argv)
       args: -dof 3 -stencil_width 2 -M 50 -N 50 -periodic -grid3d
       output_file: output/ex7_1.out
 
+   test:
+      suffix: 3_sf
+      nsize: 8
+      args: -dof 3 -stencil_width 2 -M 50 -N 50 -periodic -grid3d -vecscatter_type sf
+      output_file: output/ex7_1.out
+
+   test:
+      suffix: 3_sf_neighbor
+      nsize: 8
+      args: -dof 3 -stencil_width 2 -M 50 -N 50 -periodic -grid3d -vecscatter_type sf -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+      output_file: output/ex7_1.out
+
+   test:
+      suffix: 3_sf_node
+      nsize: 8
+      args: -dof 3 -stencil_width 2 -M 50 -N 50 -periodic -grid3d -vecscatter_type sf -sf_type node -sf_node_size {{2 3 4}}
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      output_file: output/ex7_1.out
+
 TEST*/
@@ -1650,8 +1650,8 @@ PetscErrorCode  DMGlobalToLocalBegin_Composite(DM dm,Vec gvec,InsertMode mode,Ve
     next    = next->next;
   }
 
-  ierr = VecRestoreArray(gvec,NULL);CHKERRQ(ierr);
-  ierr = VecRestoreArray(lvec,NULL);CHKERRQ(ierr);
+  ierr = VecRestoreArray(gvec,&garray);CHKERRQ(ierr);
+  ierr = VecRestoreArray(lvec,&larray);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1704,8 +1704,8 @@ PetscErrorCode  DMLocalToGlobalBegin_Composite(DM dm,Vec lvec,InsertMode mode,Ve
     next    = next->next;
   }
 
-  ierr = VecRestoreArray(gvec,NULL);CHKERRQ(ierr);
-  ierr = VecRestoreArray(lvec,NULL);CHKERRQ(ierr);
+  ierr = VecRestoreArray(gvec,&garray);CHKERRQ(ierr);
+  ierr = VecRestoreArray(lvec,&larray);CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 }
@@ -1759,8 +1759,8 @@ PetscErrorCode  DMLocalToLocalBegin_Composite(DM dm,Vec vec1,InsertMode mode,Vec
     next    = next->next;
   }
 
-  ierr = VecRestoreArray(vec1,NULL);CHKERRQ(ierr);
-  ierr = VecRestoreArray(vec2,NULL);CHKERRQ(ierr);
+  ierr = VecRestoreArray(vec1,&array1);CHKERRQ(ierr);
+  ierr = VecRestoreArray(vec2,&array2);CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 }
@@ -56,6 +56,10 @@ PetscErrorCode  DMCreate(MPI_Comm comm,DM *dm)
   v->setupcalled              = PETSC_FALSE;
   v->setfromoptionscalled     = PETSC_FALSE;
   v->ltogmap                  = NULL;
+  v->localinterior            = NULL;
+  v->localboundary            = NULL;
+  v->localowned               = NULL;
+  v->globalowned              = NULL;
   v->bs                       = 1;
   v->coloringtype             = IS_COLORING_GLOBAL;
   ierr                        = PetscSFCreate(comm, &v->sf);CHKERRQ(ierr);
@@ -607,6 +611,19 @@ PetscErrorCode DMDestroyLabelLinkList(DM dm)
   PetscFunctionReturn(0);
 }
 
+/* the index sets of DMGetLocalInteriorIS() are recomputed when the layout of the vectors changes */
+static PetscErrorCode DMClearLocalInteriorIS_Private(DM dm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = ISDestroy(&dm->localinterior);CHKERRQ(ierr);
+  ierr = ISDestroy(&dm->localboundary);CHKERRQ(ierr);
+  ierr = ISDestroy(&dm->localowned);CHKERRQ(ierr);
+  ierr = ISDestroy(&dm->globalowned);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
     DMDestroy - Destroys a vector packer or DM.
 
@@ -751,6 +768,7 @@ PetscErrorCode  DMDestroy(DM *dm)
   ierr = MatFDColoringDestroy(&(*dm)->fd);CHKERRQ(ierr);
   ierr = DMClearGlobalVectors(*dm);CHKERRQ(ierr);
   ierr = ISLocalToGlobalMappingDestroy(&(*dm)->ltogmap);CHKERRQ(ierr);
+  ierr = DMClearLocalInteriorIS_Private(*dm);CHKERRQ(ierr);
   ierr = PetscFree((*dm)->vectype);CHKERRQ(ierr);
   ierr = PetscFree((*dm)->mattype);CHKERRQ(ierr);
 
@@ -2274,6 +2292,179 @@ PetscErrorCode  DMGlobalToLocalEnd(DM dm,Vec g,InsertMode mode,Vec l)
   PetscFunctionReturn(0);
 }
 
+/*
+   The owned entries of the local vectors are found by inserting their local indices into a global vector, which only
+   uses the owned entries, and those that are ghost points of other processes by adding the number of copies of each
+   entry into a global vector. The local indices are sent digit by digit, in a base whose digits are exact in a
+   PetscScalar, so a single pass is enough unless the local size exceeds the integers exact in PetscReal; each pass
+   inserts into a global entry from the same local entry, and the first one adds 1 to the digit to mark the owned entries.
+*/
+static PetscErrorCode DMSetUpLocalInteriorIS_Private(DM dm)
+{
+  PetscErrorCode    ierr;
+  Vec               g,l;
+  PetscScalar       *a;
+  const PetscScalar *ca;
+  PetscInt          n,nl,nlmax,base,pw,r,d,i,k,nowned = 0,ni = 0,nb = 0,*lidx,*gidx,*iidx,*bidx;
+
+  PetscFunctionBegin;
+  ierr = DMGetGlobalVector(dm,&g);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm,&l);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(g,&n);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(l,&nl);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&nl,&nlmax,1,MPIU_INT,MPI_MAX,PetscObjectComm((PetscObject)dm));CHKERRQ(ierr);
+  for (base=2; base < 1.0/PETSC_MACHINE_EPSILON && base <= PETSC_MAX_INT/2; base *= 2) ;
+
+  ierr = PetscMalloc2(n,&lidx,n,&gidx);CHKERRQ(ierr);
+  for (d=0,pw=1,r=nlmax; !d || r; d++,r/=base) {
+    if (d) pw *= base;
+    ierr = VecGetArray(l,&a);CHKERRQ(ierr);
+    for (i=0; i<nl; i++) a[i] = (PetscScalar)((i/pw)%base + (d ? 0 : 1));
+    ierr = VecRestoreArray(l,&a);CHKERRQ(ierr);
+    ierr = VecSet(g,0.0);CHKERRQ(ierr);
+    ierr = DMLocalToGlobal(dm,l,INSERT_VALUES,g);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(g,&ca);CHKERRQ(ierr);
+    for (k=0; k<n; k++) {
+      if (!d) lidx[k] = (PetscInt)PetscRealPart(ca[k]) - 1;
+      else if (lidx[k] >= 0) lidx[k] += pw*(PetscInt)PetscRealPart(ca[k]);
+    }
+    ierr = VecRestoreArrayRead(g,&ca);CHKERRQ(ierr);
+  }
+  for (k=0; k<n; k++) {
+    if (lidx[k] < 0) continue;
+    lidx[nowned] = lidx[k];
+    gidx[nowned] = k;
+    nowned++;
+  }
+  ierr = PetscSortIntWithArray(nowned,lidx,gidx);CHKERRQ(ierr);
+
+  ierr = VecSet(l,1.0);CHKERRQ(ierr);
+  ierr = VecSet(g,0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobal(dm,l,ADD_VALUES,g);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nowned,&iidx);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nowned,&bidx);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(g,&ca);CHKERRQ(ierr);
+  for (i=0; i<nowned; i++) {
+    if (PetscRealPart(ca[gidx[i]]) > 1.0) bidx[nb++] = lidx[i];
+    else iidx[ni++] = lidx[i];
+  }
+  ierr = VecRestoreArrayRead(g,&ca);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm,&l);CHKERRQ(ierr);
+  ierr = DMRestoreGlobalVector(dm,&g);CHKERRQ(ierr);
+
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,ni,iidx,PETSC_OWN_POINTER,&dm->localinterior);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,nb,bidx,PETSC_OWN_POINTER,&dm->localboundary);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,nowned,lidx,PETSC_COPY_VALUES,&dm->localowned);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,nowned,gidx,PETSC_COPY_VALUES,&dm->globalowned);CHKERRQ(ierr);
+  ierr = PetscFree2(lidx,gidx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMGetLocalInteriorIS - Gets the entries of the local vectors owned by this process that are not ghost points of
+   other processes, the interior, and those that are, the boundary
+
+   Collective on DM the first time it is called
+
+   Input Parameter:
+.  dm - the DM object
+
+   Output Parameters:
++  interior - the indices in the local vectors of the interior entries, or NULL
+-  boundary - the indices in the local vectors of the boundary entries, or NULL
+
+   Notes:
+   The index sets are computed with DMLocalToGlobal() when first requested and belong to the DM; do not destroy them.
+   They are computed again after the section, the global section or the SF of the DM is replaced, so get them again
+   after DMSetSection(), DMSetGlobalSection() or DMSetDefaultSF().
+
+   When the coupling between the entries is symmetric, as for the stencils of a DMDA or the cells of a DMPlex with
+   an overlap, the interior entries do not depend on any ghost value. They can then be computed while the ghost
+   values are updated, see DMGlobalToLocalCompute().
+
+   Level: intermediate
+
+.seealso: DMGlobalToLocalCompute(), DMGlobalToLocalBegin(), DMCreateLocalVector(), VecGhostGetInteriorIS()
+@*/
+PetscErrorCode DMGetLocalInteriorIS(DM dm,IS *interior,IS *boundary)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  if (!dm->localinterior) {ierr = DMSetUpLocalInteriorIS_Private(dm);CHKERRQ(ierr);}
+  if (interior) *interior = dm->localinterior;
+  if (boundary) *boundary = dm->localboundary;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMGlobalToLocalCompute - Updates a local vector from a global vector while a computation runs on the entries that
+   do not depend on the ghost values
+
+   Neighbor-wise Collective on DM
+
+   Input Parameters:
++  dm - the DM object
+.  g - the global vector
+.  mode - INSERT_VALUES or INSERT_ALL_VALUES
+.  l - the local vector
+.  compute - the computation on a subset of the entries
+-  ctx - the context of compute, or NULL
+
+   Calling sequence of compute:
+$     PetscErrorCode compute(DM dm,Vec l,IS is,void *ctx)
+
++  dm - the DM object
+.  l - the local vector
+.  is - the indices in l of the entries to compute
+-  ctx - the context
+
+   Notes:
+   compute is called on the interior entries, see DMGetLocalInteriorIS(), between DMGlobalToLocalBegin() and
+   DMGlobalToLocalEnd(), then on the boundary entries. In the first call all the entries of l owned by this process
+   are already set, whether or not the implementation sets them in DMGlobalToLocalBegin(); the ghost values, and
+   the changes of the hooks of DMGlobalToLocalEnd(), may only be used in the second call. compute must only read l,
+   with VecGetArrayRead(), and usually writes into another vector given in ctx.
+
+   Level: intermediate
+
+.seealso: DMGetLocalInteriorIS(), DMGlobalToLocalBegin(), DMGlobalToLocalEnd(), VecGhostUpdateCompute()
+@*/
+PetscErrorCode DMGlobalToLocalCompute(DM dm,Vec g,InsertMode mode,Vec l,PetscErrorCode (*compute)(DM,Vec,IS,void*),void *ctx)
+{
+  PetscErrorCode    ierr;
+  IS                interior,boundary;
+  const PetscInt    *lidx,*gidx;
+  const PetscScalar *ga;
+  PetscScalar       *la;
+  PetscInt          i,n;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidHeaderSpecific(g,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(l,VEC_CLASSID,4);
+  PetscValidFunction(compute,5);
+  if (mode != INSERT_VALUES && mode != INSERT_ALL_VALUES) SETERRQ1(PetscObjectComm((PetscObject)dm),PETSC_ERR_ARG_OUTOFRANGE,"Invalid insertion mode %D",mode);
+  ierr = DMGetLocalInteriorIS(dm,&interior,&boundary);CHKERRQ(ierr);
+  /* the local vector may be locked between the begin and end phases, so the owned entries are copied first */
+  ierr = ISGetLocalSize(dm->localowned,&n);CHKERRQ(ierr);
+  ierr = ISGetIndices(dm->localowned,&lidx);CHKERRQ(ierr);
+  ierr = ISGetIndices(dm->globalowned,&gidx);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(g,&ga);CHKERRQ(ierr);
+  ierr = VecGetArray(l,&la);CHKERRQ(ierr);
+  for (i=0; i<n; i++) la[lidx[i]] = ga[gidx[i]];
+  ierr = VecRestoreArray(l,&la);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(g,&ga);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(dm->globalowned,&gidx);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(dm->localowned,&lidx);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm,g,mode,l);CHKERRQ(ierr);
+  ierr = (*compute)(dm,l,interior,ctx);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm,g,mode,l);CHKERRQ(ierr);
+  ierr = (*compute)(dm,l,boundary,ctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    DMLocalToGlobalHookAdd - adds a callback to be run when a local to global is called
 
@@ -3752,6 +3943,7 @@ PetscErrorCode DMSetSection(DM dm, PetscSection section)
   }
   /* The global section will be rebuilt in the next call to DMGetGlobalSection(). */
   ierr = PetscSectionDestroy(&dm->defaultGlobalSection);CHKERRQ(ierr);
+  ierr = DMClearLocalInteriorIS_Private(dm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -3962,6 +4154,7 @@ PetscErrorCode DMSetGlobalSection(DM dm, PetscSection section)
   ierr = PetscObjectReference((PetscObject)section);CHKERRQ(ierr);
   ierr = PetscSectionDestroy(&dm->defaultGlobalSection);CHKERRQ(ierr);
   dm->defaultGlobalSection = section;
+  ierr = DMClearLocalInteriorIS_Private(dm);CHKERRQ(ierr);
 #if defined(PETSC_USE_DEBUG)
   if (section) {ierr = DMDefaultSectionCheckConsistency_Internal(dm, dm->defaultSection, section);CHKERRQ(ierr);}
 #endif
@@ -4037,6 +4230,7 @@ PetscErrorCode DMSetDefaultSF(DM dm, PetscSF sf)
   }
   ierr          = PetscSFDestroy(&dm->defaultSF);CHKERRQ(ierr);
   dm->defaultSF = sf;
+  ierr          = DMClearLocalInteriorIS_Private(dm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
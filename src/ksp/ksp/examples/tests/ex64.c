@@ -0,0 +1,146 @@
+static char help[] = "Tests KSPMatSolve() with several right-hand sides on a 2D convection-diffusion problem.\n\n\
+  -m <m>, -n <n>  : the number of mesh points in each direction\n\
+  -p <p>          : the number of right-hand sides\n\
+  -convection <c> : the strength of the convection, which makes the operator nonsymmetric\n\n";
+
+#include <petscksp.h>
+
+/*
+   Counts the iterations of each column when KSPMatSolve() calls KSPSolve() for each column in turn, every solve
+   starting again at iteration 0; a block Krylov method has a single iteration count for all the columns
+*/
+typedef struct {
+  PetscInt p,col,*its;
+} ColumnIts;
+
+static PetscErrorCode MonitorColumns(KSP ksp,PetscInt n,PetscReal rnorm,void *ctx)
+{
+  ColumnIts *cits = (ColumnIts*)ctx;
+
+  PetscFunctionBeginUser;
+  if (!n && cits->col < cits->p-1) cits->col++;
+  cits->its[cits->col] = n;
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  KSP            ksp;
+  Mat            A,B,X,R;
+  PetscInt       m = 8,n = 7,p = 4,Istart,Iend,Ii,i,j,c,its;
+  PetscReal      convection = 0.0,*bnorm,*rnorm,tol = 1.e-5;
+  ColumnIts      cits;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-p",&p,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-convection",&convection,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*n,m*n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,5,NULL);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    i = Ii/n; j = Ii - i*n;
+    if (i>0)   {ierr = MatSetValue(A,Ii,Ii-n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {ierr = MatSetValue(A,Ii,Ii+n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {ierr = MatSetValue(A,Ii,Ii-1,-1.0-convection,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {ierr = MatSetValue(A,Ii,Ii+1,-1.0+convection,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,Ii,Ii,4.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateDense(PETSC_COMM_WORLD,Iend-Istart,PETSC_DECIDE,m*n,p,NULL,&B);CHKERRQ(ierr);
+  /* right-hand sides independent of the number of processes */
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    for (c=0; c<p; c++) {ierr = MatSetValue(B,Ii,c,PetscSinReal((PetscReal)((Ii+1)*(c+1))),INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&X);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  cits.p   = p;
+  cits.col = -1;
+  ierr = PetscCalloc1(p,&cits.its);CHKERRQ(ierr);
+  ierr = KSPMonitorSet(ksp,MonitorColumns,&cits,NULL);CHKERRQ(ierr);
+  ierr = KSPMatSolve(ksp,B,X);CHKERRQ(ierr);
+
+  /* check the true residual of each column */
+  ierr = MatMatMult(A,X,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&R);CHKERRQ(ierr);
+  ierr = MatAYPX(R,-1.0,B,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = PetscMalloc2(p,&bnorm,p,&rnorm);CHKERRQ(ierr);
+  ierr = MatGetColumnNorms(B,NORM_2,bnorm);CHKERRQ(ierr);
+  ierr = MatGetColumnNorms(R,NORM_2,rnorm);CHKERRQ(ierr);
+  if (cits.col <= 0) {
+    ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"All the columns: %D block iterations\n",its);CHKERRQ(ierr);
+  }
+  for (c=0; c<p; c++) {
+    if (cits.col > 0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Column %D: %D iterations\n",c,cits.its[c]);CHKERRQ(ierr);}
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Column %D: relative residual norm %g, %s the tolerance\n",c,(double)(rnorm[c]/bnorm[c]),rnorm[c] > tol*bnorm[c] ? "ABOVE" : "below");CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree(cits.its);CHKERRQ(ierr);
+  ierr = PetscFree2(bnorm,rnorm);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = MatDestroy(&X);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: cg
+      nsize: {{1 2}}
+      output_file: output/ex64_cg.out
+      args: -ksp_type cg -pc_type jacobi -ksp_converged_reason
+
+   test:
+      suffix: cg_bjacobi
+      nsize: 2
+      args: -ksp_type cg -pc_type bjacobi -sub_pc_type icc -p 6 -ksp_converged_reason
+
+   test:
+      suffix: gmres
+      nsize: {{1 2}}
+      output_file: output/ex64_gmres.out
+      args: -ksp_type gmres -convection 0.5 -pc_type jacobi -ksp_gmres_restart 5 -ksp_converged_reason -ksp_pc_side {{left right}}
+
+   test:
+      suffix: gmres_deflation
+      args: -ksp_type gmres -convection 0.3 -pc_type jacobi -ksp_gmres_restart 5 -m 20 -n 20 -p 8 -ksp_converged_reason
+
+   test:
+      suffix: gmres_refine
+      args: -ksp_type gmres -convection 0.5 -pc_type ilu -ksp_gmres_cgs_refinement_type refine_always -ksp_converged_reason
+
+   test:
+      suffix: preonly
+      args: -ksp_type preonly -pc_type lu -convection 0.5
+
+   test:
+      suffix: loop
+      args: -ksp_type bcgs -convection 0.5 -pc_type jacobi
+
+   test:
+      suffix: monitor_true_residual
+      args: -ksp_type gmres -pc_type jacobi -m 5 -n 5 -p 2 -ksp_monitor_true_residual -ksp_converged_reason
+
+   test:
+      suffix: skip
+      args: -ksp_type cg -pc_type jacobi -ksp_convergence_test skip -ksp_max_it 5 -ksp_converged_reason
+
+TEST*/
@@ -0,0 +1,104 @@
+static char help[] = "Solves a sequence of slowly changing convection-diffusion problems with the same KSP.\n\n\
+  -m <m>, -n <n>  : the number of mesh points in each direction\n\
+  -nsolves <s>    : the number of systems in the sequence\n\
+  -convection <c> : the strength of the convection, which makes the operator nonsymmetric\n\
+  -shift <s>      : the diagonal is increased by s before each new system\n\n";
+
+/*
+   KSPGCRODR keeps a recycled subspace from one KSPSolve() to the next, the iteration counts of the later
+   solves show whether it is reused.
+*/
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  KSP            ksp;
+  Mat            A;
+  Vec            x,b,r;
+  PetscInt       m = 30,n = 30,nsolves = 4,Istart,Iend,Ii,i,j,s,its;
+  PetscReal      convection = 0.3,shift = 0.01,bnorm,rnorm,tol = 1.e-6;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsolves",&nsolves,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-convection",&convection,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-shift",&shift,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*n,m*n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,5,NULL);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    i = Ii/n; j = Ii - i*n;
+    if (i>0)   {ierr = MatSetValue(A,Ii,Ii-n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {ierr = MatSetValue(A,Ii,Ii+n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {ierr = MatSetValue(A,Ii,Ii-1,-1.0-convection,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {ierr = MatSetValue(A,Ii,Ii+1,-1.0+convection,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,Ii,Ii,4.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+
+  for (s=0; s<nsolves; s++) {
+    if (s && shift != 0.0) {
+      ierr = MatShift(A,shift);CHKERRQ(ierr);
+      ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+    }
+    /* right-hand sides independent of the number of processes */
+    for (Ii=Istart; Ii<Iend; Ii++) {
+      ierr = VecSetValue(b,Ii,PetscSinReal((PetscReal)(Ii+1)*(1.0+0.1*s)),INSERT_VALUES);CHKERRQ(ierr);
+    }
+    ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D: %D iterations\n",s,its);CHKERRQ(ierr);
+
+    ierr = MatMult(A,x,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+    ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+    if (rnorm > tol*bnorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Relative residual of system %D is %g\n",s,(double)(rnorm/bnorm));CHKERRQ(ierr);}
+  }
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: gmres
+      args: -ksp_type gmres -ksp_gmres_restart 30 -pc_type jacobi -nsolves 6
+
+   test:
+      suffix: gcrodr
+      nsize: {{1 2}}
+      output_file: output/ex65_gcrodr.out
+      args: -ksp_type gcrodr -ksp_gcrodr_restart 30 -ksp_gcrodr_recycle 10 -pc_type jacobi -nsolves 6
+
+   test:
+      suffix: gcrodr_right
+      args: -ksp_type gcrodr -ksp_gcrodr_restart 20 -ksp_gcrodr_recycle 6 -pc_type jacobi -ksp_pc_side right
+
+   test:
+      suffix: gcrodr_same
+      args: -ksp_type gcrodr -ksp_gcrodr_restart 20 -ksp_gcrodr_recycle 6 -pc_type jacobi -shift 0 -nsolves 2 -ksp_view
+
+TEST*/
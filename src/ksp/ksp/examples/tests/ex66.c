@@ -0,0 +1,149 @@
+static char help[] = "Solves a 2D diffusion problem with highly varying coefficients with deflated CG.\n\n\
+  -m <m>, -n <n>  : the number of mesh points in each direction\n\
+  -contrast <c>   : the coefficient in the inclusions, it is 1 elsewhere\n\
+  -nsolves <s>    : the number of systems solved with the same KSP\n\
+  -user_space     : deflate the indicator functions of the inclusions with KSPDCGSetDeflationSpace()\n\n";
+
+/*
+   The square inclusions of large coefficient are disjoint, each of them gives a small eigenvalue of the preconditioned
+   operator that slows down KSPCG, and that KSPDCG removes when the deflation space contains its indicator function.
+*/
+#include <petscksp.h>
+
+/* index of the inclusion that contains the point (i,j), or -1 */
+static PetscInt Inclusion(PetscInt i,PetscInt j,PetscInt nj)
+{
+  if (i%8 < 2 || i%8 >= 6 || j%8 < 2 || j%8 >= 6) return -1;
+  return (i/8)*nj + j/8;
+}
+
+int main(int argc,char **args)
+{
+  KSP            ksp;
+  Mat            A,W;
+  Vec            x,b,r;
+  PetscInt       m = 48,n = 48,nsolves = 1,ni,nj,Istart,Iend,Ii,i,j,s,its,inc;
+  PetscReal      contrast = 1.e4,kc,bnorm,rnorm,tol = 1.e-6;
+  PetscBool      user_space = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-contrast",&contrast,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsolves",&nsolves,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-user_space",&user_space,NULL);CHKERRQ(ierr);
+  if (m < 8 || n < 8) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"The mesh must have at least 8 points in each direction");
+  ni = (m+5)/8;
+  nj = (n+5)/8;
+
+  /* the coefficient of an edge is the harmonic mean of those of its end points, the boundary conditions are Dirichlet */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*n,m*n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,5,NULL);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    PetscReal   k[4],kij,diag = 0.0;
+    PetscInt    ni4[4],nj4[4],l;
+
+    i = Ii/n; j = Ii - i*n;
+    kij = Inclusion(i,j,nj) >= 0 ? contrast : 1.0;
+    ni4[0] = i-1; nj4[0] = j; ni4[1] = i+1; nj4[1] = j; ni4[2] = i; nj4[2] = j-1; ni4[3] = i; nj4[3] = j+1;
+    for (l=0; l<4; l++) {
+      if (ni4[l] < 0 || ni4[l] >= m || nj4[l] < 0 || nj4[l] >= n) k[l] = kij;
+      else {
+        kc   = Inclusion(ni4[l],nj4[l],nj) >= 0 ? contrast : 1.0;
+        k[l] = 2.0*kij*kc/(kij+kc);
+        ierr = MatSetValue(A,Ii,ni4[l]*n+nj4[l],-k[l],INSERT_VALUES);CHKERRQ(ierr);
+      }
+      diag += k[l];
+    }
+    ierr = MatSetValue(A,Ii,Ii,diag,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  if (user_space) {
+    ierr = MatCreateAIJ(PETSC_COMM_WORLD,Iend-Istart,PETSC_DECIDE,m*n,ni*nj,1,NULL,1,NULL,&W);CHKERRQ(ierr);
+    for (Ii=Istart; Ii<Iend; Ii++) {
+      i = Ii/n; j = Ii - i*n;
+      inc = Inclusion(i,j,nj);
+      if (inc >= 0) {ierr = MatSetValue(W,Ii,inc,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+    ierr = MatAssemblyBegin(W,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(W,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = KSPDCGSetDeflationSpace(ksp,W);CHKERRQ(ierr);
+    ierr = MatDestroy(&W);CHKERRQ(ierr);
+  }
+
+  for (s=0; s<nsolves; s++) {
+    /* right-hand sides independent of the number of processes */
+    for (Ii=Istart; Ii<Iend; Ii++) {
+      ierr = VecSetValue(b,Ii,PetscSinReal((PetscReal)(Ii+1)*(1.0+0.1*s)),INSERT_VALUES);CHKERRQ(ierr);
+    }
+    ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D: %D iterations\n",s,its);CHKERRQ(ierr);
+
+    ierr = MatMult(A,x,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+    ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+    if (rnorm > tol*bnorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Relative residual of system %D is %g\n",s,(double)(rnorm/bnorm));CHKERRQ(ierr);}
+  }
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: cg
+      args: -ksp_type cg -pc_type jacobi
+
+   test:
+      suffix: user
+      nsize: {{1 2}}
+      output_file: output/ex66_user.out
+      args: -ksp_type dcg -pc_type jacobi -user_space
+
+   test:
+      suffix: user_view
+      args: -ksp_type dcg -pc_type jacobi -user_space -m 16 -n 16 -ksp_view
+
+   test:
+      suffix: subdomain
+      nsize: 2
+      args: -ksp_type dcg -pc_type bjacobi -pc_bjacobi_local_blocks 4 -sub_pc_type icc -ksp_dcg_space_type subdomain
+
+   test:
+      suffix: mg
+      args: -ksp_type dcg -pc_type gamg -ksp_dcg_space_type mg -nsolves 2
+
+   test:
+      suffix: ritz
+      args: -ksp_type dcg -pc_type jacobi -ksp_dcg_space_type ritz -ksp_dcg_ritz_size 12 -ksp_dcg_ritz_steps 100 -m 24 -n 24 -nsolves 2
+
+   test:
+      suffix: ritz_default
+      nsize: {{1 2}}
+      output_file: output/ex66_ritz_default.out
+      args: -ksp_type dcg -pc_type jacobi -ksp_dcg_space_type ritz -ksp_dcg_ritz_size 36 -ksp_dcg_ritz_steps 200 -nsolves 3
+
+TEST*/
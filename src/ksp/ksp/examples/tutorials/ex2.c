@@ -276,6 +276,17 @@ int main(int argc,char **args)
       requires: mkl_pardiso
       args: -ksp_type preonly -pc_type lu -pc_factor_mat_solver_type mkl_pardiso
 
+   test:
+      requires: double !complex
+      suffix: mpir
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type mpir -m 20 -n 20 -ksp_rtol 1.e-10 -ksp_view
+
+   test:
+      requires: double !complex
+      suffix: mpir_sor
+      args: -ksp_monitor_short -ksp_type mpir -m 20 -n 20 -ksp_rtol 1.e-10 -ksp_mpir_pc_type sor -ksp_mpir_sor_omega 1.5 -ksp_mpir_max_it 20
+
    test:
       suffix: pipebcgs
       args: -ksp_monitor_short -ksp_type pipebcgs -m 9 -n 9
@@ -297,6 +308,15 @@ int main(int argc,char **args)
       args: -ksp_monitor_short -ksp_type pipelcg -m 9 -n 9 -pc_type none -ksp_pipelcg_pipel 2 -ksp_pipelcg_lmax 2
       filter: grep -v "sqrt breakdown in iteration"
 
+   test:
+      suffix: scg
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type scg -m 9 -n 9
+
+   test:
+      suffix: scg_chebyshev
+      args: -ksp_monitor_short -ksp_type scg -m 9 -n 9 -pc_type none -ksp_scg_steps 3 -ksp_scg_basis chebyshev
+
    test:
       suffix: sell
       args: -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always -m 9 -n 9 -mat_type sell
@@ -306,6 +326,20 @@ int main(int argc,char **args)
       suffix: sell_mumps
       args: -ksp_type preonly -m 9 -n 12 -mat_type sell -pc_type lu -pc_factor_mat_solver_type mumps -pc_factor_mat_ordering_type natural
 
+   test:
+      suffix: sgmres
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sgmres -m 9 -n 9 -ksp_gmres_restart 10 -ksp_sgmres_steps 3
+
+   test:
+      suffix: sgmres_monomial
+      args: -ksp_monitor_short -ksp_type sgmres -m 9 -n 9 -pc_type none -ksp_sgmres_basis monomial -ksp_gmres_cgs_refinement_type refine_always
+
+   test:
+      suffix: sgmres_breakdown
+      nsize: 3
+      args: -ksp_converged_reason -ksp_type sgmres -m 60 -n 60 -pc_type jacobi -ksp_rtol 1e-8 -ksp_sgmres_basis monomial -ksp_sgmres_steps 15
+
    test:
       suffix: telescope
       nsize: 4
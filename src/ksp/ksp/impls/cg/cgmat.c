@@ -0,0 +1,205 @@
+
+/*
+    Block conjugate gradient for several right-hand sides, used by KSPMatSolve() with KSPCG
+
+    The search directions of all the right-hand sides are orthonormalized together at each iteration, and the ones
+    that become numerically dependent are dropped (the breakdown-free block CG of Ji and Li), so that the size of the
+    block decreases, instead of the method breaking down, when columns converge or the right-hand sides are close to
+    being dependent. Each iteration reads the operator once with MatMatMult(), applies the preconditioner once with
+    PCMatApply() and performs three global reductions whatever the number of right-hand sides.
+*/
+#include <../src/ksp/ksp/impls/cg/cgimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+/*
+   Creates a dense matrix of k columns using the n x k array a with leading dimension n
+*/
+static PetscErrorCode KSPCGBlockCreateMat_Private(MPI_Comm comm,PetscInt n,PetscInt N,PetscInt k,PetscScalar *a,Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreateDense(comm,n,PETSC_DECIDE,N,k,a,A);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Replaces P by an orthonormal basis of the space spanned by the p columns of W, computed with one global reduction
+   and a Cholesky factorization with pivoting of the Gram matrix, which drops the numerically dependent columns
+*/
+static PetscErrorCode KSPCGBlockOrthonormalize_Private(KSP ksp,PetscInt n,PetscInt p,PetscScalar *W,PetscScalar *P,PetscScalar *G,PetscScalar *R,PetscReal *s,PetscReal *d,PetscInt *perm,PetscInt *k)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j;
+  PetscBLASInt   bn,bp,bk;
+  PetscScalar    one = 1.0,zero = 0.0;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(p,&bp);CHKERRQ(ierr);
+  if (n) PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bp,&bp,&bn,&one,W,&bn,W,&bn,&zero,G,&bp));
+  else {ierr = PetscMemzero(G,p*p*sizeof(PetscScalar));CHKERRQ(ierr);}
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,G,p*p,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*n*p*p);CHKERRQ(ierr);
+  for (j=0; j<p; j++) s[j] = PetscRealPart(G[j+j*p]);
+  ierr = KSPBlockCholesky_Private(p,G,p,s,PetscSqrtReal(PETSC_SQRT_MACHINE_EPSILON),R,p,perm,d,k);CHKERRQ(ierr);
+  if (*k < p) {ierr = PetscInfo3(ksp,"Kept %D of the %D search directions at iteration %D\n",*k,p,ksp->its);CHKERRQ(ierr);}
+  for (i=0; i<*k; i++) {ierr = PetscMemcpy(P+i*n,W+perm[i]*n,n*sizeof(PetscScalar));CHKERRQ(ierr);}
+  ierr = PetscBLASIntCast(*k,&bk);CHKERRQ(ierr);
+  if (n && bk) PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&bn,&bk,&one,R,&bp,P,&bn));
+  ierr = PetscLogFlops(1.0*n*(*k)*(*k));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPMatSolve_CG(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode    ierr;
+  MPI_Comm          comm;
+  Mat               A,Rm,Zm,Pm = NULL,Qm = NULL,T;
+  PetscInt          n,N,p,k,kold = 0,ldb,ldx,ldq,i,j;
+  PetscScalar       *x,*r,*z,*pp,*w,*q,*t,*G,*R,*PQ,*buf,*alpha,*beta;
+  const PetscScalar *b;
+  PetscScalar       one = 1.0,mone = -1.0,zero = 0.0;
+  PetscReal         *rnorm0,*rnorm,*s,*d;
+  PetscInt          *perm;
+  PetscBLASInt      bn,bp,bk,bldx,bldq,info;
+  PetscBool         diagonalscale;
+
+  PetscFunctionBegin;
+  comm = PetscObjectComm((PetscObject)ksp);
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(comm,PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+#if defined(PETSC_USE_COMPLEX)
+  if (((KSP_CG*)ksp->data)->type != KSP_CG_HERMITIAN) SETERRQ(comm,PETSC_ERR_SUP,"Block CG is only available for Hermitian matrices");
+#endif
+  ierr = PCGetOperators(ksp->pc,&A,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&n,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,&N,&p);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(p,&bp);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldx,&bldx);CHKERRQ(ierr);
+
+  ierr = PetscMalloc4(n*p,&r,n*p,&z,n*p,&pp,n*p,&w);CHKERRQ(ierr);
+  ierr = PetscMalloc4(p*p,&G,p*p,&R,p*p,&PQ,p*p+p*p+p,&buf);CHKERRQ(ierr);
+  ierr = PetscMalloc5(p,&rnorm0,p,&rnorm,p,&s,p,&d,p,&perm);CHKERRQ(ierr);
+  ierr = KSPCGBlockCreateMat_Private(comm,n,N,p,r,&Rm);CHKERRQ(ierr);
+  ierr = KSPCGBlockCreateMat_Private(comm,n,N,p,z,&Zm);CHKERRQ(ierr);
+
+  /* R = B - A X */
+  ierr = MatDenseGetArrayRead(B,&b);CHKERRQ(ierr);
+  for (j=0; j<p; j++) {ierr = PetscMemcpy(r+j*n,b+j*ldb,n*sizeof(PetscScalar));CHKERRQ(ierr);}
+  ierr = MatDenseRestoreArrayRead(B,&b);CHKERRQ(ierr);
+  if (!ksp->guess_zero) {
+    ierr = KSPMatMatMult_Private(A,X,MAT_INITIAL_MATRIX,&T);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(T,&ldq);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(T,&t);CHKERRQ(ierr);
+    for (j=0; j<p; j++) for (i=0; i<n; i++) r[i+j*n] -= t[i+j*ldq];
+    ierr = MatDenseRestoreArray(T,&t);CHKERRQ(ierr);
+    ierr = MatDestroy(&T);CHKERRQ(ierr);
+  }
+  for (j=0; j<p; j++) {
+    for (rnorm0[j]=0.0,i=0; i<n; i++) rnorm0[j] += PetscRealPart(PetscConj(r[i+j*n])*r[i+j*n]);
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,rnorm0,p,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+  for (j=0; j<p; j++) rnorm0[j] = rnorm[j] = PetscSqrtReal(rnorm0[j]);
+  ksp->its = 0;
+  ierr = KSPBlockConverged_Private(ksp,p,rnorm0,rnorm);CHKERRQ(ierr);
+
+  if (!ksp->reason) {
+    /* P = orth(M R) */
+    ierr = PetscObjectStateIncrease((PetscObject)Rm);CHKERRQ(ierr);
+    ierr = PCMatApply(ksp->pc,Rm,Zm);CHKERRQ(ierr);
+    ierr = KSPCGBlockOrthonormalize_Private(ksp,n,p,z,pp,G,R,s,d,perm,&k);CHKERRQ(ierr);
+  }
+  while (!ksp->reason) {
+    if (!k) {ksp->reason = KSP_DIVERGED_BREAKDOWN; break;}
+    /* Q = A P */
+    if (k != kold) {
+      ierr = MatDestroy(&Pm);CHKERRQ(ierr);
+      ierr = MatDestroy(&Qm);CHKERRQ(ierr);
+      ierr = KSPCGBlockCreateMat_Private(comm,n,N,k,pp,&Pm);CHKERRQ(ierr);
+      ierr = KSPMatMatMult_Private(A,Pm,MAT_INITIAL_MATRIX,&Qm);CHKERRQ(ierr);
+      kold = k;
+    } else {
+      ierr = PetscObjectStateIncrease((PetscObject)Pm);CHKERRQ(ierr);
+      ierr = KSPMatMatMult_Private(A,Pm,MAT_REUSE_MATRIX,&Qm);CHKERRQ(ierr);
+    }
+    ierr = MatDenseGetLDA(Qm,&ldq);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(ldq,&bldq);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(k,&bk);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(Qm,&q);CHKERRQ(ierr);
+
+    /* alpha = (P'Q)^{-1} P'R, with a single reduction for P'Q and P'R */
+    alpha = buf + k*k;
+    if (n) {
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bk,&bk,&bn,&one,pp,&bn,q,&bldq,&zero,buf,&bk));
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bk,&bp,&bn,&one,pp,&bn,r,&bn,&zero,alpha,&bk));
+    } else {
+      ierr = PetscMemzero(buf,k*(k+p)*sizeof(PetscScalar));CHKERRQ(ierr);
+    }
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,buf,k*(k+p),MPIU_SCALAR,MPIU_SUM,comm);CHKERRQ(ierr);
+    ierr = PetscMemcpy(PQ,buf,k*k*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bk,PQ,&bk,&info));
+    ierr = PetscFPTrapPop();CHKERRQ(ierr);
+    if (info < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+    if (info) {
+      ierr = PetscInfo1(ksp,"The block P'AP is not positive definite at iteration %D\n",ksp->its);CHKERRQ(ierr);
+      ierr = MatDenseRestoreArray(Qm,&q);CHKERRQ(ierr);
+      ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      break;
+    }
+    PetscStackCallBLAS("LAPACKpotrs",LAPACKpotrs_("U",&bk,&bp,PQ,&bk,alpha,&bk,&info));
+    if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+
+    /* X = X + P alpha, R = R - Q alpha */
+    ierr = MatDenseGetArray(X,&x);CHKERRQ(ierr);
+    if (n) {
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bp,&bk,&one,pp,&bn,alpha,&bk,&one,x,&bldx));
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bp,&bk,&mone,q,&bldq,alpha,&bk,&one,r,&bn));
+    }
+    ierr = MatDenseRestoreArray(X,&x);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*n*k*(k+p)+4.0*n*k*p);CHKERRQ(ierr);
+    ksp->its++;
+
+    /* Z = M R, then the residual norms and Q'Z with a single reduction */
+    ierr = PetscObjectStateIncrease((PetscObject)Rm);CHKERRQ(ierr);
+    ierr = PCMatApply(ksp->pc,Rm,Zm);CHKERRQ(ierr);
+    beta = buf + p;
+    for (j=0; j<p; j++) {
+      PetscReal sum = 0.0;
+
+      for (i=0; i<n; i++) sum += PetscRealPart(PetscConj(r[i+j*n])*r[i+j*n]);
+      buf[j] = sum;
+    }
+    if (n) PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bk,&bp,&bn,&one,q,&bldq,z,&bn,&zero,beta,&bk));
+    else {ierr = PetscMemzero(beta,k*p*sizeof(PetscScalar));CHKERRQ(ierr);}
+    ierr = MatDenseRestoreArray(Qm,&q);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,buf,p+k*p,MPIU_SCALAR,MPIU_SUM,comm);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*n*p*(k+1));CHKERRQ(ierr);
+    for (j=0; j<p; j++) rnorm[j] = PetscSqrtReal(PetscRealPart(buf[j]));
+    ierr = KSPBlockConverged_Private(ksp,p,rnorm0,rnorm);CHKERRQ(ierr);
+    if (ksp->reason) break;
+
+    /* P = orth(Z - P (P'Q)^{-1} Q'Z), the new directions being A-orthogonal to the previous ones */
+    PetscStackCallBLAS("LAPACKpotrs",LAPACKpotrs_("U",&bk,&bp,PQ,&bk,beta,&bk,&info));
+    if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+    ierr = PetscMemcpy(w,z,n*p*sizeof(PetscScalar));CHKERRQ(ierr);
+    if (n) PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bp,&bk,&mone,pp,&bn,beta,&bk,&one,w,&bn));
+    ierr = PetscLogFlops(2.0*n*k*p);CHKERRQ(ierr);
+    ierr = KSPCGBlockOrthonormalize_Private(ksp,n,p,w,pp,G,R,s,d,perm,&k);CHKERRQ(ierr);
+  }
+
+  ierr = MatDestroy(&Pm);CHKERRQ(ierr);
+  ierr = MatDestroy(&Qm);CHKERRQ(ierr);
+  ierr = MatDestroy(&Rm);CHKERRQ(ierr);
+  ierr = MatDestroy(&Zm);CHKERRQ(ierr);
+  ierr = PetscFree4(r,z,pp,w);CHKERRQ(ierr);
+  ierr = PetscFree4(G,R,PQ,buf);CHKERRQ(ierr);
+  ierr = PetscFree5(rnorm0,rnorm,s,d,perm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
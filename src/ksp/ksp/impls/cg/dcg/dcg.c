@@ -0,0 +1,788 @@
+/*
+    This file implements the deflated preconditioned conjugate gradient method.
+
+    Given a deflation space W of small dimension, the iteration is restricted to the complement of W in the A-inner
+    product: the initial residual is made orthogonal to W, and each search direction is the preconditioned residual
+    minus its A-orthogonal projection onto W,
+      p <- z - W E^{-1} (AW)' z + beta p,   E = W' A W.
+    The eigenvalues of B^{-1} A that W captures no longer slow down the convergence.
+
+    E is factored once for each operator, redundantly on subcommunicators with PCREDUNDANT. The coarse correction
+    of each iteration is computed while the reduction of the inner product and of the norm is in progress.
+*/
+#include <petsc/private/kspimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+#define KSP_DCG_RITZ_TOL 0.1
+
+typedef struct {
+  KSPDCGSpaceType  type;
+  Mat              W,AW,E;                /* deflation space, A times it and the coarse operator W'AW */
+  KSP              coarse;                /* solver of the coarse problem */
+  Vec              c1,c2;                 /* coarse vectors */
+  PetscObjectId    Aid;                   /* operator used to compute AW and E */
+  PetscObjectState Astate;
+  PetscInt         nritz,nsteps;          /* number of Ritz vectors and of Lanczos steps used to compute them */
+  Vec              *L;                    /* Lanczos vectors of the first solve */
+  PetscReal        *d,*e;                 /* Lanczos matrix of the first solve, e[nl-1] couples it to the next step */
+  PetscInt         nl;                    /* number of Lanczos vectors collected */
+} KSP_DCG;
+
+static PetscErrorCode KSPSetUp_DCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetWorkVecs(ksp,5);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDCGResetLanczos_Private(KSP ksp)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (dcg->L) {ierr = VecDestroyVecs(dcg->nsteps,&dcg->L);CHKERRQ(ierr);}
+  ierr = PetscFree2(dcg->d,dcg->e);CHKERRQ(ierr);
+  dcg->nl = 0;
+  PetscFunctionReturn(0);
+}
+
+/* frees the coarse operator, and the deflation space unless the user has given it */
+static PetscErrorCode KSPDCGResetSpace_Private(KSP ksp)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (dcg->type != KSP_DCG_SPACE_USER) {ierr = MatDestroy(&dcg->W);CHKERRQ(ierr);}
+  ierr = MatDestroy(&dcg->AW);CHKERRQ(ierr);
+  ierr = MatDestroy(&dcg->E);CHKERRQ(ierr);
+  ierr = VecDestroy(&dcg->c1);CHKERRQ(ierr);
+  ierr = VecDestroy(&dcg->c2);CHKERRQ(ierr);
+  dcg->Aid    = 0;
+  dcg->Astate = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_DCG(KSP ksp)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPDCGResetSpace_Private(ksp);CHKERRQ(ierr);
+  ierr = KSPDCGResetLanczos_Private(ksp);CHKERRQ(ierr);
+  if (dcg->coarse) {ierr = KSPReset(dcg->coarse);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_DCG(KSP ksp)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_DCG(ksp);CHKERRQ(ierr);
+  ierr = MatDestroy(&dcg->W);CHKERRQ(ierr);
+  ierr = KSPDestroy(&dcg->coarse);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGSetSpaceType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGSetDeflationSpace_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGGetDeflationSpace_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGSetRitz_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGGetCoarseKSP_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   One constant vector per block of PCBJACOBI, per subdomain of PCASM, or per process for the other preconditioners
+*/
+static PetscErrorCode KSPDCGCreateSubdomainSpace_Private(KSP ksp,Mat *W)
+{
+  PetscErrorCode ierr;
+  PC             pc;
+  Mat            Amat;
+  PetscBool      isbjacobi,isasm;
+  PetscInt       nsub,rstart,rend,cstart,i,j,k,nidx;
+  const PetscInt *lens = NULL,*idx;
+  IS             *is,*is_local = NULL;
+
+  PetscFunctionBegin;
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PCGetOperators(pc,&Amat,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(Amat,&rstart,&rend);CHKERRQ(ierr);
+  nsub = rend > rstart ? 1 : 0;
+  ierr = PetscObjectTypeCompare((PetscObject)pc,PCBJACOBI,&isbjacobi);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)pc,PCASM,&isasm);CHKERRQ(ierr);
+  if (isbjacobi) {
+    ierr = PCBJacobiGetLocalBlocks(pc,&nsub,&lens);CHKERRQ(ierr);
+  } else if (isasm) {
+    ierr = PCASMGetLocalSubdomains(pc,&nsub,&is,&is_local);CHKERRQ(ierr);
+    if (!is_local) nsub = rend > rstart ? 1 : 0;
+  }
+
+  ierr = MatCreateAIJ(PetscObjectComm((PetscObject)ksp),rend-rstart,nsub,PETSC_DETERMINE,PETSC_DETERMINE,1,NULL,1,NULL,W);CHKERRQ(ierr);
+  /* the subdomains given to PCASM by the user may contain rows of the other processes */
+  ierr = MatSetOption(*W,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRangeColumn(*W,&cstart,NULL);CHKERRQ(ierr);
+  if (isbjacobi && lens) {
+    for (i=0,k=rstart; i<nsub; i++) {
+      for (j=0; j<lens[i]; j++,k++) {ierr = MatSetValue(*W,k,cstart+i,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+  } else if (isasm && is_local) {
+    for (i=0; i<nsub; i++) {
+      ierr = ISGetLocalSize(is_local[i],&nidx);CHKERRQ(ierr);
+      ierr = ISGetIndices(is_local[i],&idx);CHKERRQ(ierr);
+      for (j=0; j<nidx; j++) {ierr = MatSetValue(*W,idx[j],cstart+i,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      ierr = ISRestoreIndices(is_local[i],&idx);CHKERRQ(ierr);
+    }
+  } else {
+    for (k=rstart; k<rend; k++) {ierr = MatSetValue(*W,k,cstart,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(*W,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*W,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The interpolation from the second finest level of PCMG or PCGAMG, whose columns are the (smoothed) aggregates of PCGAMG
+*/
+static PetscErrorCode KSPDCGCreateMGSpace_Private(KSP ksp,Mat *W)
+{
+  PetscErrorCode ierr;
+  PC             pc;
+  PetscBool      ismg;
+  PetscInt       nlevels;
+
+  PetscFunctionBegin;
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)pc,&ismg,PCMG,PCGAMG,"");CHKERRQ(ierr);
+  if (!ismg) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONG,"The multigrid deflation space needs PCMG or PCGAMG, not %s",((PetscObject)pc)->type_name);
+  ierr = PCMGGetLevels(pc,&nlevels);CHKERRQ(ierr);
+  if (nlevels < 2) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONGSTATE,"The multigrid deflation space needs at least two levels");
+  ierr = PCMGGetInterpolation(pc,nlevels-1,W);CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject)*W);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The Ritz vectors of the smallest eigenvalues of the Lanczos matrix of the first solve. The Lanczos vectors lose their
+   orthogonality, and several Ritz vectors can approximate the same eigenvector, so they are orthonormalized and the
+   dependent ones are dropped, which bounds the condition number of the coarse operator by that of the operator.
+
+   The residual norm of the Ritz pair i is e[nl-1] |Z(nl-1,i)|, divided by the distance from its Ritz value to the first
+   Ritz value not wanted, it bounds the sine of the angle between the Ritz vector and the invariant subspace of the
+   smallest eigenvalues. The Ritz vectors that are still far from this subspace are dropped: they do not remove any
+   eigenvalue and only make the coarse problem larger.
+*/
+static PetscErrorCode KSPDCGCreateRitzSpace_Private(KSP ksp,Mat *W)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       n = dcg->nl,k = PetscMin(dcg->nritz,dcg->nl),nloc,nw = 0,nfar = 0,i,j,pass;
+  PetscBLASInt   bn,info;
+  PetscReal      *Z,*work,norm0,norm,enext = dcg->e[n-1],gap;
+  PetscScalar    *array,*coef;
+  Vec            t = ksp->work[4],*Y,swap;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(n*n,&Z,PetscMax(1,2*n-2),&work,n,&coef);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKsteqr",LAPACKREALsteqr_("I",&bn,dcg->d,dcg->e,Z,&bn,work,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xSTEQR %d",(int)info);
+
+  /* the eigenvalues are in ascending order */
+  ierr = VecDuplicateVecs(t,k,&Y);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    gap = (k < n ? dcg->d[k] : dcg->d[n-1]) - dcg->d[i];
+    if (enext*PetscAbsReal(Z[n-1+i*n]) > KSP_DCG_RITZ_TOL*gap) {nfar++; continue;}
+    for (j=0; j<n; j++) coef[j] = Z[j+i*n];
+    ierr = VecSet(Y[i],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(Y[i],n,coef,dcg->L);CHKERRQ(ierr);
+    ierr = VecNorm(Y[i],NORM_2,&norm0);CHKERRQ(ierr);
+    for (pass=0; pass<2; pass++) {
+      ierr = VecMDot(Y[i],nw,Y,coef);CHKERRQ(ierr);
+      for (j=0; j<nw; j++) coef[j] = -coef[j];
+      ierr = VecMAXPY(Y[i],nw,coef,Y);CHKERRQ(ierr);
+    }
+    ierr = VecNorm(Y[i],NORM_2,&norm);CHKERRQ(ierr);
+    if (norm > 1.e-8*norm0) {
+      ierr  = VecScale(Y[i],1.0/norm);CHKERRQ(ierr);
+      swap  = Y[nw];
+      Y[nw] = Y[i];
+      Y[i]  = swap;
+      nw++;
+    }
+  }
+  ierr = PetscInfo5(ksp,"%D Ritz vectors of the %D wanted are kept, %D have a large residual, Ritz values in [%g, %g]\n",nw,k,nfar,(double)dcg->d[0],(double)dcg->d[k-1]);CHKERRQ(ierr);
+
+  ierr = VecGetLocalSize(t,&nloc);CHKERRQ(ierr);
+  ierr = MatCreateDense(PetscObjectComm((PetscObject)ksp),nloc,PETSC_DECIDE,PETSC_DETERMINE,nw,NULL,W);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(*W,&array);CHKERRQ(ierr);
+  for (i=0; i<nw; i++) {
+    ierr = VecPlaceArray(t,array+i*nloc);CHKERRQ(ierr);
+    ierr = VecCopy(Y[i],t);CHKERRQ(ierr);
+    ierr = VecResetArray(t);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArray(*W,&array);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(*W,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*W,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(k,&Y);CHKERRQ(ierr);
+  ierr = PetscFree3(Z,work,coef);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDCGGetCoarseKSP_DCG(KSP ksp,KSP *coarse)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+  const char     *prefix;
+  PC             pc;
+
+  PetscFunctionBegin;
+  if (!dcg->coarse) {
+    ierr = KSPCreate(PetscObjectComm((PetscObject)ksp),&dcg->coarse);CHKERRQ(ierr);
+    ierr = KSPSetErrorIfNotConverged(dcg->coarse,ksp->errorifnotconverged);CHKERRQ(ierr);
+    ierr = PetscObjectIncrementTabLevel((PetscObject)dcg->coarse,(PetscObject)ksp,1);CHKERRQ(ierr);
+    ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)dcg->coarse);CHKERRQ(ierr);
+    ierr = KSPGetOptionsPrefix(ksp,&prefix);CHKERRQ(ierr);
+    ierr = KSPSetOptionsPrefix(dcg->coarse,prefix);CHKERRQ(ierr);
+    ierr = KSPAppendOptionsPrefix(dcg->coarse,"dcg_coarse_");CHKERRQ(ierr);
+    ierr = KSPSetType(dcg->coarse,KSPPREONLY);CHKERRQ(ierr);
+    ierr = KSPGetPC(dcg->coarse,&pc);CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCREDUNDANT);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(dcg->coarse);CHKERRQ(ierr);
+  }
+  *coarse = dcg->coarse;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the deflation space if needed, and computes and factors the coarse operator when the operator has changed
+*/
+static PetscErrorCode KSPDCGSetUpCoarse_Private(KSP ksp)
+{
+  KSP_DCG          *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode   ierr;
+  Mat              Amat;
+  PetscObjectId    Aid;
+  PetscObjectState Astate;
+  PetscBool        isdense;
+  KSP              coarse;
+  PetscInt         s;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&Amat,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Amat,&Aid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Amat,&Astate);CHKERRQ(ierr);
+  if (dcg->E && dcg->Aid == Aid && dcg->Astate == Astate) PetscFunctionReturn(0);
+
+  /* the spaces obtained from the preconditioner change with it, the Ritz vectors are kept for the new operator */
+  if (dcg->type == KSP_DCG_SPACE_SUBDOMAIN || dcg->type == KSP_DCG_SPACE_MG) {ierr = MatDestroy(&dcg->W);CHKERRQ(ierr);}
+  ierr = MatDestroy(&dcg->AW);CHKERRQ(ierr);
+  ierr = MatDestroy(&dcg->E);CHKERRQ(ierr);
+  ierr = VecDestroy(&dcg->c1);CHKERRQ(ierr);
+  ierr = VecDestroy(&dcg->c2);CHKERRQ(ierr);
+  if (!dcg->W) {
+    switch (dcg->type) {
+    case KSP_DCG_SPACE_USER:
+      SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONGSTATE,"Must call KSPDCGSetDeflationSpace() first");
+    case KSP_DCG_SPACE_SUBDOMAIN:
+      ierr = KSPDCGCreateSubdomainSpace_Private(ksp,&dcg->W);CHKERRQ(ierr);
+      break;
+    case KSP_DCG_SPACE_MG:
+      ierr = KSPDCGCreateMGSpace_Private(ksp,&dcg->W);CHKERRQ(ierr);
+      break;
+    case KSP_DCG_SPACE_RITZ:
+      /* computed at the end of the first solve */
+      PetscFunctionReturn(0);
+    }
+    ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)dcg->W);CHKERRQ(ierr);
+  }
+  ierr = MatGetSize(dcg->W,NULL,&s);CHKERRQ(ierr);
+  if (!s) PetscFunctionReturn(0);
+
+  ierr = MatMatMult(Amat,dcg->W,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&dcg->AW);CHKERRQ(ierr);
+  ierr = MatTransposeMatMult(dcg->W,dcg->AW,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&dcg->E);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)dcg->E,&isdense,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (isdense) {ierr = MatConvert(dcg->E,MATAIJ,MAT_INPLACE_MATRIX,&dcg->E);CHKERRQ(ierr);}
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)dcg->AW);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)dcg->E);CHKERRQ(ierr);
+  ierr = MatCreateVecs(dcg->E,&dcg->c2,&dcg->c1);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)dcg->c1);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)dcg->c2);CHKERRQ(ierr);
+
+  ierr = KSPDCGGetCoarseKSP_DCG(ksp,&coarse);CHKERRQ(ierr);
+  ierr = KSPSetOperators(coarse,dcg->E,dcg->E);CHKERRQ(ierr);
+  ierr = KSPSetUp(coarse);CHKERRQ(ierr);
+  ierr = PetscInfo1(ksp,"Coarse operator of dimension %D factored\n",s);CHKERRQ(ierr);
+  dcg->Aid    = Aid;
+  dcg->Astate = Astate;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_DCG(KSP ksp)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscScalar    gamma,gammaold = 1.0,delta,alpha = 1.0,alphaold,beta = 0.0;
+  PetscReal      dp = 0.0;
+  Vec            X,B,R,Z,P,Wv,T;
+  Mat            Amat;
+  PetscBool      diagonalscale,deflate,collect;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+
+  ierr = KSPDCGSetUpCoarse_Private(ksp);CHKERRQ(ierr);
+  deflate = dcg->E ? PETSC_TRUE : PETSC_FALSE;
+  collect = (PetscBool)(dcg->type == KSP_DCG_SPACE_RITZ && !dcg->W && dcg->nritz > 0 && dcg->nsteps > 0);
+  if (collect && !dcg->L) {
+    ierr = VecDuplicateVecs(ksp->work[0],dcg->nsteps,&dcg->L);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,dcg->nsteps,dcg->L);CHKERRQ(ierr);
+    ierr = PetscMalloc2(dcg->nsteps,&dcg->d,dcg->nsteps,&dcg->e);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,2*dcg->nsteps*sizeof(PetscReal));CHKERRQ(ierr);
+  }
+  dcg->nl = 0;
+
+  X  = ksp->vec_sol;
+  B  = ksp->vec_rhs;
+  R  = ksp->work[0];
+  Z  = ksp->work[1];
+  P  = ksp->work[2];
+  Wv = ksp->work[3];
+  T  = ksp->work[4];
+  ierr = PCGetOperators(ksp->pc,&Amat,NULL);CHKERRQ(ierr);
+
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,X,R);CHKERRQ(ierr);            /*     r <- b - Ax                      */
+    ierr = VecAYPX(R,-1.0,B);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(B,R);CHKERRQ(ierr);                         /*     r <- b (x is 0)                  */
+  }
+  if (deflate) {
+    ierr = MatMultTranspose(dcg->W,R,dcg->c1);CHKERRQ(ierr);   /*     x <- x + W E^{-1} W'r            */
+    ierr = KSPSolve(dcg->coarse,dcg->c1,dcg->c2);CHKERRQ(ierr);
+    ierr = MatMultAdd(dcg->W,dcg->c2,X,X);CHKERRQ(ierr);
+    ierr = MatMult(dcg->AW,dcg->c2,T);CHKERRQ(ierr);           /*     r <- r - AW E^{-1} W'r, W'r = 0  */
+    ierr = VecAXPY(R,-1.0,T);CHKERRQ(ierr);
+  }
+  ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                   /*     z <- Br                          */
+
+  i = 0;
+  while (1) {
+    /* one reduction for the inner product and the norm, the coarse correction of z is computed meanwhile */
+    ierr = VecDotBegin(R,Z,&gamma);CHKERRQ(ierr);              /*     gamma <- z'r                     */
+    if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+      ierr = VecNormBegin(Z,NORM_2,&dp);CHKERRQ(ierr);
+    } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+      ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);
+    }
+    ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R));CHKERRQ(ierr);
+    if (deflate) {
+      ierr = MatMultTranspose(dcg->AW,Z,dcg->c1);CHKERRQ(ierr);  /*   t <- W E^{-1} (AW)'z             */
+      ierr = KSPSolve(dcg->coarse,dcg->c1,dcg->c2);CHKERRQ(ierr);
+      ierr = MatMult(dcg->W,dcg->c2,T);CHKERRQ(ierr);
+    }
+    ierr = VecDotEnd(R,Z,&gamma);CHKERRQ(ierr);
+    KSPCheckDot(ksp,gamma);
+    if (collect && i && i == dcg->nl) {
+      /* subdiagonal entry of the tridiagonal matrix after the last stored Lanczos vector, for the residual bounds */
+      dcg->e[i-1] = PetscSqrtReal(PetscAbsScalar(gamma/gammaold))/PetscRealPart(alpha);
+    }
+    if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+      ierr = VecNormEnd(Z,NORM_2,&dp);CHKERRQ(ierr);
+    } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+      ierr = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);
+    } else if (ksp->normtype == KSP_NORM_NATURAL) {
+      dp = PetscSqrtReal(PetscAbsScalar(gamma));
+    } else dp = 0.0;
+    KSPCheckNorm(ksp,dp);
+
+    ksp->rnorm = dp;
+    ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,i,dp);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,i,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+    if (ksp->reason) break;
+    if (i >= ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    if (gamma == 0.0) {
+      ksp->reason = KSP_CONVERGED_ATOL;
+      ierr        = PetscInfo(ksp,"converged due to gamma = 0\n");CHKERRQ(ierr);
+      break;
+    }
+
+    if (!i) {
+      if (deflate) {
+        ierr = VecWAXPY(P,-1.0,T,Z);CHKERRQ(ierr);             /*     p <- z - t                       */
+      } else {
+        ierr = VecCopy(Z,P);CHKERRQ(ierr);
+      }
+    } else {
+      beta = gamma/gammaold;
+      if (deflate) {
+        ierr = VecAXPBYPCZ(P,1.0,-1.0,beta,Z,T);CHKERRQ(ierr); /*     p <- z - t + beta p              */
+      } else {
+        ierr = VecAYPX(P,beta,Z);CHKERRQ(ierr);
+      }
+    }
+    ierr = KSP_MatMult(ksp,Amat,P,Wv);CHKERRQ(ierr);           /*     w <- Ap                          */
+    ierr = VecDot(Wv,P,&delta);CHKERRQ(ierr);                  /*     delta <- p'w                     */
+    KSPCheckDot(ksp,delta);
+    if (PetscRealPart(delta) <= 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix");
+      ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      ierr        = PetscInfo(ksp,"diverging due to indefinite or negative definite matrix\n");CHKERRQ(ierr);
+      break;
+    }
+    alphaold = alpha;
+    alpha    = gamma/delta;
+    if (collect && i < dcg->nsteps) {
+      /* Lanczos vectors (-1)^i z/sqrt(z'r) of B^{-1}A and their tridiagonal matrix, as in cgeig.c */
+      ierr = VecCopy(Z,dcg->L[i]);CHKERRQ(ierr);
+      ierr = VecScale(dcg->L[i],(i%2 ? -1.0 : 1.0)/PetscSqrtReal(PetscAbsScalar(gamma)));CHKERRQ(ierr);
+      dcg->d[i] = PetscRealPart(1.0/alpha);
+      if (i) dcg->d[i] += PetscRealPart(beta/alphaold);
+      dcg->e[i] = 0.0;
+      dcg->nl   = i+1;
+    }
+    ierr = VecAXPY(X,alpha,P);CHKERRQ(ierr);                   /*     x <- x + alpha p                 */
+    ierr = VecAXPY(R,-alpha,Wv);CHKERRQ(ierr);                 /*     r <- r - alpha w                 */
+    ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                 /*     z <- Br                          */
+    gammaold = gamma;
+    i++;
+    ksp->its = i;
+  }
+
+  if (collect && dcg->nl) {
+    ierr = KSPDCGCreateRitzSpace_Private(ksp,&dcg->W);CHKERRQ(ierr);
+    ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)dcg->W);CHKERRQ(ierr);
+    ierr = KSPDCGResetLanczos_Private(ksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_DCG(KSP ksp,PetscViewer viewer)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+  PetscInt       s = 0;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    if (dcg->W) {ierr = MatGetSize(dcg->W,NULL,&s);CHKERRQ(ierr);}
+    ierr = PetscViewerASCIIPrintf(viewer,"  %s deflation space of dimension %D\n",KSPDCGSpaceTypes[dcg->type],s);CHKERRQ(ierr);
+    if (dcg->type == KSP_DCG_SPACE_RITZ) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  %D Ritz vectors from %D Lanczos steps\n",dcg->nritz,dcg->nsteps);CHKERRQ(ierr);
+    }
+    if (dcg->coarse && dcg->E) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  coarse problem solver\n");CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+      ierr = KSPView(dcg->coarse,viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_DCG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_DCG         *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode  ierr;
+  KSPDCGSpaceType type = dcg->type;
+  PetscInt        nritz = dcg->nritz,nsteps = dcg->nsteps;
+  PetscBool       flg,flg1,flg2;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP deflated CG options");CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-ksp_dcg_space_type","Origin of the deflation space","KSPDCGSetSpaceType",KSPDCGSpaceTypes,(PetscEnum)type,(PetscEnum*)&type,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPDCGSetSpaceType(ksp,type);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-ksp_dcg_ritz_size","Number of Ritz vectors in the deflation space","KSPDCGSetRitz",nritz,&nritz,&flg1);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_dcg_ritz_steps","Number of Lanczos steps used to compute the Ritz vectors","KSPDCGSetRitz",nsteps,&nsteps,&flg2);CHKERRQ(ierr);
+  if (flg1 || flg2) {ierr = KSPDCGSetRitz(ksp,nritz,nsteps);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDCGSetSpaceType_DCG(KSP ksp,KSPDCGSpaceType type)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (dcg->type == type) PetscFunctionReturn(0);
+  ierr = KSPDCGResetSpace_Private(ksp);CHKERRQ(ierr);
+  ierr = MatDestroy(&dcg->W);CHKERRQ(ierr);
+  ierr = KSPDCGResetLanczos_Private(ksp);CHKERRQ(ierr);
+  dcg->type = type;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDCGSetDeflationSpace_DCG(KSP ksp,Mat W)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectReference((PetscObject)W);CHKERRQ(ierr);
+  ierr = KSPDCGResetSpace_Private(ksp);CHKERRQ(ierr);
+  ierr = KSPDCGResetLanczos_Private(ksp);CHKERRQ(ierr);
+  ierr = MatDestroy(&dcg->W);CHKERRQ(ierr);
+  dcg->W    = W;
+  dcg->type = KSP_DCG_SPACE_USER;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDCGGetDeflationSpace_DCG(KSP ksp,Mat *W)
+{
+  KSP_DCG *dcg = (KSP_DCG*)ksp->data;
+
+  PetscFunctionBegin;
+  *W = dcg->W;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDCGSetRitz_DCG(KSP ksp,PetscInt nritz,PetscInt nsteps)
+{
+  KSP_DCG        *dcg = (KSP_DCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (nritz < 0) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of Ritz vectors %D cannot be negative",nritz);
+  if (nsteps < 0) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of Lanczos steps %D cannot be negative",nsteps);
+  if (nsteps != dcg->nsteps) {ierr = KSPDCGResetLanczos_Private(ksp);CHKERRQ(ierr);}
+  dcg->nritz  = nritz;
+  dcg->nsteps = nsteps;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPDCGSetSpaceType - Sets the origin of the deflation space of the deflated conjugate gradient method
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  type - KSP_DCG_SPACE_USER, KSP_DCG_SPACE_SUBDOMAIN (the default), KSP_DCG_SPACE_MG or KSP_DCG_SPACE_RITZ
+
+   Options Database:
+.  -ksp_dcg_space_type <user,subdomain,mg,ritz>
+
+   Notes:
+   The subdomain and multigrid spaces are built from the preconditioner after it is set up, and built again when the
+   operator changes. The Ritz space is computed at the end of the first solve, which is not deflated, and kept for the
+   next solves.
+
+   Level: intermediate
+
+.seealso: KSPDCG, KSPDCGSpaceType, KSPDCGSetDeflationSpace(), KSPDCGSetRitz()
+@*/
+PetscErrorCode KSPDCGSetSpaceType(KSP ksp,KSPDCGSpaceType type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,type,2);
+  ierr = PetscTryMethod(ksp,"KSPDCGSetSpaceType_C",(KSP,KSPDCGSpaceType),(ksp,type));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPDCGSetDeflationSpace - Sets the deflation space of the deflated conjugate gradient method
+
+   Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  W - the matrix whose columns span the deflation space, with the row layout of the operator
+
+   Notes:
+   The space type becomes KSP_DCG_SPACE_USER. The columns of W must be linearly independent, and W is usually sparse,
+   for instance the indicator functions of the regions of large coefficients of a diffusion problem.
+
+   Level: intermediate
+
+.seealso: KSPDCG, KSPDCGGetDeflationSpace(), KSPDCGSetSpaceType()
+@*/
+PetscErrorCode KSPDCGSetDeflationSpace(KSP ksp,Mat W)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidHeaderSpecific(W,MAT_CLASSID,2);
+  PetscCheckSameComm(ksp,1,W,2);
+  ierr = PetscTryMethod(ksp,"KSPDCGSetDeflationSpace_C",(KSP,Mat),(ksp,W));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPDCGGetDeflationSpace - Gets the deflation space of the deflated conjugate gradient method
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  W - the matrix whose columns span the deflation space, NULL if it is not built yet
+
+   Level: intermediate
+
+.seealso: KSPDCG, KSPDCGSetDeflationSpace()
+@*/
+PetscErrorCode KSPDCGGetDeflationSpace(KSP ksp,Mat *W)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidPointer(W,2);
+  ierr = PetscUseMethod(ksp,"KSPDCGGetDeflationSpace_C",(KSP,Mat*),(ksp,W));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPDCGSetRitz - Sets the number of Ritz vectors of the deflation space of type KSP_DCG_SPACE_RITZ, and the number
+   of Lanczos steps of the first solve used to compute them
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+.  nritz - the number of Ritz vectors of the smallest eigenvalues, 8 by default
+-  nsteps - the number of Lanczos steps, 40 by default
+
+   Options Database:
++  -ksp_dcg_ritz_size <nritz>
+-  -ksp_dcg_ritz_steps <nsteps>
+
+   Notes:
+   The first solve stores nsteps vectors. When the Lanczos vectors lose their orthogonality, the Ritz vectors can be
+   nearly dependent and the coarse operator ill conditioned, so nritz should remain well below nsteps. The Ritz vectors
+   whose Lanczos residual bound is large compared with the distance from their Ritz value to the first Ritz value not
+   wanted are dropped, so that the deflation space may have fewer than nritz vectors if nsteps is too small.
+
+   Level: advanced
+
+.seealso: KSPDCG, KSPDCGSetSpaceType()
+@*/
+PetscErrorCode KSPDCGSetRitz(KSP ksp,PetscInt nritz,PetscInt nsteps)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,nritz,2);
+  PetscValidLogicalCollectiveInt(ksp,nsteps,3);
+  ierr = PetscTryMethod(ksp,"KSPDCGSetRitz_C",(KSP,PetscInt,PetscInt),(ksp,nritz,nsteps));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPDCGGetCoarseKSP - Gets the solver of the coarse problem of the deflated conjugate gradient method
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  coarse - the coarse solver, KSPPREONLY with PCREDUNDANT by default
+
+   Notes:
+   Its options prefix is that of ksp followed by dcg_coarse_. The coarse operator W'AW is factored redundantly on
+   subcommunicators, whose number is set with -dcg_coarse_pc_redundant_number.
+
+   Level: advanced
+
+.seealso: KSPDCG, PCREDUNDANT
+@*/
+PetscErrorCode KSPDCGGetCoarseKSP(KSP ksp,KSP *coarse)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidPointer(coarse,2);
+  ierr = PetscUseMethod(ksp,"KSPDCGGetCoarseKSP_C",(KSP,KSP*),(ksp,coarse));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPDCG - The deflated preconditioned conjugate gradient method, for symmetric positive definite problems whose
+   convergence is slowed down by a few small eigenvalues, such as diffusion problems with highly varying coefficients.
+
+   Options Database Keys:
++   -ksp_dcg_space_type <user,subdomain,mg,ritz> - the origin of the deflation space (default subdomain)
+.   -ksp_dcg_ritz_size <nritz> - the number of Ritz vectors of the Ritz space (default 8)
+-   -ksp_dcg_ritz_steps <nsteps> - the number of Lanczos steps used to compute them (default 40)
+
+   Level: intermediate
+
+   Notes:
+   The deflation space W is given with KSPDCGSetDeflationSpace(), or built from the constant vectors of the blocks of
+   PCBJACOBI or the subdomains of PCASM (of the processes for the other preconditioners), from the finest interpolation
+   of PCMG or PCGAMG, which holds the aggregates of PCGAMG and the interpolation of the coarse grid of a DM, or from the
+   Ritz vectors of the smallest eigenvalues of the first solve.
+
+   The coarse operator W'AW is computed and factored only when the operator changes, by the coarse solver obtained with
+   KSPDCGGetCoarseKSP(). The coarse correction of each iteration is computed while the reduction of the inner product
+   and of the norm of the residual is in progress.
+
+   The initial guess is first corrected so that the residual is orthogonal to W. The norms shown are those of the
+   deflated residuals.
+
+   References:
++   1. - Y. Saad, M. Yeung, J. Erhel and F. Guyomarc'h, A deflated version of the conjugate gradient algorithm,
+         SIAM J. Sci. Comput., 2000.
+-   2. - J. M. Tang, R. Nabben, C. Vuik and Y. A. Erlangga, Comparison of two-level preconditioners derived from
+         deflation, domain decomposition and multigrid methods, J. Sci. Comput., 2009.
+
+.seealso: KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPCG, KSPPIPECG,
+          KSPDCGSetSpaceType(), KSPDCGSetDeflationSpace(), KSPDCGSetRitz(), KSPDCGGetCoarseKSP()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_DCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+  KSP_DCG        *dcg;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&dcg);CHKERRQ(ierr);
+  dcg->type   = KSP_DCG_SPACE_SUBDOMAIN;
+  dcg->nritz  = 8;
+  dcg->nsteps = 40;
+  ksp->data   = (void*)dcg;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_DCG;
+  ksp->ops->solve          = KSPSolve_DCG;
+  ksp->ops->reset          = KSPReset_DCG;
+  ksp->ops->destroy        = KSPDestroy_DCG;
+  ksp->ops->view           = KSPView_DCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_DCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGSetSpaceType_C",KSPDCGSetSpaceType_DCG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGSetDeflationSpace_C",KSPDCGSetDeflationSpace_DCG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGGetDeflationSpace_C",KSPDCGGetDeflationSpace_DCG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGSetRitz_C",KSPDCGSetRitz_DCG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDCGGetCoarseKSP_C",KSPDCGGetCoarseKSP_DCG);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
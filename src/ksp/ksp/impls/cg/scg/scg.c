@@ -0,0 +1,590 @@
+
+/*
+    This file implements the s-step (communication-avoiding) conjugate gradient method.
+
+    Each block of s iterations builds the bases of the Krylov spaces of z and p of dimension s,
+      Y = [z, T z, ..., T^{s-1} z, p, T p, ..., T^{s-1} p],   T = B^{-1} A,
+    and W = A Y, computes all the inner products Y'W and Y'r in a single global reduction, and then runs s
+    iterations of CG on the coordinates of the vectors in Y. The vectors are only updated at the end of the block.
+
+    The basis can be the monomial basis, above, or a Newton or Chebyshev polynomial basis, which is much better
+    conditioned. Their shifts come from the extreme eigenvalues of the Lanczos matrix of the first block, see
+    cgeig.c, unless they are provided with KSPSCGSetEigenvalueEstimates().
+*/
+#include <petsc/private/kspimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+extern PetscErrorCode KSPComputeExtremeSingularValues_CG(KSP,PetscReal*,PetscReal*);
+extern PetscErrorCode KSPComputeEigenvalues_CG(KSP,PetscInt,PetscReal*,PetscReal*,PetscInt*);
+
+/*
+    The first fields must be the same as those of KSP_CG, they are used by cgeig.c
+*/
+typedef struct {
+  KSPCGType         type;
+  PetscScalar       emin,emax;
+  PetscInt          ned;
+  PetscScalar       *e,*d;
+  PetscReal         *ee,*dd;              /* work space for Lanczos algorithm */
+
+  PetscInt          s;                    /* number of iterations per block */
+  KSPSStepBasisType basis;
+  PetscReal         lmin,lmax;            /* estimates of the extreme eigenvalues of B^{-1} A */
+  PetscBool         eigset;               /* lmin and lmax were given by the user */
+  PetscReal         *theta;               /* shifts of the Newton basis */
+  PetscReal         *ld,*le;              /* Lanczos matrix of the first block */
+  Vec               *Y,*W;                /* bases of the Krylov spaces and A times them */
+  PetscScalar       *G,*B;                /* G(a,b) = W_a'Y_b, T Y = Y B */
+  PetscScalar       *g,*xc,*zc,*pc,*pp;   /* g(a) = Y_a'r, coordinates of x-x_0, z, p and the previous p */
+  PetscInt          nreductions;          /* number of global reductions in the last solve */
+} KSP_SCG;
+
+static PetscErrorCode KSPSetUp_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       s = scg->s,maxit = ksp->max_it;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps per block %D must be positive",s);
+  ierr = KSPSetWorkVecs(ksp,3);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(ksp->work[0],2*s,&scg->Y);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(ksp->work[0],2*s,&scg->W);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,2*s,scg->Y);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,2*s,scg->W);CHKERRQ(ierr);
+  ierr = PetscMalloc7(4*s*s,&scg->G,4*s*s,&scg->B,2*s,&scg->g,2*s,&scg->xc,2*s,&scg->zc,2*s,&scg->pc,2*s,&scg->pp);CHKERRQ(ierr);
+  ierr = PetscMalloc3(s,&scg->theta,s,&scg->ld,s,&scg->le);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(8*s*s+10*s)*sizeof(PetscScalar)+3*s*sizeof(PetscReal));CHKERRQ(ierr);
+
+  if (ksp->calc_sings) {
+    /* get space to store tridiagonal matrix for Lanczos */
+    ierr = PetscMalloc4(maxit+1,&scg->e,maxit+1,&scg->d,maxit+1,&scg->ee,maxit+1,&scg->dd);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,2*(maxit+1)*(sizeof(PetscScalar)+sizeof(PetscReal)));CHKERRQ(ierr);
+
+    ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_CG;
+    ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_CG;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (scg->Y) {ierr = VecDestroyVecs(2*scg->s,&scg->Y);CHKERRQ(ierr);}
+  if (scg->W) {ierr = VecDestroyVecs(2*scg->s,&scg->W);CHKERRQ(ierr);}
+  ierr = PetscFree7(scg->G,scg->B,scg->g,scg->xc,scg->zc,scg->pc,scg->pp);CHKERRQ(ierr);
+  ierr = PetscFree3(scg->theta,scg->ld,scg->le);CHKERRQ(ierr);
+  ierr = PetscFree4(scg->e,scg->d,scg->ee,scg->dd);CHKERRQ(ierr);
+  scg->ned = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_SCG(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSCGSetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSCGSetBasisType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSCGSetEigenvalueEstimates_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orders the Chebyshev points of [lmin,lmax] with the Leja ordering, which keeps the Newton basis well conditioned
+*/
+static PetscErrorCode KSPSCGComputeShifts_Private(KSP ksp,PetscInt s)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       n = s-1,i,j,k,best;
+  PetscReal      *pts,c = 0.5*(scg->lmax+scg->lmin),h = 0.5*(scg->lmax-scg->lmin),prod,bestprod;
+  PetscBool      *used;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc2(n,&pts,n,&used);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    pts[i]  = c + h*PetscCosReal(PETSC_PI*(2.0*i+1.0)/(2.0*n));
+    used[i] = PETSC_FALSE;
+  }
+  for (k=0; k<n; k++) {
+    best = -1; bestprod = -1.0;
+    for (i=0; i<n; i++) {
+      if (used[i]) continue;
+      if (!k) prod = PetscAbsReal(pts[i]);
+      else for (prod=1.0,j=0; j<k; j++) prod *= PetscAbsReal(pts[i]-scg->theta[j]);
+      if (prod > bestprod) {bestprod = prod; best = i;}
+    }
+    scg->theta[k] = pts[best];
+    used[best]    = PETSC_TRUE;
+  }
+  ierr = PetscFree2(pts,used);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the chain Y[o],...,Y[o+s-1] starting at Y[o], the products W[o+i] = A Y[o+i] and the columns of B with the
+   coordinates of T Y[o+i] in the chain, except the last one
+*/
+static PetscErrorCode KSPSCGBuildChain_Private(KSP ksp,Mat Amat,PetscInt o,PetscInt s,KSPSStepBasisType basis)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       ld = 2*scg->s,i;
+  Vec            *Y = scg->Y,*W = scg->W;
+  PetscReal      c = 0.5*(scg->lmax+scg->lmin),h = 0.5*(scg->lmax-scg->lmin);
+  PetscScalar    *B = scg->B;
+
+  PetscFunctionBegin;
+  for (i=0; i<s; i++) {
+    ierr = KSP_MatMult(ksp,Amat,Y[o+i],W[o+i]);CHKERRQ(ierr);
+    if (i == s-1) break;
+    ierr = KSP_PCApply(ksp,W[o+i],Y[o+i+1]);CHKERRQ(ierr);
+    switch (basis) {
+    case KSP_SSTEP_BASIS_MONOMIAL:
+      B[o+i+1+(o+i)*ld] = 1.0;
+      break;
+    case KSP_SSTEP_BASIS_NEWTON:
+      ierr = VecAXPY(Y[o+i+1],-scg->theta[i],Y[o+i]);CHKERRQ(ierr);
+      B[o+i+1+(o+i)*ld] = 1.0;
+      B[o+i+(o+i)*ld]   = scg->theta[i];
+      break;
+    case KSP_SSTEP_BASIS_CHEBYSHEV:
+      if (!i) {
+        ierr = VecAXPBY(Y[o+1],-c/h,1.0/h,Y[o]);CHKERRQ(ierr);
+        B[o+1+o*ld] = h;
+      } else {
+        ierr = VecAXPBYPCZ(Y[o+i+1],-2.0*c/h,-1.0,2.0/h,Y[o+i],Y[o+i-1]);CHKERRQ(ierr);
+        B[o+i+1+(o+i)*ld] = 0.5*h;
+        B[o+i-1+(o+i)*ld] = 0.5*h;
+      }
+      B[o+i+(o+i)*ld] = c;
+      break;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_SCG(KSP ksp)
+{
+  KSP_SCG           *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode    ierr;
+  PetscInt          s = scg->s,ld = 2*scg->s,n,j,a,b,eigs = ksp->calc_sings,nest = 0;
+  PetscScalar       dp = 0.0,dpold = 1.0,pAp,alpha = 1.0,alphaold = 1.0,beta = 0.0,t;
+  PetscScalar       *G,*B,*g,*xc,*zc,*pc,*pp;
+  PetscReal         dnorm;
+  Vec               X,Bv,R,Z,P,*Y,*W;
+  Mat               Amat,Pmat;
+  PetscBool         diagonalscale,first = PETSC_TRUE,restart,haveeig = scg->eigset;
+  KSPSStepBasisType basis;
+  MPI_Comm          comm;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+  ierr = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+
+  X  = ksp->vec_sol;
+  Bv = ksp->vec_rhs;
+  R  = ksp->work[0];
+  Z  = ksp->work[1];
+  P  = ksp->work[2];
+  Y  = scg->Y; W = scg->W;
+  G  = scg->G; B = scg->B; g = scg->g;
+  xc = scg->xc; zc = scg->zc; pc = scg->pc; pp = scg->pp;
+  if (haveeig && scg->basis == KSP_SSTEP_BASIS_NEWTON) {ierr = KSPSCGComputeShifts_Private(ksp,s);CHKERRQ(ierr);}
+
+  ksp->its         = 0;
+  scg->nreductions = 0;
+  if (eigs) {scg->e[0] = 0.0; scg->ned = 0;}
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,X,R);CHKERRQ(ierr);            /*    r <- b - Ax                       */
+    ierr = VecAYPX(R,-1.0,Bv);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(Bv,R);CHKERRQ(ierr);                        /*    r <- b (x is 0)                   */
+  }
+  ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                   /*    z <- Br                           */
+
+  while (!ksp->reason) {
+    /* the bases of the block, z first then the previous p */
+    basis = haveeig && scg->lmax > scg->lmin ? scg->basis : KSP_SSTEP_BASIS_MONOMIAL;
+    n     = first ? s : 2*s;
+    ierr  = PetscMemzero(B,ld*ld*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr  = VecCopy(Z,Y[0]);CHKERRQ(ierr);
+    ierr  = KSPSCGBuildChain_Private(ksp,Amat,0,s,basis);CHKERRQ(ierr);
+    if (!first) {
+      ierr = VecCopy(P,Y[s]);CHKERRQ(ierr);
+      ierr = KSPSCGBuildChain_Private(ksp,Amat,s,s,basis);CHKERRQ(ierr);
+    }
+
+    /* all the inner products of the block in a single reduction */
+    for (b=0; b<n; b++) {ierr = VecMDotBegin(Y[b],n,W,G+b*ld);CHKERRQ(ierr);}
+    ierr = VecMDotBegin(R,n,Y,g);CHKERRQ(ierr);
+    ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+    for (b=0; b<n; b++) {ierr = VecMDotEnd(Y[b],n,W,G+b*ld);CHKERRQ(ierr);}
+    ierr = VecMDotEnd(R,n,Y,g);CHKERRQ(ierr);
+    scg->nreductions++;
+
+    /* s iterations of CG on the coordinates in Y */
+    restart = PETSC_FALSE;
+    for (a=0; a<n; a++) xc[a] = pp[a] = 0.0;
+    if (!first) pp[s] = 1.0;
+    for (j=0; j<s; j++) {
+      for (a=0; a<n; a++) {                                    /*    z <- z_0 - T (x - x_0)            */
+        for (t=(a ? 0.0 : 1.0),b=0; b<n; b++) t -= B[a+b*ld]*xc[b];
+        zc[a] = t;
+      }
+      for (dp=0.0,b=0; b<n; b++) {                             /*    dp <- r'z                         */
+        for (t=PetscConj(g[b]),a=0; a<n; a++) t -= PetscConj(xc[a])*G[a+b*ld];
+        dp += t*zc[b];
+      }
+      KSPCheckDot(ksp,dp);
+      if (PetscRealPart(dp) < 0.0) {
+        restart = PETSC_TRUE;
+        break;
+      }
+      dnorm      = PetscSqrtReal(PetscAbsScalar(dp));
+      ksp->rnorm = ksp->normtype == KSP_NORM_NONE ? 0.0 : dnorm;
+      ierr       = KSPLogResidualHistory(ksp,ksp->rnorm);CHKERRQ(ierr);
+      ierr       = KSPMonitor(ksp,ksp->its,ksp->rnorm);CHKERRQ(ierr);
+      ierr       = (*ksp->converged)(ksp,ksp->its,ksp->rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+      if (ksp->its >= ksp->max_it) {ksp->reason = KSP_DIVERGED_ITS; break;}
+      if (dp == 0.0) {
+        ksp->reason = KSP_CONVERGED_ATOL;
+        ierr        = PetscInfo(ksp,"converged due to r'z = 0\n");CHKERRQ(ierr);
+        break;
+      }
+      beta = (first && !j) ? 0.0 : dp/dpold;
+      for (a=0; a<n; a++) pc[a] = zc[a] + beta*pp[a];          /*    p <- z + beta p                   */
+      for (pAp=0.0,b=0; b<n; b++) {                            /*    pAp <- p'Ap                       */
+        for (t=0.0,a=0; a<n; a++) t += PetscConj(pc[a])*G[a+b*ld];
+        pAp += t*pc[b];
+      }
+      KSPCheckDot(ksp,pAp);
+      if (PetscRealPart(pAp) <= 0.0) {
+        restart = PETSC_TRUE;
+        break;
+      }
+      alphaold = alpha;
+      alpha    = dp/pAp;
+      for (a=0; a<n; a++) {
+        xc[a] += alpha*pc[a];                                  /*    x <- x + alpha p                  */
+        pp[a]  = pc[a];
+      }
+      dpold = dp;
+      /* the Lanczos matrix, as in KSPSolve_CG() */
+      if (eigs || (!haveeig && nest < s)) {
+        PetscReal e = (first && !j) ? 0.0 : PetscSqrtReal(PetscAbsScalar(beta))/PetscRealPart(alphaold);
+        PetscReal d = PetscSqrtReal(PetscAbsScalar(beta))*e + 1.0/PetscRealPart(alpha);
+
+        if (eigs) {
+          if (ksp->its > ksp->max_it) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Can not change maxit AND calculate eigenvalues");
+          scg->e[ksp->its] = e;
+          scg->d[ksp->its] = d;
+          scg->ned         = ksp->its+1;
+        }
+        if (!haveeig && nest < s) {scg->le[nest] = e; scg->ld[nest] = d; nest++;}
+      }
+      ksp->its++;
+    }
+
+    /* the vectors at the end of the block */
+    for (a=0; a<n; a++) pc[a] = -xc[a];
+    ierr = VecMAXPY(X,n,xc,Y);CHKERRQ(ierr);                   /*    x <- x + Y xc                     */
+    if (ksp->reason) break;
+    if (restart) {
+      /* the scalars of the block lost their accuracy or the operator is indefinite */
+      if (s == 1) {
+        if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix or preconditioner");
+        ksp->reason = PetscRealPart(dp) < 0.0 ? KSP_DIVERGED_INDEFINITE_PC : KSP_DIVERGED_INDEFINITE_MAT;
+        ierr        = PetscInfo(ksp,"diverging due to indefinite matrix or preconditioner\n");CHKERRQ(ierr);
+        break;
+      }
+      s    = s/2;
+      ierr = PetscInfo1(ksp,"Breakdown in the s-step recurrences, restarting with %D steps per block\n",s);CHKERRQ(ierr);
+      if (haveeig && scg->basis == KSP_SSTEP_BASIS_NEWTON) {ierr = KSPSCGComputeShifts_Private(ksp,s);CHKERRQ(ierr);}
+      ierr = KSP_MatMult(ksp,Amat,X,R);CHKERRQ(ierr);          /*    r <- b - Ax                       */
+      ierr = VecAYPX(R,-1.0,Bv);CHKERRQ(ierr);
+      first = PETSC_TRUE;
+    } else {
+      ierr  = VecMAXPY(R,n,pc,W);CHKERRQ(ierr);                /*    r <- r - W xc                     */
+      ierr  = VecSet(P,0.0);CHKERRQ(ierr);
+      ierr  = VecMAXPY(P,n,pp,Y);CHKERRQ(ierr);                /*    p <- Y pc                         */
+      first = PETSC_FALSE;
+    }
+    ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                 /*    z <- Br                           */
+
+    if (!haveeig && scg->basis != KSP_SSTEP_BASIS_MONOMIAL && nest) {
+      /* extreme eigenvalues of the Lanczos matrix of the first block */
+      PetscBLASInt bn,lierr;
+      PetscInt     k;
+
+      ierr = PetscBLASIntCast(nest,&bn);CHKERRQ(ierr);
+      for (k=0; k<nest-1; k++) scg->le[k] = scg->le[k+1];
+      ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+      PetscStackCallBLAS("LAPACKsteqr",LAPACKsteqr_("N",&bn,scg->ld,scg->le,NULL,&bn,NULL,&lierr));
+      ierr = PetscFPTrapPop();CHKERRQ(ierr);
+      if (lierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)lierr);
+      scg->lmin = scg->ld[0];
+      scg->lmax = 1.1*scg->ld[nest-1];
+      haveeig   = PETSC_TRUE;
+      ierr      = PetscInfo2(ksp,"Eigenvalue estimates for the s-step basis %g %g\n",(double)scg->lmin,(double)scg->lmax);CHKERRQ(ierr);
+      if (scg->basis == KSP_SSTEP_BASIS_NEWTON) {ierr = KSPSCGComputeShifts_Private(ksp,s);CHKERRQ(ierr);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_SCG(KSP ksp,PetscViewer viewer)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  %D steps per block, %s basis\n",scg->s,KSPSStepBasisTypes[scg->basis]);CHKERRQ(ierr);
+    if (scg->basis != KSP_SSTEP_BASIS_MONOMIAL && scg->lmax > scg->lmin) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalue estimates %g %g\n",(double)scg->lmin,(double)scg->lmax);CHKERRQ(ierr);
+    }
+    ierr = PetscViewerASCIIPrintf(viewer,"  global reductions in the last solve %D\n",scg->nreductions);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"s %D basis %s",scg->s,KSPSStepBasisTypes[scg->basis]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SCG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       s = scg->s;
+  PetscReal      eig[2] = {scg->lmin,scg->lmax};
+  PetscInt       neig = 2;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP s-step CG options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_scg_steps","Number of iterations per block","KSPSCGSetSteps",s,&s,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSCGSetSteps(ksp,s);CHKERRQ(ierr);}
+  ierr = PetscOptionsEnum("-ksp_scg_basis","Polynomial basis of the Krylov spaces","KSPSCGSetBasisType",KSPSStepBasisTypes,(PetscEnum)scg->basis,(PetscEnum*)&scg->basis,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsRealArray("-ksp_scg_eigenvalues","Estimates of the extreme eigenvalues of the preconditioned operator","KSPSCGSetEigenvalueEstimates",eig,&neig,&flg);CHKERRQ(ierr);
+  if (flg) {
+    if (neig != 2) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_INCOMP,"-ksp_scg_eigenvalues: must specify both the smallest and the largest eigenvalue estimates");
+    ierr = KSPSCGSetEigenvalueEstimates(ksp,eig[0],eig[1]);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSCGSetSteps_SCG(KSP ksp,PetscInt s)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps per block %D must be positive",s);
+  if (!ksp->setupstage) {
+    scg->s = s;
+  } else if (scg->s != s) {
+    /* free the data structures, then create them again */
+    ierr = KSPReset_SCG(ksp);CHKERRQ(ierr);
+    scg->s          = s;
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSCGSetBasisType_SCG(KSP ksp,KSPSStepBasisType basis)
+{
+  KSP_SCG *scg = (KSP_SCG*)ksp->data;
+
+  PetscFunctionBegin;
+  scg->basis = basis;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSCGSetEigenvalueEstimates_SCG(KSP ksp,PetscReal lmin,PetscReal lmax)
+{
+  KSP_SCG *scg = (KSP_SCG*)ksp->data;
+
+  PetscFunctionBegin;
+  if (lmin >= lmax) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_INCOMP,"The smallest eigenvalue estimate %g must be smaller than the largest %g",(double)lmin,(double)lmax);
+  scg->lmin   = lmin;
+  scg->lmax   = lmax;
+  scg->eigset = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSCGSetSteps - Sets the number of iterations of each block of the s-step conjugate gradient method, between
+   two global reductions
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  s - the number of iterations per block, 4 by default
+
+   Options Database:
+.  -ksp_scg_steps <s>
+
+   Notes:
+   Each block applies the matrix 2s times, and the preconditioner 2s-1 times, instead of s times for s iterations
+   of KSPCG. The basis of the Krylov spaces becomes ill conditioned when s grows, even with the Newton and Chebyshev
+   bases, and values above 8 are rarely useful.
+
+   Level: intermediate
+
+.seealso: KSPSCG, KSPSCGSetBasisType(), KSPSCGSetEigenvalueEstimates()
+@*/
+PetscErrorCode KSPSCGSetSteps(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,s,2);
+  ierr = PetscTryMethod(ksp,"KSPSCGSetSteps_C",(KSP,PetscInt),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSCGSetBasisType - Sets the polynomial basis of the Krylov spaces of the s-step conjugate gradient method
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  basis - KSP_SSTEP_BASIS_MONOMIAL, KSP_SSTEP_BASIS_NEWTON (the default) or KSP_SSTEP_BASIS_CHEBYSHEV
+
+   Options Database:
+.  -ksp_scg_basis <monomial,newton,chebyshev>
+
+   Notes:
+   The Newton and Chebyshev bases need estimates of the extreme eigenvalues of the preconditioned operator. Unless
+   they are given with KSPSCGSetEigenvalueEstimates(), the first block uses the monomial basis and its Lanczos
+   coefficients provide them.
+
+   Level: intermediate
+
+.seealso: KSPSCG, KSPSCGSetSteps(), KSPSCGSetEigenvalueEstimates(), KSPSStepBasisType
+@*/
+PetscErrorCode KSPSCGSetBasisType(KSP ksp,KSPSStepBasisType basis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,basis,2);
+  ierr = PetscTryMethod(ksp,"KSPSCGSetBasisType_C",(KSP,KSPSStepBasisType),(ksp,basis));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSCGSetEigenvalueEstimates - Sets the estimates of the extreme eigenvalues of the preconditioned operator used
+   by the Newton and Chebyshev bases of the s-step conjugate gradient method
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+.  lmin - the estimate of the smallest eigenvalue
+-  lmax - the estimate of the largest eigenvalue
+
+   Options Database:
+.  -ksp_scg_eigenvalues <lmin,lmax>
+
+   Level: advanced
+
+.seealso: KSPSCG, KSPSCGSetBasisType(), KSPSetComputeEigenvalues()
+@*/
+PetscErrorCode KSPSCGSetEigenvalueEstimates(KSP ksp,PetscReal lmin,PetscReal lmax)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveReal(ksp,lmin,2);
+  PetscValidLogicalCollectiveReal(ksp,lmax,3);
+  ierr = PetscTryMethod(ksp,"KSPSCGSetEigenvalueEstimates_C",(KSP,PetscReal,PetscReal),(ksp,lmin,lmax));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPSCG - The s-step, or communication-avoiding, preconditioned conjugate gradient method. It has a single global
+   reduction every s iterations, instead of two per iteration for KSPCG and one for KSPPIPECG.
+
+   Options Database Keys:
++   -ksp_scg_steps <s> - the number of iterations per block (default 4)
+.   -ksp_scg_basis <monomial,newton,chebyshev> - the polynomial basis of the Krylov spaces (default newton)
+-   -ksp_scg_eigenvalues <lmin,lmax> - estimates of the extreme eigenvalues of the preconditioned operator for the
+                                       Newton and Chebyshev bases, otherwise they are computed in the first block
+
+   Level: intermediate
+
+   Notes:
+   Each block builds the bases of the Krylov spaces of the preconditioned residual and of the search direction,
+   computes all their inner products in one reduction and runs s iterations on the coordinates in these bases. It
+   applies the matrix 2s times, and the preconditioner 2s-1 times, per block. It pays off when the latency of the
+   reductions dominates, with many processes and a cheap preconditioner.
+
+   The vectors are only updated at the end of each block, so the monitors that use the solution, such as
+   -ksp_monitor_true_residual, see the solution of the previous block.
+
+   Only KSP_NORM_NATURAL and KSP_NORM_NONE are supported, with left preconditioning. The number of global
+   reductions of the last solve is shown by KSPView().
+
+   When the scalars computed in a block indicate a loss of positive definiteness, which can come from the
+   ill conditioning of the basis, the residual is recomputed and the iteration continues with half as many steps
+   per block. With one step per block the method stops with KSP_DIVERGED_INDEFINITE_MAT or KSP_DIVERGED_INDEFINITE_PC.
+
+   References:
++   1. - A. T. Chronopoulos and C. W. Gear, s-step iterative methods for symmetric linear systems, J. Comput. Appl. Math., 1989.
+-   2. - E. Carson, Communication-avoiding Krylov subspace methods in theory and practice, PhD thesis, UC Berkeley, 2015.
+
+.seealso: KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPCG, KSPPIPECG, KSPPIPELCG, KSPSGMRES,
+          KSPSCGSetSteps(), KSPSCGSetBasisType(), KSPSCGSetEigenvalueEstimates()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_SCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+  KSP_SCG        *scg;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&scg);CHKERRQ(ierr);
+#if !defined(PETSC_USE_COMPLEX)
+  scg->type = KSP_CG_SYMMETRIC;
+#else
+  scg->type = KSP_CG_HERMITIAN;
+#endif
+  scg->s     = 4;
+  scg->basis = KSP_SSTEP_BASIS_NEWTON;
+  ksp->data  = (void*)scg;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_SCG;
+  ksp->ops->solve          = KSPSolve_SCG;
+  ksp->ops->reset          = KSPReset_SCG;
+  ksp->ops->destroy        = KSPDestroy_SCG;
+  ksp->ops->view           = KSPView_SCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSCGSetSteps_C",KSPSCGSetSteps_SCG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSCGSetBasisType_C",KSPSCGSetBasisType_SCG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSCGSetEigenvalueEstimates_C",KSPSCGSetEigenvalueEstimates_SCG);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
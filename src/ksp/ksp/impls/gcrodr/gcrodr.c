@@ -0,0 +1,744 @@
+/*
+    This file implements GCRO-DR, GMRES with deflated restarting that recycles a subspace between cycles and
+    between consecutive solves.
+*/
+#include <petsc/private/kspimpl.h>  /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+#define GCRODR_HAPTOL 1.0e-30
+
+typedef struct {
+  PetscInt         m;            /* dimension of the search space of one cycle, recycled subspace included */
+  PetscInt         k;            /* maximum dimension of the recycled subspace */
+  PetscInt         kc;           /* current dimension of the recycled subspace */
+  PetscInt         it;           /* number of Arnoldi steps in the current cycle */
+  PetscBool        incycle;      /* the correction of the current cycle is not yet added to the solution */
+  Vec              *U,*C,*T;     /* recycled subspace, C = op(U) with orthonormal columns, work space of the update */
+  Vec              *V;           /* Arnoldi basis of the cycle */
+  Vec              *Z,*Y;        /* the bases [C V] and [U V] of the cycle, they do not own the vectors */
+  PetscScalar      *G,*R;        /* the (m+1) x m matrix [D B; 0 H] of the cycle and its rotated copy */
+  PetscScalar      *cs,*sn,*g;   /* Givens rotations and rotated right hand side of the least squares problem */
+  PetscScalar      *h,*a,*y;     /* orthogonalization coefficients, C^H r at the start of the cycle, solution */
+  PetscReal        *d;           /* norms of the columns of U */
+  PetscObjectId    Aid,Pid;      /* operators with which C was computed */
+  PetscObjectState Astate,Pstate;
+} KSP_GCRODR;
+
+static PetscErrorCode KSPSetUp_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       m = gcrodr->m,k = gcrodr->k;
+
+  PetscFunctionBegin;
+  if (k >= m) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_INCOMP,"Dimension of the recycled subspace %D must be smaller than the restart %D",k,m);
+  ierr = KSPSetWorkVecs(ksp,3);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(ksp->work[0],m+1,&gcrodr->V);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,m+1,gcrodr->V);CHKERRQ(ierr);
+  if (k) {
+    ierr = VecDuplicateVecs(ksp->work[0],k,&gcrodr->U);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(ksp->work[0],k,&gcrodr->C);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(ksp->work[0],k,&gcrodr->T);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->U);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->C);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->T);CHKERRQ(ierr);
+  }
+  gcrodr->kc = 0;
+  ierr = PetscMalloc2(k+m+1,&gcrodr->Z,k+m+1,&gcrodr->Y);CHKERRQ(ierr);
+  ierr = PetscCalloc5((m+1)*m,&gcrodr->G,(m+1)*m,&gcrodr->R,m,&gcrodr->cs,m,&gcrodr->sn,m+1,&gcrodr->g);CHKERRQ(ierr);
+  ierr = PetscMalloc4(k+m+1,&gcrodr->h,k+1,&gcrodr->a,m,&gcrodr->y,k+1,&gcrodr->d);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,2*(k+m+1)*sizeof(Vec)+(2*(m+1)*m+4*m+2*k+3)*sizeof(PetscScalar)+(k+1)*sizeof(PetscReal));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDestroyVecs(gcrodr->m+1,&gcrodr->V);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->k,&gcrodr->U);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->k,&gcrodr->C);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->k,&gcrodr->T);CHKERRQ(ierr);
+  ierr = PetscFree2(gcrodr->Z,gcrodr->Y);CHKERRQ(ierr);
+  ierr = PetscFree5(gcrodr->G,gcrodr->R,gcrodr->cs,gcrodr->sn,gcrodr->g);CHKERRQ(ierr);
+  ierr = PetscFree4(gcrodr->h,gcrodr->a,gcrodr->y,gcrodr->d);CHKERRQ(ierr);
+  gcrodr->kc      = 0;
+  gcrodr->it      = 0;
+  gcrodr->incycle = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_GCRODR(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_GCRODR(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRecycleDimension_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRGetRecycleDimension_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Recomputes C = op(U) after the operators changed and orthonormalizes C, applying the same transformation to U
+   so that C = op(U) still holds. Vectors that became linearly dependent are dropped.
+*/
+static PetscErrorCode KSPGCRODRRefresh_Private(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       i,l,kn = 0;
+  PetscScalar    *h = gcrodr->h,*s = gcrodr->h+gcrodr->k;
+  PetscReal      nrm0,nrm;
+  Vec            tmp;
+
+  PetscFunctionBegin;
+  for (i=0; i<gcrodr->kc; i++) {
+    ierr = KSP_PCApplyBAorAB(ksp,gcrodr->U[i],gcrodr->C[i],ksp->work[1]);CHKERRQ(ierr);
+    ierr = VecNorm(gcrodr->C[i],NORM_2,&nrm0);CHKERRQ(ierr);
+    if (kn) {
+      /* classical Gram-Schmidt with one reorthogonalization */
+      ierr = VecMDot(gcrodr->C[i],kn,gcrodr->C,h);CHKERRQ(ierr);
+      for (l=0; l<kn; l++) h[l] = -h[l];
+      ierr = VecMAXPY(gcrodr->C[i],kn,h,gcrodr->C);CHKERRQ(ierr);
+      ierr = VecMDot(gcrodr->C[i],kn,gcrodr->C,s);CHKERRQ(ierr);
+      for (l=0; l<kn; l++) {s[l] = -s[l]; h[l] += s[l];}
+      ierr = VecMAXPY(gcrodr->C[i],kn,s,gcrodr->C);CHKERRQ(ierr);
+      ierr = VecMAXPY(gcrodr->U[i],kn,h,gcrodr->U);CHKERRQ(ierr);
+    }
+    ierr = VecNorm(gcrodr->C[i],NORM_2,&nrm);CHKERRQ(ierr);
+    if (nrm <= PETSC_SQRT_MACHINE_EPSILON*nrm0) {
+      ierr = PetscInfo1(ksp,"Dropping recycled vector %D, it is linearly dependent on the previous ones\n",i);CHKERRQ(ierr);
+      continue;
+    }
+    ierr = VecScale(gcrodr->C[i],1.0/nrm);CHKERRQ(ierr);
+    ierr = VecScale(gcrodr->U[i],1.0/nrm);CHKERRQ(ierr);
+    if (i != kn) {
+      tmp = gcrodr->U[kn]; gcrodr->U[kn] = gcrodr->U[i]; gcrodr->U[i] = tmp;
+      tmp = gcrodr->C[kn]; gcrodr->C[kn] = gcrodr->C[i]; gcrodr->C[i] = tmp;
+    }
+    kn++;
+  }
+  gcrodr->kc = kn;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Adds to x the correction of the current cycle, x + U (a - B y) + V y where y solves the least squares problem
+   of the it Arnoldi steps done so far. With right preconditioning the correction goes through the preconditioner.
+*/
+static PetscErrorCode KSPGCRODRBuildSoln_Private(KSP ksp,Vec x)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       kc = gcrodr->kc,it = gcrodr->it,ld = gcrodr->m+1,i,l;
+  PetscScalar    *G = gcrodr->G,*R = gcrodr->R,*y = gcrodr->y,*h = gcrodr->h;
+
+  PetscFunctionBegin;
+  if (!gcrodr->incycle || (!kc && !it)) PetscFunctionReturn(0);
+  for (l=it-1; l>=0; l--) {
+    y[l] = gcrodr->g[l];
+    for (i=l+1; i<it; i++) y[l] -= R[kc+l+(kc+i)*ld]*y[i];
+    y[l] /= R[kc+l+(kc+l)*ld];
+  }
+  for (i=0; i<kc; i++) {
+    h[i] = gcrodr->a[i];
+    for (l=0; l<it; l++) h[i] -= G[i+(kc+l)*ld]*y[l];
+  }
+  for (l=0; l<it; l++) h[kc+l] = y[l];
+  if (ksp->pc_side == PC_RIGHT) {
+    ierr = VecSet(ksp->work[0],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(ksp->work[0],kc+it,h,gcrodr->Y);CHKERRQ(ierr);
+    ierr = KSP_PCApply(ksp,ksp->work[0],ksp->work[1]);CHKERRQ(ierr);
+    ierr = VecAXPY(x,1.0,ksp->work[1]);CHKERRQ(ierr);
+  } else {
+    ierr = VecMAXPY(x,kc+it,h,gcrodr->Y);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Replaces the recycled subspace by the harmonic Ritz vectors of the cycle associated with the harmonic Ritz values
+   of smallest magnitude. With What = [U D, V] and Vhat = [C V] the cycle satisfies op(What) = Vhat G, the harmonic
+   Ritz pairs solve G^H G z = theta G^H Vhat^H What z, computed here as the largest eigenpairs of
+   G^+ Vhat^H What = R^{-1} Q^H Vhat^H What from the Givens QR factorization G = Q R of the cycle.
+*/
+static PetscErrorCode KSPGCRODRUpdateRecycleSpace_Private(KSP ksp)
+{
+#if defined(PETSC_MISSING_LAPACK_GEEV) || defined(PETSC_HAVE_ESSL)
+  PetscFunctionBegin;
+  SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"GEEV - Lapack routine is unavailable");
+#else
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       kc = gcrodr->kc,it = gcrodr->it,k = gcrodr->k,ld = gcrodr->m+1,n = kc+it,kn = 0,kk = 0,i,l,r,*perm;
+  PetscScalar    *G = gcrodr->G,*R = gcrodr->R,*M,*VR,*P,*GP,*Rk,*work,*x,tmp,sdummy;
+  PetscReal      *d = gcrodr->d,*modul,nrm,nrm0;
+  PetscBLASInt   bn,bld,lwork,idummy = 1,info;
+  Vec            *swap;
+#if defined(PETSC_USE_COMPLEX)
+  PetscScalar    *eig;
+  PetscReal      *rwork;
+#else
+  PetscReal      *wr,*wi;
+#endif
+
+  PetscFunctionBegin;
+  if (!k || !it) PetscFunctionReturn(0);
+  /* the first kc columns of G and R are D = diag(1/||U_i||), the columns of What have unit norm */
+  for (i=0; i<kc; i++) {ierr = VecNormBegin(gcrodr->U[i],NORM_2,&d[i]);CHKERRQ(ierr);}
+  for (i=0; i<kc; i++) {ierr = VecNormEnd(gcrodr->U[i],NORM_2,&d[i]);CHKERRQ(ierr);}
+  for (i=0; i<kc; i++) {
+    ierr = PetscMemzero(G+i*ld,(n+1)*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMemzero(R+i*ld,(n+1)*sizeof(PetscScalar));CHKERRQ(ierr);
+    G[i+i*ld] = R[i+i*ld] = 1.0/d[i];
+  }
+  for (i=0; i<n; i++) {
+    if (R[i+i*ld] == 0.0) {
+      ierr = PetscInfo(ksp,"Singular projected matrix, keeping the previous recycled subspace\n");CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
+
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ld,&bld);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(5*n,&lwork);CHKERRQ(ierr);
+  ierr = PetscCalloc6(ld*n,&M,n*n,&VR,n*k,&P,(n+1)*k,&GP,k*k,&Rk,lwork,&work);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n,&modul,n,&perm);CHKERRQ(ierr);
+
+  /* M = Vhat^H What, the columns of V are orthonormal and orthogonal to C */
+  for (i=0; i<kc; i++) {ierr = VecMDotBegin(gcrodr->U[i],n+1,gcrodr->Z,M+i*ld);CHKERRQ(ierr);}
+  for (i=0; i<kc; i++) {ierr = VecMDotEnd(gcrodr->U[i],n+1,gcrodr->Z,M+i*ld);CHKERRQ(ierr);}
+  for (i=0; i<kc; i++) {
+    for (r=0; r<=n; r++) M[r+i*ld] /= d[i];
+  }
+  for (l=0; l<it; l++) M[kc+l+(kc+l)*ld] = 1.0;
+  /* M = R^{-1} Q^H M, the rotations only act on the rows of the Hessenberg part */
+  for (i=0; i<n; i++) {
+    x = M+i*ld;
+    for (l=0; l<it; l++) {
+      tmp       = x[kc+l];
+      x[kc+l]   = PetscConj(gcrodr->cs[l])*tmp + gcrodr->sn[l]*x[kc+l+1];
+      x[kc+l+1] = gcrodr->cs[l]*x[kc+l+1] - gcrodr->sn[l]*tmp;
+    }
+    for (r=n-1; r>=0; r--) {
+      for (l=r+1; l<n; l++) x[r] -= R[r+l*ld]*x[l];
+      x[r] /= R[r+r*ld];
+    }
+  }
+
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+  ierr = PetscMalloc2(n,&eig,2*n,&rwork);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","V",&bn,M,&bld,eig,&sdummy,&idummy,VR,&bn,work,&lwork,rwork,&info));
+  for (i=0; i<n; i++) modul[i] = PetscAbsScalar(eig[i]);
+#else
+  ierr = PetscMalloc2(n,&wr,n,&wi);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","V",&bn,M,&bld,wr,wi,&sdummy,&idummy,VR,&bn,work,&lwork,&info));
+  for (i=0; i<n; i++) modul[i] = PetscSqrtReal(wr[i]*wr[i]+wi[i]*wi[i]);
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xGEEV %d",(int)info);
+
+  /* P holds the eigenvectors of the largest eigenvalues, for a complex conjugate pair its real and imaginary parts */
+  for (i=0; i<n; i++) perm[i] = i;
+  ierr = PetscSortRealWithPermutation(n,modul,perm);CHKERRQ(ierr);
+  for (l=n-1; l>=0 && kn<k; l--) {
+    i = perm[l];
+#if defined(PETSC_USE_COMPLEX)
+    ierr = PetscMemcpy(P+kn*n,VR+i*n,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    kn++;
+#else
+    if (wi[i] == 0.0) {
+      ierr = PetscMemcpy(P+kn*n,VR+i*n,n*sizeof(PetscScalar));CHKERRQ(ierr);
+      kn++;
+    } else if (wi[i] > 0.0) {
+      if (kn+2 > k) break;
+      ierr = PetscMemcpy(P+kn*n,VR+i*n,2*n*sizeof(PetscScalar));CHKERRQ(ierr);
+      kn += 2;
+    }
+#endif
+  }
+#if defined(PETSC_USE_COMPLEX)
+  ierr = PetscFree2(eig,rwork);CHKERRQ(ierr);
+#else
+  ierr = PetscFree2(wr,wi);CHKERRQ(ierr);
+#endif
+
+  /* G P = Qk Rk with modified Gram-Schmidt and one reorthogonalization, dropping dependent columns */
+  for (i=0; i<kn; i++) {
+    x = GP+kk*(n+1);
+    for (r=0; r<=n; r++) {
+      x[r] = 0.0;
+      for (l=0; l<n; l++) x[r] += G[r+l*ld]*P[l+i*n];
+    }
+    nrm0 = 0.0;
+    for (r=0; r<=n; r++) nrm0 += PetscRealPart(PetscConj(x[r])*x[r]);
+    nrm0 = PetscSqrtReal(nrm0);
+    for (l=0; l<kk; l++) Rk[l+kk*k] = 0.0;
+    for (l=0; l<2*kk; l++) {
+      PetscScalar *q = GP+(l%kk)*(n+1),dot = 0.0;
+
+      for (r=0; r<=n; r++) dot += PetscConj(q[r])*x[r];
+      for (r=0; r<=n; r++) x[r] -= dot*q[r];
+      Rk[l%kk+kk*k] += dot;
+    }
+    nrm = 0.0;
+    for (r=0; r<=n; r++) nrm += PetscRealPart(PetscConj(x[r])*x[r]);
+    nrm = PetscSqrtReal(nrm);
+    if (nrm <= PETSC_SQRT_MACHINE_EPSILON*nrm0) continue;
+    for (r=0; r<=n; r++) x[r] /= nrm;
+    Rk[kk+kk*k] = nrm;
+    if (kk != i) {ierr = PetscMemcpy(P+kk*n,P+i*n,n*sizeof(PetscScalar));CHKERRQ(ierr);}
+    kk++;
+  }
+  /* P = P Rk^{-1} so that op(What P) = Vhat Qk */
+  for (i=0; i<kk; i++) {
+    x = P+i*n;
+    for (l=0; l<i; l++) {
+      for (r=0; r<n; r++) x[r] -= Rk[l+i*k]*P[r+l*n];
+    }
+    for (r=0; r<n; r++) x[r] /= Rk[i+i*k];
+  }
+  for (r=0; r<kc; r++) {
+    for (i=0; i<kk; i++) P[r+i*n] /= d[r];
+  }
+
+  /* the new C = Vhat Qk goes to T and the new U = What P to C, which is no longer referenced */
+  for (i=0; i<kk; i++) {
+    ierr = VecSet(gcrodr->T[i],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->T[i],n+1,GP+i*(n+1),gcrodr->Z);CHKERRQ(ierr);
+  }
+  for (i=0; i<kk; i++) {
+    ierr = VecSet(gcrodr->C[i],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->C[i],n,P+i*n,gcrodr->Y);CHKERRQ(ierr);
+  }
+  swap       = gcrodr->U;
+  gcrodr->U  = gcrodr->C;
+  gcrodr->C  = gcrodr->T;
+  gcrodr->T  = swap;
+  gcrodr->kc = kk;
+  ierr = PetscInfo2(ksp,"Recycled subspace of dimension %D from a cycle of %D vectors\n",kk,n);CHKERRQ(ierr);
+
+  ierr = PetscFree6(M,VR,P,GP,Rk,work);CHKERRQ(ierr);
+  ierr = PetscFree2(modul,perm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#endif
+}
+
+/*
+   One cycle of GCRO-DR: V_0 holds the initial residual on entry. The residual is projected onto the orthogonal
+   complement of range(C), then m-kc Arnoldi steps are done with (I - C C^H) op, the coefficients C^H op V are
+   stored above the Hessenberg matrix in G.
+*/
+static PetscErrorCode KSPGCRODRCycle_Private(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       kc = gcrodr->kc,ld = gcrodr->m+1,steps = gcrodr->m-gcrodr->kc,it = 0,nz,i,l;
+  PetscScalar    *h = gcrodr->h,*g = gcrodr->g,*cs = gcrodr->cs,*sn = gcrodr->sn,*col,*hh,tmp;
+  PetscReal      res,tt,hapbnd;
+  PetscBool      hapend = PETSC_FALSE;
+  Vec            *V = gcrodr->V;
+
+  PetscFunctionBegin;
+  for (i=0; i<kc; i++) {
+    gcrodr->Z[i] = gcrodr->C[i];
+    gcrodr->Y[i] = gcrodr->U[i];
+  }
+  for (i=0; i<=steps; i++) gcrodr->Z[kc+i] = gcrodr->Y[kc+i] = V[i];
+  gcrodr->it      = 0;
+  gcrodr->incycle = PETSC_TRUE;
+  if (kc) {
+    ierr = VecMDot(V[0],kc,gcrodr->C,gcrodr->a);CHKERRQ(ierr);
+    for (i=0; i<kc; i++) h[i] = -gcrodr->a[i];
+    ierr = VecMAXPY(V[0],kc,h,gcrodr->C);CHKERRQ(ierr);
+  }
+  ierr = VecNormalize(V[0],&res);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res);
+  g[0] = res;
+
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = res;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+  } else {
+    ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  }
+  while (!ksp->reason && it < steps && ksp->its < ksp->max_it) {
+    if (it) {
+      ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+    }
+    ierr = KSP_PCApplyBAorAB(ksp,V[it],V[it+1],ksp->work[1]);CHKERRQ(ierr);
+
+    /* classical Gram-Schmidt with one reorthogonalization against [C V_0 ... V_it] */
+    nz   = kc+it+1;
+    col  = gcrodr->G+(kc+it)*ld;
+    ierr = VecMDot(V[it+1],nz,gcrodr->Z,col);CHKERRQ(ierr);
+    for (i=0; i<nz; i++) h[i] = -col[i];
+    ierr = VecMAXPY(V[it+1],nz,h,gcrodr->Z);CHKERRQ(ierr);
+    ierr = VecMDot(V[it+1],nz,gcrodr->Z,h);CHKERRQ(ierr);
+    for (i=0; i<nz; i++) {
+      col[i] += h[i];
+      h[i]    = -h[i];
+    }
+    ierr = VecMAXPY(V[it+1],nz,h,gcrodr->Z);CHKERRQ(ierr);
+    ierr = VecNormalize(V[it+1],&tt);CHKERRQ(ierr);
+    KSPCheckNorm(ksp,tt);
+    col[nz] = tt;
+
+    /* check for the happy breakdown */
+    hapbnd = PetscAbsScalar(tt/g[it]);
+    if (hapbnd > GCRODR_HAPTOL) hapbnd = GCRODR_HAPTOL;
+    if (tt < hapbnd) {
+      ierr   = PetscInfo2(ksp,"Detected happy breakdown, current hapbnd = %14.12e tt = %14.12e\n",(double)hapbnd,(double)tt);CHKERRQ(ierr);
+      hapend = PETSC_TRUE;
+    }
+
+    /* apply the previous rotations and compute the new one on the Hessenberg part of the copy in R */
+    ierr = PetscMemcpy(gcrodr->R+(kc+it)*ld,col,(nz+1)*sizeof(PetscScalar));CHKERRQ(ierr);
+    hh   = gcrodr->R+(kc+it)*ld+kc;
+    for (l=0; l<it; l++) {
+      tmp     = hh[l];
+      hh[l]   = PetscConj(cs[l])*tmp + sn[l]*hh[l+1];
+      hh[l+1] = cs[l]*hh[l+1] - sn[l]*tmp;
+    }
+    if (!hapend) {
+      tmp = PetscSqrtScalar(PetscConj(hh[it])*hh[it] + PetscConj(hh[it+1])*hh[it+1]);
+      if (tmp == 0.0) {
+        if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"tt == 0.0");
+        ksp->reason = KSP_DIVERGED_NULL;
+        break;
+      }
+      cs[it]   = hh[it]/tmp;
+      sn[it]   = hh[it+1]/tmp;
+      g[it+1]  = -sn[it]*g[it];
+      g[it]    = PetscConj(cs[it])*g[it];
+      hh[it]   = PetscConj(cs[it])*hh[it] + sn[it]*hh[it+1];
+      hh[it+1] = 0.0;
+      res      = PetscAbsScalar(g[it+1]);
+    } else {
+      cs[it]  = 1.0;
+      sn[it]  = 0.0;
+      g[it+1] = 0.0;
+      res     = 0.0;
+    }
+
+    it++;
+    gcrodr->it = it;
+    ksp->its++;
+    ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->rnorm = res;
+    ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+    /* catch error in happy breakdown and signal convergence and break from loop */
+    if (hapend) {
+      if (!ksp->reason) {
+        if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      }
+      break;
+    }
+  }
+
+  /* monitor if we know that we will not return for a restart */
+  if (it && (ksp->reason || ksp->its >= ksp->max_it)) {
+    ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  }
+
+  ierr = KSPGCRODRBuildSoln_Private(ksp,ksp->vec_sol);CHKERRQ(ierr);
+  gcrodr->incycle = PETSC_FALSE;
+  ierr = KSPGCRODRUpdateRecycleSpace_Private(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_GCRODR(KSP ksp)
+{
+  KSP_GCRODR       *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode   ierr;
+  PetscBool        guess_zero = ksp->guess_zero,diagonalscale;
+  Mat              Amat,Pmat;
+  PetscObjectId    Aid,Pid;
+  PetscObjectState Astate,Pstate;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+
+  /* the recycled subspace is kept, only its image is recomputed when the operators changed */
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Amat,&Aid);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Pmat,&Pid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Amat,&Astate);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Pmat,&Pstate);CHKERRQ(ierr);
+  if (gcrodr->kc && (Aid != gcrodr->Aid || Pid != gcrodr->Pid || Astate != gcrodr->Astate || Pstate != gcrodr->Pstate)) {
+    ierr = PetscInfo1(ksp,"Operators changed, updating the image of the recycled subspace of dimension %D\n",gcrodr->kc);CHKERRQ(ierr);
+    ierr = KSPGCRODRRefresh_Private(ksp);CHKERRQ(ierr);
+  }
+  gcrodr->Aid    = Aid;
+  gcrodr->Pid    = Pid;
+  gcrodr->Astate = Astate;
+  gcrodr->Pstate = Pstate;
+
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr = KSPInitialResidual(ksp,ksp->vec_sol,ksp->work[1],ksp->work[2],gcrodr->V[0],ksp->vec_rhs);CHKERRQ(ierr);
+    ierr = KSPGCRODRCycle_Private(ksp);CHKERRQ(ierr);
+    if (ksp->its >= ksp->max_it && !ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_GCRODR(KSP ksp,Vec ptr,Vec *result)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) ptr = ksp->work[2];
+  ierr = VecCopy(ksp->vec_sol,ptr);CHKERRQ(ierr);
+  ierr = KSPGCRODRBuildSoln_Private(ksp,ptr);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_GCRODR(KSP ksp,PetscViewer viewer)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, recycled subspace of maximum dimension %D\n",gcrodr->m,gcrodr->k);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  current dimension of the recycled subspace %D\n",gcrodr->kc);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"restart %D recycle %D",gcrodr->m,gcrodr->k);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_GCRODR(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       m,k;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP GCRODR options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_gcrodr_restart","Number of vectors of a cycle, recycled subspace included","KSPGCRODRSetRestart",gcrodr->m,&m,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGCRODRSetRestart(ksp,m);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-ksp_gcrodr_recycle","Maximum dimension of the recycled subspace","KSPGCRODRSetRecycleDimension",gcrodr->k,&k,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGCRODRSetRecycleDimension(ksp,k);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRSetRestart_GCRODR(KSP ksp,PetscInt m)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (m < 2) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Restart %D must be at least 2",m);
+  if (m == gcrodr->m) PetscFunctionReturn(0);
+  if (ksp->setupstage) {
+    /* free the data structures, then create them again */
+    ierr = KSPReset_GCRODR(ksp);CHKERRQ(ierr);
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  gcrodr->m = m;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRSetRecycleDimension_GCRODR(KSP ksp,PetscInt k)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (k < 0) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Dimension of the recycled subspace %D cannot be negative",k);
+  if (k == gcrodr->k) PetscFunctionReturn(0);
+  if (ksp->setupstage) {
+    ierr = KSPReset_GCRODR(ksp);CHKERRQ(ierr);
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  gcrodr->k = k;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRGetRecycleDimension_GCRODR(KSP ksp,PetscInt *k,PetscInt *kc)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR*)ksp->data;
+
+  PetscFunctionBegin;
+  if (k)  *k  = gcrodr->k;
+  if (kc) *kc = gcrodr->kc;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRSetRestart - Sets the number of vectors of a GCRO-DR cycle, the recycled subspace included
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  m - the number of vectors, 30 by default
+
+   Options Database:
+.  -ksp_gcrodr_restart <m>
+
+   Notes:
+   Each cycle does m-k Arnoldi steps when the recycled subspace has dimension k. Changing m after the solver is
+   set up discards the recycled subspace.
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetRecycleDimension()
+@*/
+PetscErrorCode KSPGCRODRSetRestart(KSP ksp,PetscInt m)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,m,2);
+  ierr = PetscTryMethod(ksp,"KSPGCRODRSetRestart_C",(KSP,PetscInt),(ksp,m));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRSetRecycleDimension - Sets the maximum dimension of the subspace GCRO-DR recycles between cycles and
+   between solves
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  k - the dimension, 10 by default, 0 gives GMRES
+
+   Options Database:
+.  -ksp_gcrodr_recycle <k>
+
+   Notes:
+   k must be smaller than the restart. Changing k after the solver is set up discards the recycled subspace.
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetRestart(), KSPGCRODRGetRecycleDimension()
+@*/
+PetscErrorCode KSPGCRODRSetRecycleDimension(KSP ksp,PetscInt k)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,k,2);
+  ierr = PetscTryMethod(ksp,"KSPGCRODRSetRecycleDimension_C",(KSP,PetscInt),(ksp,k));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRGetRecycleDimension - Gets the maximum and the current dimension of the subspace recycled by GCRO-DR
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameters:
++  k - the maximum dimension (pass NULL if not needed)
+-  kc - the dimension of the subspace currently kept for the next solve (pass NULL if not needed)
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetRecycleDimension()
+@*/
+PetscErrorCode KSPGCRODRGetRecycleDimension(KSP ksp,PetscInt *k,PetscInt *kc)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  ierr = PetscUseMethod(ksp,"KSPGCRODRGetRecycleDimension_C",(KSP,PetscInt*,PetscInt*),(ksp,k,kc));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPGCRODR - GCRO-DR, GMRES with deflated restarting that recycles a Krylov subspace between consecutive solves.
+
+   Options Database Keys:
++   -ksp_gcrodr_restart <m> - the number of vectors of a cycle, the recycled subspace included (default 30)
+-   -ksp_gcrodr_recycle <k> - the maximum dimension of the recycled subspace (default 10)
+
+   Level: intermediate
+
+   Notes:
+   At the end of each cycle the recycled subspace U is replaced by the k harmonic Ritz vectors of the cycle with the
+   harmonic Ritz values of smallest magnitude, with C = op(U) kept orthonormal. Each cycle first removes the
+   component of the residual in range(C), then does m-k Arnoldi steps with (I - C C^H) op, which deflates the
+   eigenvalues of smallest magnitude from the restarted iteration.
+
+   The recycled subspace is kept by KSPSolve() for the next solve. When the operators changed since the previous
+   solve only C = op(U) is recomputed, which costs k applications of the operator and the preconditioner instead
+   of the first cycle of GMRES, so that sequences of slowly changing systems, as in time stepping or Newton's
+   method, start each solve with the deflation space of the previous one. KSPReset() discards the subspace.
+
+   The method stores m+1+3k vectors. Left and right preconditioning are supported, with the preconditioned and the
+   unpreconditioned norm respectively.
+
+   References:
+.   1. - M. L. Parks, E. de Sturler, G. Mackey, D. D. Johnson and S. Maiti, Recycling Krylov subspaces for
+         sequences of linear systems, SIAM J. Sci. Comput., 2006.
+
+.seealso: KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPDGMRES, KSPLGMRES,
+          KSPGCRODRSetRestart(), KSPGCRODRSetRecycleDimension(), KSPGCRODRGetRecycleDimension()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP ksp)
+{
+  PetscErrorCode ierr;
+  KSP_GCRODR     *gcrodr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&gcrodr);CHKERRQ(ierr);
+  gcrodr->m = 30;
+  gcrodr->k = 10;
+  ksp->data = (void*)gcrodr;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_GCRODR;
+  ksp->ops->solve          = KSPSolve_GCRODR;
+  ksp->ops->reset          = KSPReset_GCRODR;
+  ksp->ops->destroy        = KSPDestroy_GCRODR;
+  ksp->ops->view           = KSPView_GCRODR;
+  ksp->ops->setfromoptions = KSPSetFromOptions_GCRODR;
+  ksp->ops->buildsolution  = KSPBuildSolution_GCRODR;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRestart_C",KSPGCRODRSetRestart_GCRODR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRecycleDimension_C",KSPGCRODRSetRecycleDimension_GCRODR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRGetRecycleDimension_C",KSPGCRODRGetRecycleDimension_GCRODR);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
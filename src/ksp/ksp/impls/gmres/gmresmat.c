@@ -0,0 +1,334 @@
+
+/*
+    Block GMRES for several right-hand sides, used by KSPMatSolve() with KSPGMRES
+
+    A block of basis vectors is built per iteration by applying the operator to the previous block with MatMatMult()
+    and the preconditioner with PCMatApply(). The block is orthogonalized against the basis and among itself with a
+    block classical Gram-Schmidt and a Cholesky QR factorization, so that all the inner products come from a single
+    global reduction (two with the refinement), whatever the number of right-hand sides. The factorization is
+    pivoted and drops the numerically dependent vectors, so that the size of the blocks decreases instead of the
+    method breaking down. The block Hessenberg matrix is reduced to triangular form with Householder reflections as
+    the blocks are built, which gives the residual norms of all the columns at each iteration.
+*/
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+#if defined(PETSC_USE_COMPLEX)
+#define KSPGMRES_BLOCK_TRANS "C"
+#else
+#define KSPGMRES_BLOCK_TRANS "T"
+#endif
+
+typedef struct {
+  PetscInt    n,N,p,m;    /* local and global numbers of rows, number of right-hand sides, block iterations per cycle */
+  PetscInt    ldh;        /* leading dimension of H and Gq */
+  PetscScalar *V;         /* the basis, n x (m+1)p */
+  PetscScalar *H;         /* the block Hessenberg matrix, (m+1)p x mp, reduced to upper triangular */
+  PetscScalar *tau;       /* scalar factors of the Householder reflections */
+  PetscScalar *Gq;        /* the right-hand sides of the least-squares problems, (m+1)p x p */
+  PetscScalar *Z;         /* n x p work space */
+  PetscScalar *buf;       /* the inner products, (m+1)p x p */
+  PetscScalar *G,*R;      /* Gram matrix of the new block and its triangular factor */
+  PetscScalar *work;
+  PetscBLASInt lwork;
+  PetscReal   *s,*t,*d;   /* squared norms of the new vectors before and after the first projection, work space */
+  PetscInt    *perm;
+  PetscInt    *Kb,*kb;    /* offsets and sizes of the blocks of the basis */
+} KSP_GMRESBlock;
+
+/*
+   Computes the inner products of the kw vectors W = V(:,K:K+kw) with V(:,0:K+kw) and subtracts the projection of W
+   on V(:,0:K), with a single global reduction; G is then the Gram matrix of the projected vectors and C the
+   coefficients of the projection, which are added to the K first rows of Hc
+*/
+static PetscErrorCode KSPGMRESBlockProject_Private(KSP ksp,KSP_GMRESBlock *blk,PetscInt K,PetscInt kw,PetscScalar *Hc,PetscInt ldhc)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = blk->n,nrows = K+kw,i,j;
+  PetscScalar    *W = blk->V+K*n,*C = blk->buf,one = 1.0,mone = -1.0,zero = 0.0;
+  PetscBLASInt   bn,bK,bkw,bnrows;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(K,&bK);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(kw,&bkw);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(nrows,&bnrows);CHKERRQ(ierr);
+  if (n) PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bnrows,&bkw,&bn,&one,blk->V,&bn,W,&bn,&zero,C,&bnrows));
+  else {ierr = PetscMemzero(C,nrows*kw*sizeof(PetscScalar));CHKERRQ(ierr);}
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,C,nrows*kw,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*n*nrows*kw);CHKERRQ(ierr);
+  /* G = W'W - C'C, W = W - V C */
+  for (j=0; j<kw; j++) {
+    for (i=0; i<kw; i++) blk->G[i+j*kw] = C[K+i+j*nrows];
+    for (i=0; i<K; i++) Hc[i+j*ldhc] += C[i+j*nrows];
+  }
+  if (K) {
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bkw,&bkw,&bK,&mone,C,&bnrows,C,&bnrows,&one,blk->G,&bkw));
+    if (n) PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bkw,&bK,&mone,blk->V,&bn,C,&bnrows,&one,W,&bn));
+    ierr = PetscLogFlops(2.0*(n+kw)*K*kw);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orthonormalizes the kw vectors W = V(:,K:K+kw) against V(:,0:K) and among themselves, and computes the factors of
+
+     W = V(:,0:K) C + V(:,K:K+rank) S
+
+   stored in the rows of Hc. The numerically dependent vectors are dropped, and the rank remaining ones are stored in
+   V(:,K:K+rank).
+*/
+static PetscErrorCode KSPGMRESBlockOrthogonalize_Private(KSP ksp,KSP_GMRESBlock *blk,PetscInt K,PetscInt kw,PetscScalar *Hc,PetscInt ldhc,PetscInt *rank)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       n = blk->n,i,j,rk;
+  PetscScalar    *W = blk->V+K*n,one = 1.0;
+  PetscBLASInt   bn,brk,bkw;
+  PetscBool      refine;
+
+  PetscFunctionBegin;
+  ierr = KSPGMRESBlockProject_Private(ksp,blk,K,kw,Hc,ldhc);CHKERRQ(ierr);
+  for (j=0; j<kw; j++) blk->s[j] = PetscRealPart(blk->buf[K+j+j*(K+kw)]);
+  ierr = KSPBlockCholesky_Private(kw,blk->G,kw,blk->s,PETSC_SQRT_MACHINE_EPSILON,blk->R,kw,blk->perm,blk->d,&rk);CHKERRQ(ierr);
+  refine = (PetscBool)(gmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS);
+  if (!refine) {
+    /* KSP_GMRES_CGS_REFINE_NEVER is treated like KSP_GMRES_CGS_REFINE_IFNEEDED, a single CholQR being unstable;
+       refine when the projection removed more than it kept, as in KSPGMRESClassicalGramSchmidtOrthogonalization(),
+       since the Gram matrix of the projected vectors is then inaccurate after cancellation, and when the projected
+       vectors are ill-conditioned, since CholQR loses orthogonality like the square of their condition number */
+    if (rk < kw) refine = PETSC_TRUE;
+    for (j=0; j<kw; j++) {
+      if (2.0*PetscRealPart(blk->G[j+j*kw]) < blk->s[j]) refine = PETSC_TRUE;
+    }
+    for (i=0; i<rk; i++) {
+      if (2.0*PetscRealPart(blk->R[i+i*kw])*PetscRealPart(blk->R[i+i*kw]) < PetscRealPart(blk->G[blk->perm[i]*(kw+1)])) refine = PETSC_TRUE;
+    }
+  }
+  if (refine) {
+    /* the vectors are dropped relative to their projected norms, which are those of the entries of the Hessenberg
+       matrix, so that a vector in the span of the basis to working precision is kept like in a happy breakdown of
+       GMRES, and only the vectors dependent on the others of the block are dropped */
+    ierr = KSPGMRESBlockProject_Private(ksp,blk,K,kw,Hc,ldhc);CHKERRQ(ierr);
+    for (j=0; j<kw; j++) blk->t[j] = PetscRealPart(blk->buf[K+j+j*(K+kw)]);
+    ierr = KSPBlockCholesky_Private(kw,blk->G,kw,blk->t,PETSC_SQRT_MACHINE_EPSILON,blk->R,kw,blk->perm,blk->d,&rk);CHKERRQ(ierr);
+  }
+  if (rk < kw) {ierr = PetscInfo3(ksp,"Kept %D of the %D vectors of the block at iteration %D\n",rk,kw,ksp->its);CHKERRQ(ierr);}
+
+  /* V(:,K:K+rank) = W(:,perm) R^{-1} */
+  for (i=0; i<rk; i++) {ierr = PetscMemcpy(blk->Z+i*n,W+blk->perm[i]*n,n*sizeof(PetscScalar));CHKERRQ(ierr);}
+  ierr = PetscMemcpy(W,blk->Z,rk*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(rk,&brk);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(kw,&bkw);CHKERRQ(ierr);
+  if (n && brk) PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&bn,&brk,&one,blk->R,&bkw,W,&bn));
+  ierr = PetscLogFlops(1.0*n*rk*rk);CHKERRQ(ierr);
+  for (j=0; j<kw; j++) {
+    for (i=0; i<rk; i++) Hc[K+i+blk->perm[j]*ldhc] = blk->R[i+j*kw];
+  }
+  *rank = rk;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Applies the previous Householder reflections to the new block column j of the Hessenberg matrix, reduces it to
+   triangular form and applies the new reflections to the right-hand sides of the least-squares problems
+*/
+static PetscErrorCode KSPGMRESBlockUpdateHessenberg_Private(KSP ksp,KSP_GMRESBlock *blk,PetscInt j)
+{
+  PetscInt       ldh = blk->ldh,i,*Kb = blk->Kb,*kb = blk->kb;
+  PetscErrorCode ierr;
+  PetscScalar    *Hc = blk->H+Kb[j]*ldh;
+  PetscBLASInt   bm,bc,bk,bldh,bp,info;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(ldh,&bldh);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(kb[j],&bc);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(blk->p,&bp);CHKERRQ(ierr);
+  for (i=0; i<j; i++) {
+    ierr = PetscBLASIntCast(kb[i]+kb[i+1],&bm);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(kb[i],&bk);CHKERRQ(ierr);
+    PetscStackCallBLAS("LAPACKormqr",LAPACKormqr_("L",KSPGMRES_BLOCK_TRANS,&bm,&bc,&bk,blk->H+Kb[i]+Kb[i]*ldh,&bldh,blk->tau+Kb[i],Hc+Kb[i],&bldh,blk->work,&blk->lwork,&info));
+    if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+  }
+  ierr = PetscBLASIntCast(kb[j]+kb[j+1],&bm);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgeqrf",LAPACKgeqrf_(&bm,&bc,Hc+Kb[j],&bldh,blk->tau+Kb[j],blk->work,&blk->lwork,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+  PetscStackCallBLAS("LAPACKormqr",LAPACKormqr_("L",KSPGMRES_BLOCK_TRANS,&bm,&bp,&bc,Hc+Kb[j],&bldh,blk->tau+Kb[j],blk->Gq+Kb[j],&bldh,blk->work,&blk->lwork,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGMRESBlockCreateMat_Private(KSP ksp,KSP_GMRESBlock *blk,PetscInt k,PetscScalar *a,Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreateDense(PetscObjectComm((PetscObject)ksp),blk->n,PETSC_DECIDE,blk->N,k,a,A);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPMatSolve_GMRES(KSP ksp,Mat B,Mat X)
+{
+  KSP_GMRES         *gmres = (KSP_GMRES*)ksp->data;
+  KSP_GMRESBlock    blk;
+  PetscErrorCode    ierr;
+  Mat               A,Vm = NULL,Wm = NULL,Um = NULL,Tm = NULL,Zm,Upm,V0m,AX = NULL;
+  PetscInt          n,p,m,ldh,ldb,ldx,ldt,i,j,c,k,K,nb,km = 0;
+  PetscScalar       *x,*t,*U,one = 1.0;
+  const PetscScalar *b;
+  PetscReal         *rnorm0,*rnorm;
+  PetscBLASInt      bn,bp,bK,bldh,bldx;
+  PetscBool         diagonalscale,first = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+  if (ksp->pc_side == PC_SYMMETRIC) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Block GMRES does not support symmetric preconditioning");
+  ierr = PCGetOperators(ksp->pc,&A,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&n,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,&blk.N,&p);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  m       = gmres->max_k;
+  ldh     = (m+1)*p;
+  blk.n   = n;
+  blk.p   = p;
+  blk.m   = m;
+  blk.ldh = ldh;
+  ierr = PetscBLASIntCast(32*p,&blk.lwork);CHKERRQ(ierr);
+  ierr = PetscMalloc5(n*ldh,&blk.V,ldh*m*p,&blk.H,m*p,&blk.tau,ldh*p,&blk.Gq,n*p,&blk.Z);CHKERRQ(ierr);
+  ierr = PetscMalloc5(ldh*p,&blk.buf,p*p,&blk.G,p*p,&blk.R,32*p,&blk.work,n*p,&U);CHKERRQ(ierr);
+  ierr = PetscMalloc6(p,&blk.s,p,&blk.t,p,&blk.d,p,&blk.perm,m+1,&blk.Kb,m+1,&blk.kb);CHKERRQ(ierr);
+  ierr = PetscMalloc2(p,&rnorm0,p,&rnorm);CHKERRQ(ierr);
+  ierr = KSPGMRESBlockCreateMat_Private(ksp,&blk,p,blk.Z,&Zm);CHKERRQ(ierr);
+  ierr = KSPGMRESBlockCreateMat_Private(ksp,&blk,p,U,&Upm);CHKERRQ(ierr);
+  ierr = KSPGMRESBlockCreateMat_Private(ksp,&blk,p,blk.V,&V0m);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(p,&bp);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldh,&bldh);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldx,&bldx);CHKERRQ(ierr);
+  blk.kb[0] = -1;
+
+  ksp->its = 0;
+  while (!ksp->reason) {
+    /* the residual, preconditioned with left preconditioning, in the first block of the basis */
+    ierr = MatDenseGetArrayRead(B,&b);CHKERRQ(ierr);
+    for (j=0; j<p; j++) {ierr = PetscMemcpy(blk.Z+j*n,b+j*ldb,n*sizeof(PetscScalar));CHKERRQ(ierr);}
+    ierr = MatDenseRestoreArrayRead(B,&b);CHKERRQ(ierr);
+    if (!first || !ksp->guess_zero) {
+      ierr = KSPMatMatMult_Private(A,X,AX ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,&AX);CHKERRQ(ierr);
+      ierr = MatDenseGetLDA(AX,&ldt);CHKERRQ(ierr);
+      ierr = MatDenseGetArray(AX,&t);CHKERRQ(ierr);
+      for (j=0; j<p; j++) for (i=0; i<n; i++) blk.Z[i+j*n] -= t[i+j*ldt];
+      ierr = MatDenseRestoreArray(AX,&t);CHKERRQ(ierr);
+    }
+    if (ksp->pc_side == PC_LEFT) {
+      ierr = PetscObjectStateIncrease((PetscObject)Zm);CHKERRQ(ierr);
+      ierr = PCMatApply(ksp->pc,Zm,V0m);CHKERRQ(ierr);
+    } else {
+      ierr = PetscMemcpy(blk.V,blk.Z,n*p*sizeof(PetscScalar));CHKERRQ(ierr);
+    }
+    ierr = PetscMemzero(blk.H,ldh*m*p*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMemzero(blk.Gq,ldh*p*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = KSPGMRESBlockOrthogonalize_Private(ksp,&blk,0,p,blk.Gq,ldh,&k);CHKERRQ(ierr);
+    for (j=0; j<p; j++) {
+      rnorm[j] = PetscSqrtReal(blk.s[j]);
+      if (first) rnorm0[j] = rnorm[j];
+    }
+    first = PETSC_FALSE;
+    ierr  = KSPBlockConverged_Private(ksp,p,rnorm0,rnorm);CHKERRQ(ierr);
+    if (ksp->reason) break;
+
+    /* block Arnoldi */
+    blk.Kb[0] = 0;
+    blk.kb[0] = k;
+    for (nb=0; nb<m && !ksp->reason && blk.kb[nb]; nb++) {
+      K = blk.Kb[nb];
+      k = blk.kb[nb];
+      blk.Kb[nb+1] = K+k;
+      if (km != k) {
+        km   = k;
+        ierr = MatDestroy(&Vm);CHKERRQ(ierr);
+        ierr = MatDestroy(&Wm);CHKERRQ(ierr);
+        ierr = MatDestroy(&Um);CHKERRQ(ierr);
+        ierr = MatDestroy(&Tm);CHKERRQ(ierr);
+        ierr = KSPGMRESBlockCreateMat_Private(ksp,&blk,k,blk.V,&Vm);CHKERRQ(ierr);
+        ierr = KSPGMRESBlockCreateMat_Private(ksp,&blk,k,blk.V,&Wm);CHKERRQ(ierr);
+        ierr = KSPGMRESBlockCreateMat_Private(ksp,&blk,k,U,&Um);CHKERRQ(ierr);
+      }
+      ierr = MatDensePlaceArray(Vm,blk.V+K*n);CHKERRQ(ierr);
+      if (ksp->pc_side == PC_LEFT) {
+        ierr = MatDensePlaceArray(Wm,blk.V+(K+k)*n);CHKERRQ(ierr);
+        ierr = KSPMatMatMult_Private(A,Vm,Tm ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,&Tm);CHKERRQ(ierr);
+        ierr = PCMatApply(ksp->pc,Tm,Wm);CHKERRQ(ierr);
+        ierr = MatDenseResetArray(Wm);CHKERRQ(ierr);
+      } else {
+        ierr = PCMatApply(ksp->pc,Vm,Um);CHKERRQ(ierr);
+        ierr = KSPMatMatMult_Private(A,Um,Tm ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,&Tm);CHKERRQ(ierr);
+        ierr = MatDenseGetLDA(Tm,&ldt);CHKERRQ(ierr);
+        ierr = MatDenseGetArray(Tm,&t);CHKERRQ(ierr);
+        for (j=0; j<k; j++) {ierr = PetscMemcpy(blk.V+(K+k+j)*n,t+j*ldt,n*sizeof(PetscScalar));CHKERRQ(ierr);}
+        ierr = MatDenseRestoreArray(Tm,&t);CHKERRQ(ierr);
+      }
+      ierr = MatDenseResetArray(Vm);CHKERRQ(ierr);
+      ierr = KSPGMRESBlockOrthogonalize_Private(ksp,&blk,K+k,k,blk.H+K*ldh,ldh,&blk.kb[nb+1]);CHKERRQ(ierr);
+      ierr = KSPGMRESBlockUpdateHessenberg_Private(ksp,&blk,nb);CHKERRQ(ierr);
+
+      /* the residual norms are the norms of the rows of the right-hand sides below the triangular part */
+      for (c=0; c<p; c++) {
+        for (rnorm[c]=0.0,i=0; i<blk.kb[nb+1]; i++) rnorm[c] += PetscRealPart(PetscConj(blk.Gq[K+k+i+c*ldh])*blk.Gq[K+k+i+c*ldh]);
+        rnorm[c] = PetscSqrtReal(rnorm[c]);
+      }
+      ksp->its++;
+      if (!blk.kb[nb+1]) {
+        /* the block Krylov space is invariant up to the dropped vectors, which the least-squares residuals ignore, so
+           the convergence is tested on the true residuals after the restart */
+        ierr = PetscInfo1(ksp,"Invariant block Krylov space at iteration %D, restarting\n",ksp->its);CHKERRQ(ierr);
+      } else {
+        ierr = KSPBlockConverged_Private(ksp,p,rnorm0,rnorm);CHKERRQ(ierr);
+      }
+    }
+
+    /* X = X + V Y (or M V Y with right preconditioning), where R Y = Gq */
+    K    = blk.Kb[nb];
+    ierr = PetscBLASIntCast(K,&bK);CHKERRQ(ierr);
+    for (i=0; i<K; i++) {
+      if (blk.H[i+i*ldh] == 0.0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_CONV_FAILED,"Singular block Hessenberg matrix at iteration %D",ksp->its);
+    }
+    if (K) PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","U","N","N",&bK,&bp,&one,blk.H,&bldh,blk.Gq,&bldh));
+    ierr = PetscLogFlops(1.0*K*K*p);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(X,&x);CHKERRQ(ierr);
+    if (ksp->pc_side == PC_LEFT) {
+      if (n && K) PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bp,&bK,&one,blk.V,&bn,blk.Gq,&bldh,&one,x,&bldx));
+    } else {
+      PetscScalar zero = 0.0;
+
+      ierr = MatDenseRestoreArray(X,&x);CHKERRQ(ierr);
+      if (n && K) PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bp,&bK,&one,blk.V,&bn,blk.Gq,&bldh,&zero,blk.Z,&bn));
+      else {ierr = PetscMemzero(blk.Z,n*p*sizeof(PetscScalar));CHKERRQ(ierr);}
+      ierr = PetscObjectStateIncrease((PetscObject)Zm);CHKERRQ(ierr);
+      ierr = PCMatApply(ksp->pc,Zm,Upm);CHKERRQ(ierr);
+      ierr = MatDenseGetArray(X,&x);CHKERRQ(ierr);
+      for (j=0; j<p; j++) for (i=0; i<n; i++) x[i+j*ldx] += U[i+j*n];
+    }
+    ierr = MatDenseRestoreArray(X,&x);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*n*K*p);CHKERRQ(ierr);
+  }
+
+  ierr = MatDestroy(&Vm);CHKERRQ(ierr);
+  ierr = MatDestroy(&Wm);CHKERRQ(ierr);
+  ierr = MatDestroy(&Um);CHKERRQ(ierr);
+  ierr = MatDestroy(&Tm);CHKERRQ(ierr);
+  ierr = MatDestroy(&AX);CHKERRQ(ierr);
+  ierr = MatDestroy(&Zm);CHKERRQ(ierr);
+  ierr = MatDestroy(&Upm);CHKERRQ(ierr);
+  ierr = MatDestroy(&V0m);CHKERRQ(ierr);
+  ierr = PetscFree5(blk.V,blk.H,blk.tau,blk.Gq,blk.Z);CHKERRQ(ierr);
+  ierr = PetscFree5(blk.buf,blk.G,blk.R,blk.work,U);CHKERRQ(ierr);
+  ierr = PetscFree6(blk.s,blk.t,blk.d,blk.perm,blk.Kb,blk.kb);CHKERRQ(ierr);
+  ierr = PetscFree2(rnorm0,rnorm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,859 @@
+
+/*
+    This file implements SGMRES, the s-step (communication-avoiding) GMRES method.
+
+    Each block builds s vectors of the Krylov space, with the monomial or the Newton basis, and orthogonalizes them
+    together against the previous basis vectors and among themselves with a block classical Gram-Schmidt and a Cholesky
+    QR factorization: all the inner products of the block come from a single global reduction. The columns of the
+    Hessenberg matrix are then recovered from the change of basis and the triangular factors.
+*/
+
+#include <../src/ksp/ksp/impls/gmres/sgmres/sgmresimpl.h>       /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+#define SGMRES_DELTA_DIRECTIONS 10
+#define SGMRES_DEFAULT_MAXK     30
+
+static PetscErrorCode KSPSGMRESUpdateHessenberg(KSP,PetscInt,PetscBool*,PetscReal*);
+static PetscErrorCode KSPSGMRESBuildSoln(PetscScalar*,Vec,Vec,KSP,PetscInt);
+
+/*
+    KSPSetUp_SGMRES - Sets up the workspace needed by sgmres: the one of GMRES, the space to compute the Ritz values
+    used as shifts of the Newton basis, and the small dense matrices of a block.
+*/
+static PetscErrorCode KSPSetUp_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       max_k,s = sgmres->s;
+
+  PetscFunctionBegin;
+  ierr  = KSPSetUp_GMRES(ksp);CHKERRQ(ierr);
+  max_k = sgmres->max_k;
+  if (!sgmres->Rsvd) {
+    ierr = PetscMalloc1((max_k + 3)*(max_k + 9),&sgmres->Rsvd);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,(max_k + 3)*(max_k + 9)*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMalloc1(6*(max_k+2),&sgmres->Dsvd);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,6*(max_k+2)*sizeof(PetscReal));CHKERRQ(ierr);
+  }
+  if (!sgmres->orthogwork) {
+    ierr = PetscMalloc1(max_k + 2,&sgmres->orthogwork);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,(max_k + 2)*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  /* the restart may have changed since the last setup */
+  ierr = PetscFree3(sgmres->shr,sgmres->shi,sgmres->wnorm);CHKERRQ(ierr);
+  ierr = PetscFree4(sgmres->C,sgmres->C2,sgmres->R,sgmres->R2);CHKERRQ(ierr);
+  ierr = PetscFree4(sgmres->G,sgmres->Rf,sgmres->T,sgmres->Bs);CHKERRQ(ierr);
+  ierr = PetscMalloc3(s,&sgmres->shr,s,&sgmres->shi,s,&sgmres->wnorm);CHKERRQ(ierr);
+  ierr = PetscMalloc4((max_k+1)*s,&sgmres->C,(max_k+1)*s,&sgmres->C2,s*s,&sgmres->R,s*s,&sgmres->R2);CHKERRQ(ierr);
+  ierr = PetscMalloc4(s*s,&sgmres->G,(max_k+2)*(s+1),&sgmres->Rf,(max_k+2)*s,&sgmres->T,(s+1)*s,&sgmres->Bs);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,3*s*sizeof(PetscReal)+(2*(max_k+1)*s+3*s*s+(max_k+2)*(2*s+1)+(s+1)*s)*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes, with a single global reduction, the projections C = Q'W of the new block W = VV(it+1),...,VV(it+sb) on
+   Q = VV(0),...,VV(it) and the Cholesky factor R of W'W - C'C, which is the Gram matrix of the projected block.
+
+   The rank is the number of leading columns whose factorization succeeded and that are not numerically dependent on
+   the previous ones.
+*/
+static PetscErrorCode KSPSGMRESGram_Private(KSP ksp,PetscInt it,PetscInt sb,PetscScalar *C,PetscScalar *R,PetscInt *rank)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       m = it+1,ldc = sgmres->max_k+1,ld = sgmres->s,i,k,l;
+  PetscBLASInt   bn,bld,info;
+  Vec            *Q = &VEC_VV(0),*W = &VEC_VV(it+1);
+  PetscScalar    t;
+
+  PetscFunctionBegin;
+  for (k=0; k<sb; k++) {
+    ierr = VecMDotBegin(W[k],m,Q,C+k*ldc);CHKERRQ(ierr);
+    ierr = VecMDotBegin(W[k],k+1,W,R+k*ld);CHKERRQ(ierr);
+  }
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)W[0]));CHKERRQ(ierr);
+  for (k=0; k<sb; k++) {
+    ierr = VecMDotEnd(W[k],m,Q,C+k*ldc);CHKERRQ(ierr);
+    ierr = VecMDotEnd(W[k],k+1,W,R+k*ld);CHKERRQ(ierr);
+  }
+  sgmres->nreductions++;
+
+  for (k=0; k<sb; k++) {
+    sgmres->wnorm[k] = PetscSqrtReal(PetscAbsScalar(R[k+k*ld]));
+    for (i=0; i<=k; i++) {
+      for (t=0.0,l=0; l<m; l++) t += PetscConj(C[l+i*ldc])*C[l+k*ldc];
+      R[i+k*ld] -= t;
+    }
+    for (i=k+1; i<sb; i++) R[i+k*ld] = 0.0;
+  }
+  ierr = PetscBLASIntCast(sb,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ld,&bld);CHKERRQ(ierr);
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bn,R,&bld,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+  *rank = info ? info-1 : sb;
+  for (k=0; k<*rank; k++) {
+    if (PetscRealPart(R[k+k*ld]) <= PETSC_SQRT_MACHINE_EPSILON*sgmres->wnorm[k]) {*rank = k; break;}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Replaces the first n vectors of the new block by W R^{-1} after subtracting Q C
+*/
+static PetscErrorCode KSPSGMRESNormalize_Private(KSP ksp,PetscInt it,PetscInt n,const PetscScalar *C,const PetscScalar *R)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       m = it+1,ldc = sgmres->max_k+1,ld = sgmres->s,i,k;
+  PetscScalar    *coef = sgmres->orthogwork;
+
+  PetscFunctionBegin;
+  for (k=0; k<n; k++) {
+    for (i=0; i<m; i++) coef[i] = -C[i+k*ldc];
+    for (i=0; i<k; i++) coef[m+i] = -R[i+k*ld];
+    ierr = VecMAXPY(VEC_VV(it+1+k),m+k,coef,&VEC_VV(0));CHKERRQ(ierr);
+    ierr = VecScale(VEC_VV(it+1+k),1.0/R[k+k*ld]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orthonormalizes the new block VV(it+1),...,VV(it+sb) against the previous basis vectors and computes the factors of
+
+     [VV(it+1),...,VV(it+sb)] = [VV(0),...,VV(it)] C + [VV(it+1),...,VV(it+rank)] R
+
+   with CholQR, followed by a second pass (CholQR2) when requested by the CGS refinement type. When the Cholesky
+   factorization breaks down, the block is explicitly projected and factored again, and only its leading columns of
+   full numerical rank are kept.
+*/
+static PetscErrorCode KSPSGMRESBlockOrthogonalize_Private(KSP ksp,PetscInt it,PetscInt sb,PetscInt *rank)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       m = it+1,ldc = sgmres->max_k+1,ld = sgmres->s,rk,i,k,l;
+  PetscScalar    *C = sgmres->C,*C2 = sgmres->C2,*R = sgmres->R,*R2 = sgmres->R2,*G = sgmres->G,*coef = sgmres->orthogwork;
+  PetscScalar    t;
+  PetscBool      refine;
+
+  PetscFunctionBegin;
+  ierr = KSPSGMRESGram_Private(ksp,it,sb,C,R,&rk);CHKERRQ(ierr);
+  if (rk == sb) {
+    refine = (PetscBool)(sgmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS);
+    if (sgmres->cgstype == KSP_GMRES_CGS_REFINE_IFNEEDED) {
+      /* the loss of orthogonality of CholQR grows like the square of the condition number of the block */
+      for (k=0; k<sb; k++) {
+        if (PetscRealPart(R[k+k*ld]) < PetscSqrtReal(PETSC_SQRT_MACHINE_EPSILON)*sgmres->wnorm[k]) refine = PETSC_TRUE;
+      }
+    }
+    ierr = KSPSGMRESNormalize_Private(ksp,it,sb,C,R);CHKERRQ(ierr);
+    if (refine) {
+      ierr = KSPSGMRESGram_Private(ksp,it,sb,C2,R2,&rk);CHKERRQ(ierr);
+      ierr = KSPSGMRESNormalize_Private(ksp,it,rk,C2,R2);CHKERRQ(ierr);
+      if (!rk) R2[0] = 0.0;
+      /* C <- C + C2 R, R <- R2 R */
+      for (k=0; k<PetscMax(rk,1); k++) {
+        for (i=0; i<=k; i++) {
+          for (l=0; l<m; l++) C[l+k*ldc] += C2[l+i*ldc]*R[i+k*ld];
+          for (t=0.0,l=i; l<=k; l++) t += R2[i+l*ld]*R[l+k*ld];
+          G[i+k*ld] = t;
+        }
+      }
+      for (k=0; k<PetscMax(rk,1); k++) {
+        for (i=0; i<=k; i++) R[i+k*ld] = G[i+k*ld];
+      }
+    }
+  } else {
+    ierr = PetscInfo2(ksp,"Cholesky QR of the block at iteration %D broke down at column %D, projecting explicitly\n",ksp->its,rk);CHKERRQ(ierr);
+    for (k=0; k<sb; k++) {
+      for (i=0; i<m; i++) coef[i] = -C[i+k*ldc];
+      ierr = VecMAXPY(VEC_VV(it+1+k),m,coef,&VEC_VV(0));CHKERRQ(ierr);
+    }
+    ierr = KSPSGMRESGram_Private(ksp,it,sb,C2,R,&rk);CHKERRQ(ierr);
+    ierr = KSPSGMRESNormalize_Private(ksp,it,rk,C2,R);CHKERRQ(ierr);
+    if (!rk) R[0] = 0.0;
+    for (k=0; k<PetscMax(rk,1); k++) {
+      for (l=0; l<m; l++) C[l+k*ldc] += C2[l+k*ldc];
+    }
+  }
+  if (rk < sb) {ierr = PetscInfo3(ksp,"Kept %D of the %D vectors of the block at iteration %D\n",rk,sb,ksp->its);CHKERRQ(ierr);}
+  *rank = rk;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orders the Ritz values with the (modified) Leja ordering, conjugate pairs being kept together with the one with a
+   positive imaginary part first, and stores the first s of them, repeated if needed, as the shifts of the Newton basis
+*/
+static PetscErrorCode KSPSGMRESLejaOrdering_Private(KSP ksp,PetscInt n,const PetscReal *rr,const PetscReal *ri)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       i,j,best,cnt = 0;
+  PetscReal      *lr,*li,val,bestval,d;
+  PetscBool      *used;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(n+1,&lr,n+1,&li,n,&used);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+#if defined(PETSC_USE_COMPLEX)
+    used[i] = PETSC_FALSE;
+#else
+    used[i] = (PetscBool)(ri[i] < 0.0); /* the conjugate is added with its pair */
+#endif
+  }
+  while (cnt < n) {
+    best = -1; bestval = PETSC_MIN_REAL;
+    for (i=0; i<n; i++) {
+      if (used[i]) continue;
+      if (!cnt) val = PetscSqrtReal(rr[i]*rr[i]+ri[i]*ri[i]);
+      else {
+        for (val=0.0,j=0; j<cnt; j++) {
+          d = PetscSqrtReal((rr[i]-lr[j])*(rr[i]-lr[j])+(ri[i]-li[j])*(ri[i]-li[j]));
+          if (d == 0.0) {val = PETSC_MIN_REAL; break;}
+          val += PetscLogReal(d);
+        }
+      }
+      if (best < 0 || val > bestval) {best = i; bestval = val;}
+    }
+    if (best < 0) break;
+    used[best] = PETSC_TRUE;
+    lr[cnt]    = rr[best];
+    li[cnt++]  = ri[best];
+#if !defined(PETSC_USE_COMPLEX)
+    if (ri[best] > 0.0) {
+      lr[cnt]   = rr[best];
+      li[cnt++] = -ri[best];
+    }
+#endif
+  }
+  for (i=0; i<sgmres->s; i++) {
+    sgmres->shr[i] = lr[i%cnt];
+    sgmres->shi[i] = li[i%cnt];
+  }
+  ierr = PetscFree3(lr,li,used);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the new block VV(it+1),...,VV(it+sb) from VV(it) and the change of basis Bs, A VV(it+i) = sum_j VV(it+j) Bs(j,i)
+*/
+static PetscErrorCode KSPSGMRESBuildBasis_Private(KSP ksp,PetscInt it,PetscInt sb,PetscBool newton)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       ldb = sgmres->s+1,i;
+  PetscScalar    *Bs = sgmres->Bs;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(Bs,(sgmres->s+1)*sgmres->s*sizeof(PetscScalar));CHKERRQ(ierr);
+  for (i=0; i<sb; i++) {
+    if (sgmres->vv_allocated <= it + i + VEC_OFFSET + 1) {
+      ierr = KSPGMRESGetNewVectors(ksp,it+i+1);CHKERRQ(ierr);
+    }
+    ierr = KSP_PCApplyBAorAB(ksp,VEC_VV(it+i),VEC_VV(it+i+1),VEC_TEMP_MATOP);CHKERRQ(ierr);
+    if (newton) {
+#if defined(PETSC_USE_COMPLEX)
+      PetscScalar theta = PetscCMPLX(sgmres->shr[i],sgmres->shi[i]);
+
+      ierr            = VecAXPY(VEC_VV(it+i+1),-theta,VEC_VV(it+i));CHKERRQ(ierr);
+      Bs[i+i*ldb]     = theta;
+#else
+      if (i && sgmres->shi[i] < 0.0) {
+        /* second shift of a complex conjugate pair, the basis stays real */
+        ierr            = VecAXPBYPCZ(VEC_VV(it+i+1),-sgmres->shr[i],sgmres->shi[i]*sgmres->shi[i],1.0,VEC_VV(it+i),VEC_VV(it+i-1));CHKERRQ(ierr);
+        Bs[i-1+i*ldb]   = -sgmres->shi[i]*sgmres->shi[i];
+      } else {
+        ierr = VecAXPY(VEC_VV(it+i+1),-sgmres->shr[i],VEC_VV(it+i));CHKERRQ(ierr);
+      }
+      Bs[i+i*ldb] = sgmres->shr[i];
+#endif
+    }
+    Bs[i+1+i*ldb] = 1.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the columns it,...,it+n-1 of the Hessenberg matrix. With Rf the coordinates of the Krylov block
+   [VV(it),Z_1,...,Z_n] in the orthonormal basis,
+
+     A [V_0,...,V_{it+n-1}] Rf(0:it+n-1,0:n-1) = [V_0,...,V_{it+n}] Rf Bs
+
+   and the columns it,...,it+n-1 of the Hessenberg matrix are (Rf Bs - H_{it} Rf(0:it-1,0:n-1)) Rf(it:it+n-1,0:n-1)^{-1}
+*/
+static PetscErrorCode KSPSGMRESBlockHessenberg_Private(KSP ksp,PetscInt it,PetscInt n)
+{
+  KSP_SGMRES  *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt    m = it+1,nrow = it+1+n,ldc = sgmres->max_k+1,ld = sgmres->s,ldf = sgmres->max_k+2,ldb = sgmres->s+1,a,i,j,k,l;
+  PetscScalar *C = sgmres->C,*R = sgmres->R,*Rf = sgmres->Rf,*T = sgmres->T,*Bs = sgmres->Bs,t;
+
+  PetscFunctionBegin;
+  for (k=0; k<=n; k++) {
+    for (a=0; a<nrow; a++) Rf[a+k*ldf] = 0.0;
+  }
+  Rf[it] = 1.0;
+  for (k=0; k<n; k++) {
+    for (a=0; a<m; a++) Rf[a+(k+1)*ldf] = C[a+k*ldc];
+    for (i=0; i<=k; i++) Rf[m+i+(k+1)*ldf] = R[i+k*ld];
+  }
+  for (k=0; k<n; k++) {
+    for (a=0; a<nrow; a++) {
+      for (t=0.0,j=0; j<=n; j++) t += Rf[a+j*ldf]*Bs[j+k*ldb];
+      T[a+k*ldf] = t;
+    }
+    for (a=0; a<m; a++) {
+      for (t=0.0,l=PetscMax(a-1,0); l<it; l++) t += *HES(a,l)*Rf[l+k*ldf];
+      T[a+k*ldf] -= t;
+    }
+    for (i=0; i<k; i++) {
+      for (a=0; a<nrow; a++) T[a+k*ldf] -= T[a+i*ldf]*Rf[it+i+k*ldf];
+    }
+    for (a=0; a<nrow; a++) T[a+k*ldf] /= Rf[it+k+k*ldf];
+  }
+  for (k=0; k<n; k++) {
+    for (a=0; a<=it+k+1; a++) *HH(a,it+k) = T[a+k*ldf];
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSGMRESCycle - Run sgmres, possibly with restart.
+
+    input parameters:
+.        sgmres  - structure containing parameters and work areas
+
+    output parameters:
+.        itcount - number of iterations used.  If null, ignored.
+
+    Notes:
+    On entry, the value in vector VEC_VV(0) should be
+    the initial residual.
+ */
+static PetscErrorCode KSPSGMRESCycle(PetscInt *itcount,KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)(ksp->data);
+  PetscReal      res_norm,res;
+  PetscErrorCode ierr;
+  PetscInt       it = 0,max_k = sgmres->max_k,sb,rank,k;
+  PetscBool      hapend = PETSC_FALSE,newton;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  ierr   = VecNormalize(VEC_VV(0),&res_norm);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res_norm);
+  sgmres->nreductions++;
+  res    = res_norm;
+  *RS(0) = res_norm;
+
+  /* check for the convergence */
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = res;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  sgmres->it = it-1;
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    sb     = PetscMin(sgmres->sb,PetscMin(max_k-it,ksp->max_it-ksp->its));
+    newton = (PetscBool)(sgmres->basis == KSP_SSTEP_BASIS_NEWTON && sgmres->haveshifts);
+    ierr   = KSPSGMRESBuildBasis_Private(ksp,it,sb,newton);CHKERRQ(ierr);
+    ierr   = KSPSGMRESBlockOrthogonalize_Private(ksp,it,sb,&rank);CHKERRQ(ierr);
+    if (!rank && (it || sb > 1)) {
+      /*
+         No vector of the block is independent of the basis: either the basis lost its orthogonality or the block is
+         too ill-conditioned, the residual estimate of a zero subdiagonal would be wrong. Smaller blocks are used for the
+         rest of the solve, after a restart that recomputes the residual if the basis is not reduced to VV(0).
+      */
+      sgmres->sb = PetscMax(sb/2,1);
+      ierr = PetscInfo4(ksp,"No vector of the block of %D steps at iteration %D is kept, %s with blocks of %D steps\n",sb,ksp->its,it ? "restarting" : "retrying",sgmres->sb);CHKERRQ(ierr);
+      if (it) break;
+      continue;
+    }
+    sb     = PetscMax(rank,1);
+    ierr   = KSPSGMRESBlockHessenberg_Private(ksp,it,sb);CHKERRQ(ierr);
+
+    for (k=0; k<sb; k++) {
+      ierr = KSPSGMRESUpdateHessenberg(ksp,it,&hapend,&res);CHKERRQ(ierr);
+      sgmres->it = it;
+      it++;
+      ksp->its++;
+      ksp->rnorm = res;
+      if (ksp->reason) break;
+
+      ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (it < max_k || ksp->reason || ksp->its == ksp->max_it) {  /* Monitor if we are done or still iterating, but not before a restart. */
+        ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+        ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+      }
+      if (ksp->reason) break;
+      /* Catch error in happy breakdown and signal convergence and break from loop */
+      if (hapend) {
+        if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+        else {
+          ksp->reason = KSP_DIVERGED_BREAKDOWN;
+          break;
+        }
+      }
+    }
+
+    if (!ksp->reason && sgmres->basis == KSP_SSTEP_BASIS_NEWTON && !sgmres->haveshifts) {
+      /* the Ritz values of the first (monomial) block are the shifts of the Newton basis */
+      PetscReal *rr,*ri;
+      PetscInt  neig;
+
+      ierr = PetscMalloc2(max_k,&rr,max_k,&ri);CHKERRQ(ierr);
+      ierr = KSPComputeEigenvalues_GMRES(ksp,max_k,rr,ri,&neig);CHKERRQ(ierr);
+      if (neig) {
+        ierr = KSPSGMRESLejaOrdering_Private(ksp,neig,rr,ri);CHKERRQ(ierr);
+        sgmres->haveshifts = PETSC_TRUE;
+        ierr = PetscInfo1(ksp,"Computed the shifts of the Newton basis from %D Ritz values\n",neig);CHKERRQ(ierr);
+      }
+      ierr = PetscFree2(rr,ri);CHKERRQ(ierr);
+    }
+  }
+
+  if (itcount) *itcount = it;
+
+  /*
+    Down here we have to solve for the "best" coefficients of the Krylov
+    columns, add the solution values together, and possibly unwind the
+    preconditioning from the solution
+   */
+  /* Form the solution (or the solution so far) */
+  ierr = KSPSGMRESBuildSoln(RS(0),ksp->vec_sol,ksp->vec_sol,ksp,it-1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSolve_SGMRES - This routine applies the SGMRES method.
+
+   Input Parameter:
+.     ksp - the Krylov space object that was set to use sgmres
+
+   Output Parameter:
+.     outits - number of iterations used
+
+*/
+static PetscErrorCode KSPSolve_SGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+  PetscInt       its,itcount;
+  KSP_SGMRES     *sgmres    = (KSP_SGMRES*)ksp->data;
+  PetscBool      guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  itcount             = 0;
+  sgmres->nreductions = 0;
+  sgmres->haveshifts  = PETSC_FALSE;
+  sgmres->sb          = sgmres->s;
+  ksp->reason         = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr     = KSPInitialResidual(ksp,ksp->vec_sol,VEC_TEMP,VEC_TEMP_MATOP,VEC_VV(0),ksp->vec_rhs);CHKERRQ(ierr);
+    ierr     = KSPSGMRESCycle(&its,ksp);CHKERRQ(ierr);
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(sgmres->shr,sgmres->shi,sgmres->wnorm);CHKERRQ(ierr);
+  ierr = PetscFree4(sgmres->C,sgmres->C2,sgmres->R,sgmres->R2);CHKERRQ(ierr);
+  ierr = PetscFree4(sgmres->G,sgmres->Rf,sgmres->T,sgmres->Bs);CHKERRQ(ierr);
+  ierr = KSPReset_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(sgmres->shr,sgmres->shi,sgmres->wnorm);CHKERRQ(ierr);
+  ierr = PetscFree4(sgmres->C,sgmres->C2,sgmres->R,sgmres->R2);CHKERRQ(ierr);
+  ierr = PetscFree4(sgmres->G,sgmres->Rf,sgmres->T,sgmres->Bs);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetBasisType_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroy_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSGMRESBuildSoln - create the solution from the starting vector and the
+                      current iterates.
+
+    Input parameters:
+        nrs - work area of size it + 1.
+        vguess  - index of initial guess
+        vdest - index of result.  Note that vguess may == vdest (replace
+                guess with the solution).
+        it - HH upper triangular part is a block of size (it+1) x (it+1)
+
+     This is an internal routine that knows about the SGMRES internals.
+ */
+static PetscErrorCode KSPSGMRESBuildSoln(PetscScalar *nrs,Vec vguess,Vec vdest,KSP ksp,PetscInt it)
+{
+  PetscScalar    tt;
+  PetscErrorCode ierr;
+  PetscInt       k,j;
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)(ksp->data);
+
+  PetscFunctionBegin;
+  /* Solve for solution vector that minimizes the residual */
+
+  if (it < 0) {                                 /* no sgmres steps have been performed */
+    ierr = VecCopy(vguess,vdest);CHKERRQ(ierr); /* VecCopy() is smart, exits immediately if vguess == vdest */
+    PetscFunctionReturn(0);
+  }
+
+  /* solve the upper triangular system - RS is the right side and HH is
+     the upper triangular matrix  - put soln in nrs */
+  if (*HH(it,it) != 0.0) nrs[it] = *RS(it) / *HH(it,it);
+  else nrs[it] = 0.0;
+
+  for (k=it-1; k>=0; k--) {
+    tt = *RS(k);
+    for (j=k+1; j<=it; j++) tt -= *HH(k,j) * nrs[j];
+    nrs[k] = tt / *HH(k,k);
+  }
+
+  /* Accumulate the correction to the solution of the preconditioned problem in TEMP */
+  ierr = VecZeroEntries(VEC_TEMP);CHKERRQ(ierr);
+  ierr = VecMAXPY(VEC_TEMP,it+1,nrs,&VEC_VV(0));CHKERRQ(ierr);
+  ierr = KSPUnwindPreconditioner(ksp,VEC_TEMP,VEC_TEMP_MATOP);CHKERRQ(ierr);
+  /* add solution to previous solution */
+  if (vdest == vguess) {
+    ierr = VecAXPY(vdest,1.0,VEC_TEMP);CHKERRQ(ierr);
+  } else {
+    ierr = VecWAXPY(vdest,1.0,VEC_TEMP,vguess);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSGMRESUpdateHessenberg - Applies the plane rotations to the column it of the Hessenberg matrix, after saving
+    it for the computation of the Ritz values and of the next blocks. Return new residual.
+ */
+static PetscErrorCode KSPSGMRESUpdateHessenberg(KSP ksp,PetscInt it,PetscBool *hapend,PetscReal *res)
+{
+  PetscScalar    *hh,*cc,*ss,*rs;
+  PetscInt       j;
+  PetscReal      hapbnd;
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)(ksp->data);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  hh = HH(0,it);   /* pointer to beginning of column to update */
+  cc = CC(0);      /* beginning of cosine rotations */
+  ss = SS(0);      /* beginning of sine rotations */
+  rs = RS(0);      /* right hand side of least squares system */
+
+  /* The Hessenberg matrix is now correct through column it, save that form for possible spectral analysis */
+  for (j=0; j<=it+1; j++) *HES(j,it) = hh[j];
+
+  /* check for the happy breakdown */
+  hapbnd = PetscMin(PetscAbsScalar(hh[it+1] / rs[it]),sgmres->haptol);
+  if (PetscAbsScalar(hh[it+1]) < hapbnd) {
+    ierr    = PetscInfo4(ksp,"Detected happy breakdown, current hapbnd = %14.12e H(%D,%D) = %14.12e\n",(double)hapbnd,it+1,it,(double)PetscAbsScalar(*HH(it+1,it)));CHKERRQ(ierr);
+    *hapend = PETSC_TRUE;
+  }
+
+  /* Apply all the previously computed plane rotations to the new column
+     of the Hessenberg matrix */
+  /* Note: this uses the rotation [conj(c)  s ; -s   c], c= cos(theta), s= sin(theta),
+     and some refs have [c   s ; -conj(s)  c] (don't be confused!) */
+
+  for (j=0; j<it; j++) {
+    PetscScalar hhj = hh[j];
+    hh[j]   = PetscConj(cc[j])*hhj + ss[j]*hh[j+1];
+    hh[j+1] =          -ss[j] *hhj + cc[j]*hh[j+1];
+  }
+
+  /* compute new plane rotation */
+  if (!*hapend) {
+    PetscReal delta = PetscSqrtReal(PetscSqr(PetscAbsScalar(hh[it])) + PetscSqr(PetscAbsScalar(hh[it+1])));
+    if (delta == 0.0) {
+      ksp->reason = KSP_DIVERGED_NULL;
+      PetscFunctionReturn(0);
+    }
+
+    cc[it] = hh[it] / delta;    /* new cosine value */
+    ss[it] = hh[it+1] / delta;  /* new sine value */
+
+    hh[it]   = PetscConj(cc[it])*hh[it] + ss[it]*hh[it+1];
+    rs[it+1] = -ss[it]*rs[it];
+    rs[it]   = PetscConj(cc[it])*rs[it];
+    *res     = PetscAbsScalar(rs[it+1]);
+  } else { /* happy breakdown: the residual of the least squares problem vanishes */
+    *res = 0.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_SGMRES(KSP ksp,Vec ptr,Vec *result)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!sgmres->sol_temp) {
+      ierr = VecDuplicate(ksp->vec_sol,&sgmres->sol_temp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)sgmres->sol_temp);CHKERRQ(ierr);
+    }
+    ptr = sgmres->sol_temp;
+  }
+  if (!sgmres->nrs) {
+    /* allocate the work area */
+    ierr = PetscMalloc1(sgmres->max_k,&sgmres->nrs);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,sgmres->max_k*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+
+  ierr = KSPSGMRESBuildSoln(sgmres->nrs,ksp->vec_sol,ptr,ksp,sgmres->it);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_SGMRES(KSP ksp,PetscViewer viewer)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, %D steps per block, %s basis\n",sgmres->max_k,sgmres->s,KSPSStepBasisTypes[sgmres->basis]);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  block Cholesky QR orthogonalization with %s\n",sgmres->cgstype == KSP_GMRES_CGS_REFINE_NEVER ? "no second pass" : (sgmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS ? "a second pass" : "a second pass when needed"));CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  happy breakdown tolerance %g\n",(double)sgmres->haptol);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  global reductions in the last solve %D\n",sgmres->nreductions);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"restart %D s %D basis %s",sgmres->max_k,sgmres->s,KSPSStepBasisTypes[sgmres->basis]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SGMRES(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_SGMRES        *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode    ierr;
+  PetscInt          s = sgmres->s;
+  KSPSStepBasisType basis = sgmres->basis;
+  PetscBool         flg;
+
+  PetscFunctionBegin;
+  ierr = KSPSetFromOptions_GMRES(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP s-step GMRES Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_sgmres_steps","Number of Krylov vectors built and orthogonalized together","KSPSGMRESSetSteps",s,&s,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSGMRESSetSteps(ksp,s);CHKERRQ(ierr);}
+  ierr = PetscOptionsEnum("-ksp_sgmres_basis","Polynomial basis of the Krylov space","KSPSGMRESSetBasisType",KSPSStepBasisTypes,(PetscEnum)basis,(PetscEnum*)&basis,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSGMRESSetBasisType(ksp,basis);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESSetSteps_SGMRES(KSP ksp,PetscInt s)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps per block %D must be positive",s);
+  if (!ksp->setupstage) {
+    sgmres->s = s;
+  } else if (sgmres->s != s) {
+    /* free the data structures, then create them again */
+    ierr = KSPReset_SGMRES(ksp);CHKERRQ(ierr);
+    sgmres->s       = s;
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESSetBasisType_SGMRES(KSP ksp,KSPSStepBasisType basis)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES*)ksp->data;
+
+  PetscFunctionBegin;
+  if (basis == KSP_SSTEP_BASIS_CHEBYSHEV) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"The Chebyshev basis needs a real spectrum, use the Newton basis");
+  sgmres->basis = basis;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSGMRESSetSteps - Sets the number of Krylov vectors that the s-step GMRES method builds and orthogonalizes together
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  s - the number of vectors per block, 4 by default
+
+   Options Database:
+.  -ksp_sgmres_steps <s>
+
+   Notes:
+   The blocks are shortened at the end of each restart cycle. Large values of s make the basis ill conditioned, and
+   some vectors of the block may then be dropped, see KSPSGMRES.
+
+   Level: intermediate
+
+.seealso: KSPSGMRES, KSPSGMRESSetBasisType(), KSPGMRESSetRestart()
+@*/
+PetscErrorCode KSPSGMRESSetSteps(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,s,2);
+  ierr = PetscTryMethod(ksp,"KSPSGMRESSetSteps_C",(KSP,PetscInt),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSGMRESSetBasisType - Sets the polynomial basis of the Krylov space of the s-step GMRES method
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  basis - KSP_SSTEP_BASIS_MONOMIAL or KSP_SSTEP_BASIS_NEWTON (the default)
+
+   Options Database:
+.  -ksp_sgmres_basis <monomial,newton>
+
+   Notes:
+   The shifts of the Newton basis are the Ritz values of the first block of each solve, which uses the monomial basis,
+   in Leja order.
+
+   Level: intermediate
+
+.seealso: KSPSGMRES, KSPSGMRESSetSteps(), KSPSStepBasisType
+@*/
+PetscErrorCode KSPSGMRESSetBasisType(KSP ksp,KSPSStepBasisType basis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,basis,2);
+  ierr = PetscTryMethod(ksp,"KSPSGMRESSetBasisType_C",(KSP,KSPSStepBasisType),(ksp,basis));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPSGMRES - Implements the s-step, or communication-avoiding, Generalized Minimal Residual method. It builds s
+     vectors of the Krylov space at a time and orthogonalizes them with a single global reduction, or two when a
+     second pass is needed, instead of one or two reductions per iteration for KSPGMRES.
+
+   Options Database Keys:
++   -ksp_gmres_restart <restart> - the number of Krylov directions to orthogonalize against
+.   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
+.   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
+                             vectors are allocated as needed)
+.   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if the Cholesky QR
+                                   factorization of each block is repeated (CholQR2), the default is refine_ifneeded
+.   -ksp_sgmres_steps <s> - the number of vectors per block (default 4)
+-   -ksp_sgmres_basis <monomial,newton> - the polynomial basis of the Krylov space (default newton)
+
+   Level: intermediate
+
+   Notes:
+   Each block applies the operator s times in a row, then computes the projections of the new vectors on the basis and
+   their Gram matrix in one reduction and orthogonalizes them with a block Gram-Schmidt and a Cholesky QR
+   factorization. With refine_ifneeded the factorization is repeated when it indicates a loss of orthogonality. When
+   the Cholesky factorization breaks down the block is projected explicitly, factored again, and its numerically
+   dependent vectors are dropped. The number of global reductions of the last solve is shown by KSPView().
+
+   The Newton basis uses the Ritz values of the first block of each solve, in Leja order, as shifts; complex conjugate
+   pairs keep the basis real in real arithmetic.
+
+   Only the orthogonalization is done by blocks: the operator is applied one vector at a time, so there is no matrix
+   powers kernel, and the convergence is monitored at every iteration as for KSPGMRES.
+
+   References:
++   1. - Z. Bai, D. Hu and L. Reichel, A Newton basis GMRES implementation, IMA J. Numer. Anal., 1994.
+.   2. - M. Hoemmen, Communication-avoiding Krylov subspace methods, PhD thesis, UC Berkeley, 2010.
+-   3. - T. Fukaya, Y. Nakatsukasa, Y. Yanagisawa and Y. Yamamoto, CholeskyQR2: a simple and communication-avoiding
+         algorithm for computing a tall-skinny QR factorization on a large-scale parallel system, 2014.
+
+   Developer Notes:
+    This object is subclassed off of KSPGMRES
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPPGMRES, KSPAGMRES, KSPSCG,
+           KSPSGMRESSetSteps(), KSPSGMRESSetBasisType(), KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(),
+           KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&sgmres);CHKERRQ(ierr);
+
+  ksp->data                              = (void*)sgmres;
+  ksp->ops->buildsolution                = KSPBuildSolution_SGMRES;
+  ksp->ops->setup                        = KSPSetUp_SGMRES;
+  ksp->ops->solve                        = KSPSolve_SGMRES;
+  ksp->ops->reset                        = KSPReset_SGMRES;
+  ksp->ops->destroy                      = KSPDestroy_SGMRES;
+  ksp->ops->view                         = KSPView_SGMRES;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_SGMRES;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetOrthogonalization_C",KSPGMRESSetOrthogonalization_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetOrthogonalization_C",KSPGMRESGetOrthogonalization_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetHapTol_C",KSPGMRESSetHapTol_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetCGSRefinementType_C",KSPGMRESSetCGSRefinementType_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetCGSRefinementType_C",KSPGMRESGetCGSRefinementType_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetSteps_C",KSPSGMRESSetSteps_SGMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetBasisType_C",KSPSGMRESSetBasisType_SGMRES);CHKERRQ(ierr);
+
+  sgmres->haptol         = 1.0e-30;
+  sgmres->q_preallocate  = 0;
+  sgmres->delta_allocate = SGMRES_DELTA_DIRECTIONS;
+  sgmres->orthog         = KSPGMRESClassicalGramSchmidtOrthogonalization;
+  sgmres->nrs            = 0;
+  sgmres->sol_temp       = 0;
+  sgmres->max_k          = SGMRES_DEFAULT_MAXK;
+  sgmres->Rsvd           = 0;
+  sgmres->orthogwork     = 0;
+  sgmres->cgstype        = KSP_GMRES_CGS_REFINE_IFNEEDED;
+  sgmres->s              = 4;
+  sgmres->basis          = KSP_SSTEP_BASIS_NEWTON;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,39 @@
+#if !defined(__SGMRES)
+#define __SGMRES
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+typedef struct {
+  KSPGMRESHEADER
+
+  /* s-step specific */
+  PetscInt          s;                    /* number of basis vectors built and orthogonalized together */
+  PetscInt          sb;                   /* number of steps of the blocks in this solve, reduced after a breakdown */
+  KSPSStepBasisType basis;
+  PetscBool         haveshifts;           /* the Newton shifts have been computed in this solve */
+  PetscReal         *shr,*shi;            /* real and imaginary parts of the shifts of the Newton basis, in Leja order */
+  PetscScalar       *C,*C2;               /* projections of the new block on the previous basis vectors */
+  PetscScalar       *R,*R2,*G;            /* triangular factors of the new block and Gram matrix */
+  PetscScalar       *Rf,*T,*Bs;           /* change of basis and Hessenberg matrix of the block */
+  PetscReal         *wnorm;               /* norms of the new vectors, to detect the loss of orthogonality */
+  PetscInt          nreductions;          /* number of global reductions in the last solve */
+} KSP_SGMRES;
+
+#define HH(a,b)  (sgmres->hh_origin + (b)*(sgmres->max_k+2)+(a))
+/* HH will be size (max_k+2)*(max_k+1)  -  think of HH as
+   being stored columnwise for access purposes. */
+#define HES(a,b) (sgmres->hes_origin + (b)*(sgmres->max_k+1)+(a))
+/* HES will be size (max_k + 1) * (max_k + 1) -
+   again, think of HES as being stored columnwise */
+#define CC(a)    (sgmres->cc_origin + (a)) /* CC will be length (max_k+1) - cosines */
+#define SS(a)    (sgmres->ss_origin + (a)) /* SS will be length (max_k+1) - sines */
+#define RS(a)    (sgmres->rs_origin + (a)) /* RS will be length (max_k+2) - rt side */
+
+/* vector names */
+#define VEC_OFFSET     2
+#define VEC_TEMP       sgmres->vecs[0]               /* work space */
+#define VEC_TEMP_MATOP sgmres->vecs[1]               /* work space */
+#define VEC_VV(i)      sgmres->vecs[VEC_OFFSET+i]    /* use to access
+                                                        othog basis vectors */
+#endif
@@ -0,0 +1,659 @@
+
+/*
+    This file implements mixed precision iterative refinement.
+
+    The outer iteration computes the residual r = b - A x in double precision, solves A d = r approximately with an
+    inner GMRES that runs entirely in single precision, on single precision copies of the local rows of the operator,
+    of the preconditioner and of the Krylov vectors, and updates x = x + d in double precision. The inner iterations
+    move half as many bytes as double precision ones, while the outer iteration converges to the accuracy of a double
+    precision solver as long as the inner solves reduce the residual.
+*/
+#include <petsc/private/kspimpl.h>             /*I "petscksp.h" I*/
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+#include <petscsf.h>
+
+typedef struct {
+  /* settings of the inner solves */
+  KSPMPIRPCType    pctype;
+  PetscReal        omega;                 /* relaxation factor of SOR */
+  PetscReal        rtol;                  /* relative tolerance of the inner solves */
+  PetscInt         restart;               /* maximum number of iterations of the inner solves */
+
+  /* single precision copy of the local rows of the operator, the structure is the one of the AIJ matrix */
+  Mat              A,P;                   /* the matrices that were copied */
+  PetscObjectState Astate,Pstate;
+  PetscInt         m;                     /* number of local rows */
+  const PetscInt   *ai,*aj,*bi,*bj;       /* diagonal and off-diagonal blocks */
+  float            *aa,*ba;
+  PetscSF          sf;                    /* gathers the ghost values needed by the off-diagonal block */
+  float            *xghost;
+
+  /* single precision preconditioner, from the diagonal block of the preconditioning matrix */
+  const PetscInt   *pi,*pj;
+  PetscInt         *pdiag;                /* positions of the diagonal entries */
+  float            *pa;                   /* copy of the diagonal block, or its ILU(0) factors */
+  float            *idiag;                /* inverses of the diagonal entries, or of the pivots */
+  PetscBool        pcfailed;
+
+  /* inner GMRES */
+  float            *V,*z,*w;              /* Krylov basis, m x (restart+1), and work vectors */
+  PetscReal        *H,*hh,*cs,*sn,*g;     /* Hessenberg matrix, inner products, Givens rotations, right-hand side */
+  PetscInt         innerits;              /* total number of inner iterations in the last solve */
+} KSP_MPIR;
+
+static PetscErrorCode KSPSetUp_MPIR(KSP ksp)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+  Mat            Amat;
+  PetscInt       m,k = mpir->restart;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&Amat,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(Amat,&m,NULL);CHKERRQ(ierr);
+  ierr = KSPSetWorkVecs(ksp,1);CHKERRQ(ierr);
+  ierr = PetscMalloc3(m*(k+1),&mpir->V,m,&mpir->z,m,&mpir->w);CHKERRQ(ierr);
+  ierr = PetscMalloc5((k+1)*k,&mpir->H,k+1,&mpir->hh,k,&mpir->cs,k,&mpir->sn,k+1,&mpir->g);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(m*(k+3))*sizeof(float)+((k+1)*k+4*k+2)*sizeof(PetscReal));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPMPIRResetOperators_Private(KSP ksp)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(mpir->aa,mpir->ba);CHKERRQ(ierr);
+  ierr = PetscFree(mpir->xghost);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&mpir->sf);CHKERRQ(ierr);
+  ierr = PetscFree3(mpir->pdiag,mpir->pa,mpir->idiag);CHKERRQ(ierr);
+  mpir->A = NULL;
+  mpir->P = NULL;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_MPIR(KSP ksp)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPMPIRResetOperators_Private(ksp);CHKERRQ(ierr);
+  ierr = PetscFree3(mpir->V,mpir->z,mpir->w);CHKERRQ(ierr);
+  ierr = PetscFree5(mpir->H,mpir->hh,mpir->cs,mpir->sn,mpir->g);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_MPIR(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_MPIR(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPMPIRSetInnerPCType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPMPIRSetInnerTolerances_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Gets the local diagonal and off-diagonal blocks of a MATSEQAIJ or MATMPIAIJ matrix
+*/
+static PetscErrorCode KSPMPIRGetBlocks_Private(KSP ksp,Mat A,Mat_SeqAIJ **Ad,Mat_SeqAIJ **Ao,const PetscInt **garray)
+{
+  PetscErrorCode ierr;
+  PetscBool      isseq,ismpi;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&isseq);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATMPIAIJ,&ismpi);CHKERRQ(ierr);
+  if (isseq) {
+    *Ad = (Mat_SeqAIJ*)A->data;
+    if (Ao) *Ao = NULL;
+  } else if (ismpi) {
+    Mat_MPIAIJ *a = (Mat_MPIAIJ*)A->data;
+
+    *Ad = (Mat_SeqAIJ*)a->A->data;
+    if (Ao) {
+      *Ao     = (Mat_SeqAIJ*)a->B->data;
+      *garray = a->garray;
+    }
+  } else SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPMPIR needs MATSEQAIJ or MATMPIAIJ matrices, not %s",((PetscObject)A)->type_name);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Copies the local rows of the operator in single precision, and builds the single precision preconditioner from the
+   diagonal block of the preconditioning matrix, when these matrices have changed since the last solve
+*/
+static PetscErrorCode KSPMPIRSetUpOperators_Private(KSP ksp)
+{
+  KSP_MPIR         *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode   ierr;
+  Mat              Amat,Pmat;
+  Mat_SeqAIJ       *Ad,*Ao,*Pd;
+  const PetscInt   *garray = NULL;
+  PetscObjectState Astate,Pstate;
+  PetscInt         m,i,j,k,kk,nz,*iw;
+  PetscReal        *lu;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Amat,&Astate);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Pmat,&Pstate);CHKERRQ(ierr);
+  if (mpir->A == Amat && mpir->Astate == Astate && mpir->P == Pmat && mpir->Pstate == Pstate) PetscFunctionReturn(0);
+  ierr = KSPMPIRResetOperators_Private(ksp);CHKERRQ(ierr);
+  ierr = KSPMPIRGetBlocks_Private(ksp,Amat,&Ad,&Ao,&garray);CHKERRQ(ierr);
+  ierr = KSPMPIRGetBlocks_Private(ksp,Pmat,&Pd,NULL,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(Amat,&m,NULL);CHKERRQ(ierr);
+  mpir->m  = m;
+  mpir->ai = Ad->i;
+  mpir->aj = Ad->j;
+  mpir->bi = Ao ? Ao->i : NULL;
+  mpir->bj = Ao ? Ao->j : NULL;
+  ierr = PetscMalloc2(Ad->i[m],&mpir->aa,Ao ? Ao->i[m] : 0,&mpir->ba);CHKERRQ(ierr);
+  for (k=0; k<Ad->i[m]; k++) mpir->aa[k] = (float)Ad->a[k];
+  if (Ao) {
+    PetscInt nghost = ((Mat_MPIAIJ*)Amat->data)->B->cmap->n;
+
+    for (k=0; k<Ao->i[m]; k++) mpir->ba[k] = (float)Ao->a[k];
+    ierr = PetscMalloc1(nghost,&mpir->xghost);CHKERRQ(ierr);
+    ierr = PetscSFCreate(PetscObjectComm((PetscObject)ksp),&mpir->sf);CHKERRQ(ierr);
+    ierr = PetscSFSetGraphLayout(mpir->sf,Amat->cmap,nghost,NULL,PETSC_COPY_VALUES,garray);CHKERRQ(ierr);
+    ierr = PetscSFSetUp(mpir->sf);CHKERRQ(ierr);
+  }
+
+  /* the preconditioner */
+  mpir->pcfailed = PETSC_FALSE;
+  mpir->pi       = Pd->i;
+  mpir->pj       = Pd->j;
+  nz             = Pd->i[m];
+  ierr = PetscMalloc3(m,&mpir->pdiag,nz,&mpir->pa,m,&mpir->idiag);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    for (k=Pd->i[i]; k<Pd->i[i+1] && Pd->j[k] < i; k++) ;
+    if (mpir->pctype != KSP_MPIR_PC_NONE && (k == Pd->i[i+1] || Pd->j[k] != i)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Missing diagonal entry in row %D",i);
+    mpir->pdiag[i] = k;
+  }
+  switch (mpir->pctype) {
+  case KSP_MPIR_PC_NONE:
+    break;
+  case KSP_MPIR_PC_JACOBI:
+  case KSP_MPIR_PC_SOR:
+    for (k=0; k<nz; k++) mpir->pa[k] = (float)Pd->a[k];
+    for (i=0; i<m; i++) {
+      if (Pd->a[mpir->pdiag[i]] == 0.0) mpir->pcfailed = PETSC_TRUE;
+      else mpir->idiag[i] = (float)(1.0/Pd->a[mpir->pdiag[i]]);
+    }
+    break;
+  case KSP_MPIR_PC_ILU:
+    /* ILU(0) computed in double precision, stored in single precision */
+    ierr = PetscMalloc2(nz,&lu,m,&iw);CHKERRQ(ierr);
+    for (k=0; k<nz; k++) lu[k] = PetscRealPart(Pd->a[k]);
+    for (i=0; i<m; i++) iw[i] = -1;
+    for (i=0; i<m && !mpir->pcfailed; i++) {
+      for (k=Pd->i[i]; k<Pd->i[i+1]; k++) iw[Pd->j[k]] = k;
+      for (k=Pd->i[i]; k<mpir->pdiag[i]; k++) {
+        j      = Pd->j[k];
+        lu[k] /= lu[mpir->pdiag[j]];
+        for (kk=mpir->pdiag[j]+1; kk<Pd->i[j+1]; kk++) {
+          if (iw[Pd->j[kk]] >= 0) lu[iw[Pd->j[kk]]] -= lu[k]*lu[kk];
+        }
+      }
+      for (k=Pd->i[i]; k<Pd->i[i+1]; k++) iw[Pd->j[k]] = -1;
+      if (lu[mpir->pdiag[i]] == 0.0) mpir->pcfailed = PETSC_TRUE;
+      else mpir->idiag[i] = (float)(1.0/lu[mpir->pdiag[i]]);
+    }
+    for (k=0; k<nz; k++) mpir->pa[k] = (float)lu[k];
+    ierr = PetscFree2(lu,iw);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*nz*(nz/(m ? m : 1)));CHKERRQ(ierr);
+    break;
+  }
+  if (mpir->pcfailed) {ierr = PetscInfo(ksp,"Zero pivot in the single precision preconditioner\n");CHKERRQ(ierr);}
+  mpir->A      = Amat;
+  mpir->P      = Pmat;
+  mpir->Astate = Astate;
+  mpir->Pstate = Pstate;
+  PetscFunctionReturn(0);
+}
+
+/* y = A x in single precision */
+static PetscErrorCode KSPMPIRMatMult_Private(KSP ksp,const float *x,float *y)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       i,k,m = mpir->m;
+  float          sum;
+
+  PetscFunctionBegin;
+  if (mpir->sf) {ierr = PetscSFBcastBegin(mpir->sf,MPI_FLOAT,x,mpir->xghost);CHKERRQ(ierr);}
+  for (i=0; i<m; i++) {
+    sum = 0.0f;
+    for (k=mpir->ai[i]; k<mpir->ai[i+1]; k++) sum += mpir->aa[k]*x[mpir->aj[k]];
+    y[i] = sum;
+  }
+  if (mpir->sf) {
+    ierr = PetscSFBcastEnd(mpir->sf,MPI_FLOAT,x,mpir->xghost);CHKERRQ(ierr);
+    for (i=0; i<m; i++) {
+      sum = 0.0f;
+      for (k=mpir->bi[i]; k<mpir->bi[i+1]; k++) sum += mpir->ba[k]*mpir->xghost[mpir->bj[k]];
+      y[i] += sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*(mpir->ai[m]+(mpir->sf ? mpir->bi[m] : 0)));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* z = M^{-1} v in single precision, with M block Jacobi with one block per process */
+static PetscErrorCode KSPMPIRPCApply_Private(KSP ksp,const float *v,float *z)
+{
+  KSP_MPIR        *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode  ierr;
+  PetscInt        i,k,m = mpir->m;
+  const PetscInt  *pi = mpir->pi,*pj = mpir->pj,*pdiag = mpir->pdiag;
+  const float     *pa = mpir->pa,*idiag = mpir->idiag,omega = (float)mpir->omega;
+  float           sum;
+
+  PetscFunctionBegin;
+  switch (mpir->pctype) {
+  case KSP_MPIR_PC_NONE:
+    ierr = PetscMemcpy(z,v,m*sizeof(float));CHKERRQ(ierr);
+    break;
+  case KSP_MPIR_PC_JACOBI:
+    for (i=0; i<m; i++) z[i] = idiag[i]*v[i];
+    ierr = PetscLogFlops(1.0*m);CHKERRQ(ierr);
+    break;
+  case KSP_MPIR_PC_SOR:
+    /* one symmetric sweep from a zero initial guess */
+    for (i=0; i<m; i++) {
+      sum = v[i];
+      for (k=pi[i]; k<pdiag[i]; k++) sum -= pa[k]*z[pj[k]];
+      z[i] = omega*sum*idiag[i];
+    }
+    for (i=m-1; i>=0; i--) {
+      sum = v[i];
+      for (k=pi[i]; k<pi[i+1]; k++) if (k != pdiag[i]) sum -= pa[k]*z[pj[k]];
+      z[i] = (1.0f-omega)*z[i] + omega*sum*idiag[i];
+    }
+    ierr = PetscLogFlops(4.0*pi[m]);CHKERRQ(ierr);
+    break;
+  case KSP_MPIR_PC_ILU:
+    for (i=0; i<m; i++) {
+      sum = v[i];
+      for (k=pi[i]; k<pdiag[i]; k++) sum -= pa[k]*z[pj[k]];
+      z[i] = sum;
+    }
+    for (i=m-1; i>=0; i--) {
+      sum = z[i];
+      for (k=pdiag[i]+1; k<pi[i+1]; k++) sum -= pa[k]*z[pj[k]];
+      z[i] = sum*idiag[i];
+    }
+    ierr = PetscLogFlops(2.0*pi[m]);CHKERRQ(ierr);
+    break;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Solves A d = f approximately with right preconditioned GMRES in single precision, with classical Gram-Schmidt
+   with reorthogonalization; the inner products are accumulated in double precision
+*/
+static PetscErrorCode KSPMPIRInnerSolve_Private(KSP ksp,float *d)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+  MPI_Comm       comm = PetscObjectComm((PetscObject)ksp);
+  PetscInt       m = mpir->m,ldh = mpir->restart+1,i,j,l,pass;
+  float          *V = mpir->V,*w = mpir->w;
+  PetscReal      *H = mpir->H,*hh = mpir->hh,*g = mpir->g,beta,hnorm,t,res;
+
+  PetscFunctionBegin;
+  for (t=0.0,i=0; i<m; i++) t += (PetscReal)V[i]*V[i];
+  ierr = MPIU_Allreduce(&t,&beta,1,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+  beta = PetscSqrtReal(beta);
+  if (beta == 0.0) {
+    ierr = PetscMemzero(d,m*sizeof(float));CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (i=0; i<m; i++) V[i] = (float)(V[i]/beta);
+  g[0] = beta;
+  for (j=0; j<mpir->restart; j++) {
+    ierr = KSPMPIRPCApply_Private(ksp,V+j*m,mpir->z);CHKERRQ(ierr);
+    ierr = KSPMPIRMatMult_Private(ksp,mpir->z,w);CHKERRQ(ierr);
+    for (l=0; l<=j; l++) H[l+j*ldh] = 0.0;
+    for (pass=0; pass<2; pass++) {
+      for (l=0; l<=j; l++) {
+        for (t=0.0,i=0; i<m; i++) t += (PetscReal)V[i+l*m]*w[i];
+        hh[l] = t;
+      }
+      ierr = MPIU_Allreduce(MPI_IN_PLACE,hh,j+1,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+      for (l=0; l<=j; l++) {
+        const float c = (float)hh[l];
+
+        for (i=0; i<m; i++) w[i] -= c*V[i+l*m];
+        H[l+j*ldh] += hh[l];
+      }
+    }
+    for (t=0.0,i=0; i<m; i++) t += (PetscReal)w[i]*w[i];
+    ierr  = MPIU_Allreduce(&t,&hnorm,1,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+    hnorm = PetscSqrtReal(hnorm);
+    ierr  = PetscLogFlops(8.0*m*(j+1)+2.0*m);CHKERRQ(ierr);
+    H[j+1+j*ldh] = hnorm;
+
+    /* reduce H to triangular form with Givens rotations */
+    for (l=0; l<j; l++) {
+      t                = mpir->cs[l]*H[l+j*ldh] + mpir->sn[l]*H[l+1+j*ldh];
+      H[l+1+j*ldh]     = -mpir->sn[l]*H[l+j*ldh] + mpir->cs[l]*H[l+1+j*ldh];
+      H[l+j*ldh]       = t;
+    }
+    t            = PetscSqrtReal(H[j+j*ldh]*H[j+j*ldh] + hnorm*hnorm);
+    if (t == 0.0) break;
+    mpir->cs[j]  = H[j+j*ldh]/t;
+    mpir->sn[j]  = hnorm/t;
+    H[j+j*ldh]   = t;
+    g[j+1]       = -mpir->sn[j]*g[j];
+    g[j]         = mpir->cs[j]*g[j];
+    res          = PetscAbsReal(g[j+1]);
+    mpir->innerits++;
+    if (res <= mpir->rtol*beta || hnorm == 0.0 || j+1 == mpir->restart) {j++; break;}
+    for (i=0; i<m; i++) V[i+(j+1)*m] = (float)(w[i]/hnorm);
+  }
+
+  /* d = M^{-1} V y, with H y = g */
+  for (l=j-1; l>=0; l--) {
+    for (i=l+1; i<j; i++) g[l] -= H[l+i*ldh]*g[i];
+    g[l] /= H[l+l*ldh];
+  }
+  ierr = PetscMemzero(w,m*sizeof(float));CHKERRQ(ierr);
+  for (l=0; l<j; l++) {
+    const float c = (float)g[l];
+
+    for (i=0; i<m; i++) w[i] += c*V[i+l*m];
+  }
+  ierr = PetscLogFlops(2.0*m*j);CHKERRQ(ierr);
+  ierr = KSPMPIRPCApply_Private(ksp,w,d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_MPIR(KSP ksp)
+{
+  KSP_MPIR          *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode    ierr;
+  Mat               Amat;
+  Vec               x = ksp->vec_sol,b = ksp->vec_rhs,r = ksp->work[0];
+  PetscReal         rnorm;
+  PetscScalar       *xx;
+  const PetscScalar *rr;
+  PetscInt          i,m;
+
+  PetscFunctionBegin;
+  if (ksp->transpose_solve) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPMPIR does not support transpose solves");
+  ierr = KSPMPIRSetUpOperators_Private(ksp);CHKERRQ(ierr);
+  ierr = PCGetOperators(ksp->pc,&Amat,NULL);CHKERRQ(ierr);
+  m    = mpir->m;
+  mpir->innerits = 0;
+
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,x,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(b,r);CHKERRQ(ierr);
+  }
+  ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,rnorm);
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = rnorm;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,rnorm);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,0,rnorm);CHKERRQ(ierr);
+  ierr = (*ksp->converged)(ksp,0,rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  if (ksp->reason) PetscFunctionReturn(0);
+  if (mpir->pcfailed) {
+    ksp->reason = KSP_DIVERGED_PC_FAILED;
+    PetscFunctionReturn(0);
+  }
+
+  while (!ksp->reason) {
+    /* the inner solve is scaled to a right-hand side of unit norm, which is representable in single precision */
+    ierr = VecGetArrayRead(r,&rr);CHKERRQ(ierr);
+    for (i=0; i<m; i++) mpir->V[i] = (float)(PetscRealPart(rr[i])/rnorm);
+    ierr = VecRestoreArrayRead(r,&rr);CHKERRQ(ierr);
+    ierr = KSPMPIRInnerSolve_Private(ksp,mpir->z);CHKERRQ(ierr);
+    ierr = VecGetArray(x,&xx);CHKERRQ(ierr);
+    for (i=0; i<m; i++) xx[i] += rnorm*(PetscReal)mpir->z[i];
+    ierr = VecRestoreArray(x,&xx);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*m);CHKERRQ(ierr);
+
+    ierr = KSP_MatMult(ksp,Amat,x,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+    KSPCheckNorm(ksp,rnorm);
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its++;
+    ksp->rnorm = rnorm;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = KSPLogResidualHistory(ksp,rnorm);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,rnorm);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,ksp->its,rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+    if (!ksp->reason && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_MPIR(KSP ksp,PetscViewer viewer)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  single precision inner GMRES: relative tolerance %g, at most %D iterations\n",(double)mpir->rtol,mpir->restart);CHKERRQ(ierr);
+    if (mpir->pctype == KSP_MPIR_PC_SOR) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  single precision inner preconditioner: %s, omega %g\n",KSPMPIRPCTypes[mpir->pctype],(double)mpir->omega);CHKERRQ(ierr);
+    } else {
+      ierr = PetscViewerASCIIPrintf(viewer,"  single precision inner preconditioner: %s\n",KSPMPIRPCTypes[mpir->pctype]);CHKERRQ(ierr);
+    }
+    ierr = PetscViewerASCIIPrintf(viewer,"  inner iterations in the last solve %D\n",mpir->innerits);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"inner pc %s rtol %g",KSPMPIRPCTypes[mpir->pctype],(double)mpir->rtol);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_MPIR(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscReal      rtol = mpir->rtol;
+  PetscInt       maxits = mpir->restart;
+  KSPMPIRPCType  pctype = mpir->pctype;
+  PetscBool      flg1,flg2;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP mixed precision iterative refinement options");CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-ksp_mpir_pc_type","Single precision preconditioner of the inner solves","KSPMPIRSetInnerPCType",KSPMPIRPCTypes,(PetscEnum)pctype,(PetscEnum*)&pctype,&flg1);CHKERRQ(ierr);
+  if (flg1) {ierr = KSPMPIRSetInnerPCType(ksp,pctype);CHKERRQ(ierr);}
+  ierr = PetscOptionsReal("-ksp_mpir_sor_omega","Relaxation factor of the SOR preconditioner","None",mpir->omega,&mpir->omega,NULL);CHKERRQ(ierr);
+  if (mpir->omega <= 0.0 || mpir->omega >= 2.0) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Relaxation factor %g must be in (0,2)",(double)mpir->omega);
+  ierr = PetscOptionsReal("-ksp_mpir_rtol","Relative tolerance of the inner solves","KSPMPIRSetInnerTolerances",rtol,&rtol,&flg1);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_mpir_max_it","Maximum number of iterations of the inner solves","KSPMPIRSetInnerTolerances",maxits,&maxits,&flg2);CHKERRQ(ierr);
+  if (flg1 || flg2) {ierr = KSPMPIRSetInnerTolerances(ksp,rtol,maxits);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPMPIRSetInnerPCType_MPIR(KSP ksp,KSPMPIRPCType pctype)
+{
+  KSP_MPIR *mpir = (KSP_MPIR*)ksp->data;
+
+  PetscFunctionBegin;
+  if (mpir->pctype != pctype) {
+    mpir->pctype = pctype;
+    mpir->P      = NULL;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPMPIRSetInnerTolerances_MPIR(KSP ksp,PetscReal rtol,PetscInt maxits)
+{
+  KSP_MPIR       *mpir = (KSP_MPIR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (rtol != PETSC_DEFAULT) {
+    if (rtol <= 0.0 || rtol >= 1.0) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Inner relative tolerance %g must be in (0,1)",(double)rtol);
+    mpir->rtol = rtol;
+  }
+  if (maxits != PETSC_DEFAULT && maxits != mpir->restart) {
+    if (maxits < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Maximum number of inner iterations %D must be positive",maxits);
+    if (ksp->setupstage) {
+      /* free the data structures, then create them again */
+      ierr = KSPReset_MPIR(ksp);CHKERRQ(ierr);
+      ksp->setupstage = KSP_SETUP_NEW;
+    }
+    mpir->restart = maxits;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPMPIRSetInnerPCType - Sets the single precision preconditioner of the inner solves of the mixed precision
+   iterative refinement
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  pctype - KSP_MPIR_PC_NONE, KSP_MPIR_PC_JACOBI, KSP_MPIR_PC_SOR or KSP_MPIR_PC_ILU (the default)
+
+   Options Database:
++  -ksp_mpir_pc_type <none,jacobi,sor,ilu>
+-  -ksp_mpir_sor_omega <omega> - the relaxation factor of SOR, 1 by default
+
+   Notes:
+   The preconditioner is built from the diagonal block of the local rows of the preconditioning matrix, like
+   PCBJACOBI with one block per process. KSP_MPIR_PC_SOR applies one symmetric sweep and KSP_MPIR_PC_ILU the ILU(0)
+   factorization, computed in double precision and stored in single precision.
+
+   Level: intermediate
+
+.seealso: KSPMPIR, KSPMPIRSetInnerTolerances(), KSPMPIRPCType
+@*/
+PetscErrorCode KSPMPIRSetInnerPCType(KSP ksp,KSPMPIRPCType pctype)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,pctype,2);
+  ierr = PetscTryMethod(ksp,"KSPMPIRSetInnerPCType_C",(KSP,KSPMPIRPCType),(ksp,pctype));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPMPIRSetInnerTolerances - Sets the stopping criteria of the single precision inner solves of the mixed
+   precision iterative refinement
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+.  rtol - the reduction of the residual norm that stops each inner solve, 1.e-4 by default
+-  maxits - the maximum number of iterations of each inner solve, 30 by default
+
+   Options Database:
++  -ksp_mpir_rtol <rtol>
+-  -ksp_mpir_max_it <maxits>
+
+   Notes:
+   Use PETSC_DEFAULT to leave a value unchanged. Each inner solve is one cycle of GMRES that stores maxits+1
+   single precision vectors. The inner solves cannot reduce the residual by much more than the single precision
+   machine epsilon, about 1.e-7, so smaller values of rtol only cost iterations.
+
+   Level: intermediate
+
+.seealso: KSPMPIR, KSPMPIRSetInnerPCType()
+@*/
+PetscErrorCode KSPMPIRSetInnerTolerances(KSP ksp,PetscReal rtol,PetscInt maxits)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveReal(ksp,rtol,2);
+  PetscValidLogicalCollectiveInt(ksp,maxits,3);
+  ierr = PetscTryMethod(ksp,"KSPMPIRSetInnerTolerances_C",(KSP,PetscReal,PetscInt),(ksp,rtol,maxits));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPMPIR - Mixed precision iterative refinement. The residual and the solution are updated in double precision,
+   and the correction is computed with GMRES in single precision.
+
+   Options Database Keys:
++   -ksp_mpir_pc_type <none,jacobi,sor,ilu> - the single precision preconditioner of the inner solves (default ilu)
+.   -ksp_mpir_sor_omega <omega> - the relaxation factor of SOR (default 1)
+.   -ksp_mpir_rtol <rtol> - the relative tolerance of the inner solves (default 1.e-4)
+-   -ksp_mpir_max_it <maxits> - the maximum number of iterations of the inner solves (default 30)
+
+   Level: intermediate
+
+   Notes:
+   Each outer iteration computes the residual in double precision, solves for the correction with one cycle of
+   right preconditioned GMRES on single precision copies of the matrix, the preconditioner and the vectors, and
+   adds the correction to the solution in double precision. The inner iterations move about half as many bytes,
+   and the outer iteration still converges to double precision accuracy when the single precision problem is not
+   too ill-conditioned, condition numbers below about 1.e6.
+
+   Only MATSEQAIJ and MATMPIAIJ matrices are supported. The preconditioner of the KSP is not used, the inner solves
+   have their own, see KSPMPIRSetInnerPCType(), so it is set to PCNONE when the KSP is created. The iteration
+   count and the monitors refer to the outer iterations, the residual norm is the unpreconditioned one. The single
+   precision copies are refreshed when the matrices change. KSPSolveTranspose() is not supported.
+
+   This type is only available when PETSc is configured with real double precision scalars.
+
+   References:
+.   1. - E. Carson and N. J. Higham, Accelerating the solution of linear systems by iterative refinement in three
+         precisions, SIAM J. Sci. Comput., 2018.
+
+.seealso: KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPRICHARDSON, KSPGMRES,
+          KSPMPIRSetInnerPCType(), KSPMPIRSetInnerTolerances()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_MPIR(KSP ksp)
+{
+  PetscErrorCode ierr;
+  KSP_MPIR       *mpir;
+  PC             pc;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&mpir);CHKERRQ(ierr);
+  mpir->pctype  = KSP_MPIR_PC_ILU;
+  mpir->omega   = 1.0;
+  mpir->rtol    = 1.e-4;
+  mpir->restart = 30;
+  ksp->data     = (void*)mpir;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_MPIR;
+  ksp->ops->solve          = KSPSolve_MPIR;
+  ksp->ops->reset          = KSPReset_MPIR;
+  ksp->ops->destroy        = KSPDestroy_MPIR;
+  ksp->ops->view           = KSPView_MPIR;
+  ksp->ops->setfromoptions = KSPSetFromOptions_MPIR;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PCSetType(pc,PCNONE);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPMPIRSetInnerPCType_C",KSPMPIRSetInnerPCType_MPIR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPMPIRSetInnerTolerances_C",KSPMPIRSetInnerTolerances_MPIR);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -119,6 +119,9 @@ const char *const KSPConvergedReasons_Shifted[] = {"DIVERGED_PC_FAILED","DIVERGE
                                                    "CONVERGED_HAPPY_BREAKDOWN","CONVERGED_ATOL_NORMAL","KSPConvergedReason","KSP_",0};
 const char *const*KSPConvergedReasons = KSPConvergedReasons_Shifted + 11;
 const char *const KSPFCDTruncationTypes[] = {"STANDARD","NOTAY","KSPFCDTruncationTypes","KSP_FCD_TRUNC_TYPE_",0};
+const char *const KSPSStepBasisTypes[]    = {"MONOMIAL","NEWTON","CHEBYSHEV","KSPSStepBasisType","KSP_SSTEP_BASIS_",0};
+const char *const KSPMPIRPCTypes[]        = {"NONE","JACOBI","SOR","ILU","KSPMPIRPCType","KSP_MPIR_PC_",0};
+const char *const KSPDCGSpaceTypes[]      = {"USER","SUBDOMAIN","MG","RITZ","KSPDCGSpaceType","KSP_DCG_SPACE_",0};
 
 static PetscBool KSPPackageInitialized = PETSC_FALSE;
 /*@C
@@ -174,6 +177,7 @@ PetscErrorCode  KSPInitializePackage(void)
   /* Register Events */
   ierr = PetscLogEventRegister("KSPSetUp",         KSP_CLASSID,&KSP_SetUp);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("KSPSolve",         KSP_CLASSID,&KSP_Solve);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("KSPMatSolve",      KSP_CLASSID,&KSP_MatSolve);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("KSPGMRESOrthog",   KSP_CLASSID,&KSP_GMRESOrthogonalization);CHKERRQ(ierr);
   /* Process info exclusions */
   ierr = PetscOptionsGetString(NULL,NULL,"-info_exclude",logList,sizeof(logList),&opt);CHKERRQ(ierr);
@@ -0,0 +1,150 @@
+/*
+    Routines shared by the block Krylov methods used by KSPMatSolve()
+*/
+#include <petsc/private/kspimpl.h>   /*I "petscksp.h" I*/
+#include <petsc/private/matimpl.h>
+
+/*
+   KSPMatMatMult_Private - Computes the product of the operator with a dense matrix, with MatMatMult() when the
+   matrix types support it and otherwise one column at a time with MatMult()
+*/
+PetscErrorCode KSPMatMatMult_Private(Mat A,Mat X,MatReuse scall,Mat *Y)
+{
+  PetscErrorCode    ierr;
+  PetscErrorCode    (*mult)(Mat,Mat,MatReuse,PetscReal,Mat*) = NULL;
+  char              multname[256];
+  Vec               x,y;
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+  PetscInt          i,N,ldx,ldy;
+
+  PetscFunctionBegin;
+  /* same dispatch as MatMatMult() */
+  if (A->ops->matmult == X->ops->matmult) mult = X->ops->matmult;
+  else {
+    ierr = PetscStrncpy(multname,"MatMatMult_",sizeof(multname));CHKERRQ(ierr);
+    ierr = PetscStrlcat(multname,((PetscObject)A)->type_name,sizeof(multname));CHKERRQ(ierr);
+    ierr = PetscStrlcat(multname,"_",sizeof(multname));CHKERRQ(ierr);
+    ierr = PetscStrlcat(multname,((PetscObject)X)->type_name,sizeof(multname));CHKERRQ(ierr);
+    ierr = PetscStrlcat(multname,"_C",sizeof(multname));CHKERRQ(ierr);
+    ierr = PetscObjectQueryFunction((PetscObject)X,multname,&mult);CHKERRQ(ierr);
+  }
+  if (mult) {
+    ierr = MatMatMult(A,X,scall,PETSC_DEFAULT,Y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+  if (scall == MAT_INITIAL_MATRIX) {
+    ierr = MatCreateDense(PetscObjectComm((PetscObject)A),A->rmap->n,X->cmap->n,A->rmap->N,N,NULL,Y);CHKERRQ(ierr);
+  }
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(*Y,&ldy);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(X,&xx);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(*Y,&yy);CHKERRQ(ierr);
+  for (i=0; i<N; i++) {
+    ierr = VecPlaceArray(x,xx+i*ldx);CHKERRQ(ierr);
+    ierr = VecPlaceArray(y,yy+i*ldy);CHKERRQ(ierr);
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = VecResetArray(x);CHKERRQ(ierr);
+    ierr = VecResetArray(y);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArray(*Y,&yy);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(X,&xx);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPBlockCholesky_Private - Cholesky factorization with diagonal pivoting of the Gram matrix G of a block of m vectors,
+   which stops when the remaining part of every column is smaller than tol times its reference norm sqrt(s[j])
+
+   On output, the rank first columns of R (upper triangular) and the columns perm[0],...,perm[rank-1] of the block
+   satisfy W(:,perm[0:rank]) = Q R(0:rank,0:rank) with Q orthonormal, and the column i of R, for i >= rank, holds the
+   coefficients in Q of the column perm[i] of the block. d is a work array of length m.
+*/
+PetscErrorCode KSPBlockCholesky_Private(PetscInt m,const PetscScalar *G,PetscInt ldg,const PetscReal *s,PetscReal tol,PetscScalar *R,PetscInt ldr,PetscInt *perm,PetscReal *d,PetscInt *rank)
+{
+  PetscInt    i,j,k,l,c,q,best;
+  PetscReal   ratio,rkk;
+  PetscScalar t;
+
+  PetscFunctionBegin;
+  for (j=0; j<m; j++) {
+    perm[j] = j;
+    d[j]    = PetscRealPart(G[j+j*ldg]);
+    for (i=0; i<m; i++) R[i+j*ldr] = 0.0;
+  }
+  for (k=0; k<m; k++) {
+    best  = -1;
+    ratio = tol*tol;
+    for (j=k; j<m; j++) {
+      c = perm[j];
+      if (s[c] > 0.0 && d[c] > ratio*s[c]) {ratio = d[c]/s[c]; best = j;}
+    }
+    if (best < 0) break;
+    if (best != k) {
+      c = perm[k]; perm[k] = perm[best]; perm[best] = c;
+      for (l=0; l<k; l++) {t = R[l+k*ldr]; R[l+k*ldr] = R[l+best*ldr]; R[l+best*ldr] = t;}
+    }
+    q           = perm[k];
+    rkk         = PetscSqrtReal(d[q]);
+    R[k+k*ldr]  = rkk;
+    for (i=k+1; i<m; i++) {
+      c = perm[i];
+      t = G[q+c*ldg];
+      for (l=0; l<k; l++) t -= PetscConj(R[l+k*ldr])*R[l+i*ldr];
+      R[k+i*ldr] = t/rkk;
+      d[c]      -= PetscRealPart(PetscConj(R[k+i*ldr])*R[k+i*ldr]);
+    }
+  }
+  *rank = k;
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPBlockConverged_Private - Logs and monitors the largest of the residual norms of the columns and tests the
+   convergence of all of them, each with respect to its initial residual norm as in KSPConvergedDefault(). A test set
+   with KSPSetConvergenceTest() is instead called for each column with the residual norm of the column: the block has
+   converged when all the columns have, and has diverged as soon as one of them has.
+*/
+PetscErrorCode KSPBlockConverged_Private(KSP ksp,PetscInt p,const PetscReal rnorm0[],const PetscReal rnorm[])
+{
+  PetscErrorCode     ierr;
+  PetscInt           j;
+  PetscReal          max = 0.0;
+  PetscBool          rtol = PETSC_TRUE,atol = PETSC_TRUE,dtol = PETSC_FALSE,nan = PETSC_FALSE,all = PETSC_TRUE;
+  KSPConvergedReason reason,creason = KSP_CONVERGED_ITERATING;
+
+  PetscFunctionBegin;
+  for (j=0; j<p; j++) {
+    if (PetscIsInfOrNanReal(rnorm[j])) nan = PETSC_TRUE;
+    max = PetscMax(max,rnorm[j]);
+    if (rnorm[j] > PetscMax(ksp->rtol*rnorm0[j],ksp->abstol)) rtol = PETSC_FALSE;
+    if (rnorm[j] > ksp->abstol) atol = PETSC_FALSE;
+    if (ksp->its && rnorm[j] > ksp->divtol*rnorm0[j]) dtol = PETSC_TRUE;
+  }
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = max;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr       = KSPLogResidualHistory(ksp,max);CHKERRQ(ierr);
+  ierr       = KSPMonitor(ksp,ksp->its,max);CHKERRQ(ierr);
+  if (nan) ksp->reason = KSP_DIVERGED_NANORINF;
+  else if (ksp->converged != KSPConvergedDefault) {
+    for (j=0; j<p; j++) {
+      reason = KSP_CONVERGED_ITERATING;
+      ierr   = (*ksp->converged)(ksp,ksp->its,rnorm[j],&reason,ksp->cnvP);CHKERRQ(ierr);
+      if (reason < 0) {creason = reason; break;}
+      if (!reason) all = PETSC_FALSE;
+      else creason = reason;
+    }
+    ksp->reason = (creason < 0 || all) ? creason : KSP_CONVERGED_ITERATING;
+    if (!ksp->reason && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  } else if (atol) ksp->reason = KSP_CONVERGED_ATOL;
+  else if (rtol) ksp->reason = KSP_CONVERGED_RTOL;
+  else if (dtol) ksp->reason = KSP_DIVERGED_DTOL;
+  else if (ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  if (ksp->reason) {ierr = PetscInfo2(ksp,"Block solve stopped at iteration %D with largest residual norm %14.12e\n",ksp->its,(double)max);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
@@ -4,6 +4,7 @@
 */
 
 #include <petsc/private/kspimpl.h>   /*I "petscksp.h" I*/
+#include <petsc/private/pcimpl.h>
 #include <petscdm.h>
 
 PETSC_STATIC_INLINE PetscErrorCode ObjectView(PetscObject obj, PetscViewer viewer, PetscViewerFormat format)
@@ -966,6 +967,131 @@ PetscErrorCode  KSPSolveTranspose(KSP ksp,Vec b,Vec x)
   PetscFunctionReturn(0);
 }
 
+/* whether one of the monitors builds the solution or the residual, or needs the Krylov data of a single solve */
+static PetscErrorCode KSPMonitorsNeedVectors_Internal(KSP ksp,PetscBool *flg)
+{
+  typedef PetscErrorCode (*KSPMonitorFunction)(KSP,PetscInt,PetscReal,void*);
+  const KSPMonitorFunction vecmonitors[] = {(KSPMonitorFunction)KSPMonitorTrueResidualNorm,(KSPMonitorFunction)KSPMonitorTrueResidualMaxNorm,
+                                            (KSPMonitorFunction)KSPMonitorSolution,(KSPMonitorFunction)KSPMonitorRange,
+                                            (KSPMonitorFunction)KSPMonitorSingularValue,KSPMonitorLGTrueResidualNorm,KSPMonitorLGRange,
+                                            KSPGMRESMonitorKrylov,
+#if defined(PETSC_HAVE_SAWS)
+                                            KSPMonitorSAWs,
+#endif
+                                           };
+  PetscInt                 i,j;
+
+  PetscFunctionBegin;
+  *flg = PETSC_FALSE;
+  for (i=0; i<ksp->numbermonitors; i++) {
+    for (j=0; j<(PetscInt)(sizeof(vecmonitors)/sizeof(vecmonitors[0])); j++) {
+      if (ksp->monitor[i] == vecmonitors[j]) {*flg = PETSC_TRUE; PetscFunctionReturn(0);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPMatSolve - Solves a linear system with several right-hand sides stored as the columns of a dense matrix
+
+   Collective on KSP
+
+   Input Parameters:
++  ksp - iterative context obtained from KSPCreate()
+-  B - the block of right-hand sides, of type MATDENSE
+
+   Output Parameter:
+.  X - the block of solutions, of type MATDENSE, which is used as the initial guess with KSPSetInitialGuessNonzero()
+
+   Notes:
+   KSPCG and KSPGMRES solve for all the right-hand sides together with block Krylov methods: each block iteration
+   reads the operator once with MatMatMult(), applies the preconditioner once with PCMatApply() and needs a few
+   global reductions, whatever the number of right-hand sides. The iteration count is then the number of block
+   iterations, the residual norm given to the monitors is the largest of the residual norms of the columns, and
+   the solve has converged when all the columns have converged in the sense of KSPConvergedDefault(). A convergence
+   test set with KSPSetConvergenceTest() is called for each column with the residual norm of that column: the solve
+   has converged when the test reports convergence for all the columns, and stops as soon as it reports divergence
+   for one of them.
+
+   The other Krylov methods, as well as the solves with diagonal scaling, null spaces, a KSPGuess, pre- and
+   post-solve callbacks or monitors that need the solution or the residual, such as KSPMonitorTrueResidualNorm(),
+   call KSPSolve() for each column in turn. The monitors set by the user are called during the block iterations
+   without a current solution, so they must not call KSPBuildSolution() or KSPBuildResidual().
+
+   Level: intermediate
+
+.keywords: solve, linear system, multiple right-hand sides, block Krylov
+
+.seealso: KSPSolve(), PCMatApply(), MatMatMult(), KSPCG, KSPGMRES
+@*/
+PetscErrorCode KSPMatSolve(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode    ierr;
+  Mat               mat,pmat;
+  MatNullSpace      nullsp,tnullsp;
+  MPI_Comm          comm;
+  PetscBool         match1,match2,vecmonitors;
+  PetscInt          i,N,N2,ldb,ldx;
+  Vec               b,x;
+  const PetscScalar *bb;
+  PetscScalar       *xx;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidHeaderSpecific(B,MAT_CLASSID,2);
+  PetscValidHeaderSpecific(X,MAT_CLASSID,3);
+  PetscCheckSameComm(ksp,1,B,2);
+  PetscCheckSameComm(ksp,1,X,3);
+  comm = PetscObjectComm((PetscObject)ksp);
+  if (B == X) SETERRQ(comm,PETSC_ERR_ARG_IDN,"B and X must be different matrices");
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&match1,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)X,&match2,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match1 || !match2) SETERRQ(comm,PETSC_ERR_ARG_WRONG,"B and X must be of type MATDENSE");
+  ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&N2);CHKERRQ(ierr);
+  if (N != N2) SETERRQ2(comm,PETSC_ERR_ARG_SIZ,"B has %D columns but X has %D",N,N2);
+
+  ksp->transpose_solve = PETSC_FALSE;
+  ierr = KSPSetUp(ksp);CHKERRQ(ierr);
+  ierr = KSPSetUpOnBlocks(ksp);CHKERRQ(ierr);
+  ierr = PCGetOperators(ksp->pc,&mat,&pmat);CHKERRQ(ierr);
+  ierr = MatGetNullSpace(mat,&nullsp);CHKERRQ(ierr);
+  ierr = MatGetTransposeNullSpace(pmat,&tnullsp);CHKERRQ(ierr);
+  ierr = KSPMonitorsNeedVectors_Internal(ksp,&vecmonitors);CHKERRQ(ierr);
+
+  ierr = PetscLogEventBegin(KSP_MatSolve,ksp,B,X,0);CHKERRQ(ierr);
+  if (ksp->ops->matsolve && !ksp->dscale && !nullsp && !tnullsp && !ksp->guess && !ksp->guess_knoll && !ksp->presolve && !ksp->postsolve && !ksp->pc->ops->presolve && !ksp->pc->ops->postsolve && !vecmonitors) {
+    if (ksp->res_hist_reset) ksp->res_hist_len = 0;
+    if (ksp->guess_zero) {ierr = MatZeroEntries(X);CHKERRQ(ierr);}
+    ksp->reason = KSP_CONVERGED_ITERATING;
+    ierr = (*ksp->ops->matsolve)(ksp,B,X);CHKERRQ(ierr);
+    if (!ksp->reason) SETERRQ(comm,PETSC_ERR_PLIB,"Internal error, solver returned without setting converged reason");
+    ksp->totalits += ksp->its;
+    if (ksp->viewReason) {ierr = KSPReasonView_Internal(ksp,ksp->viewerReason,ksp->formatReason);CHKERRQ(ierr);}
+    if (ksp->errorifnotconverged && ksp->reason < 0 && ksp->reason != KSP_DIVERGED_ITS) SETERRQ1(comm,PETSC_ERR_NOT_CONVERGED,"KSPMatSolve has not converged, reason %s",KSPConvergedReasons[ksp->reason]);
+  } else {
+    ierr = PetscInfo1(ksp,"Solving for the %D right-hand sides one after the other\n",N);CHKERRQ(ierr);
+    ierr = MatCreateVecs(mat,&x,&b);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(B,&bb);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(X,&xx);CHKERRQ(ierr);
+    for (i=0; i<N; i++) {
+      ierr = VecPlaceArray(b,bb+i*ldb);CHKERRQ(ierr);
+      ierr = VecPlaceArray(x,xx+i*ldx);CHKERRQ(ierr);
+      ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+      ierr = VecResetArray(b);CHKERRQ(ierr);
+      ierr = VecResetArray(x);CHKERRQ(ierr);
+    }
+    ierr = MatDenseRestoreArray(X,&xx);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(B,&bb);CHKERRQ(ierr);
+    ierr = VecDestroy(&b);CHKERRQ(ierr);
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(KSP_MatSolve,ksp,B,X,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPResetViewers - Resets all the viewers set from the options database during KSPSetFromOptions()
 
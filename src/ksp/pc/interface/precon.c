@@ -466,6 +466,79 @@ PetscErrorCode  PCApply(PC pc,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCMatApply - Applies the preconditioner to each column of a dense matrix
+
+   Collective on PC and Mat
+
+   Input Parameters:
++  pc - the preconditioner context
+-  X - input block of vectors, of type MATDENSE
+
+   Output Parameter:
+.  Y - output block of vectors, of type MATDENSE
+
+   Notes:
+   The preconditioners that do not provide a block application are applied with PCApply() to each column in turn.
+
+   Level: developer
+
+.keywords: PC, apply, multiple right-hand sides
+
+.seealso: PCApply(), KSPMatSolve()
+@*/
+PetscErrorCode PCMatApply(PC pc,Mat X,Mat Y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          m,n,mx,my,N,N2,i,ldx,ldy;
+  PetscBool         match1,match2;
+  Vec               x,y;
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidHeaderSpecific(X,MAT_CLASSID,2);
+  PetscValidHeaderSpecific(Y,MAT_CLASSID,3);
+  if (X == Y) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_IDN,"X and Y must be different matrices");
+  ierr = PetscObjectTypeCompareAny((PetscObject)X,&match1,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)Y,&match2,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match1 || !match2) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_WRONG,"X and Y must be of type MATDENSE");
+  ierr = MatGetLocalSize(pc->pmat,&m,&n);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(X,&mx,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(Y,&my,NULL);CHKERRQ(ierr);
+  if (my != m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Preconditioner number of local rows %D does not equal resulting block number of rows %D",m,my);
+  if (mx != n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Preconditioner number of local columns %D does not equal block number of rows %D",n,mx);
+  ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+  ierr = MatGetSize(Y,NULL,&N2);CHKERRQ(ierr);
+  if (N != N2) SETERRQ2(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_SIZ,"X has %D columns but Y has %D",N,N2);
+
+  ierr = PCSetUp(pc);CHKERRQ(ierr);
+  if (pc->ops->matapply) {
+    ierr = PetscLogEventBegin(PC_ApplyMultiple,pc,X,Y,0);CHKERRQ(ierr);
+    ierr = (*pc->ops->matapply)(pc,X,Y);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(PC_ApplyMultiple,pc,X,Y,0);CHKERRQ(ierr);
+  } else {
+    ierr = MatCreateVecs(pc->pmat,&x,&y);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(Y,&ldy);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(X,&xx);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(Y,&yy);CHKERRQ(ierr);
+    for (i=0; i<N; i++) {
+      ierr = VecPlaceArray(x,xx+i*ldx);CHKERRQ(ierr);
+      ierr = VecPlaceArray(y,yy+i*ldy);CHKERRQ(ierr);
+      ierr = PCApply(pc,x,y);CHKERRQ(ierr);
+      ierr = VecResetArray(x);CHKERRQ(ierr);
+      ierr = VecResetArray(y);CHKERRQ(ierr);
+    }
+    ierr = MatDenseRestoreArray(Y,&yy);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(X,&xx);CHKERRQ(ierr);
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
    PCApplySymmetricLeft - Applies the left part of a symmetric preconditioner to a vector.
 
@@ -0,0 +1,142 @@
+static char help[] = "Compares AIJ assembly with exact preallocation, with a hash table (MAT_USE_HASH_TABLE)\n\
+and with insufficient preallocation (reallocation in MatSetValues()) for a Q1 finite element stiffness matrix.\n\
+Run with -log_view to compare the timings of the three stages.\n\
+  -n <n>       : number of elements in each direction\n\
+  -nrepeat <r> : number of assemblies of each matrix\n\n";
+
+#include <petscmat.h>
+
+/* Adds the Q1 Laplacian element matrices of elements [estart,eend) of an n x n grid */
+static PetscErrorCode AssembleElements(Mat A,PetscInt n,PetscInt estart,PetscInt eend)
+{
+  PetscErrorCode    ierr;
+  PetscInt          e,ei,ej,idx[4];
+  const PetscScalar Ke[16] = { 2.0/3.0, -1.0/6.0, -1.0/6.0, -1.0/3.0,
+                              -1.0/6.0,  2.0/3.0, -1.0/3.0, -1.0/6.0,
+                              -1.0/6.0, -1.0/3.0,  2.0/3.0, -1.0/6.0,
+                              -1.0/3.0, -1.0/6.0, -1.0/6.0,  2.0/3.0};
+
+  PetscFunctionBeginUser;
+  for (e=estart; e<eend; e++) {
+    ei     = e % n;
+    ej     = e / n;
+    idx[0] = ej*(n+1) + ei;
+    idx[1] = idx[0] + 1;
+    idx[2] = idx[0] + n + 1;
+    idx[3] = idx[2] + 1;
+    ierr   = MatSetValues(A,4,idx,4,idx,Ke,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Preallocates the rows [rstart,rend) of the 9 point stencil of the (n+1)^2 nodes exactly if exact is true, one entry per row otherwise */
+static PetscErrorCode PreallocateQ1(Mat A,PetscInt n,PetscInt rstart,PetscInt rend,PetscBool exact)
+{
+  PetscErrorCode ierr;
+  PetscInt       row,i,j,di,dj,col,*dnnz,*onnz;
+
+  PetscFunctionBeginUser;
+  ierr = PetscCalloc2(rend-rstart,&dnnz,rend-rstart,&onnz);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    if (!exact) {dnnz[row-rstart] = 1; continue;}
+    i = row % (n+1);
+    j = row / (n+1);
+    for (dj=-1; dj<=1; dj++) {
+      for (di=-1; di<=1; di++) {
+        if (i+di < 0 || i+di > n || j+dj < 0 || j+dj > n) continue;
+        col = (j+dj)*(n+1) + i+di;
+        if (col >= rstart && col < rend) dnnz[row-rstart]++;
+        else onnz[row-rstart]++;
+      }
+    }
+  }
+  ierr = MatXAIJSetPreallocation(A,1,dnnz,onnz,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscFree2(dnnz,onnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A[3];
+  const char     *name[3] = {"Preallocated","Hash table","Reallocation"};
+  PetscInt       n = 10,N,nrepeat = 1,r,k,nel,estart,eend,rstart,rend;
+  PetscReal      nrm;
+  MatInfo        info;
+  PetscBool      flg;
+  PetscLogStage  stages[3];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrepeat",&nrepeat,NULL);CHKERRQ(ierr);
+  for (k=0; k<3; k++) {ierr = PetscLogStageRegister(name[k],&stages[k]);CHKERRQ(ierr);}
+  N = (n+1)*(n+1);
+
+  /* each process adds a contiguous range of elements, some of which contribute to rows of other processes */
+  estart = PETSC_DECIDE;
+  nel    = n*n;
+  ierr   = PetscSplitOwnership(PETSC_COMM_WORLD,&estart,&nel);CHKERRQ(ierr);
+  ierr   = MPI_Scan(&estart,&eend,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  estart = eend - estart;
+  rstart = PETSC_DECIDE;
+  ierr   = PetscSplitOwnership(PETSC_COMM_WORLD,&rstart,&N);CHKERRQ(ierr);
+  ierr   = MPI_Scan(&rstart,&rend,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  rstart = rend - rstart;
+
+  for (r=0; r<nrepeat; r++) {
+    for (k=0; k<3; k++) {
+      ierr = PetscLogStagePush(stages[k]);CHKERRQ(ierr);
+      ierr = MatCreate(PETSC_COMM_WORLD,&A[k]);CHKERRQ(ierr);
+      ierr = MatSetSizes(A[k],rend-rstart,rend-rstart,N,N);CHKERRQ(ierr);
+      ierr = MatSetType(A[k],MATAIJ);CHKERRQ(ierr);
+      ierr = MatSetFromOptions(A[k]);CHKERRQ(ierr);
+      if (k == 1) {
+        ierr = MatSetOption(A[k],MAT_USE_HASH_TABLE,PETSC_TRUE);CHKERRQ(ierr);
+        ierr = MatSetUp(A[k]);CHKERRQ(ierr);
+      } else {
+        ierr = PreallocateQ1(A[k],n,rstart,rend,(PetscBool)!k);CHKERRQ(ierr);
+        ierr = MatSetOption(A[k],MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+      }
+      ierr = AssembleElements(A[k],n,estart,eend);CHKERRQ(ierr);
+      ierr = PetscLogStagePop();CHKERRQ(ierr);
+
+      /* the hash table allocates exactly the nonzeros that are used, without mallocs */
+      ierr = MatGetInfo(A[k],MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+      ierr = MatNorm(A[k],NORM_FROBENIUS,&nrm);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %D nonzeros, %s, %s, Frobenius norm %g\n",name[k],(PetscInt)info.nz_used,
+                         info.nz_allocated == info.nz_used ? "exact storage" : "excess storage",info.mallocs > 0.0 ? "mallocs" : "no mallocs",(double)nrm);CHKERRQ(ierr);
+      if (k) {
+        ierr = MatEqual(A[0],A[k],&flg);CHKERRQ(ierr);
+        ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s the preallocated matrix\n",name[k],flg ? "equal to" : "DIFFERENT from");CHKERRQ(ierr);
+      }
+    }
+
+    /* the structure built from the hash table is used by further (value only) assemblies */
+    ierr = MatZeroEntries(A[1]);CHKERRQ(ierr);
+    ierr = MatSetOption(A[1],MAT_NEW_NONZERO_LOCATION_ERR,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = AssembleElements(A[1],n,estart,eend);CHKERRQ(ierr);
+    ierr = MatEqual(A[0],A[1],&flg);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Reassembled hash table matrix: %s the preallocated matrix\n",flg ? "equal to" : "DIFFERENT from");CHKERRQ(ierr);
+    for (k=0; k<3; k++) {ierr = MatDestroy(&A[k]);CHKERRQ(ierr);}
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -n 13
+
+   test:
+      suffix: 3
+      nsize: 2
+      args: -n 7 -nrepeat 2 -mat_use_hash_table
+
+TEST*/
@@ -0,0 +1,152 @@
+static char help[] = "Tests MatSetPreallocationCOO() and MatSetValuesCOO() against MatSetValues() for a Q1 finite element matrix.\n\
+  -n <n>       : number of elements in each direction\n\
+  -nrepeat <r> : number of value updates\n\n";
+
+#include <petscmat.h>
+
+/* six times the Q1 Laplacian element matrix, so that sums are exact in any order and MatEqual() can be used */
+static const PetscScalar Ke[16] = { 4.0, -1.0, -1.0, -2.0,
+                                   -1.0,  4.0, -2.0, -1.0,
+                                   -1.0, -2.0,  4.0, -1.0,
+                                   -2.0, -1.0, -1.0,  4.0};
+
+/* Node numbers of element e of an n x n grid; the first node is dropped (-1) for every seventh element to test ignored entries */
+static void ElementNodes(PetscInt n,PetscInt e,PetscInt idx[])
+{
+  PetscInt ei = e % n,ej = e / n;
+
+  idx[0] = ej*(n+1) + ei;
+  idx[1] = idx[0] + 1;
+  idx[2] = idx[0] + n + 1;
+  idx[3] = idx[2] + 1;
+  if (!(e % 7)) idx[0] = -1;
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C;
+  PetscInt       n = 10,nrepeat = 2,r,nel,estart,eend,e,a,b,k,ncoo,idx[4],*coo_i,*coo_j,M = 6;
+  PetscScalar    *coo_v,scale;
+  PetscReal      nrm;
+  PetscMPIInt    rank;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrepeat",&nrepeat,NULL);CHKERRQ(ierr);
+
+  /* each process owns a contiguous range of elements, some of which contribute to rows of other processes */
+  estart = PETSC_DECIDE;
+  nel    = n*n;
+  ierr   = PetscSplitOwnership(PETSC_COMM_WORLD,&estart,&nel);CHKERRQ(ierr);
+  ierr   = MPI_Scan(&estart,&eend,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  estart = eend - estart;
+
+  ncoo = 16*(eend-estart);
+  ierr = PetscMalloc3(ncoo,&coo_i,ncoo,&coo_j,ncoo,&coo_v);CHKERRQ(ierr);
+  for (e=estart,k=0; e<eend; e++) {
+    ElementNodes(n,e,idx);
+    for (a=0; a<4; a++) {
+      for (b=0; b<4; b++,k++) {
+        coo_i[k] = idx[a];
+        coo_j[k] = idx[b];
+      }
+    }
+  }
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,(n+1)*(n+1),(n+1)*(n+1));CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(A,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatDuplicate(A,MAT_DO_NOT_COPY_VALUES,&B);CHKERRQ(ierr);
+
+  for (r=0; r<nrepeat; r++) {
+    scale = 1.0 + r;
+    for (e=estart,k=0; e<eend; e++) {
+      for (a=0; a<16; a++,k++) coo_v[k] = scale*Ke[a];
+    }
+    ierr = MatSetValuesCOO(A,coo_v,r ? ADD_VALUES : INSERT_VALUES);CHKERRQ(ierr);
+
+    /* the reference matrix is assembled with MatSetValues() */
+    if (!r) {ierr = MatZeroEntries(B);CHKERRQ(ierr);}
+    for (e=estart; e<eend; e++) {
+      ElementNodes(n,e,idx);
+      for (a=0; a<16; a++) coo_v[a] = scale*Ke[a];
+      ierr = MatSetValues(B,4,idx,4,idx,coo_v,ADD_VALUES);CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+    ierr = MatNorm(A,NORM_FROBENIUS,&nrm);CHKERRQ(ierr);
+    ierr = MatEqual(A,B,&flg);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Update %D with %s: Frobenius norm %g, %s MatSetValues()\n",r,r ? "ADD_VALUES" : "INSERT_VALUES",(double)nrm,flg ? "equal to" : "DIFFERENT from");CHKERRQ(ierr);
+  }
+
+  /* INSERT_VALUES replaces all the values */
+  for (e=estart,k=0; e<eend; e++) {
+    for (a=0; a<16; a++,k++) coo_v[k] = Ke[a];
+  }
+  ierr = MatSetValuesCOO(A,coo_v,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = MatZeroEntries(B);CHKERRQ(ierr);
+  for (e=estart; e<eend; e++) {
+    ElementNodes(n,e,idx);
+    ierr = MatSetValues(B,4,idx,4,idx,Ke,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatNorm(A,NORM_FROBENIUS,&nrm);CHKERRQ(ierr);
+  ierr = MatEqual(A,B,&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Final INSERT_VALUES: Frobenius norm %g, %s MatSetValues()\n",(double)nrm,flg ? "equal to" : "DIFFERENT from");CHKERRQ(ierr);
+  ierr = PetscFree3(coo_i,coo_j,coo_v);CHKERRQ(ierr);
+
+  /* the first process gives all the entries, including those of the rows of the others, which have none and pass NULL */
+  ncoo = rank ? 0 : 2*M;
+  ierr = PetscMalloc3(ncoo,&coo_i,ncoo,&coo_j,ncoo,&coo_v);CHKERRQ(ierr);
+  for (k=0; k<ncoo/2; k++) {
+    coo_i[2*k]   = k; coo_j[2*k]   = k;     coo_v[2*k]   = 2.0 + k;
+    coo_i[2*k+1] = k; coo_j[2*k+1] = M-1-k; coo_v[2*k+1] = -1.0;
+  }
+  ierr = MatCreate(PETSC_COMM_WORLD,&C);CHKERRQ(ierr);
+  ierr = MatSetSizes(C,PETSC_DECIDE,PETSC_DECIDE,M,M);CHKERRQ(ierr);
+  ierr = MatSetType(C,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(C);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(C,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(C,ncoo ? coo_v : NULL,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(C,NULL,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(C,ncoo ? coo_v : NULL,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatView(C,PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(C,NULL,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = MatNorm(C,NORM_FROBENIUS,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Frobenius norm after inserting NULL values %g\n",(double)nrm);CHKERRQ(ierr);
+
+  ierr = PetscFree3(coo_i,coo_j,coo_v);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -n 9 -nrepeat 3
+
+   test:
+      suffix: baij
+      nsize: 2
+      args: -mat_type baij
+
+   test:
+      suffix: null
+      nsize: 2
+      args: -n 4 -nrepeat 1
+
+TEST*/
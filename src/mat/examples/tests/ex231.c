@@ -0,0 +1,128 @@
+static char help[] = "Tests the block size specialized SeqBAIJ kernels for block sizes 2 to 8 against AIJ.\n\
+  -mbs <mbs> : number of block rows\n\
+  -empty     : leave four out of five block rows empty, so that the compressed row kernels are used\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,w,r;
+  PetscInt       bs,mbs = 20,i,k,c,ncols,cols[5],bs2;
+  PetscScalar    *v;
+  PetscReal      nrm,err;
+  PetscBool      empty = PETSC_FALSE;
+  const char     *ops[5] = {"MatMult()","MatMultAdd()","in-place MatMultAdd()","MatMultTranspose()","MatMultTransposeAdd()"};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-mbs",&mbs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-empty",&empty,NULL);CHKERRQ(ierr);
+
+  for (bs=2; bs<=8; bs++) {
+    /* block tridiagonal with (periodic) couplings to the block rows at distance 3, the blocks are given by columns */
+    bs2  = bs*bs;
+    ierr = MatCreateSeqBAIJ(PETSC_COMM_SELF,bs,bs*mbs,bs*mbs,5,NULL,&A);CHKERRQ(ierr);
+    ierr = MatSetOption(A,MAT_ROW_ORIENTED,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = PetscMalloc1(bs2,&v);CHKERRQ(ierr);
+    for (i=0; i<mbs; i++) {
+      if (empty && i % 5) continue;
+      ncols         = 0;
+      cols[ncols++] = i;
+      if (i > 0)     cols[ncols++] = i-1;
+      if (i < mbs-1) cols[ncols++] = i+1;
+      if (mbs > 6) {
+        cols[ncols++] = (i+3) % mbs;
+        cols[ncols++] = (i+mbs-3) % mbs;
+      }
+      /* the diagonal of the diagonal block dominates all the rows, so block Gauss-Seidel converges */
+      for (c=0; c<ncols; c++) {
+        for (k=0; k<bs2; k++) v[k] = (!c && !(k % (bs+1))) ? 6.0*bs : 1.0/(1 + (cols[c] + k + i) % 7);
+        ierr = MatSetValuesBlocked(A,1,&i,1,&cols[c],v,INSERT_VALUES);CHKERRQ(ierr);
+      }
+    }
+    ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = PetscFree(v);CHKERRQ(ierr);
+    ierr = MatConvert(A,MATSEQAIJ,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+
+    ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+    ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+    ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+    ierr = VecDuplicate(x,&r);CHKERRQ(ierr);
+    for (i=0; i<bs*mbs; i++) {
+      ierr = VecSetValue(x,i,PetscSinReal((PetscReal)(i+1)),INSERT_VALUES);CHKERRQ(ierr);
+      ierr = VecSetValue(z,i,PetscCosReal((PetscReal)(i+1)),INSERT_VALUES);CHKERRQ(ierr);
+    }
+    ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+    ierr = VecAssemblyBegin(z);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(z);CHKERRQ(ierr);
+
+    /* each product of the specialized kernel y is printed with its difference to the AIJ product w */
+    for (k=0; k<5; k++) {
+      switch (k) {
+      case 0:
+        ierr = MatMult(A,x,y);CHKERRQ(ierr);
+        ierr = MatMult(B,x,w);CHKERRQ(ierr);
+        break;
+      case 1:
+        ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+        ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+        break;
+      case 2:
+        ierr = VecCopy(z,y);CHKERRQ(ierr);
+        ierr = MatMultAdd(A,x,y,y);CHKERRQ(ierr);
+        break;
+      case 3:
+        ierr = MatMultTranspose(A,x,y);CHKERRQ(ierr);
+        ierr = MatMultTranspose(B,x,w);CHKERRQ(ierr);
+        break;
+      case 4:
+        ierr = MatMultTransposeAdd(A,x,z,y);CHKERRQ(ierr);
+        ierr = MatMultTransposeAdd(B,x,z,w);CHKERRQ(ierr);
+        break;
+      }
+      ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+      ierr = VecWAXPY(r,-1.0,y,w);CHKERRQ(ierr);
+      ierr = VecNorm(r,NORM_INFINITY,&err);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_SELF,"Block size %D: %-22s norm %g, %s AIJ\n",bs,ops[k],(double)nrm,err < 100*PETSC_MACHINE_EPSILON*PetscMax(nrm,1.0) ? "equal to" : "DIFFERENT from");CHKERRQ(ierr);
+    }
+
+    if (!empty) {
+      ierr = MatMult(A,x,z);CHKERRQ(ierr);
+      ierr = MatSOR(A,z,1.0,(MatSORType)(SOR_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,1,1,y);CHKERRQ(ierr);
+      ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+      ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+      ierr = MatSOR(A,z,1.0,SOR_SYMMETRIC_SWEEP,0.0,40,1,y);CHKERRQ(ierr);
+      ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+      ierr = VecNorm(y,NORM_2,&err);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_SELF,"Block size %D: MatSOR() error %g after one sweep, %s after 40 more\n",bs,(double)nrm,err < 1.e-10 ? "below 1e-10" : "ABOVE 1e-10");CHKERRQ(ierr);
+    }
+
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+    ierr = VecDestroy(&z);CHKERRQ(ierr);
+    ierr = VecDestroy(&w);CHKERRQ(ierr);
+    ierr = VecDestroy(&r);CHKERRQ(ierr);
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+    ierr = MatDestroy(&B);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      args: -empty
+
+   test:
+      suffix: 3
+      args: -mat_no_unroll
+      output_file: output/ex231_1.out
+
+TEST*/
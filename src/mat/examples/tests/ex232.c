@@ -0,0 +1,274 @@
+static char help[] = "Tests MATAIJSINGLE, the AIJ matrix with single precision values for preconditioners, against AIJ.\n\
+  -n <n>   : the grid has n x n points\n\
+  -pc_type : the preconditioner that is built once from AIJ and once from AIJSINGLE\n\n";
+
+#include <petscksp.h>
+
+/* prints the norm of the AIJSINGLE result y and how it compares with the AIJ result w, using the work vector r */
+static PetscErrorCode PrintSingle(const char *op,Vec y,Vec w,Vec r)
+{
+  PetscErrorCode ierr;
+  PetscReal      nrm,nrmw,err;
+
+  PetscFunctionBeginUser;
+  ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_INFINITY,&nrmw);CHKERRQ(ierr);
+  ierr = VecWAXPY(r,-1.0,y,w);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject)y),"%s: norm %.5g, %s\n",op,(double)nrm,err > 1.e-5*PetscMax(nrmw,1.0) ? "DIFFERENT from AIJ" : (err == 0.0 && nrmw > 0.0 ? "equal to AIJ, the single precision values are not used" : "equal to AIJ in single precision"));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* sets the entries of x to sin((i+1)*f), independently of the number of processes */
+static PetscErrorCode SetSines(Vec x,PetscReal f)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,rstart,rend;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetOwnershipRange(x,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {ierr = VecSetValue(x,i,PetscSinReal((i+1)*f),INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* solves with the AIJ operator A and the preconditioner built from P, and prints the number of iterations */
+static PetscErrorCode Solve(const char *name,Mat A,Mat P,Vec b,Vec x)
+{
+  PetscErrorCode     ierr;
+  KSP                ksp;
+  KSPConvergedReason reason;
+  PetscInt           its;
+
+  PetscFunctionBeginUser;
+  ierr = KSPCreate(PetscObjectComm((PetscObject)A),&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,P);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,200);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = VecSet(x,0.0);CHKERRQ(ierr);
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject)A),"Preconditioner from %s: %s in %D iterations\n",name,KSPConvergedReasons[reason],its);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,F,G,P,C,D,S;
+  Vec            x,y,z,w,r;
+  MPI_Comm       comm;
+  PetscMPIInt    size;
+  PetscInt       n = 20,Istart,Iend,i,j,k,col[5],nc;
+  PetscScalar    v[5],*a,sum;
+  PetscReal      nrm;
+  MatType        type;
+  IS             isrow,iscol;
+  MatFactorInfo  info;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  comm = PETSC_COMM_WORLD;
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* the 5-point Laplacian with a varying coefficient, so that the values are not exactly representable in single precision */
+  ierr = MatCreate(comm,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,n*n,n*n);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,2,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (k=Istart; k<Iend; k++) {
+    i  = k/n; j = k%n; nc = 0;
+    if (i > 0)   {col[nc] = k-n; v[nc++] = -1.0/3.0;}
+    if (j > 0)   {col[nc] = k-1; v[nc++] = -1.0 - 1.0/(7.0 + i);}
+    col[nc] = k; v[nc++] = 4.0 + 2.0/(7.0 + i) + 1.0/(3.0 + j);
+    if (j < n-1) {col[nc] = k+1; v[nc++] = -1.0 - 1.0/(7.0 + i);}
+    if (i < n-1) {col[nc] = k+n; v[nc++] = -1.0/3.0;}
+    ierr = MatSetValues(A,1,&k,nc,col,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJSINGLE,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = MatGetType(B,&type);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"MatConvert() to MATAIJSINGLE gives type %s\n",type);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&r);CHKERRQ(ierr);
+  ierr = SetSines(x,1.0);CHKERRQ(ierr);
+  ierr = SetSines(z,2.0);CHKERRQ(ierr);
+
+  /* products */
+  ierr = MatMult(B,x,y);CHKERRQ(ierr);
+  ierr = MatMult(A,x,w);CHKERRQ(ierr);
+  ierr = PrintSingle("MatMult()",y,w,r);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,z,w);CHKERRQ(ierr);
+  ierr = PrintSingle("MatMultAdd()",y,w,r);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,x,y);CHKERRQ(ierr);
+  ierr = MatMultTranspose(A,x,w);CHKERRQ(ierr);
+  ierr = PrintSingle("MatMultTranspose()",y,w,r);CHKERRQ(ierr);
+
+  /* the single precision values follow changes of the matrix */
+  ierr = MatScale(A,2.0);CHKERRQ(ierr);
+  ierr = MatScale(B,2.0);CHKERRQ(ierr);
+  ierr = MatMult(B,x,y);CHKERRQ(ierr);
+  ierr = MatMult(A,x,w);CHKERRQ(ierr);
+  ierr = PrintSingle("MatMult() after MatScale()",y,w,r);CHKERRQ(ierr);
+
+  /* SOR sweeps of AIJ and AIJSINGLE agree to single precision */
+  ierr = MatSOR(B,z,1.0,(MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,1,1,y);CHKERRQ(ierr);
+  ierr = MatSOR(A,z,1.0,(MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,1,1,w);CHKERRQ(ierr);
+  ierr = PrintSingle("MatSOR() with zero initial guess",y,w,r);CHKERRQ(ierr);
+  ierr = MatSOR(B,z,1.2,SOR_LOCAL_SYMMETRIC_SWEEP,0.0,2,1,y);CHKERRQ(ierr);
+  ierr = MatSOR(A,z,1.2,SOR_LOCAL_SYMMETRIC_SWEEP,0.0,2,1,w);CHKERRQ(ierr);
+  ierr = PrintSingle("MatSOR()",y,w,r);CHKERRQ(ierr);
+
+  /* LU with a nested dissection ordering and ILU(0) of the sequential matrix */
+  if (size == 1) {
+    ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+    info.fill = 5.0;
+    ierr = MatGetOrdering(A,MATORDERINGND,&isrow,&iscol);CHKERRQ(ierr);
+    ierr = MatGetFactor(B,MATSOLVERPETSC,MAT_FACTOR_LU,&F);CHKERRQ(ierr);
+    ierr = MatLUFactorSymbolic(F,B,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(F,B,&info);CHKERRQ(ierr);
+    ierr = MatSolve(F,z,y);CHKERRQ(ierr);
+    ierr = MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_LU,&G);CHKERRQ(ierr);
+    ierr = MatLUFactorSymbolic(G,A,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(G,A,&info);CHKERRQ(ierr);
+    ierr = MatSolve(G,z,w);CHKERRQ(ierr);
+    ierr = PrintSingle("MatSolve() with the LU factors",y,w,r);CHKERRQ(ierr);
+    ierr = MatDestroy(&F);CHKERRQ(ierr);
+    ierr = MatDestroy(&G);CHKERRQ(ierr);
+    ierr = ISDestroy(&isrow);CHKERRQ(ierr);
+    ierr = ISDestroy(&iscol);CHKERRQ(ierr);
+
+    info.fill = 1.0;
+    ierr = MatGetOrdering(A,MATORDERINGNATURAL,&isrow,&iscol);CHKERRQ(ierr);
+    ierr = MatGetFactor(B,MATSOLVERPETSC,MAT_FACTOR_ILU,&F);CHKERRQ(ierr);
+    ierr = MatILUFactorSymbolic(F,B,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(F,B,&info);CHKERRQ(ierr);
+    ierr = MatSolve(F,z,y);CHKERRQ(ierr);
+    ierr = MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_ILU,&G);CHKERRQ(ierr);
+    ierr = MatILUFactorSymbolic(G,A,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(G,A,&info);CHKERRQ(ierr);
+    ierr = MatSolve(G,z,w);CHKERRQ(ierr);
+    ierr = PrintSingle("MatSolve() with the ILU(0) factors",y,w,r);CHKERRQ(ierr);
+    ierr = MatDestroy(&F);CHKERRQ(ierr);
+    ierr = MatDestroy(&G);CHKERRQ(ierr);
+    ierr = ISDestroy(&isrow);CHKERRQ(ierr);
+    ierr = ISDestroy(&iscol);CHKERRQ(ierr);
+  }
+
+  /* the Galerkin product of AIJSINGLE with an AIJ interpolation (pairs of rows aggregated) is AIJSINGLE, also when reused */
+  ierr = MatCreateAIJ(comm,PETSC_DECIDE,PETSC_DECIDE,n*n,n*n/2,1,NULL,1,NULL,&P);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(P,&Istart,&Iend);CHKERRQ(ierr);
+  for (k=Istart; k<Iend; k++) {ierr = MatSetValue(P,k,k/2,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = MatAssemblyBegin(P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatPtAP(B,P,MAT_INITIAL_MATRIX,2.0,&C);CHKERRQ(ierr);
+  ierr = MatPtAP(A,P,MAT_INITIAL_MATRIX,2.0,&D);CHKERRQ(ierr);
+  ierr = MatGetType(C,&type);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"MatPtAP() of MATAIJSINGLE gives type %s\n",type);CHKERRQ(ierr);
+  ierr = MatScale(A,0.5);CHKERRQ(ierr);
+  ierr = MatScale(B,0.5);CHKERRQ(ierr);
+  ierr = MatPtAP(B,P,MAT_REUSE_MATRIX,2.0,&C);CHKERRQ(ierr);
+  ierr = MatPtAP(A,P,MAT_REUSE_MATRIX,2.0,&D);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = MatCreateVecs(C,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&r);CHKERRQ(ierr);
+  ierr = SetSines(x,1.0);CHKERRQ(ierr);
+  ierr = MatMult(C,x,y);CHKERRQ(ierr);
+  ierr = MatMult(D,x,w);CHKERRQ(ierr);
+  ierr = PrintSingle("MatMult() of the reused MatPtAP()",y,w,r);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = MatDestroy(&D);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+
+  /* the values changed through the array or by MatRetrieveValues() leave the object state alone, the single precision copy must follow them */
+  ierr = MatCreate(PETSC_COMM_SELF,&S);CHKERRQ(ierr);
+  ierr = MatSetSizes(S,4,4,4,4);CHKERRQ(ierr);
+  ierr = MatSetType(S,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(S,1,NULL);CHKERRQ(ierr);
+  for (k=0; k<4; k++) {ierr = MatSetValue(S,k,k,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = MatAssemblyBegin(S,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(S,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(S,&x,&y);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+  ierr = MatMult(S,x,y);CHKERRQ(ierr);
+  ierr = VecSum(y,&sum);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"Sum of MatMult() of the identity: %g\n",(double)PetscRealPart(sum));CHKERRQ(ierr);
+  ierr = MatSeqAIJGetArray(S,&a);CHKERRQ(ierr);
+  for (k=0; k<4; k++) a[k] = 5.0;
+  ierr = MatSeqAIJRestoreArray(S,&a);CHKERRQ(ierr);
+  ierr = MatMult(S,x,y);CHKERRQ(ierr);
+  ierr = VecSum(y,&sum);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"Sum of MatMult() after setting the values to 5 with MatSeqAIJGetArray(): %g\n",(double)PetscRealPart(sum));CHKERRQ(ierr);
+  ierr = MatSetOption(S,MAT_NEW_NONZERO_LOCATIONS,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatStoreValues(S);CHKERRQ(ierr);
+  ierr = MatScale(S,2.0);CHKERRQ(ierr);
+  ierr = MatMult(S,x,y);CHKERRQ(ierr);
+  ierr = VecSum(y,&sum);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"Sum of MatMult() after MatStoreValues() and MatScale(): %g\n",(double)PetscRealPart(sum));CHKERRQ(ierr);
+  ierr = MatRetrieveValues(S);CHKERRQ(ierr);
+  ierr = MatMult(S,x,y);CHKERRQ(ierr);
+  ierr = VecSum(y,&sum);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"Sum of MatMult() after MatRetrieveValues(): %g\n",(double)PetscRealPart(sum));CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = MatDestroy(&S);CHKERRQ(ierr);
+
+  /* the preconditioner built from AIJSINGLE is (nearly) as good as the one built from AIJ */
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecSet(y,1.0);CHKERRQ(ierr);
+  ierr = Solve("AIJ",A,A,y,x);CHKERRQ(ierr);
+  ierr = Solve("AIJSINGLE",A,B,y,z);CHKERRQ(ierr);
+  ierr = VecAXPY(z,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(z,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"The solutions differ by %s\n",nrm > 1.e-7 ? "MORE than 1e-7" : "less than 1e-7");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -ksp_type cg -pc_type ilu
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -ksp_type cg -pc_type bjacobi -sub_pc_type ilu
+
+   test:
+      suffix: gamg
+      args: -ksp_type cg -pc_type gamg -mg_levels_pc_type sor
+
+   test:
+      suffix: gamg_2
+      nsize: 2
+      args: -ksp_type cg -pc_type gamg -mg_levels_pc_type sor
+
+   test:
+      suffix: sor
+      args: -ksp_type cg -pc_type sor -pc_sor_symmetric
+
+TEST*/
@@ -0,0 +1,150 @@
+static char help[] = "Tests MATAIJDELTA, the AIJ matrix whose products read compressed column indices, against AIJ.\n\
+  -n <n>      : the grid has n x n points\n\
+  -long       : couple every tenth row to a far away column, so that these rows use the full indices\n\
+  -empty      : leave four out of five rows empty, so that the compressed row storage is used\n\n";
+
+#include <petscmat.h>
+
+/* prints the norm of the MATAIJDELTA product y and whether it equals the AIJ product w, using the work vector r */
+static PetscErrorCode PrintProduct(const char *op,Vec y,Vec w,Vec r)
+{
+  PetscErrorCode ierr;
+  PetscReal      nrm,err;
+
+  PetscFunctionBeginUser;
+  ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecWAXPY(r,-1.0,y,w);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PetscObjectComm((PetscObject)y),"%s: norm %g, %s AIJ\n",op,(double)nrm,err > 100*PETSC_MACHINE_EPSILON*PetscMax(nrm,1.0) ? "DIFFERENT from" : "equal to");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C;
+  Vec            x,y,z,w,r;
+  MPI_Comm       comm;
+  PetscInt       n = 12,N,Istart,Iend,i,j,k,nc,cols[6],row,col;
+  PetscScalar    vals[6],v = 2.0;
+  PetscBool      farcols = PETSC_FALSE,empty = PETSC_FALSE;
+  MatType        type;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  comm = PETSC_COMM_WORLD;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-long",&farcols,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-empty",&empty,NULL);CHKERRQ(ierr);
+  N    = n*n;
+
+  /* the 5-point Laplacian, with the far couplings starting a new span of columns */
+  ierr = MatCreate(comm,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,6,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,6,NULL,3,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (k=Istart; k<Iend; k++) {
+    if (empty && k % 5) continue;
+    i  = k/n; j = k%n; nc = 0;
+    if (i > 0)   {cols[nc] = k-n; vals[nc++] = -1.0;}
+    if (j > 0)   {cols[nc] = k-1; vals[nc++] = -1.0 - 0.1*j;}
+    cols[nc] = k; vals[nc++] = 5.0 + 0.01*k;
+    if (j < n-1) {cols[nc] = k+1; vals[nc++] = -1.0 + 0.1*j;}
+    if (i < n-1) {cols[nc] = k+n; vals[nc++] = -1.0;}
+    if (farcols && !(k % 10)) {cols[nc] = (k + N/2) % N; vals[nc++] = 0.5;}
+    ierr = MatSetValues(A,1,&k,nc,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJDELTA,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = MatGetType(B,&type);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"MatConvert() to MATAIJDELTA gives type %s\n",type);CHKERRQ(ierr);
+
+  /* vectors independent of the number of processes */
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&r);CHKERRQ(ierr);
+  for (k=Istart; k<Iend; k++) {
+    ierr = VecSetValue(x,k,PetscSinReal((PetscReal)(k+1)),INSERT_VALUES);CHKERRQ(ierr);
+    ierr = VecSetValue(z,k,PetscCosReal((PetscReal)(k+1)),INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(z);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(z);CHKERRQ(ierr);
+
+  ierr = MatMult(B,x,y);CHKERRQ(ierr);
+  ierr = MatMult(A,x,w);CHKERRQ(ierr);
+  ierr = PrintProduct("MatMult()",y,w,r);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,z,w);CHKERRQ(ierr);
+  ierr = PrintProduct("MatMultAdd()",y,w,r);CHKERRQ(ierr);
+  ierr = VecCopy(z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,y,y);CHKERRQ(ierr);
+  ierr = PrintProduct("in-place MatMultAdd()",y,w,r);CHKERRQ(ierr);
+
+  /* a duplicate has its own offsets */
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+  ierr = MatMult(C,x,y);CHKERRQ(ierr);
+  ierr = MatMult(A,x,w);CHKERRQ(ierr);
+  ierr = PrintProduct("MatMult() of the duplicate",y,w,r);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+
+  /* a new nonzero far from the diagonal changes the nonzero structure, so the offsets are computed again */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&row,NULL);CHKERRQ(ierr);
+  col  = N-1;
+  ierr = MatSetValues(A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatSetValues(B,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatMult(B,x,y);CHKERRQ(ierr);
+  ierr = MatMult(A,x,w);CHKERRQ(ierr);
+  ierr = PrintProduct("MatMult() after a new nonzero",y,w,r);CHKERRQ(ierr);
+
+  /* back to AIJ */
+  ierr = MatConvert(B,MATAIJ,MAT_INPLACE_MATRIX,&B);CHKERRQ(ierr);
+  ierr = MatGetType(B,&type);CHKERRQ(ierr);
+  ierr = MatMult(B,x,y);CHKERRQ(ierr);
+  ierr = PrintProduct("MatMult() after MatConvert() to AIJ",y,w,r);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"MatConvert() back to MATAIJ gives type %s\n",type);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      args: -long -empty -mat_aijdelta_bits 16
+
+   test:
+      suffix: 3
+      args: -n 140 -long
+
+   test:
+      suffix: 4
+      nsize: 3
+      args: -long
+
+   test:
+      suffix: 5
+      nsize: 2
+      args: -empty -mat_aijdelta_bits 8
+
+TEST*/
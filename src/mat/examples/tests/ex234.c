@@ -0,0 +1,168 @@
+static char help[] = "Tests the level scheduled triangular solves (-mat_solve_levels) of the SeqAIJ factors against the sequential ones.\n\
+  -n <n>            : the grid has n x n points\n\
+  -ftype <type>     : LU, ILU, CHOLESKY or ICC\n\
+  -levels <k>       : levels of fill of ILU and ICC\n\
+  -ordering <type>  : ordering of the factor\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode Factor(Mat A,MatFactorType ftype,IS row,IS col,MatFactorInfo *info,Mat *F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,F);CHKERRQ(ierr);
+  switch (ftype) {
+  case MAT_FACTOR_LU:
+    ierr = MatLUFactorSymbolic(*F,A,row,col,info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(*F,A,info);CHKERRQ(ierr);
+    break;
+  case MAT_FACTOR_ILU:
+    ierr = MatILUFactorSymbolic(*F,A,row,col,info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(*F,A,info);CHKERRQ(ierr);
+    break;
+  case MAT_FACTOR_CHOLESKY:
+    ierr = MatCholeskyFactorSymbolic(*F,A,row,info);CHKERRQ(ierr);
+    ierr = MatCholeskyFactorNumeric(*F,A,info);CHKERRQ(ierr);
+    break;
+  case MAT_FACTOR_ICC:
+    ierr = MatICCFactorSymbolic(*F,A,row,info);CHKERRQ(ierr);
+    ierr = MatCholeskyFactorNumeric(*F,A,info);CHKERRQ(ierr);
+    break;
+  default: SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Factor type not tested");
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Refactor(Mat A,MatFactorType ftype,MatFactorInfo *info,Mat F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU) {
+    ierr = MatLUFactorNumeric(F,A,info);CHKERRQ(ierr);
+  } else {
+    ierr = MatCholeskyFactorNumeric(F,A,info);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* prints the norm of the level scheduled solution x and whether it equals the sequential solution w, using the work vector r */
+static PetscErrorCode PrintSolution(const char *op,Vec x,Vec w,Vec r)
+{
+  PetscErrorCode ierr;
+  PetscReal      nrm,err;
+
+  PetscFunctionBeginUser;
+  ierr = VecNorm(x,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecWAXPY(r,-1.0,x,w);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%s: norm %g, %s the sequential solve\n",op,(double)nrm,err > 100*PETSC_MACHINE_EPSILON*PetscMax(nrm,1.0) ? "DIFFERENT from" : "equal to");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat             A,F0,F1;
+  Vec             b,x,w,r;
+  IS              row,col;
+  MatFactorInfo   info;
+  MatFactorType   ftype = MAT_FACTOR_LU;
+  PetscInt        n = 20,levels = 0,t,i,j,k,N,cols[5],nc;
+  PetscScalar     v[5],c;
+  char            ordering[256] = MATORDERINGNATURAL,name[64];
+  PetscErrorCode  ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-levels",&levels,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-ftype",MatFactorTypes,(PetscEnum*)&ftype,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-ordering",ordering,sizeof(ordering),NULL);CHKERRQ(ierr);
+  N    = n*n;
+
+  /* 5-point stencil on an n x n grid, with a convection term unless the matrix is symmetric */
+  c    = (ftype == MAT_FACTOR_CHOLESKY || ftype == MAT_FACTOR_ICC) ? 0.0 : 0.3;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,N,N,5,NULL,&A);CHKERRQ(ierr);
+  for (k=0; k<N; k++) {
+    i  = k/n; j = k%n; nc = 0;
+    if (i > 0)   {cols[nc] = k-n; v[nc++] = -1.0 - c;}
+    if (j > 0)   {cols[nc] = k-1; v[nc++] = -1.0 - c;}
+    cols[nc] = k; v[nc++] = 4.5;
+    if (j < n-1) {cols[nc] = k+1; v[nc++] = -1.0 + c;}
+    if (i < n-1) {cols[nc] = k+n; v[nc++] = -1.0 + c;}
+    ierr = MatSetValues(A,1,&k,nc,cols,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatGetOrdering(A,ordering,&row,&col);CHKERRQ(ierr);
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.fill   = 5.0;
+  info.levels = levels;
+
+  /* the option is read by MatGetFactor() */
+  ierr = PetscOptionsClearValue(NULL,"-mat_solve_levels");CHKERRQ(ierr);
+  ierr = Factor(A,ftype,row,col,&info,&F0);CHKERRQ(ierr);
+  ierr = PetscOptionsSetValue(NULL,"-mat_solve_levels",NULL);CHKERRQ(ierr);
+  ierr = Factor(A,ftype,row,col,&info,&F1);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&r);CHKERRQ(ierr);
+  for (t=0; t<2; t++) {
+    for (k=0; k<N; k++) {ierr = VecSetValue(b,k,PetscSinReal((PetscReal)(k+1)*(t+1)),INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+    ierr = MatSolve(F0,b,w);CHKERRQ(ierr);
+    ierr = MatSolve(F1,b,x);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(name,sizeof(name),"%s MatSolve() %D",MatFactorTypes[ftype],t);CHKERRQ(ierr);
+    ierr = PrintSolution(name,x,w,r);CHKERRQ(ierr);
+  }
+
+  /* new values with the same nonzero structure reuse the levels */
+  ierr = MatShift(A,1.0);CHKERRQ(ierr);
+  ierr = Refactor(A,ftype,&info,F0);CHKERRQ(ierr);
+  ierr = Refactor(A,ftype,&info,F1);CHKERRQ(ierr);
+  ierr = MatSolve(F0,b,w);CHKERRQ(ierr);
+  ierr = MatSolve(F1,b,x);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"%s MatSolve() after a new numeric factorization",MatFactorTypes[ftype]);CHKERRQ(ierr);
+  ierr = PrintSolution(name,x,w,r);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  ierr = MatDestroy(&F0);CHKERRQ(ierr);
+  ierr = MatDestroy(&F1);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -ftype LU -ordering nd
+
+   test:
+      suffix: 2
+      args: -ftype ILU -levels 1
+
+   test:
+      suffix: 3
+      args: -ftype ILU -ordering rcm -mat_solve_levels_threads 2
+
+   test:
+      suffix: 4
+      args: -ftype CHOLESKY -ordering nd
+
+   test:
+      suffix: 5
+      args: -ftype ICC
+
+   test:
+      suffix: 6
+      args: -ftype ICC -levels 2 -ordering rcm
+
+TEST*/
@@ -0,0 +1,106 @@
+static char help[] = "Test MatMatMult() of an MPIAIJ matrix with interlaced fields and a dense matrix.\n\n\
+  -n <n>     : the number of grid points in each direction\n\
+  -dof <dof> : the number of fields at each grid point\n\
+  -k <k>     : the number of columns of the dense matrix\n\n";
+
+/*
+   Each field of a grid point is coupled to all the fields of the neighboring points, so the ghost columns of the
+   off-diagonal block come in aligned runs of dof indices and VecScatterCreate() builds a block scatter for them.
+*/
+#include <petscmat.h>
+
+int main(int argc,char **argv)
+{
+  Mat            A,B,C;
+  Vec            x,y,z,c;
+  PetscInt       n = 12,dof = 3,k = 4,N,Istart,Iend,Ii,i,j,l,f,p,J,col;
+  PetscScalar    *b;
+  PetscReal      norm,cnorm;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-k",&k,NULL);CHKERRQ(ierr);
+  N    = n*n*dof;
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(A,dof);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5*dof,NULL,5*dof,NULL);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5*dof,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    PetscInt ni[5],nj[5];
+
+    p = Ii/dof; f = Ii - p*dof; i = p/n; j = p - i*n;
+    ni[0] = i; nj[0] = j; ni[1] = i-1; nj[1] = j; ni[2] = i+1; nj[2] = j; ni[3] = i; nj[3] = j-1; ni[4] = i; nj[4] = j+1;
+    for (l=0; l<5; l++) {
+      if (ni[l] < 0 || ni[l] >= n || nj[l] < 0 || nj[l] >= n) continue;
+      for (J=0; J<dof; J++) {
+        PetscScalar v = l ? -1.0/(1+J+f) : (J == f ? 4.0*dof : -1.0);
+
+        col  = (ni[l]*n+nj[l])*dof + J;
+        ierr = MatSetValue(A,Ii,col,v,INSERT_VALUES);CHKERRQ(ierr);
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  /* entries independent of the number of processes */
+  ierr = MatCreateDense(PETSC_COMM_WORLD,Iend-Istart,PETSC_DECIDE,N,k,NULL,&B);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(B,&b);CHKERRQ(ierr);
+  for (J=0; J<k; J++) {
+    for (Ii=Istart; Ii<Iend; Ii++) b[Ii-Istart+J*(Iend-Istart)] = PetscSinReal((PetscReal)(Ii+1)*(J+1));
+  }
+  ierr = MatDenseRestoreArray(B,&b);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatMatMult(A,B,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&C);CHKERRQ(ierr);
+  ierr = MatMatMult(A,B,MAT_REUSE_MATRIX,PETSC_DEFAULT,&C);CHKERRQ(ierr);
+
+  /* compare each column of C with the product of A and the column of B */
+  ierr = MatCreateVecs(B,&c,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  for (J=0; J<k; J++) {
+    ierr = VecSet(c,0.0);CHKERRQ(ierr);
+    ierr = VecSetValue(c,J,1.0,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = VecAssemblyBegin(c);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(c);CHKERRQ(ierr);
+    ierr = MatMult(B,c,x);CHKERRQ(ierr);
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = MatMult(C,c,z);CHKERRQ(ierr);
+    ierr = VecNorm(z,NORM_2,&cnorm);CHKERRQ(ierr);
+    ierr = VecAXPY(z,-1.0,y);CHKERRQ(ierr);
+    ierr = VecNorm(z,NORM_2,&norm);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Column %D: norm %g, %s\n",J,(double)cnorm,norm < 1.e-10*cnorm ? "equal to MatMult()" : "DIFFERENT from MatMult()");CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&c);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      output_file: output/ex235_1.out
+
+   test:
+      suffix: 2
+      nsize: 3
+      output_file: output/ex235_1.out
+      args: -vecscatter_type {{sf mpi1}}
+
+TEST*/
@@ -339,6 +339,12 @@ int main(int argc,char **argv)
      args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via scalable -inner_diag_matmatmult_via rowmerge -inner_offdiag_matmatmult_via rowmerge
      output_file: output/ex96_1.out
 
+   test:
+     suffix: seq_hash
+     nsize: 3
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via scalable -inner_diag_matmatmult_via hash -inner_offdiag_matmatmult_via hash
+     output_file: output/ex96_1.out
+
    test:
      suffix: allatonce
      nsize: 3
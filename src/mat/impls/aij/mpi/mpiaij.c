@@ -20,7 +20,7 @@
 . -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
 
   Developer Notes:
-    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
+    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJOMP, MATAIJSINGLE, MATAIJDELTA, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
    enough exist.
 
   Level: beginner
@@ -633,6 +633,93 @@ PetscErrorCode MatSetValues_MPIAIJ(Mat mat,PetscInt m,const PetscInt im[],PetscI
   PetscFunctionReturn(0);
 }
 
+/*
+    Used instead of MatSetValues_MPIAIJ() until the first final assembly when MAT_USE_HASH_TABLE is set.
+    Local entries go into the hash tables of the diagonal and off-diagonal blocks, the latter still indexed
+    by global column, off-process entries are stashed as usual.
+*/
+PetscErrorCode MatSetValues_MPIAIJ_Hash(Mat mat,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode addv)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *a   = (Mat_SeqAIJ*)aij->A->data,*b = (Mat_SeqAIJ*)aij->B->data;
+  PetscInt       i,j,row,rstart = mat->rmap->rstart,rend = mat->rmap->rend;
+  PetscInt       cstart = mat->cmap->rstart,cend = mat->cmap->rend;
+  PetscBool      roworiented = aij->roworiented;
+  PetscBool      ignorezeroentries = a->ignorezeroentries;
+  PetscScalar    value;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    if (im[i] < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (im[i] >= mat->rmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",im[i],mat->rmap->N-1);
+#endif
+    if (im[i] >= rstart && im[i] < rend) {
+      row = im[i] - rstart;
+      for (j=0; j<n; j++) {
+        if (in[j] < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+        if (in[j] >= mat->cmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",in[j],mat->cmap->N-1);
+#endif
+        if (roworiented) value = v[i*n+j];
+        else             value = v[i+j*m];
+        if (ignorezeroentries && value == 0.0 && (addv == ADD_VALUES) && im[i] != in[j]) continue;
+        if (in[j] >= cstart && in[j] < cend) {
+          ierr = MatSeqAIJSetValueHash_Private(a,row,in[j]-cstart,value,addv);CHKERRQ(ierr);
+        } else {
+          ierr = MatSeqAIJSetValueHash_Private(b,row,in[j],value,addv);CHKERRQ(ierr);
+        }
+      }
+    } else {
+      if (mat->nooffprocentries) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Setting off process row %D even though MatSetOption(,MAT_NO_OFF_PROC_ENTRIES,PETSC_TRUE) was set",im[i]);
+      if (!aij->donotstash) {
+        mat->assembled = PETSC_FALSE;
+        if (roworiented) {
+          ierr = MatStashValuesRow_Private(&mat->stash,im[i],n,in,v+i*n,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        } else {
+          ierr = MatStashValuesCol_Private(&mat->stash,im[i],n,in,v+i,m,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    Switches the diagonal and off-diagonal blocks to hash table assembly, see MAT_USE_HASH_TABLE
+*/
+static PetscErrorCode MatMPIAIJSetUpHash_Private(Mat mat)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetOption(aij->A,MAT_USE_HASH_TABLE,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatSetOption(aij->B,MAT_USE_HASH_TABLE,PETSC_TRUE);CHKERRQ(ierr);
+  mat->ops->setvalues = MatSetValues_MPIAIJ_Hash;
+  PetscFunctionReturn(0);
+}
+
+/*
+    Frees the communication pattern and the maps built by MatSetPreallocationCOO()
+*/
+static PetscErrorCode MatResetPreallocationCOO_MPIAIJ(Mat mat)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFDestroy(&aij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscFree(aij->coo_sendperm);CHKERRQ(ierr);
+  ierr = PetscFree4(aij->coo_jmap1,aij->coo_perm1,aij->coo_jmap2,aij->coo_perm2);CHKERRQ(ierr);
+  ierr = PetscFree2(aij->coo_sendbuf,aij->coo_recvbuf);CHKERRQ(ierr);
+  aij->coo_n     = 0;
+  aij->coo_nsend = 0;
+  aij->coo_nrecv = 0;
+  PetscFunctionReturn(0);
+}
+
 /*
     This function sets the j and ilen arrays (of the diagonal and off-diagonal part) of an MPIAIJ-matrix.
     The values in mat_i have to be sorted and the values in mat_j have to be sorted for each row (CSR-like).
@@ -805,13 +892,22 @@ PetscErrorCode MatAssemblyEnd_MPIAIJ(Mat mat,MatAssemblyType mode)
         if (j < n) ncols = j-i;
         else       ncols = n-i;
         /* Now assemble all these values with a single function call */
-        ierr = MatSetValues_MPIAIJ(mat,1,row+i,ncols,col+i,val+i,mat->insertmode);CHKERRQ(ierr);
+        if (a->ht) {
+          ierr = MatSetValues_MPIAIJ_Hash(mat,1,row+i,ncols,col+i,val+i,mat->insertmode);CHKERRQ(ierr);
+        } else {
+          ierr = MatSetValues_MPIAIJ(mat,1,row+i,ncols,col+i,val+i,mat->insertmode);CHKERRQ(ierr);
+        }
 
         i = j;
       }
     }
     ierr = MatStashScatterEnd_Private(&mat->stash);CHKERRQ(ierr);
   }
+  if (a->ht && mode == MAT_FINAL_ASSEMBLY) {
+    /* the off-diagonal structure must exist before MatSetUpMultiply_MPIAIJ() compacts its columns */
+    ierr = MatSeqAIJAssembleHash_Private(aij->B);CHKERRQ(ierr);
+    mat->ops->setvalues = MatSetValues_MPIAIJ;
+  }
   ierr = MatAssemblyBegin(aij->A,mode);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(aij->A,mode);CHKERRQ(ierr);
 
@@ -1229,6 +1325,7 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   if (aij->Mvctx_mpi1) {ierr = VecScatterDestroy(&aij->Mvctx_mpi1);CHKERRQ(ierr);}
   ierr = PetscFree2(aij->rowvalues,aij->rowindices);CHKERRQ(ierr);
   ierr = PetscFree(aij->ld);CHKERRQ(ierr);
+  ierr = MatResetPreallocationCOO_MPIAIJ(mat);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)mat,0);CHKERRQ(ierr);
@@ -1249,6 +1346,9 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
 #endif
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_is_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatPtAP_is_mpiaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatPtAP_mpiaijsingle_mpiaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1823,6 +1923,14 @@ PetscErrorCode MatSetOption_MPIAIJ(Mat A,MatOption op,PetscBool flg)
   case MAT_IGNORE_OFF_PROC_ENTRIES:
     a->donotstash = flg;
     break;
+  case MAT_USE_HASH_TABLE:
+    if (A->assembled || A->was_assembled) {
+      ierr = PetscInfo1(A,"Option %s ignored after the first assembly\n",MatOptions[op]);CHKERRQ(ierr);
+    } else {
+      a->ht_flag = flg;
+      if (flg && A->preallocated) {ierr = MatMPIAIJSetUpHash_Private(A);CHKERRQ(ierr);}
+    }
+    break;
   /* Symmetry flags are handled directly by MatSetOption() and they don't affect preallocation */
   case MAT_SPD:
   case MAT_SYMMETRIC:
@@ -2170,10 +2278,16 @@ PetscErrorCode MatCopy_MPIAIJ(Mat A,Mat B,MatStructure str)
 
 PetscErrorCode MatSetUp_MPIAIJ(Mat A)
 {
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = MatMPIAIJSetPreallocation(A,PETSC_DEFAULT,0,PETSC_DEFAULT,0);CHKERRQ(ierr);
+  if (a->ht_flag) {
+    /* storage is allocated from the hash tables in MatAssemblyEnd() */
+    ierr = MatMPIAIJSetPreallocation(A,0,0,0,0);CHKERRQ(ierr);
+  } else {
+    ierr = MatMPIAIJSetPreallocation(A,PETSC_DEFAULT,0,PETSC_DEFAULT,0);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
@@ -2517,8 +2631,9 @@ PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat A,PetscBool sc)
 
 PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat A)
 {
+  Mat_MPIAIJ           *a = (Mat_MPIAIJ*)A->data;
   PetscErrorCode       ierr;
-  PetscBool            sc = PETSC_FALSE,flg;
+  PetscBool            sc = PETSC_FALSE,ht,flg;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"MPIAIJ options");CHKERRQ(ierr);
@@ -2527,6 +2642,10 @@ PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat
   if (flg) {
     ierr = MatMPIAIJSetUseScalableIncreaseOverlap(A,sc);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-mat_use_hash_table","Collect entries in hash tables and build the exact nonzero structure at the first assembly","MatSetOption",a->ht_flag,&ht,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = MatSetOption(A,MAT_USE_HASH_TABLE,ht);CHKERRQ(ierr);
+  }
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -2787,9 +2906,11 @@ PetscErrorCode  MatMPIAIJSetPreallocation_MPIAIJ(Mat B,PetscInt d_nz,const Petsc
 
   ierr = MatSeqAIJSetPreallocation(b->A,d_nz,d_nnz);CHKERRQ(ierr);
   ierr = MatSeqAIJSetPreallocation(b->B,o_nz,o_nnz);CHKERRQ(ierr);
+  ierr = MatResetPreallocationCOO_MPIAIJ(B);CHKERRQ(ierr);
   B->preallocated  = PETSC_TRUE;
   B->was_assembled = PETSC_FALSE;
   B->assembled     = PETSC_FALSE;
+  if (b->ht_flag) {ierr = MatMPIAIJSetUpHash_Private(B);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
@@ -2815,12 +2936,268 @@ PetscErrorCode MatResetPreallocation_MPIAIJ(Mat B)
 
   ierr = MatResetPreallocation(b->A);CHKERRQ(ierr);
   ierr = MatResetPreallocation(b->B);CHKERRQ(ierr);
+  ierr = MatResetPreallocationCOO_MPIAIJ(B);CHKERRQ(ierr);
   B->preallocated  = PETSC_TRUE;
   B->was_assembled = PETSC_FALSE;
   B->assembled = PETSC_FALSE;
   PetscFunctionReturn(0);
 }
 
+/*
+    Entries of off-process rows are sent once to their owners to build the nonzero structure; the PetscSF
+    created for this (one leaf per received entry, its root is the position in the sender's buffer) is kept
+    to move the values in MatSetValuesCOO(). Each nonzero of the diagonal (A) and off-diagonal (B) block then
+    records which local and which received entries are summed into it.
+*/
+PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat mat,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIAIJ     *aij;
+  Mat_SeqAIJ     *a,*b;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+  PetscMPIInt    size,rank,nto = 0,nfrom,*toranks,*fromranks;
+  PetscInt       k,t,r,p,u,d,m,M,N,rstart,rend,cstart,cend,owner,nown,nsend,nrecv,ntot,nuniq,nzA,nzB,da,db;
+  PetscInt       *sendcnt,*sendoff,*todata,*fromdata = NULL,*sendperm,*sendij,*recvij;
+  PetscInt       *rowptr,*cnt,*cols,*src,*ucols,*urow,*ustart,*dest,*dnnz,*onnz,*jmap1,*perm1,*jmap2,*perm2;
+  PetscScalar    *zeros;
+  PetscSFNode    *iremote;
+  PetscSF        sf;
+
+  PetscFunctionBegin;
+  ierr   = PetscObjectGetComm((PetscObject)mat,&comm);CHKERRQ(ierr);
+  ierr   = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr   = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr   = PetscLayoutSetUp(mat->rmap);CHKERRQ(ierr);
+  ierr   = PetscLayoutSetUp(mat->cmap);CHKERRQ(ierr);
+  m      = mat->rmap->n;
+  M      = mat->rmap->N;
+  N      = mat->cmap->N;
+  rstart = mat->rmap->rstart;
+  rend   = mat->rmap->rend;
+  cstart = mat->cmap->rstart;
+  cend   = mat->cmap->rend;
+
+  /* count the entries that go to each process; entries with a negative index are ignored */
+  ierr = PetscCalloc2(size,&sendcnt,size+1,&sendoff);CHKERRQ(ierr);
+  for (k=0,nown=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_i[k] >= M) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D: row %D out of range [0,%D)",k,coo_i[k],M);
+    if (coo_j[k] >= N) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D: column %D out of range [0,%D)",k,coo_j[k],N);
+    if (coo_i[k] >= rstart && coo_i[k] < rend) {nown++; continue;}
+    ierr = PetscLayoutFindOwner(mat->rmap,coo_i[k],&owner);CHKERRQ(ierr);
+    sendcnt[owner]++;
+  }
+  for (r=0; r<size; r++) {
+    sendoff[r+1] = sendoff[r] + sendcnt[r];
+    if (sendcnt[r]) nto++;
+  }
+  nsend = sendoff[size];
+
+  /* pack the indices of the entries to send, grouped by owner */
+  ierr = PetscMalloc1(nsend,&sendperm);CHKERRQ(ierr);
+  ierr = PetscMalloc1(2*nsend,&sendij);CHKERRQ(ierr);
+  ierr = PetscMemzero(sendcnt,size*sizeof(PetscInt));CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0 || (coo_i[k] >= rstart && coo_i[k] < rend)) continue;
+    ierr        = PetscLayoutFindOwner(mat->rmap,coo_i[k],&owner);CHKERRQ(ierr);
+    t           = sendoff[owner] + sendcnt[owner]++;
+    sendperm[t] = k;
+    sendij[2*t]   = coo_i[k];
+    sendij[2*t+1] = coo_j[k];
+  }
+
+  /* each receiver learns how many entries it gets from whom and where they start in the sender's buffer */
+  ierr = PetscMalloc2(nto,&toranks,2*nto,&todata);CHKERRQ(ierr);
+  for (r=0,t=0; r<size; r++) {
+    if (!sendcnt[r]) continue;
+    toranks[t]    = r;
+    todata[2*t]   = sendcnt[r];
+    todata[2*t+1] = sendoff[r];
+    t++;
+  }
+  ierr = PetscCommBuildTwoSided(comm,2,MPIU_INT,nto,toranks,todata,&nfrom,&fromranks,&fromdata);CHKERRQ(ierr);
+  ierr = PetscFree2(toranks,todata);CHKERRQ(ierr);
+  ierr = PetscFree2(sendcnt,sendoff);CHKERRQ(ierr);
+
+  for (r=0,nrecv=0; r<nfrom; r++) nrecv += fromdata[2*r];
+  ierr = PetscMalloc1(nrecv,&iremote);CHKERRQ(ierr);
+  for (r=0,p=0; r<nfrom; r++) {
+    for (t=0; t<fromdata[2*r]; t++,p++) {
+      iremote[p].rank  = fromranks[r];
+      iremote[p].index = fromdata[2*r+1] + t;
+    }
+  }
+  ierr = PetscFree(fromranks);CHKERRQ(ierr);
+  ierr = PetscFree(fromdata);CHKERRQ(ierr);
+  ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf,nsend,nrecv,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+
+  /* the (i,j) pairs move in a single operation: concurrent ones on the same PetscSF are told apart by their root
+     arrays, which are all NULL on processes that send nothing */
+  ierr = PetscMalloc1(2*nrecv,&recvij);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(sf,MPIU_2INT,sendij,recvij);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,MPIU_2INT,sendij,recvij);CHKERRQ(ierr);
+  ierr = PetscFree(sendij);CHKERRQ(ierr);
+
+  /* bucket the owned and received entries by local row and sort them by column; src[] < ncoo refers to coo_v[], otherwise to the receive buffer */
+  ntot = nown + nrecv;
+  ierr = PetscCalloc2(m+1,&rowptr,m,&cnt);CHKERRQ(ierr);
+  ierr = PetscMalloc2(ntot,&cols,ntot,&src);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] < rstart || coo_i[k] >= rend || coo_j[k] < 0) continue;
+    rowptr[coo_i[k]-rstart+1]++;
+  }
+  for (t=0; t<nrecv; t++) {
+    if (recvij[2*t] < rstart || recvij[2*t] >= rend) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Received row %D not owned by process %d",recvij[2*t],rank);
+    rowptr[recvij[2*t]-rstart+1]++;
+  }
+  for (r=0; r<m; r++) rowptr[r+1] += rowptr[r];
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] < rstart || coo_i[k] >= rend || coo_j[k] < 0) continue;
+    p       = rowptr[coo_i[k]-rstart] + cnt[coo_i[k]-rstart]++;
+    cols[p] = coo_j[k];
+    src[p]  = k;
+  }
+  for (t=0; t<nrecv; t++) {
+    p       = rowptr[recvij[2*t]-rstart] + cnt[recvij[2*t]-rstart]++;
+    cols[p] = recvij[2*t+1];
+    src[p]  = ncoo + t;
+  }
+  ierr = PetscFree(recvij);CHKERRQ(ierr);
+  for (r=0; r<m; r++) {
+    ierr = PetscSortIntWithArray(rowptr[r+1]-rowptr[r],cols+rowptr[r],src+rowptr[r]);CHKERRQ(ierr);
+  }
+
+  /* merge repeated (i,j) pairs: ustart[u] is the first position in cols[] of the u-th distinct nonzero */
+  ierr = PetscMalloc5(ntot,&ucols,ntot,&urow,ntot+1,&ustart,m,&dnnz,m,&onnz);CHKERRQ(ierr);
+  for (r=0,nuniq=0; r<m; r++) {
+    dnnz[r] = onnz[r] = 0;
+    for (p=rowptr[r]; p<rowptr[r+1]; p++) {
+      if (p > rowptr[r] && cols[p] == cols[p-1]) continue;
+      ucols[nuniq]  = cols[p];
+      urow[nuniq]   = r;
+      ustart[nuniq] = p;
+      nuniq++;
+      if (cols[p] >= cstart && cols[p] < cend) dnnz[r]++;
+      else onnz[r]++;
+    }
+  }
+  ustart[nuniq] = ntot;
+
+  /* create the exact nonzero structure */
+  ierr = MatMPIAIJSetPreallocation(mat,0,dnnz,0,onnz);CHKERRQ(ierr);
+  ierr = PetscCalloc1(ntot,&zeros);CHKERRQ(ierr);
+  for (r=0,u=0; r<m; r++) {
+    PetscInt row = rstart + r,nc = dnnz[r] + onnz[r];
+    ierr = MatSetValues(mat,1,&row,nc,ucols+u,zeros,INSERT_VALUES);CHKERRQ(ierr);
+    u   += nc;
+  }
+  ierr = PetscFree(zeros);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  /* the columns of both blocks are sorted in each row (those of B by global index), so the distinct nonzeros map in order */
+  aij = (Mat_MPIAIJ*)mat->data;
+  a   = (Mat_SeqAIJ*)aij->A->data;
+  b   = (Mat_SeqAIJ*)aij->B->data;
+  nzA = a->nz;
+  nzB = b->nz;
+  ierr = PetscMalloc1(nuniq,&dest);CHKERRQ(ierr);
+  for (r=0,u=0; r<m; r++) {
+    for (da=0,db=0; u<nuniq && urow[u]==r; u++) {
+      if (ucols[u] >= cstart && ucols[u] < cend) dest[u] = a->i[r] + da++;
+      else dest[u] = nzA + b->i[r] + db++;
+    }
+    if (da != a->i[r+1]-a->i[r] || db != b->i[r+1]-b->i[r]) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Nonzero structure of local row %D does not match the coordinate list",r);
+  }
+
+  /* for each nonzero of A and B, the local and the received entries summed into it */
+  ierr = PetscCalloc4(nzA+nzB+1,&jmap1,nown,&perm1,nzA+nzB+1,&jmap2,nrecv,&perm2);CHKERRQ(ierr);
+  for (u=0; u<nuniq; u++) {
+    for (p=ustart[u]; p<ustart[u+1]; p++) {
+      if (src[p] < ncoo) jmap1[dest[u]+1]++;
+      else jmap2[dest[u]+1]++;
+    }
+  }
+  for (d=0; d<nzA+nzB; d++) {
+    jmap1[d+1] += jmap1[d];
+    jmap2[d+1] += jmap2[d];
+  }
+  for (u=0; u<nuniq; u++) {
+    PetscInt p1 = jmap1[dest[u]],p2 = jmap2[dest[u]];
+    for (p=ustart[u]; p<ustart[u+1]; p++) {
+      if (src[p] < ncoo) perm1[p1++] = src[p];
+      else perm2[p2++] = src[p] - ncoo;
+    }
+  }
+  ierr = PetscFree(dest);CHKERRQ(ierr);
+  ierr = PetscFree5(ucols,urow,ustart,dnnz,onnz);CHKERRQ(ierr);
+  ierr = PetscFree2(rowptr,cnt);CHKERRQ(ierr);
+  ierr = PetscFree2(cols,src);CHKERRQ(ierr);
+
+  ierr = MatResetPreallocationCOO_MPIAIJ(mat);CHKERRQ(ierr);
+  aij->coo_sf       = sf;
+  aij->coo_n        = ncoo;
+  aij->coo_nsend    = nsend;
+  aij->coo_nrecv    = nrecv;
+  aij->coo_sendperm = sendperm;
+  aij->coo_jmap1    = jmap1;
+  aij->coo_perm1    = perm1;
+  aij->coo_jmap2    = jmap2;
+  aij->coo_perm2    = perm2;
+  ierr = PetscMalloc2(nsend,&aij->coo_sendbuf,nrecv,&aij->coo_recvbuf);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)mat,(nsend+2*(nzA+nzB+1)+nown+nrecv)*sizeof(PetscInt)+(nsend+nrecv)*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat,const PetscScalar coo_v[],InsertMode imode)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)aij->A->data,*b = (Mat_SeqAIJ*)aij->B->data;
+  PetscInt       k,p,nzA = a->nz,nzB = b->nz;
+  const PetscInt *jmap1 = aij->coo_jmap1,*perm1 = aij->coo_perm1,*jmap2 = aij->coo_jmap2,*perm2 = aij->coo_perm2;
+  PetscScalar    *sendbuf = aij->coo_sendbuf,*recvbuf = aij->coo_recvbuf,sum;
+  MatScalar      *aa = a->a,*ba = b->a;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!aij->coo_sf) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Must call MatSetPreallocationCOO() first");
+  if (imode != INSERT_VALUES && imode != ADD_VALUES) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Only INSERT_VALUES and ADD_VALUES are supported");
+
+  /* start moving the entries of off-process rows and sum the local entries meanwhile; NULL values are zeros,
+     but the entries other processes send to this one must still be received */
+  if (coo_v) {
+    for (k=0; k<aij->coo_nsend; k++) sendbuf[k] = coo_v[aij->coo_sendperm[k]];
+  } else {
+    ierr = PetscMemzero(sendbuf,aij->coo_nsend*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  ierr = PetscSFBcastBegin(aij->coo_sf,MPIU_SCALAR,sendbuf,recvbuf);CHKERRQ(ierr);
+  for (k=0; k<nzA; k++) {
+    for (p=jmap1[k],sum=0.0; coo_v && p<jmap1[k+1]; p++) sum += coo_v[perm1[p]];
+    aa[k] = (imode == INSERT_VALUES ? 0.0 : aa[k]) + sum;
+  }
+  for (k=0; k<nzB; k++) {
+    for (p=jmap1[nzA+k],sum=0.0; coo_v && p<jmap1[nzA+k+1]; p++) sum += coo_v[perm1[p]];
+    ba[k] = (imode == INSERT_VALUES ? 0.0 : ba[k]) + sum;
+  }
+  ierr = PetscSFBcastEnd(aij->coo_sf,MPIU_SCALAR,sendbuf,recvbuf);CHKERRQ(ierr);
+  for (k=0; k<nzA; k++) {
+    for (p=jmap2[k]; p<jmap2[k+1]; p++) aa[k] += recvbuf[perm2[p]];
+  }
+  for (k=0; k<nzB; k++) {
+    for (p=jmap2[nzA+k]; p<jmap2[nzA+k+1]; p++) ba[k] += recvbuf[perm2[p]];
+  }
+  ierr = PetscLogFlops(jmap1[nzA+nzB]+jmap2[nzA+nzB]);CHKERRQ(ierr);
+  a->idiagvalid  = PETSC_FALSE;
+  a->ibdiagvalid = PETSC_FALSE;
+  b->idiagvalid  = PETSC_FALSE;
+  b->ibdiagvalid = PETSC_FALSE;
+  ierr = PetscObjectStateIncrease((PetscObject)aij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)aij->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatDuplicate_MPIAIJ(Mat matin,MatDuplicateOption cpvalues,Mat *newmat)
 {
   Mat            mat;
@@ -5519,6 +5896,10 @@ PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[],
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJOMP(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSingle(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJSingle_MPIAIJ(Mat,Mat,MatReuse,PetscReal,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJDelta(Mat,MatType,MatReuse,Mat*);
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat,MatType,MatReuse,Mat*);
 #endif
@@ -5631,6 +6012,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = MatStashCreate_Private(PetscObjectComm((PetscObject)B),1,&B->stash);CHKERRQ(ierr);
 
   b->donotstash  = PETSC_FALSE;
+  b->ht_flag     = PETSC_FALSE;
   b->colmap      = 0;
   b->garray      = 0;
   b->roworiented = PETSC_TRUE;
@@ -5657,6 +6039,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijperm_C",MatConvert_MPIAIJ_MPIAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsell_C",MatConvert_MPIAIJ_MPIAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijomp_C",MatConvert_MPIAIJ_MPIAIJOMP);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsingle_C",MatConvert_MPIAIJ_MPIAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijdelta_C",MatConvert_MPIAIJ_MPIAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmkl_C",MatConvert_MPIAIJ_MPIAIJMKL);CHKERRQ(ierr);
 #endif
@@ -5677,6 +6062,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMatMult_transpose_mpiaij_mpiaij_C",MatMatMatMult_Transpose_AIJ_AIJ);CHKERRQ(ierr);
 #endif
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_mpiaij_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_mpiaijsingle_mpiaij_C",MatPtAP_MPIAIJSingle_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJ);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -5800,6 +6188,10 @@ PETSC_EXTERN void PETSC_STDCALL matsetvaluesmpiaij_(Mat *mmat,PetscInt *mm,const
 #if defined(PETSC_USE_DEBUG)
   else if (mat->insertmode != addv) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot mix add values and insert values");
 #endif
+  if (mat->ops->setvalues == MatSetValues_MPIAIJ_Hash) {
+    ierr = MatSetValues_MPIAIJ_Hash(mat,m,im,n,in,v,addv);CHKERRQ(ierr);
+    PetscFunctionReturnVoid();
+  }
   {
     PetscInt  i,j,rstart  = mat->rmap->rstart,rend = mat->rmap->rend;
     PetscInt  cstart      = mat->cmap->rstart,cend = mat->cmap->rend,row,col;
@@ -31,6 +31,8 @@ typedef struct { /* used by MatPtAP_MPIAIJ_MPIAIJ() and MatMatMult_MPIAIJ_MPIAIJ
   PetscInt                algType;                 /* implementation algorithm */
   PetscSF                 sf;                      /* use it to communicate remote part of C */
   PetscInt                *c_othi,*c_rmti;
+  PetscInt                *c_othj,*c_rmtj;         /* sorted column indices of the remote part of C, kept by the allatonce symbolic phase so that the numeric phase only sends values */
+  PetscLogDouble          symbolicmem,numericmem;  /* peak PetscMalloc()ed memory of the last symbolic and numeric phases, above the usage on entry */
 
   Mat_Merge_SeqsToMPI *merge;
   PetscErrorCode (*destroy)(Mat);
@@ -46,6 +48,7 @@ typedef struct {
 
   /* The following variables are used for matrix assembly */
   PetscBool   donotstash;               /* PETSC_TRUE if off processor entries dropped */
+  PetscBool   ht_flag;                  /* PETSC_TRUE if A and B collect entries in hash tables until the first final assembly */
   MPI_Request *send_waits;              /* array of send requests */
   MPI_Request *recv_waits;              /* array of receive requests */
   PetscInt    nsends,nrecvs;           /* numbers of sends and receives */
@@ -79,6 +82,14 @@ typedef struct {
   /* used by MatMatMatMult() */
   Mat_MatMatMatMult *matmatmatmult;
 
+  /* used by MatSetPreallocationCOO() and MatSetValuesCOO() */
+  PetscSF     coo_sf;                   /* sends the entries of off-process rows to their owners */
+  PetscInt    coo_n,coo_nsend,coo_nrecv; /* lengths of the coordinate list and of the send and receive buffers */
+  PetscInt    *coo_sendperm;            /* coo_v[coo_sendperm[t]] is packed into coo_sendbuf[t] */
+  PetscInt    *coo_jmap1,*coo_perm1;    /* coo_v[coo_perm1[coo_jmap1[k]..coo_jmap1[k+1]-1]] are summed into the k-th nonzero of A, then B */
+  PetscInt    *coo_jmap2,*coo_perm2;    /* the same for the received entries coo_recvbuf[] */
+  PetscScalar *coo_sendbuf,*coo_recvbuf;
+
   /* Used by MPICUSP and MPICUSPARSE classes */
   void * spptr;
 
@@ -145,6 +156,9 @@ PETSC_INTERN PetscErrorCode MatRARt_MPIAIJ_MPIAIJ(Mat,Mat,MatReuse,PetscReal,Mat
 
 PETSC_INTERN PetscErrorCode MatGetBrowsOfAoCols_MPIAIJ(Mat,Mat,MatReuse,PetscInt**,PetscInt**,MatScalar**,Mat*);
 PETSC_INTERN PetscErrorCode MatSetValues_MPIAIJ(Mat,PetscInt,const PetscInt[],PetscInt,const PetscInt[],const PetscScalar [],InsertMode);
+PETSC_INTERN PetscErrorCode MatSetValues_MPIAIJ_Hash(Mat,PetscInt,const PetscInt[],PetscInt,const PetscInt[],const PetscScalar [],InsertMode);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat,const PetscScalar[],InsertMode);
 PETSC_INTERN PetscErrorCode MatSetValues_MPIAIJ_CopyFromCSRFormat(Mat,const PetscInt[],const PetscInt[],const PetscScalar[]);
 PETSC_INTERN PetscErrorCode MatSetValues_MPIAIJ_CopyFromCSRFormat_Symbolic(Mat,const PetscInt[],const PetscInt[]);
 PETSC_INTERN PetscErrorCode MatDestroy_MPIAIJ_MatMatMult(Mat);
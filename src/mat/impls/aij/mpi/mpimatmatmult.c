@@ -390,7 +390,7 @@ PetscErrorCode MatMatMultNumeric_MPIDense(Mat A,Mat B,Mat C)
   PetscErrorCode         ierr;
   PetscBool              flg;
   Mat_MPIAIJ             *aij = (Mat_MPIAIJ*) A->data;
-  PetscInt               nz   = aij->B->cmap->n,to_n,to_entries,from_n,from_entries;
+  PetscInt               nz   = aij->B->cmap->n,to_n,to_entries,from_n,from_entries,sbs,rbs;
   PetscContainer         container;
   MPIAIJ_MPIDense        *contents;
   VecScatter             ctx   = aij->Mvctx;
@@ -411,7 +411,12 @@ PetscErrorCode MatMatMultNumeric_MPIDense(Mat A,Mat B,Mat C)
   /* Create work arrays needed */
   ierr = VecScatterGetRemoteCount_Private(ctx,PETSC_TRUE/*send*/,&to_n,&to_entries);CHKERRQ(ierr);
   ierr = VecScatterGetRemoteCount_Private(ctx,PETSC_FALSE/*recv*/,&from_n,&from_entries);CHKERRQ(ierr);
-  ierr = PetscMalloc4(B->cmap->N*from_entries,&contents->rvalues,B->cmap->N*to_entries,&contents->svalues,from_n,&contents->rwaits,to_n,&contents->swaits);CHKERRQ(ierr);
+  /* the entries are blocks of bs rows when the scatter was created with block index sets */
+  ierr = VecScatterGetRemote_Private(ctx,PETSC_TRUE/*send*/,NULL,NULL,NULL,NULL,&sbs);CHKERRQ(ierr);
+  ierr = VecScatterRestoreRemote_Private(ctx,PETSC_TRUE/*send*/,NULL,NULL,NULL,NULL,&sbs);CHKERRQ(ierr);
+  ierr = VecScatterGetRemote_Private(ctx,PETSC_FALSE/*recv*/,NULL,NULL,NULL,NULL,&rbs);CHKERRQ(ierr);
+  ierr = VecScatterRestoreRemote_Private(ctx,PETSC_FALSE/*recv*/,NULL,NULL,NULL,NULL,&rbs);CHKERRQ(ierr);
+  ierr = PetscMalloc4(B->cmap->N*PetscMax(rbs,1)*from_entries,&contents->rvalues,B->cmap->N*PetscMax(sbs,1)*to_entries,&contents->svalues,from_n,&contents->rwaits,to_n,&contents->swaits);CHKERRQ(ierr);
 
   ierr = PetscContainerCreate(PetscObjectComm((PetscObject)A),&container);CHKERRQ(ierr);
   ierr = PetscContainerSetPointer(container,contents);CHKERRQ(ierr);
@@ -427,7 +432,7 @@ PetscErrorCode MatMatMultSymbolic_MPIAIJ_MPIDense(Mat A,Mat B,PetscReal fill,Mat
 {
   PetscErrorCode         ierr;
   Mat_MPIAIJ             *aij = (Mat_MPIAIJ*) A->data;
-  PetscInt               nz   = aij->B->cmap->n,to_n,to_entries,from_n,from_entries;
+  PetscInt               nz   = aij->B->cmap->n,to_n,to_entries,from_n,from_entries,sbs,rbs;
   PetscContainer         container;
   MPIAIJ_MPIDense        *contents;
   VecScatter             ctx   = aij->Mvctx;
@@ -450,7 +455,12 @@ PetscErrorCode MatMatMultSymbolic_MPIAIJ_MPIDense(Mat A,Mat B,PetscReal fill,Mat
   /* Create work arrays needed */
   ierr = VecScatterGetRemoteCount_Private(ctx,PETSC_TRUE/*send*/,&to_n,&to_entries);CHKERRQ(ierr);
   ierr = VecScatterGetRemoteCount_Private(ctx,PETSC_FALSE/*recv*/,&from_n,&from_entries);CHKERRQ(ierr);
-  ierr = PetscMalloc4(B->cmap->N*from_entries,&contents->rvalues,B->cmap->N*to_entries,&contents->svalues,from_n,&contents->rwaits,to_n,&contents->swaits);CHKERRQ(ierr);
+  /* the entries are blocks of bs rows when the scatter was created with block index sets */
+  ierr = VecScatterGetRemote_Private(ctx,PETSC_TRUE/*send*/,NULL,NULL,NULL,NULL,&sbs);CHKERRQ(ierr);
+  ierr = VecScatterRestoreRemote_Private(ctx,PETSC_TRUE/*send*/,NULL,NULL,NULL,NULL,&sbs);CHKERRQ(ierr);
+  ierr = VecScatterGetRemote_Private(ctx,PETSC_FALSE/*recv*/,NULL,NULL,NULL,NULL,&rbs);CHKERRQ(ierr);
+  ierr = VecScatterRestoreRemote_Private(ctx,PETSC_FALSE/*recv*/,NULL,NULL,NULL,NULL,&rbs);CHKERRQ(ierr);
+  ierr = PetscMalloc4(B->cmap->N*PetscMax(rbs,1)*from_entries,&contents->rvalues,B->cmap->N*PetscMax(sbs,1)*to_entries,&contents->svalues,from_n,&contents->rwaits,to_n,&contents->swaits);CHKERRQ(ierr);
 
   ierr = PetscContainerCreate(PetscObjectComm((PetscObject)A),&container);CHKERRQ(ierr);
   ierr = PetscContainerSetPointer(container,contents);CHKERRQ(ierr);
@@ -470,7 +480,7 @@ PetscErrorCode MatMPIDenseScatter(Mat A,Mat B,Mat C,Mat *outworkB)
   PetscErrorCode         ierr;
   PetscScalar            *b,*w,*svalues,*rvalues;
   VecScatter             ctx   = aij->Mvctx;
-  PetscInt               i,j,k;
+  PetscInt               i,j,k,l,sbs,rbs;
   const PetscInt         *sindices,*sstarts,*rindices,*rstarts;
   const PetscMPIInt      *sprocs,*rprocs;
   PetscInt               nsends,nrecvs,nrecvs2;
@@ -490,8 +500,11 @@ PetscErrorCode MatMPIDenseScatter(Mat A,Mat B,Mat C,Mat *outworkB)
 
   workB = *outworkB = contents->workB;
   if (nrows != workB->rmap->n) SETERRQ2(comm,PETSC_ERR_PLIB,"Number of rows of workB %D not equal to columns of aij->B %D",nrows,workB->cmap->n);
-  ierr    = VecScatterGetRemote_Private(ctx,PETSC_TRUE/*send*/,&nsends,&sstarts,&sindices,&sprocs,NULL/*bs*/);CHKERRQ(ierr);
-  ierr    = VecScatterGetRemoteOrdered_Private(ctx,PETSC_FALSE/*recv*/,&nrecvs,&rstarts,&rindices,&rprocs,NULL/*bs*/);CHKERRQ(ierr);
+  /* the starts count blocks of sbs (rbs) rows, and the indices are those of the first rows of the blocks */
+  ierr    = VecScatterGetRemote_Private(ctx,PETSC_TRUE/*send*/,&nsends,&sstarts,&sindices,&sprocs,&sbs);CHKERRQ(ierr);
+  ierr    = VecScatterGetRemoteOrdered_Private(ctx,PETSC_FALSE/*recv*/,&nrecvs,&rstarts,&rindices,&rprocs,&rbs);CHKERRQ(ierr);
+  sbs     = PetscMax(sbs,1);
+  rbs     = PetscMax(rbs,1);
   ierr    = PetscMPIIntCast(nsends,&nsends_mpi);CHKERRQ(ierr);
   ierr    = PetscMPIIntCast(nrecvs,&nrecvs_mpi);CHKERRQ(ierr);
   svalues = contents->svalues;
@@ -503,17 +516,19 @@ PetscErrorCode MatMPIDenseScatter(Mat A,Mat B,Mat C,Mat *outworkB)
   ierr = MatDenseGetArray(workB,&w);CHKERRQ(ierr);
 
   for (i=0; i<nrecvs; i++) {
-    ierr = MPI_Irecv(rvalues+ncols*(rstarts[i]-rstarts[0]),ncols*(rstarts[i+1]-rstarts[i]),MPIU_SCALAR,rprocs[i],tag,comm,rwaits+i);CHKERRQ(ierr);
+    ierr = MPI_Irecv(rvalues+ncols*rbs*(rstarts[i]-rstarts[0]),ncols*rbs*(rstarts[i+1]-rstarts[i]),MPIU_SCALAR,rprocs[i],tag,comm,rwaits+i);CHKERRQ(ierr);
   }
 
   for (i=0; i<nsends; i++) {
     /* pack a message at a time */
     for (j=0; j<sstarts[i+1]-sstarts[i]; j++) {
-      for (k=0; k<ncols; k++) {
-        svalues[ncols*(sstarts[i]-sstarts[0]+j) + k] = b[sindices[sstarts[i]+j] + nrowsB*k];
+      for (l=0; l<sbs; l++) {
+        for (k=0; k<ncols; k++) {
+          svalues[ncols*(sbs*(sstarts[i]-sstarts[0]+j)+l) + k] = b[sindices[sstarts[i]+j] + l + nrowsB*k];
+        }
       }
     }
-    ierr = MPI_Isend(svalues+ncols*(sstarts[i]-sstarts[0]),ncols*(sstarts[i+1]-sstarts[i]),MPIU_SCALAR,sprocs[i],tag,comm,swaits+i);CHKERRQ(ierr);
+    ierr = MPI_Isend(svalues+ncols*sbs*(sstarts[i]-sstarts[0]),ncols*sbs*(sstarts[i+1]-sstarts[i]),MPIU_SCALAR,sprocs[i],tag,comm,swaits+i);CHKERRQ(ierr);
   }
 
   nrecvs2 = nrecvs;
@@ -522,15 +537,17 @@ PetscErrorCode MatMPIDenseScatter(Mat A,Mat B,Mat C,Mat *outworkB)
     nrecvs2--;
     /* unpack a message at a time */
     for (j=0; j<rstarts[imdex+1]-rstarts[imdex]; j++) {
-      for (k=0; k<ncols; k++) {
-        w[rindices[rstarts[imdex]+j] + nrows*k] = rvalues[ncols*(rstarts[imdex]-rstarts[0]+j) + k];
+      for (l=0; l<rbs; l++) {
+        for (k=0; k<ncols; k++) {
+          w[rindices[rstarts[imdex]+j] + l + nrows*k] = rvalues[ncols*(rbs*(rstarts[imdex]-rstarts[0]+j)+l) + k];
+        }
       }
     }
   }
   if (nsends) {ierr = MPI_Waitall(nsends_mpi,swaits,MPI_STATUSES_IGNORE);CHKERRQ(ierr);}
 
-  ierr = VecScatterRestoreRemote_Private(ctx,PETSC_TRUE/*send*/,&nsends,&sstarts,&sindices,&sprocs,NULL/*bs*/);CHKERRQ(ierr);
-  ierr = VecScatterRestoreRemoteOrdered_Private(ctx,PETSC_FALSE/*recv*/,&nrecvs,&rstarts,&rindices,&rprocs,NULL/*bs*/);CHKERRQ(ierr);
+  ierr = VecScatterRestoreRemote_Private(ctx,PETSC_TRUE/*send*/,&nsends,&sstarts,&sindices,&sprocs,&sbs);CHKERRQ(ierr);
+  ierr = VecScatterRestoreRemoteOrdered_Private(ctx,PETSC_FALSE/*recv*/,&nrecvs,&rstarts,&rindices,&rprocs,&rbs);CHKERRQ(ierr);
   ierr = MatDenseRestoreArray(B,&b);CHKERRQ(ierr);
   ierr = MatDenseRestoreArray(workB,&w);CHKERRQ(ierr);
   ierr = MatAssemblyBegin(workB,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
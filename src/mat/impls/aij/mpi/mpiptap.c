@@ -21,6 +21,7 @@ PetscErrorCode MatView_MPIAIJ_PtAP(Mat A,PetscViewer viewer)
   Mat_APMPI         *ptap=a->ap;
   PetscBool         iascii;
   PetscViewerFormat format;
+  PetscLogDouble    lmem[2],gmem[2];
 
   PetscFunctionBegin;
   if (!ptap) {
@@ -43,6 +44,11 @@ PetscErrorCode MatView_MPIAIJ_PtAP(Mat A,PetscViewer viewer)
       } else if (ptap->algType == 3) {
         ierr = PetscViewerASCIIPrintf(viewer,"using merged allatonce MatPtAP() implementation\n");CHKERRQ(ierr);
       }
+      if (format == PETSC_VIEWER_ASCII_INFO_DETAIL) {
+        lmem[0] = ptap->symbolicmem; lmem[1] = ptap->numericmem;
+        ierr = MPIU_Allreduce(lmem,gmem,2,MPIU_PETSCLOGDOUBLE,MPI_MAX,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"maximum over the processes of the memory used by the symbolic phase %g bytes, by the last numeric phase %g bytes\n",(double)gmem[0],(double)gmem[1]);CHKERRQ(ierr);
+      }
     }
   }
   ierr = (ptap->view)(A,viewer);CHKERRQ(ierr);
@@ -103,6 +109,8 @@ PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_AP(Mat A)
   ierr = PetscSFDestroy(&ptap->sf);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_othi);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_rmti);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->c_othj);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->c_rmtj);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -132,6 +140,7 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
   PetscInt            nalg=5;
 #endif
   PetscInt            pN=P->cmap->N,alg=1; /* set default algorithm */
+  PetscLogDouble      mem,peak;
 
   PetscFunctionBegin;
   /* check if matrix local sizes are compatible */
@@ -162,6 +171,9 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
       }
     }
 
+    /* the memory used by the product is reported as the peak PetscMalloc()ed memory above the usage on entry */
+    ierr = PetscMallocGetCurrentUsage(&mem);CHKERRQ(ierr);
+    ierr = PetscMallocPushMaximumUsage((int)MAT_PtAPSymbolic);CHKERRQ(ierr);
     switch (alg) {
     case 1:
       /* do R=P^T locally, then C=R*A*P -- nonscalable */
@@ -197,9 +209,13 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
       break;
     }
 
+    ierr = PetscMallocPopMaximumUsage((int)MAT_PtAPSymbolic,&peak);CHKERRQ(ierr);
+    ierr = PetscInfo2(A,"%s symbolic phase used %g bytes of memory\n",algTypes[alg],peak-mem);CHKERRQ(ierr);
+
     if (alg == 0 || alg == 1 || alg == 2 || alg == 3) {
       Mat_MPIAIJ *c  = (Mat_MPIAIJ*)(*C)->data;
       Mat_APMPI  *ap = c->ap;
+      ap->symbolicmem = peak-mem;
       ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)(*C)),((PetscObject)(*C))->prefix,"MatFreeIntermediateDataStructures","Mat");CHKERRQ(ierr);
       ap->freestruct = PETSC_FALSE;
       ierr = PetscOptionsBool("-mat_freeintermediatedatastructures","Free intermediate data structures", "MatFreeIntermediateDataStructures",ap->freestruct,&ap->freestruct, NULL);CHKERRQ(ierr);
@@ -207,9 +223,14 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
     }
   }
 
+  ierr = PetscMallocGetCurrentUsage(&mem);CHKERRQ(ierr);
+  ierr = PetscMallocPushMaximumUsage((int)MAT_PtAPNumeric);CHKERRQ(ierr);
   ierr = PetscLogEventBegin(MAT_PtAPNumeric,A,P,0,0);CHKERRQ(ierr);
   ierr = (*(*C)->ops->ptapnumeric)(A,P,*C);CHKERRQ(ierr);
   ierr = PetscLogEventEnd(MAT_PtAPNumeric,A,P,0,0);CHKERRQ(ierr);
+  ierr = PetscMallocPopMaximumUsage((int)MAT_PtAPNumeric,&peak);CHKERRQ(ierr);
+  ierr = PetscInfo1(A,"Numeric phase used %g bytes of memory\n",peak-mem);CHKERRQ(ierr);
+  if (((Mat_MPIAIJ*)(*C)->data)->ap) ((Mat_MPIAIJ*)(*C)->data)->ap->numericmem = peak-mem;
   PetscFunctionReturn(0);
 }
 
@@ -822,7 +843,7 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,Mat C)
   Mat_SeqAIJ        *cd,*co,*po,*pd;
   Mat_APMPI         *ptap = c->ap;
   PetscHMapIV       hmap;
-  PetscInt          i,j,jj,kk,nzi,*c_rmtj,voff,*c_othj,pn,pon,pcstart,pcend,ccstart,ccend,row,am,*poj,*pdj,*apindices,cmaxr,*c_rmtc,*c_rmtjj,*dcc,*occ,loc;
+  PetscInt          i,j,jj,nzi,voff,pn,pon,pcstart,pcend,row,am,*poj,*pdj,*apindices,cmaxr,*c_rmtjj,rmtnz,loc;
   PetscScalar       *c_rmta,*c_otha,*poa,*pda,*apvalues,*apvaluestmp,*c_rmtaa;
   MPI_Comm          comm;
 
@@ -844,13 +865,14 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,Mat C)
 
   ierr = MatGetLocalSize(p->B,NULL,&pon);CHKERRQ(ierr);
 
-  ierr = PetscCalloc2(ptap->c_rmti[pon],&c_rmtj,ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
+  /* the column indices of the remote rows, ptap->c_rmtj, are sorted and were sent to their owners by the symbolic phase */
+  ierr = PetscCalloc1(ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
   ierr = MatGetLocalSize(A,&am,NULL);CHKERRQ(ierr);
   cmaxr = 0;
   for (i=0; i<pon; i++) {
     cmaxr = PetscMax(cmaxr,ptap->c_rmti[i+1]-ptap->c_rmti[i]);
   }
-  ierr = PetscCalloc4(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp,pon,&c_rmtc);CHKERRQ(ierr);
+  ierr = PetscMalloc2(cmaxr,&apindices,cmaxr,&apvalues);CHKERRQ(ierr);
   ierr = PetscHMapIVCreate(&hmap);CHKERRQ(ierr);
   ierr = PetscHMapIVResize(hmap,cmaxr);CHKERRQ(ierr);
   for (i=0; i<am && pon; i++) {
@@ -861,47 +883,29 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,Mat C)
     voff = 0;
     ierr = PetscHMapIVGetPairs(hmap,&voff,apindices,apvalues);CHKERRQ(ierr);
     if (!voff) continue;
-    /*ierr = PetscMemzero(c_rmtc,sizeof(PetscInt)*pon);CHKERRQ(ierr);*/
 
     /* Form C(ii, :) */
     poj = po->j + po->i[i];
     poa = po->a + po->i[i];
     for (j=0; j<nzi; j++) {
-      c_rmtjj = c_rmtj + ptap->c_rmti[poj[j]];
+      rmtnz   = ptap->c_rmti[poj[j]+1] - ptap->c_rmti[poj[j]];
+      c_rmtjj = ptap->c_rmtj + ptap->c_rmti[poj[j]];
       c_rmtaa = c_rmta + ptap->c_rmti[poj[j]];
       for (jj=0; jj<voff; jj++) {
-        apvaluestmp[jj] = apvalues[jj]*poa[j];
-        /*If the row is empty */
-        if (!c_rmtc[poj[j]]) {
-          c_rmtjj[jj] = apindices[jj];
-          c_rmtaa[jj] = apvaluestmp[jj];
-          c_rmtc[poj[j]]++;
-        } else {
-          ierr = PetscFindInt(apindices[jj],c_rmtc[poj[j]],c_rmtjj,&loc);CHKERRQ(ierr);
-          if (loc>=0){ /* hit */
-            c_rmtaa[loc] += apvaluestmp[jj];
-          } else { /* new element */
-            loc = -(loc+1);
-            /* Move data backward */
-            for (kk=c_rmtc[poj[j]]; kk>loc; kk--) {
-              c_rmtjj[kk] = c_rmtjj[kk-1];
-              c_rmtaa[kk] = c_rmtaa[kk-1];
-            }/* End kk */
-            c_rmtjj[loc] = apindices[jj];
-            c_rmtaa[loc] = apvaluestmp[jj];
-            c_rmtc[poj[j]]++;
-          }
-        }
+        ierr = PetscFindInt(apindices[jj],rmtnz,c_rmtjj,&loc);CHKERRQ(ierr);
+        if (loc < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Column %D is not in the nonzero structure computed by MatPtAPSymbolic(), did the nonzero structure of A or P change?",apindices[jj]);
+        c_rmtaa[loc] += apvalues[jj]*poa[j];
       } /* End jj */
     } /* End j */
   } /* End i */
 
-  ierr = PetscFree4(apindices,apvalues,apvaluestmp,c_rmtc);CHKERRQ(ierr);
+  ierr = PetscFree2(apindices,apvalues);CHKERRQ(ierr);
+  ierr = PetscHMapIVDestroy(&hmap);CHKERRQ(ierr);
 
   ierr = MatGetLocalSize(P,NULL,&pn);CHKERRQ(ierr);
-  ierr = PetscCalloc2(ptap->c_othi[pn],&c_othj,ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
 
-  ierr = PetscSFReduceBegin(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
+  /* send the remote values while the local part is computed */
   ierr = PetscSFReduceBegin(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
   ierr = MatGetOwnershipRangeColumn(P,&pcstart,&pcend);CHKERRQ(ierr);
   cd = (Mat_SeqAIJ*)(c->A)->data;
@@ -911,7 +915,7 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,Mat C)
   for (i=0; i<pn; i++) {
     cmaxr = PetscMax(cmaxr,(cd->i[i+1]-cd->i[i])+(co->i[i+1]-co->i[i]));
   }
-  ierr = PetscCalloc5(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp,pn,&dcc,pn,&occ);CHKERRQ(ierr);
+  ierr = PetscMalloc3(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVCreate(&hmap);CHKERRQ(ierr);
   ierr = PetscHMapIVResize(hmap,cmaxr);CHKERRQ(ierr);
   for (i=0; i<am && pn; i++) {
@@ -934,19 +938,17 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,Mat C)
     }
   }
 
-  ierr = MatGetOwnershipRangeColumn(C,&ccstart,&ccend);CHKERRQ(ierr);
-  ierr = PetscFree5(apindices,apvalues,apvaluestmp,dcc,occ);CHKERRQ(ierr);
+  ierr = PetscFree3(apindices,apvalues,apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVDestroy(&hmap);CHKERRQ(ierr);
-  ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPI_SUM);CHKERRQ(ierr);
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree2(c_rmtj,c_rmta);CHKERRQ(ierr);
+  ierr = PetscFree(c_rmta);CHKERRQ(ierr);
 
   /* Add contributions from remote */
   for (i = 0; i < pn; i++) {
     row = i + pcstart;
-    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],ptap->c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
   }
-  ierr = PetscFree2(c_othj,c_otha);CHKERRQ(ierr);
+  ierr = PetscFree(c_otha);CHKERRQ(ierr);
 
   ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
@@ -967,7 +969,7 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,Mat C)
   Mat_SeqAIJ        *cd,*co,*po,*pd;
   Mat_APMPI         *ptap = c->ap;
   PetscHMapIV       hmap;
-  PetscInt          i,j,jj,kk,nzi,dnzi,*c_rmtj,voff,*c_othj,pn,pon,pcstart,pcend,row,am,*poj,*pdj,*apindices,cmaxr,*c_rmtc,*c_rmtjj,loc;
+  PetscInt          i,j,jj,nzi,dnzi,voff,pn,pon,pcstart,pcend,row,am,*poj,*pdj,*apindices,cmaxr,*c_rmtjj,rmtnz,loc;
   PetscScalar       *c_rmta,*c_otha,*poa,*pda,*apvalues,*apvaluestmp,*c_rmtaa;
   MPI_Comm          comm;
 
@@ -990,7 +992,8 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,Mat C)
   ierr = MatGetLocalSize(p->B,NULL,&pon);CHKERRQ(ierr);
   ierr = MatGetLocalSize(P,NULL,&pn);CHKERRQ(ierr);
 
-  ierr = PetscCalloc2(ptap->c_rmti[pon],&c_rmtj,ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
+  /* the column indices of the remote rows, ptap->c_rmtj, are sorted and were sent to their owners by the symbolic phase */
+  ierr = PetscCalloc1(ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
   ierr = MatGetLocalSize(A,&am,NULL);CHKERRQ(ierr);
   ierr = MatGetOwnershipRangeColumn(P,&pcstart,&pcend);CHKERRQ(ierr);
   cmaxr = 0;
@@ -1002,7 +1005,7 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,Mat C)
   for (i=0; i<pn; i++) {
     cmaxr = PetscMax(cmaxr,(cd->i[i+1]-cd->i[i])+(co->i[i+1]-co->i[i]));
   }
-  ierr = PetscCalloc4(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp,pon,&c_rmtc);CHKERRQ(ierr);
+  ierr = PetscMalloc3(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVCreate(&hmap);CHKERRQ(ierr);
   ierr = PetscHMapIVResize(hmap,cmaxr);CHKERRQ(ierr);
   for (i=0; i<am && (pon || pn); i++) {
@@ -1019,31 +1022,13 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,Mat C)
     poj = po->j + po->i[i];
     poa = po->a + po->i[i];
     for (j=0; j<nzi; j++) {
-      c_rmtjj = c_rmtj + ptap->c_rmti[poj[j]];
+      rmtnz   = ptap->c_rmti[poj[j]+1] - ptap->c_rmti[poj[j]];
+      c_rmtjj = ptap->c_rmtj + ptap->c_rmti[poj[j]];
       c_rmtaa = c_rmta + ptap->c_rmti[poj[j]];
       for (jj=0; jj<voff; jj++) {
-        apvaluestmp[jj] = apvalues[jj]*poa[j];
-        /*If the row is empty */
-        if (!c_rmtc[poj[j]]) {
-          c_rmtjj[jj] = apindices[jj];
-          c_rmtaa[jj] = apvaluestmp[jj];
-          c_rmtc[poj[j]]++;
-        } else {
-          ierr = PetscFindInt(apindices[jj],c_rmtc[poj[j]],c_rmtjj,&loc);CHKERRQ(ierr);
-          if (loc>=0){ /* hit */
-            c_rmtaa[loc] += apvaluestmp[jj];
-          } else { /* new element */
-            loc = -(loc+1);
-            /* Move data backward */
-            for (kk=c_rmtc[poj[j]]; kk>loc; kk--) {
-              c_rmtjj[kk] = c_rmtjj[kk-1];
-              c_rmtaa[kk] = c_rmtaa[kk-1];
-            }/* End kk */
-            c_rmtjj[loc] = apindices[jj];
-            c_rmtaa[loc] = apvaluestmp[jj];
-            c_rmtc[poj[j]]++;
-          }
-        }
+        ierr = PetscFindInt(apindices[jj],rmtnz,c_rmtjj,&loc);CHKERRQ(ierr);
+        if (loc < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Column %D is not in the nonzero structure computed by MatPtAPSymbolic(), did the nonzero structure of A or P change?",apindices[jj]);
+        c_rmtaa[loc] += apvalues[jj]*poa[j];
       } /* End jj */
     } /* End j */
 
@@ -1059,22 +1044,20 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,Mat C)
     }/* End j */
   } /* End i */
 
-  ierr = PetscFree4(apindices,apvalues,apvaluestmp,c_rmtc);CHKERRQ(ierr);
+  ierr = PetscFree3(apindices,apvalues,apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVDestroy(&hmap);CHKERRQ(ierr);
-  ierr = PetscCalloc2(ptap->c_othi[pn],&c_othj,ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
 
-  ierr = PetscSFReduceBegin(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
   ierr = PetscSFReduceBegin(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPI_SUM);CHKERRQ(ierr);
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree2(c_rmtj,c_rmta);CHKERRQ(ierr);
+  ierr = PetscFree(c_rmta);CHKERRQ(ierr);
 
   /* Add contributions from remote */
   for (i = 0; i < pn; i++) {
     row = i + pcstart;
-    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],ptap->c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
   }
-  ierr = PetscFree2(c_othj,c_otha);CHKERRQ(ierr);
+  ierr = PetscFree(c_otha);CHKERRQ(ierr);
 
   ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
@@ -1174,6 +1157,8 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,PetscReal fil
   for (i=0; i<pon; i++) {
     off = 0;
     ierr = PetscHSetIGetElems(hta[i],&off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
+    /* sorted, so that the numeric phase can locate the entries with a binary search */
+    ierr = PetscSortInt(off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
     ierr = PetscHSetIDestroy(&hta[i]);CHKERRQ(ierr);
   }
   ierr = PetscFree(hta);CHKERRQ(ierr);
@@ -1282,7 +1267,8 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,PetscReal fil
 
   /* Get remote data */
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree(c_rmtj);CHKERRQ(ierr);
+  /* keep the remote structure, the numeric phase only communicates values */
+  ptap->c_rmtj = c_rmtj;
 
   for (i = 0; i < pn; i++) {
     nzi = ptap->c_othi[i+1] - ptap->c_othi[i];
@@ -1305,7 +1291,7 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce(Mat A,Mat P,PetscReal fil
   }
 
   ierr = PetscFree2(hta,hto);CHKERRQ(ierr);
-  ierr = PetscFree(c_othj);CHKERRQ(ierr);
+  ptap->c_othj = c_othj;
 
   /* local sizes and preallocation */
   ierr = MatSetSizes(Cmpi,pn,pn,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
@@ -1450,6 +1436,8 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,PetscR
   for (i=0; i<pon; i++) {
     off = 0;
     ierr = PetscHSetIGetElems(hta[i],&off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
+    /* sorted, so that the numeric phase can locate the entries with a binary search */
+    ierr = PetscSortInt(off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
     ierr = PetscHSetIDestroy(&hta[i]);CHKERRQ(ierr);
   }
   ierr = PetscFree(hta);CHKERRQ(ierr);
@@ -1526,7 +1514,8 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,PetscR
   ierr = PetscSFReduceBegin(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
   /* Get remote data */
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree(c_rmtj);CHKERRQ(ierr);
+  /* keep the remote structure, the numeric phase only communicates values */
+  ptap->c_rmtj = c_rmtj;
   ierr = PetscCalloc2(pn,&dnz,pn,&onz);CHKERRQ(ierr);
   ierr = MatGetOwnershipRangeColumn(P,&pcstart,&pcend);CHKERRQ(ierr);
 
@@ -1551,7 +1540,7 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,PetscR
   }
 
   ierr = PetscFree2(htd,hto);CHKERRQ(ierr);
-  ierr = PetscFree(c_othj);CHKERRQ(ierr);
+  ptap->c_othj = c_othj;
 
   /* local sizes and preallocation */
   ierr = MatSetSizes(Cmpi,pn,pn,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
@@ -497,6 +497,95 @@ noinsert:;
   PetscFunctionReturn(0);
 }
 
+/*
+    Used instead of MatSetValues_SeqAIJ() until the first final assembly when MAT_USE_HASH_TABLE is set;
+    entries are collected in a->ht so no preallocation is needed and no reallocations or shifts take place
+*/
+PetscErrorCode MatSetValues_SeqAIJ_Hash(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode is)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       k,l,row,col;
+  PetscScalar    value = 1.0;
+  PetscBool      ignorezeroentries = (PetscBool)(a->ignorezeroentries && is == ADD_VALUES);
+  PetscBool      roworiented       = a->roworiented;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<m; k++) {
+    row = im[k];
+    if (row < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (row >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",row,A->rmap->n-1);
+#endif
+    for (l=0; l<n; l++) {
+      col = in[l];
+      if (col < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+      if (col >= A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",col,A->cmap->n-1);
+#endif
+      if (!A->structure_only) value = roworiented ? v[l + k*n] : v[k + l*m];
+      if (ignorezeroentries && value == 0.0 && row != col) continue;
+      ierr = MatSeqAIJSetValueHash_Private(a,row,col,value,is);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    Builds the exact CSR structure from the entries collected in the hash table, frees the
+    hash table and switches MatSetValues() back to the regular (searching) implementation
+*/
+PetscErrorCode MatSeqAIJAssembleHash_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       i,m = A->rmap->n,nz,*nnz,*ai,*aj,*ailen,p;
+  MatScalar      *aa;
+  PetscHashIter  hi;
+  PetscHashIJKey key;
+  PetscScalar    value;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->ht) PetscFunctionReturn(0);
+  ierr = PetscHMapIJVGetSize(a->ht,&nz);CHKERRQ(ierr);
+  ierr = PetscCalloc1(m,&nnz);CHKERRQ(ierr);
+  PetscHashIterBegin(a->ht,hi);
+  while (!PetscHashIterAtEnd(a->ht,hi)) {
+    PetscHashIterGetKey(a->ht,hi,key);
+    nnz[key.i]++;
+    PetscHashIterNext(a->ht,hi);
+  }
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(A,0,nnz);CHKERRQ(ierr);
+  ierr = PetscFree(nnz);CHKERRQ(ierr);
+
+  ai = a->i; aj = a->j; aa = a->a; ailen = a->ilen;
+  PetscHashIterBegin(a->ht,hi);
+  while (!PetscHashIterAtEnd(a->ht,hi)) {
+    PetscHashIterGetKey(a->ht,hi,key);
+    p     = ai[key.i] + ailen[key.i]++;
+    aj[p] = key.j;
+    if (!A->structure_only) {
+      PetscHashIterGetVal(a->ht,hi,value);
+      aa[p] = value;
+    }
+    PetscHashIterNext(a->ht,hi);
+  }
+  for (i=0; i<m; i++) {
+    if (A->structure_only) {
+      ierr = PetscSortInt(ailen[i],aj+ai[i]);CHKERRQ(ierr);
+    } else {
+      ierr = PetscSortIntWithScalarArray(ailen[i],aj+ai[i],aa+ai[i]);CHKERRQ(ierr);
+    }
+  }
+  a->nz = nz;
+  A->nonzerostate++;
+  ierr = PetscInfo2(A,"Built matrix structure with %D nonzeros in %D rows from hash table\n",nz,m);CHKERRQ(ierr);
+
+  ierr = PetscHMapIJVDestroy(&a->ht);CHKERRQ(ierr);
+  A->ops->setvalues = MatSetValues_SeqAIJ;
+  PetscFunctionReturn(0);
+}
+
 
 PetscErrorCode MatGetValues_SeqAIJ(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],PetscScalar v[])
 {
@@ -978,18 +1067,54 @@ PetscErrorCode MatView_SeqAIJ(Mat A,PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+/*
+   Converts a SEQAIJ matrix at its first final assembly to SEQAIJSELL, whose products use a SELL copy of the matrix,
+   if -mat_aij_sell_padding <ratio> is given and the padding zeros of that copy are at most ratio times the nonzeros
+*/
+static PetscErrorCode MatSeqAIJCheckSELL_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       m  = A->rmap->n,i,k,rlenmax,nzsell = 0;
+  PetscReal      maxpadding;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (A->was_assembled || A->structure_only || !a->nz) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&flg);CHKERRQ(ierr);
+  if (!flg) PetscFunctionReturn(0);
+  ierr = PetscOptionsGetReal(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_aij_sell_padding",&maxpadding,&flg);CHKERRQ(ierr);
+  if (!flg) PetscFunctionReturn(0);
+
+  /* each slice of 8 rows is padded to its longest row */
+  for (i=0; i<m; i+=8) {
+    rlenmax = 0;
+    for (k=i; k<PetscMin(i+8,m); k++) rlenmax = PetscMax(rlenmax,a->ilen[k]);
+    nzsell += 8*rlenmax;
+  }
+  ierr = PetscInfo3(A,"SELL storage would need %D padding zeros for %D nonzeros, limit is %g times the nonzeros\n",nzsell-a->nz,a->nz,(double)maxpadding);CHKERRQ(ierr);
+  if (nzsell-a->nz <= maxpadding*a->nz) {
+    ierr = MatConvert_SeqAIJ_SeqAIJSELL(A,MATSEQAIJSELL,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A,MatAssemblyType mode)
 {
   Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
   PetscErrorCode ierr;
-  PetscInt       fshift = 0,i,j,*ai = a->i,*aj = a->j,*imax = a->imax;
-  PetscInt       m      = A->rmap->n,*ip,N,*ailen = a->ilen,rmax = 0;
-  MatScalar      *aa    = a->a,*ap;
+  PetscInt       fshift = 0,i,j,*ai,*aj,*imax;
+  PetscInt       m      = A->rmap->n,*ip,N,*ailen,rmax = 0;
+  MatScalar      *aa,*ap;
   PetscReal      ratio  = 0.6;
 
   PetscFunctionBegin;
   if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
 
+  /* entries collected with MAT_USE_HASH_TABLE are moved into an exactly sized CSR structure */
+  ierr = MatSeqAIJAssembleHash_Private(A);CHKERRQ(ierr);
+  ai = a->i; aj = a->j; imax = a->imax; ailen = a->ilen; aa = a->a;
+
   if (m) rmax = ailen[0]; /* determine row with most nonzeros */
   for (i=1; i<m; i++) {
     /* move each row back by the amount of empty slots (fshift) before it*/
@@ -1039,6 +1164,7 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A,MatAssemblyType mode)
   }
   ierr = MatAssemblyEnd_SeqAIJ_Inode(A,mode);CHKERRQ(ierr);
   ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJCheckSELL_Private(A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1074,6 +1200,10 @@ PetscErrorCode MatZeroEntries_SeqAIJ(Mat A)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  if (a->ht) {
+    ierr = PetscHMapIJVClear(a->ht);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscMemzero(a->a,(a->i[A->rmap->n])*sizeof(PetscScalar));CHKERRQ(ierr);
   ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1102,6 +1232,8 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = ISColoringDestroy(&a->coloring);CHKERRQ(ierr);
   ierr = PetscFree2(a->compressedrow.i,a->compressedrow.rindex);CHKERRQ(ierr);
   ierr = PetscFree(a->matmult_abdense);CHKERRQ(ierr);
+  ierr = PetscHMapIJVDestroy(&a->ht);CHKERRQ(ierr);
+  ierr = PetscFree2(a->coo_perm,a->coo_jmap);CHKERRQ(ierr);
 
   ierr = MatDestroy_SeqAIJ_Inode(A);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
@@ -1129,6 +1261,9 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatReorderForNonzeroDiagonal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatPtAP_is_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatPtAP_seqaijsingle_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1168,9 +1303,16 @@ PetscErrorCode MatSetOption_SeqAIJ(Mat A,MatOption op,PetscBool flg)
   case MAT_STRUCTURE_ONLY:
     /* These options are handled directly by MatSetOption() */
     break;
+  case MAT_USE_HASH_TABLE:
+    if (A->assembled || A->was_assembled) {
+      ierr = PetscInfo1(A,"Option %s ignored after the first assembly\n",MatOptions[op]);CHKERRQ(ierr);
+    } else if (flg && !a->ht) {
+      ierr = PetscHMapIJVCreate(&a->ht);CHKERRQ(ierr);
+      A->ops->setvalues = MatSetValues_SeqAIJ_Hash;
+    }
+    break;
   case MAT_NEW_DIAGONALS:
   case MAT_IGNORE_OFF_PROC_ENTRIES:
-  case MAT_USE_HASH_TABLE:
     ierr = PetscInfo1(A,"Option %s ignored\n",MatOptions[op]);CHKERRQ(ierr);
     break;
   case MAT_USE_INODES:
@@ -2847,11 +2989,30 @@ PetscErrorCode MatCopy_SeqAIJ(Mat A,Mat B,MatStructure str)
 }
 
 PetscErrorCode MatSetUp_SeqAIJ(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->ht) {
+    /* storage is allocated from the hash table in MatAssemblyEnd() */
+    ierr = MatSeqAIJSetPreallocation_SeqAIJ(A,MAT_SKIP_ALLOCATION,0);CHKERRQ(ierr);
+  } else {
+    ierr = MatSeqAIJSetPreallocation_SeqAIJ(A,PETSC_DEFAULT,0);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetFromOptions_SeqAIJ(PetscOptionItems *PetscOptionsObject,Mat A)
 {
   PetscErrorCode ierr;
+  PetscBool      flg = PETSC_FALSE,set;
 
   PetscFunctionBegin;
-  ierr =  MatSeqAIJSetPreallocation_SeqAIJ(A,PETSC_DEFAULT,0);CHKERRQ(ierr);
+  ierr = PetscOptionsHead(PetscOptionsObject,"SeqAIJ options");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_use_hash_table","Collect entries in a hash table and build the exact nonzero structure at the first assembly","MatSetOption",flg,&flg,&set);CHKERRQ(ierr);
+  if (set) {ierr = MatSetOption(A,MAT_USE_HASH_TABLE,flg);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -3338,7 +3499,7 @@ static struct _MatOps MatOps_Values = { MatSetValues_SeqAIJ,
                                         0,
                                 /* 74*/ 0,
                                         MatFDColoringApply_AIJ,
-                                        0,
+                                        MatSetFromOptions_SeqAIJ,
                                         0,
                                         0,
                                 /* 79*/ MatFindZeroDiagonals_SeqAIJ,
@@ -3755,11 +3916,12 @@ PetscErrorCode  MatCreateSeqAIJ(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+-  -mat_use_hash_table - Collect the entries in a hash table and allocate the exact storage at the first assembly, see MAT_USE_HASH_TABLE
 
    Level: intermediate
 
-.seealso: MatCreate(), MatCreateAIJ(), MatSetValues(), MatSeqAIJSetColumnIndices(), MatCreateSeqAIJWithArrays(), MatGetInfo()
+.seealso: MatCreate(), MatCreateAIJ(), MatSetValues(), MatSeqAIJSetColumnIndices(), MatCreateSeqAIJWithArrays(), MatGetInfo(), MatSetOption()
 
 @*/
 PetscErrorCode  MatSeqAIJSetPreallocation(Mat B,PetscInt nz,const PetscInt nnz[])
@@ -3802,6 +3964,10 @@ PetscErrorCode  MatSeqAIJSetPreallocation_SeqAIJ(Mat B,PetscInt nz,const PetscIn
 
   b = (Mat_SeqAIJ*)B->data;
 
+  /* a new nonzero structure invalidates the one set up with MatSetPreallocationCOO() */
+  ierr     = PetscFree2(b->coo_perm,b->coo_jmap);CHKERRQ(ierr);
+  b->coo_n = 0;
+
   if (!skipallocation) {
     if (!b->imax) {
       ierr = PetscMalloc2(B->rmap->n,&b->imax,B->rmap->n,&b->ilen);CHKERRQ(ierr);
@@ -3832,7 +3998,9 @@ PetscErrorCode  MatSeqAIJSetPreallocation_SeqAIJ(Mat B,PetscInt nz,const PetscIn
       ierr = PetscMalloc1(B->rmap->n+1,&b->i);CHKERRQ(ierr);
       ierr = PetscLogObjectMemory((PetscObject)B,(B->rmap->n+1)*sizeof(PetscInt)+nz*sizeof(PetscInt));CHKERRQ(ierr);
     } else {
+      ierr = PetscMallocPushClass(MAT_CLASSID);CHKERRQ(ierr);
       ierr = PetscMalloc3(nz,&b->a,nz,&b->j,B->rmap->n+1,&b->i);CHKERRQ(ierr);
+      ierr = PetscMallocPopClass();CHKERRQ(ierr);
       ierr = PetscLogObjectMemory((PetscObject)B,(B->rmap->n+1)*sizeof(PetscInt)+nz*(sizeof(PetscScalar)+sizeof(PetscInt)));CHKERRQ(ierr);
     }
     b->i[0] = 0;
@@ -3974,6 +4142,109 @@ PetscErrorCode  MatSeqAIJSetPreallocationCSR_SeqAIJ(Mat B,const PetscInt Ii[],co
   PetscFunctionReturn(0);
 }
 
+/*
+   Builds the (sorted, duplicate free) nonzero structure from the coordinate list and records for each
+   nonzero which entries of the list are summed into it; entries with a negative index are ignored
+*/
+PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_SeqAIJ     *a;
+  PetscErrorCode ierr;
+  PetscInt       m,n,k,r,p,nz,nvalid,*rowptr,*cnt,*cols,*perm,*Ai,*Aj,*jmap;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  m    = A->rmap->n;
+  n    = A->cmap->n;
+  a    = (Mat_SeqAIJ*)A->data;
+  if (a->ht) {
+    ierr = PetscHMapIJVDestroy(&a->ht);CHKERRQ(ierr);
+    A->ops->setvalues = MatSetValues_SeqAIJ;
+  }
+
+  /* bucket the entries by row, then sort the columns (with their position in the list) within each row */
+  ierr = PetscCalloc2(m+1,&rowptr,m,&cnt);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_i[k] >= m) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D: row %D out of range [0,%D)",k,coo_i[k],m);
+    if (coo_j[k] >= n) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D: column %D out of range [0,%D)",k,coo_j[k],n);
+    rowptr[coo_i[k]+1]++;
+  }
+  for (r=0; r<m; r++) rowptr[r+1] += rowptr[r];
+  nvalid = rowptr[m];
+  ierr   = PetscMalloc2(nvalid,&cols,nvalid,&perm);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    p       = rowptr[coo_i[k]] + cnt[coo_i[k]]++;
+    cols[p] = coo_j[k];
+    perm[p] = k;
+  }
+  for (r=0; r<m; r++) {
+    ierr = PetscSortIntWithArray(rowptr[r+1]-rowptr[r],cols+rowptr[r],perm+rowptr[r]);CHKERRQ(ierr);
+  }
+
+  /* merge repeated (i,j) pairs */
+  ierr  = PetscMalloc3(m+1,&Ai,nvalid,&Aj,nvalid+1,&jmap);CHKERRQ(ierr);
+  Ai[0] = 0;
+  for (r=0,nz=0; r<m; r++) {
+    for (p=rowptr[r]; p<rowptr[r+1]; p++) {
+      if (p > rowptr[r] && cols[p] == cols[p-1]) continue;
+      Aj[nz]   = cols[p];
+      jmap[nz] = p;
+      nz++;
+    }
+    Ai[r+1] = nz;
+  }
+  jmap[nz] = nvalid;
+  ierr = PetscFree2(rowptr,cnt);CHKERRQ(ierr);
+
+  ierr = MatSeqAIJSetPreallocationCSR_SeqAIJ(A,Ai,Aj,NULL);CHKERRQ(ierr);
+  a    = (Mat_SeqAIJ*)A->data;
+  if (a->nz != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Matrix has %D nonzeros, expected %D",a->nz,nz);
+
+  ierr = PetscFree2(a->coo_perm,a->coo_jmap);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nvalid,&a->coo_perm,nz+1,&a->coo_jmap);CHKERRQ(ierr);
+  ierr = PetscMemcpy(a->coo_perm,perm,nvalid*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscMemcpy(a->coo_jmap,jmap,(nz+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(nvalid+nz+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  a->coo_n = ncoo;
+  ierr = PetscFree2(cols,perm);CHKERRQ(ierr);
+  ierr = PetscFree3(Ai,Aj,jmap);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat A,const PetscScalar coo_v[],InsertMode imode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       k,p,nz = a->nz;
+  const PetscInt *perm = a->coo_perm,*jmap = a->coo_jmap;
+  MatScalar      *aa = a->a;
+  PetscScalar    sum;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!jmap) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Must call MatSetPreallocationCOO() first");
+  if (imode != INSERT_VALUES && imode != ADD_VALUES) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Only INSERT_VALUES and ADD_VALUES are supported");
+  if (!coo_v) {
+    if (imode == INSERT_VALUES) {ierr = PetscMemzero(aa,nz*sizeof(MatScalar));CHKERRQ(ierr);}
+  } else if (imode == INSERT_VALUES) {
+    for (k=0; k<nz; k++) {
+      for (p=jmap[k],sum=0.0; p<jmap[k+1]; p++) sum += coo_v[perm[p]];
+      aa[k] = sum;
+    }
+  } else {
+    for (k=0; k<nz; k++) {
+      for (p=jmap[k],sum=0.0; p<jmap[k+1]; p++) sum += coo_v[perm[p]];
+      aa[k] += sum;
+    }
+  }
+  ierr = PetscLogFlops(jmap[nz]);CHKERRQ(ierr);
+  a->idiagvalid  = PETSC_FALSE;
+  a->ibdiagvalid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
 #include <../src/mat/impls/dense/seq/dense.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
@@ -4064,7 +4335,9 @@ PETSC_INTERN PetscErrorCode MatMatMult_SeqDense_SeqAIJ(Mat A,Mat B,MatReuse scal
    based on compressed sparse row format.
 
    Options Database Keys:
-. -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
++ -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+- -mat_aij_sell_padding <ratio> - at the first assembly convert to MATSEQAIJSELL if the SELL format needs at most ratio times
+                                  the number of nonzeros as padding zeros; this also applies to the blocks of MATMPIAIJ matrices
 
   Level: beginner
 
@@ -4084,7 +4357,7 @@ M*/
 . -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
 
   Developer Notes:
-    Subclasses include MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
+    Subclasses include MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJOMP, MATAIJSINGLE, MATAIJDELTA, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
    enough exist.
 
   Level: beginner
@@ -4249,6 +4522,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqbaij_C",MatConvert_SeqAIJ_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijperm_C",MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsell_C",MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijomp_C",MatConvert_SeqAIJ_SeqAIJOMP);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsingle_C",MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijdelta_C",MatConvert_SeqAIJ_SeqAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmkl_C",MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4276,6 +4552,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultSymbolic_seqdense_seqaij_C",MatMatMultSymbolic_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultNumeric_seqdense_seqaij_C",MatMatMultNumeric_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_seqaij_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_seqaijsingle_seqaij_C",MatPtAP_SeqAIJSingle_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_SeqAIJ);CHKERRQ(ierr);
   ierr = MatCreate_SeqAIJ_Inode(B);CHKERRQ(ierr);
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
   ierr = MatSeqAIJSetTypeFromOptions(B);CHKERRQ(ierr);  /* this allows changing the matrix subtype to say MATSEQAIJPERM */
@@ -4889,6 +5168,9 @@ PetscErrorCode  MatSeqAIJRegisterAll(void)
   ierr = MatSeqAIJRegister(MATSEQAIJCRL,      MatConvert_SeqAIJ_SeqAIJCRL);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJPERM,     MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJSELL,     MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJOMP,      MatConvert_SeqAIJ_SeqAIJOMP);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJSINGLE,   MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJDELTA,    MatConvert_SeqAIJ_SeqAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = MatSeqAIJRegister(MATSEQAIJMKL,      MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4932,6 +5214,10 @@ PETSC_EXTERN void PETSC_STDCALL matsetvaluesseqaij_(Mat *AA,PetscInt *mm,const P
 
   PetscFunctionBegin;
   MatCheckPreallocated(A,1);
+  if (a->ht) {
+    ierr = MatSetValues_SeqAIJ_Hash(A,m,im,n,in,v,is);CHKERRQ(ierr);
+    PetscFunctionReturnVoid();
+  }
   imax  = a->imax;
   ai    = a->i;
   ailen = a->ilen;
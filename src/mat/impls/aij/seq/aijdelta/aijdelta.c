@@ -0,0 +1,326 @@
+/*
+  Defines basic operations for the MATSEQAIJDELTA matrix class.
+  This class is derived from the MATSEQAIJ class and keeps the same compressed row
+  storage, but the matrix-vector products read compressed column indices: each row
+  stores the first column it touches and the offsets of its columns from it in 8 or
+  16 bits. Rows whose columns span too wide a range fall back to the full indices.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef struct {
+  PetscInt         bits;         /* width of the offsets, 8 or 16, chosen from the widest row when 0 */
+  PetscInt         nbits;        /* width actually used */
+  PetscInt         *rbase;       /* first column of each row of the (possibly compressed) row structure, -1 for fallback rows */
+  void             *dj;          /* column offsets from rbase[], aligned with a->j (unsigned char or unsigned short) */
+  PetscInt         nfallback;    /* number of rows that use a->j */
+  PetscObjectState nonzerostate; /* nonzero state for which the offsets were computed */
+} Mat_SeqAIJDelta;
+
+PETSC_INTERN PetscErrorCode MatMult_SeqAIJDelta(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJDelta(Mat,Vec,Vec,Vec);
+
+/* Computes the row bases and column offsets for the current nonzero structure */
+static PetscErrorCode MatSeqAIJDeltaSetUp_Private(Mat A)
+{
+  Mat_SeqAIJ      *a     = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta *delta = (Mat_SeqAIJDelta*)A->spptr;
+  PetscInt        m      = A->rmap->n,i,k,span,maxspan = 0,nbits;
+  const PetscInt  *ii    = a->i;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  A->ops->mult    = MatMult_SeqAIJDelta;
+  A->ops->multadd = MatMultAdd_SeqAIJDelta;
+  if (delta->nonzerostate == A->nonzerostate) PetscFunctionReturn(0);
+  if (a->compressedrow.use) {
+    m  = a->compressedrow.nrows;
+    ii = a->compressedrow.i;
+  }
+  /* the rows are sorted, so the span of a row is its last column minus its first */
+  for (i=0; i<m; i++) {
+    if (ii[i+1] > ii[i]) {
+      span    = a->j[ii[i+1]-1] - a->j[ii[i]];
+      maxspan = PetscMax(maxspan,span);
+    }
+  }
+  nbits = delta->bits;
+  if (!nbits) nbits = maxspan < 256 ? 8 : 16;
+
+  ierr = PetscFree(delta->rbase);CHKERRQ(ierr);
+  ierr = PetscFree(delta->dj);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,&delta->rbase);CHKERRQ(ierr);
+  if (nbits == 8) {
+    unsigned char *dj;
+    ierr = PetscMalloc1(a->nz,&dj);CHKERRQ(ierr);
+    delta->dj = (void*)dj;
+  } else {
+    unsigned short *dj;
+    ierr = PetscMalloc1(a->nz,&dj);CHKERRQ(ierr);
+    delta->dj = (void*)dj;
+  }
+  ierr = PetscLogObjectMemory((PetscObject)A,m*sizeof(PetscInt)+a->nz*(nbits/8));CHKERRQ(ierr);
+
+  delta->nbits     = nbits;
+  delta->nfallback = 0;
+  for (i=0; i<m; i++) {
+    PetscInt base = ii[i+1] > ii[i] ? a->j[ii[i]] : 0;
+    span = ii[i+1] > ii[i] ? a->j[ii[i+1]-1] - base : 0;
+    if (span >= ((PetscInt)1 << nbits)) {
+      delta->rbase[i] = -1;
+      delta->nfallback++;
+      continue;
+    }
+    delta->rbase[i] = base;
+    if (nbits == 8) {
+      unsigned char *dj = (unsigned char*)delta->dj;
+      for (k=ii[i]; k<ii[i+1]; k++) dj[k] = (unsigned char)(a->j[k] - base);
+    } else {
+      unsigned short *dj = (unsigned short*)delta->dj;
+      for (k=ii[i]; k<ii[i+1]; k++) dj[k] = (unsigned short)(a->j[k] - base);
+    }
+  }
+  delta->nonzerostate = A->nonzerostate;
+  ierr = PetscInfo4(A,"Column offsets of %D bits, %D of %D rows use the full indices, widest row spans %D columns\n",nbits,delta->nfallback,m,maxspan);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJDelta(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJDeltaSetUp_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The row loop shared by MatMult and MatMultAdd; y is NULL for MatMult. The offsets are read through
+   a pointer of type ctype, x is shifted by the row base so that they index it directly.
+*/
+#define MatMultAdd_SeqAIJDelta_Rows(ctype) do { \
+    const ctype *dj = (const ctype*)delta->dj; \
+    for (i=0; i<mr; i++) { \
+      const MatScalar   *aa  = a->a + ii[i]; \
+      PetscInt          n    = ii[i+1] - ii[i],k,r = ridx ? ridx[i] : i,base = delta->rbase[i]; \
+      PetscScalar       sum  = y ? y[r] : 0.0; \
+      if (base >= 0) { \
+        const ctype       *d  = dj + ii[i]; \
+        const PetscScalar *xb = x + base; \
+        for (k=0; k<n; k++) sum += aa[k]*xb[d[k]]; \
+      } else { \
+        const PetscInt *aj = a->j + ii[i]; \
+        for (k=0; k<n; k++) sum += aa[k]*x[aj[k]]; \
+      } \
+      z[r] = sum; \
+    } \
+  } while (0)
+
+static PetscErrorCode MatMultAdd_SeqAIJDelta_Private(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a     = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta   *delta = (Mat_SeqAIJDelta*)A->spptr;
+  PetscInt          m      = A->rmap->n,mr = m,i;
+  const PetscInt    *ii    = a->i,*ridx = NULL;
+  const PetscScalar *x;
+  PetscScalar       *y = NULL,*z;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);}
+  else {ierr = VecGetArray(zz,&z);CHKERRQ(ierr);}
+  if (a->compressedrow.use) {
+    if (!yy) {ierr = PetscMemzero(z,m*sizeof(PetscScalar));CHKERRQ(ierr);}
+    else if (zz != yy) {ierr = PetscMemcpy(z,y,m*sizeof(PetscScalar));CHKERRQ(ierr);}
+    mr   = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  if (delta->nbits == 8) MatMultAdd_SeqAIJDelta_Rows(unsigned char);
+  else MatMultAdd_SeqAIJDelta_Rows(unsigned short);
+  ierr = PetscLogFlops(yy ? 2.0*a->nz : 2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);}
+  else {ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJDelta(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultAdd_SeqAIJDelta_Private(A,xx,NULL,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJDelta(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultAdd_SeqAIJDelta_Private(A,xx,yy,zz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJDelta(Mat A)
+{
+  PetscErrorCode  ierr;
+  Mat_SeqAIJDelta *delta = (Mat_SeqAIJDelta*)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJDelta matrix will not have an spptr pointer. */
+  if (delta) {
+    ierr = PetscFree(delta->rbase);CHKERRQ(ierr);
+    ierr = PetscFree(delta->dj);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaijdelta_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJDelta(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode  ierr;
+  Mat_SeqAIJDelta *delta = (Mat_SeqAIJDelta*)A->spptr,*delta_dest;
+
+  PetscFunctionBegin;
+  ierr       = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  delta_dest = (Mat_SeqAIJDelta*)(*M)->spptr;
+  delta_dest->bits = delta->bits;
+  ierr = MatSeqAIJDeltaSetUp_Private(*M);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJDelta_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATSEQAIJDELTA to its base PETSc type, so 'type' is ignored. */
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJDelta *delta;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  delta = (Mat_SeqAIJDelta*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate   = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy     = MatDestroy_SeqAIJ;
+  B->ops->mult        = MatMult_SeqAIJ;
+  B->ops->multadd     = MatMultAdd_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijdelta_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscFree(delta->rbase);CHKERRQ(ierr);
+  ierr = PetscFree(delta->dj);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJDelta converts a SeqAIJ matrix into a SeqAIJDelta matrix. This routine is called by
+ * MatCreate_SeqAIJDelta(), but can also be used to convert an assembled SeqAIJ matrix. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJDelta(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJDelta *delta;
+  PetscBool       sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&delta);CHKERRQ(ierr);
+  B->spptr = (void*)delta;
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"AIJDELTA Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijdelta_bits","Width of the column offsets, 8 or 16 (0 chooses from the widest row)","None",delta->bits,&delta->bits,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (delta->bits && delta->bits != 8 && delta->bits != 16) SETERRQ1(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_OUTOFRANGE,"Offsets of %D bits are not supported, use 8 or 16",delta->bits);
+  delta->nonzerostate = -1;
+
+  B->ops->duplicate   = MatDuplicate_SeqAIJDelta;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJDelta;
+  B->ops->destroy     = MatDestroy_SeqAIJDelta;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijdelta_seqaij_C",MatConvert_SeqAIJDelta_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJDELTA);CHKERRQ(ierr);
+
+  /* an assembled matrix gets its offsets and products right away */
+  if (B->assembled) {
+    ierr = MatSeqAIJDeltaSetUp_Private(B);CHKERRQ(ierr);
+  }
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJDelta - Creates a sparse matrix of type SEQAIJDELTA.
+   This type inherits from AIJ and is largely identical, but MatMult() and MatMultAdd() read
+   compressed column indices: each row stores its first column and the offsets of its nonzeros
+   from it in 8 or 16 bits, instead of a full PetscInt per nonzero.
+   Because SEQAIJDELTA is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijdelta" can be used to make
+   sequential AIJ matrices default to being instances of MATSEQAIJDELTA.
+
+   Collective on MPI_Comm
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
+.  -mat_aijdelta_bits <bits> - width of the offsets, 8 or 16; by default 8 bits are used if every row spans fewer than 256 columns
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   Rows whose columns span at least 2^bits columns use the full column indices. The offsets are
+   computed again only when the nonzero structure changes. They are kept in addition to the full
+   indices, which all other operations use; the saving is in the memory traffic of the products,
+   from sizeof(MatScalar)+sizeof(PetscInt) to sizeof(MatScalar)+1 or 2 bytes per nonzero.
+
+   Level: intermediate
+
+.keywords: matrix, sparse, compressed indices
+
+.seealso: MatCreate(), MatCreateMPIAIJDelta(), MatSetValues()
+@*/
+PetscErrorCode MatCreateSeqAIJDelta(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJDELTA);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJDelta(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJDelta(A,MATSEQAIJDELTA,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -118,6 +118,7 @@ PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat A,MatFactorType ftype,
 
   ierr = PetscFree((*B)->solvertype);CHKERRQ(ierr);
   ierr = PetscStrallocpy(MATSOLVERPETSC,&(*B)->solvertype);CHKERRQ(ierr);
+  ierr = MatFactorSetUpSolveLevels_SeqAIJ(A,*B);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -0,0 +1,428 @@
+/*
+  Level scheduled triangular solves for the LU, ILU, Cholesky and ICC factors computed by MATSOLVERPETSC
+  for SeqAIJ matrices. After each numeric factorization the rows of each triangular factor are sorted into
+  levels: a row only depends on rows of earlier levels, so the rows of one level are solved concurrently by
+  OpenMP threads, with a barrier between levels. The factors keep their usual storage and the levels only
+  depend on the nonzero structure, so they are computed once for each symbolic factorization.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <../src/mat/impls/sbaij/seq/sbaij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+typedef struct {
+  PetscInt       nthreads;                  /* number of threads sharing each level */
+  PetscBool      built;                     /* the levels are computed for the current symbolic factor */
+  PetscBool      identity;                  /* the factor uses the natural ordering */
+  PetscInt       nlevelsL,*levelL,*rowL;    /* rows rowL[levelL[l]..levelL[l+1]) of the forward solve only depend on rows of earlier levels */
+  PetscInt       nlevelsU,*levelU,*rowU;    /* the same for the backward solve */
+  PetscInt       *ti,*tj,*tv;               /* Cholesky and ICC only: the off-diagonal entries of U by columns, with their row tj and position tv in the factor */
+  PetscScalar    *work;                     /* Cholesky and ICC only: the forward solution before the scaling by the diagonal */
+  PetscErrorCode (*lufactorsymbolic)(Mat,Mat,IS,IS,const MatFactorInfo*);
+  PetscErrorCode (*ilufactorsymbolic)(Mat,Mat,IS,IS,const MatFactorInfo*);
+  PetscErrorCode (*choleskyfactorsymbolic)(Mat,Mat,IS,const MatFactorInfo*);
+  PetscErrorCode (*iccfactorsymbolic)(Mat,Mat,IS,const MatFactorInfo*);
+  PetscErrorCode (*lufactornumeric)(Mat,Mat,const MatFactorInfo*);
+  PetscErrorCode (*choleskyfactornumeric)(Mat,Mat,const MatFactorInfo*);
+} Mat_SolveLevels;
+
+static PetscErrorCode MatSolveLevelsReset_Private(Mat_SolveLevels *lv)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(lv->levelL);CHKERRQ(ierr);
+  ierr = PetscFree(lv->rowL);CHKERRQ(ierr);
+  ierr = PetscFree(lv->levelU);CHKERRQ(ierr);
+  ierr = PetscFree(lv->rowU);CHKERRQ(ierr);
+  ierr = PetscFree3(lv->ti,lv->tj,lv->tv);CHKERRQ(ierr);
+  ierr = PetscFree(lv->work);CHKERRQ(ierr);
+  lv->nlevelsL = 0;
+  lv->nlevelsU = 0;
+  lv->built    = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolveLevelsDestroy_Private(void *ctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsReset_Private((Mat_SolveLevels*)ctx);CHKERRQ(ierr);
+  ierr = PetscFree(ctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolveLevelsGet_Private(Mat B,Mat_SolveLevels **lv)
+{
+  PetscErrorCode ierr;
+  PetscContainer container;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject)B,"MatSolveLevels",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Factor has no solve levels");
+  ierr = PetscContainerGetPointer(container,(void**)lv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Sorts the rows 0..n-1 by their level lev[], keeping the increasing order of the rows within each level */
+static PetscErrorCode MatSolveLevelsSort_Private(PetscInt n,const PetscInt *lev,PetscInt *nlevels,PetscInt **level,PetscInt **row)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l,nl = 0,*lp,*rp;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) nl = PetscMax(nl,lev[i]+1);
+  ierr = PetscCalloc1(nl+1,&lp);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&rp);CHKERRQ(ierr);
+  for (i=0; i<n; i++) lp[lev[i]+1]++;
+  for (l=0; l<nl; l++) lp[l+1] += lp[l];
+  for (i=0; i<n; i++) rp[lp[lev[i]]++] = i;
+  for (l=nl; l>0; l--) lp[l] = lp[l-1];
+  lp[0]    = 0;
+  *nlevels = nl;
+  *level   = lp;
+  *row     = rp;
+  PetscFunctionReturn(0);
+}
+
+/* Levels of L and U of an LU factor: row i of L holds ai[i]..ai[i+1]-1, row i of U adiag[i+1]+1..adiag[i]-1 */
+static PetscErrorCode MatSolveLevelsSetUp_LU(Mat B,Mat_SolveLevels *lv)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)B->data;
+  const PetscInt *ai = b->i,*aj = b->j,*adiag = b->diag;
+  PetscInt       n = B->rmap->n,i,k,l,*lev;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(n,&lev);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (l=0,k=ai[i]; k<ai[i+1]; k++) l = PetscMax(l,lev[aj[k]]+1);
+    lev[i] = l;
+  }
+  ierr = MatSolveLevelsSort_Private(n,lev,&lv->nlevelsL,&lv->levelL,&lv->rowL);CHKERRQ(ierr);
+  for (i=n-1; i>=0; i--) {
+    for (l=0,k=adiag[i+1]+1; k<adiag[i]; k++) l = PetscMax(l,lev[aj[k]]+1);
+    lev[i] = l;
+  }
+  ierr = MatSolveLevelsSort_Private(n,lev,&lv->nlevelsU,&lv->levelU,&lv->rowU);CHKERRQ(ierr);
+  ierr = PetscFree(lev);CHKERRQ(ierr);
+  lv->built = PETSC_TRUE;
+  ierr = PetscInfo3(B,"%D rows in %D levels for L and %D levels for U\n",n,lv->nlevelsL,lv->nlevelsU);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Levels of U^T and U of a Cholesky factor: row i of U holds ai[i]..ai[i+1]-2, followed by the inverse of the diagonal */
+static PetscErrorCode MatSolveLevelsSetUp_Cholesky(Mat B,Mat_SolveLevels *lv)
+{
+  Mat_SeqSBAIJ   *b = (Mat_SeqSBAIJ*)B->data;
+  const PetscInt *ai = b->i,*aj = b->j;
+  PetscInt       n = B->rmap->n,nz = ai[n]-n,i,k,l,*lev,*ti,*tj,*tv;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(n+1,&lv->ti,nz,&lv->tj,nz,&lv->tv);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&lv->work);CHKERRQ(ierr);
+  ti   = lv->ti; tj = lv->tj; tv = lv->tv;
+  ierr = PetscMemzero(ti,(n+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (k=ai[i]; k<ai[i+1]-1; k++) ti[aj[k]+1]++;
+  }
+  for (i=0; i<n; i++) ti[i+1] += ti[i];
+  for (i=0; i<n; i++) {
+    for (k=ai[i]; k<ai[i+1]-1; k++) {
+      tj[ti[aj[k]]]   = i;
+      tv[ti[aj[k]]++] = k;
+    }
+  }
+  for (i=n; i>0; i--) ti[i] = ti[i-1];
+  ti[0] = 0;
+
+  ierr = PetscMalloc1(n,&lev);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (l=0,k=ti[i]; k<ti[i+1]; k++) l = PetscMax(l,lev[tj[k]]+1);
+    lev[i] = l;
+  }
+  ierr = MatSolveLevelsSort_Private(n,lev,&lv->nlevelsL,&lv->levelL,&lv->rowL);CHKERRQ(ierr);
+  for (i=n-1; i>=0; i--) {
+    for (l=0,k=ai[i]; k<ai[i+1]-1; k++) l = PetscMax(l,lev[aj[k]]+1);
+    lev[i] = l;
+  }
+  ierr = MatSolveLevelsSort_Private(n,lev,&lv->nlevelsU,&lv->levelU,&lv->rowU);CHKERRQ(ierr);
+  ierr = PetscFree(lev);CHKERRQ(ierr);
+  lv->built = PETSC_TRUE;
+  ierr = PetscInfo3(B,"%D rows in %D levels for U^T and %D levels for U\n",n,lv->nlevelsL,lv->nlevelsU);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SolveLevels   *lv;
+  PetscErrorCode    ierr;
+  const PetscInt    *ai = a->i,*aj = a->j,*adiag = a->diag,*r = NULL,*c = NULL;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *b;
+  PetscScalar       *x,*tmp;
+  PetscInt          n = A->rmap->n;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = MatSolveLevelsGet_Private(A,&lv);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  if (lv->identity) tmp = x;
+  else {
+    tmp  = a->solve_work;
+    ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+    ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  }
+
+  PetscPragmaOMP(omp parallel num_threads(lv->nthreads))
+  {
+    PetscInt l,k;
+
+    /* forward solve the lower triangular */
+    for (l=0; l<lv->nlevelsL; l++) {
+      PetscPragmaOMP(omp for schedule(static))
+      for (k=lv->levelL[l]; k<lv->levelL[l+1]; k++) {
+        const PetscInt  i   = lv->rowL[k],nz = ai[i+1] - ai[i];
+        const PetscInt  *vi = aj + ai[i];
+        const MatScalar *v  = aa + ai[i];
+        PetscScalar     sum = b[r ? r[i] : i];
+
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        tmp[i] = sum;
+      }
+    }
+
+    /* backward solve the upper triangular */
+    for (l=0; l<lv->nlevelsU; l++) {
+      PetscPragmaOMP(omp for schedule(static))
+      for (k=lv->levelU[l]; k<lv->levelU[l+1]; k++) {
+        const PetscInt  i   = lv->rowU[k],nz = adiag[i] - adiag[i+1] - 1;
+        const PetscInt  *vi = aj + adiag[i+1] + 1;
+        const MatScalar *v  = aa + adiag[i+1] + 1;
+        PetscScalar     sum = tmp[i];
+
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        tmp[i] = sum*v[nz]; /* v[nz] = aa[adiag[i]] */
+        if (c) x[c[i]] = tmp[i];
+      }
+    }
+  }
+
+  if (!lv->identity) {
+    ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolve_SeqSBAIJ_1_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqSBAIJ      *a = (Mat_SeqSBAIJ*)A->data;
+  Mat_SolveLevels   *lv;
+  PetscErrorCode    ierr;
+  const PetscInt    *ai = a->i,*aj = a->j,*rp = NULL;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *b;
+  PetscScalar       *x,*t,*y;
+  PetscInt          n = A->rmap->n;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = MatSolveLevelsGet_Private(A,&lv);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  t    = lv->work;
+  if (lv->identity) y = x;
+  else {
+    y    = a->solve_work;
+    ierr = ISGetIndices(a->row,&rp);CHKERRQ(ierr);
+  }
+
+  PetscPragmaOMP(omp parallel num_threads(lv->nthreads))
+  {
+    PetscInt l,k;
+
+    /* solve U^T*D*y = perm(b) by forward substitution, gathering the columns of U */
+    for (l=0; l<lv->nlevelsL; l++) {
+      PetscPragmaOMP(omp for schedule(static))
+      for (k=lv->levelL[l]; k<lv->levelL[l+1]; k++) {
+        const PetscInt i   = lv->rowL[k];
+        PetscScalar    sum = b[rp ? rp[i] : i];
+        PetscInt       j;
+
+        for (j=lv->ti[i]; j<lv->ti[i+1]; j++) sum += aa[lv->tv[j]]*t[lv->tj[j]];
+        t[i] = sum;
+        y[i] = sum*aa[ai[i+1]-1]; /* aa[ai[i+1]-1] = 1/D(i) */
+      }
+    }
+
+    /* solve U*perm(x) = y by backward substitution */
+    for (l=0; l<lv->nlevelsU; l++) {
+      PetscPragmaOMP(omp for schedule(static))
+      for (k=lv->levelU[l]; k<lv->levelU[l+1]; k++) {
+        const PetscInt  i   = lv->rowU[k],nz = ai[i+1] - ai[i] - 1;
+        const PetscInt  *vi = aj + ai[i];
+        const MatScalar *v  = aa + ai[i];
+        PetscScalar     sum = y[i];
+
+        PetscSparseDensePlusDot(sum,y,v,vi,nz);
+        y[i] = sum;
+        if (rp) x[rp[i]] = sum;
+      }
+    }
+  }
+
+  if (!lv->identity) {ierr = ISRestoreIndices(a->row,&rp);CHKERRQ(ierr);}
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(4.0*a->nz - 3.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_Levels(Mat B,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ      *b = (Mat_SeqAIJ*)B->data;
+  Mat_SolveLevels *lv;
+  PetscBool       row_identity,col_identity;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsGet_Private(B,&lv);CHKERRQ(ierr);
+  ierr = (*lv->lufactornumeric)(B,A,info);CHKERRQ(ierr);
+  /* only the factors stored by MatLUFactorNumeric_SeqAIJ() and MatLUFactorNumeric_SeqAIJ_Inode() are supported, not the inplace ones */
+  if (B->ops->solve == MatSolve_SeqAIJ || B->ops->solve == MatSolve_SeqAIJ_NaturalOrdering || B->ops->solve == MatSolve_SeqAIJ_Inode) {
+    if (!lv->built) {ierr = MatSolveLevelsSetUp_LU(B,lv);CHKERRQ(ierr);}
+    ierr = ISIdentity(b->row,&row_identity);CHKERRQ(ierr);
+    ierr = ISIdentity(b->col,&col_identity);CHKERRQ(ierr);
+    lv->identity   = (PetscBool)(row_identity && col_identity);
+    B->ops->solve  = MatSolve_SeqAIJ_Levels;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCholeskyFactorNumeric_SeqAIJ_Levels(Mat B,Mat A,const MatFactorInfo *info)
+{
+  Mat_SolveLevels *lv;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsGet_Private(B,&lv);CHKERRQ(ierr);
+  ierr = (*lv->choleskyfactornumeric)(B,A,info);CHKERRQ(ierr);
+  /* only the factors stored by MatCholeskyFactorNumeric_SeqAIJ() are supported, not the inplace ones */
+  if (B->ops->solve == MatSolve_SeqSBAIJ_1 || B->ops->solve == MatSolve_SeqSBAIJ_1_NaturalOrdering) {
+    if (!lv->built) {ierr = MatSolveLevelsSetUp_Cholesky(B,lv);CHKERRQ(ierr);}
+    lv->identity  = (PetscBool)(B->ops->solve == MatSolve_SeqSBAIJ_1_NaturalOrdering);
+    B->ops->solve = MatSolve_SeqSBAIJ_1_Levels;
+    B->ops->solvetranspose = MatSolve_SeqSBAIJ_1_Levels;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLUFactorSymbolic_SeqAIJ_Levels(Mat B,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  Mat_SolveLevels *lv;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsGet_Private(B,&lv);CHKERRQ(ierr);
+  ierr = MatSolveLevelsReset_Private(lv);CHKERRQ(ierr);
+  ierr = (*lv->lufactorsymbolic)(B,A,isrow,iscol,info);CHKERRQ(ierr);
+  lv->lufactornumeric     = B->ops->lufactornumeric;
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Levels;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJ_Levels(Mat B,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  Mat_SolveLevels *lv;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsGet_Private(B,&lv);CHKERRQ(ierr);
+  ierr = MatSolveLevelsReset_Private(lv);CHKERRQ(ierr);
+  ierr = (*lv->ilufactorsymbolic)(B,A,isrow,iscol,info);CHKERRQ(ierr);
+  lv->lufactornumeric     = B->ops->lufactornumeric;
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Levels;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCholeskyFactorSymbolic_SeqAIJ_Levels(Mat B,Mat A,IS perm,const MatFactorInfo *info)
+{
+  Mat_SolveLevels *lv;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsGet_Private(B,&lv);CHKERRQ(ierr);
+  ierr = MatSolveLevelsReset_Private(lv);CHKERRQ(ierr);
+  ierr = (*lv->choleskyfactorsymbolic)(B,A,perm,info);CHKERRQ(ierr);
+  lv->choleskyfactornumeric     = B->ops->choleskyfactornumeric;
+  B->ops->choleskyfactornumeric = MatCholeskyFactorNumeric_SeqAIJ_Levels;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatICCFactorSymbolic_SeqAIJ_Levels(Mat B,Mat A,IS perm,const MatFactorInfo *info)
+{
+  Mat_SolveLevels *lv;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSolveLevelsGet_Private(B,&lv);CHKERRQ(ierr);
+  ierr = MatSolveLevelsReset_Private(lv);CHKERRQ(ierr);
+  ierr = (*lv->iccfactorsymbolic)(B,A,perm,info);CHKERRQ(ierr);
+  lv->choleskyfactornumeric     = B->ops->choleskyfactornumeric;
+  B->ops->choleskyfactornumeric = MatCholeskyFactorNumeric_SeqAIJ_Levels;
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatFactorSetUpSolveLevels_SeqAIJ - Called by MatGetFactor_seqaij_petsc(): with -mat_solve_levels the
+   factor B of A gets level scheduled MatSolve(). The symbolic factorizations are wrapped so that the levels
+   are computed again for each new nonzero structure, and the numeric factorizations so that the solve is
+   installed after each of them.
+*/
+PetscErrorCode MatFactorSetUpSolveLevels_SeqAIJ(Mat A,Mat B)
+{
+  PetscErrorCode  ierr;
+  Mat_SolveLevels *lv;
+  PetscContainer  container;
+  PetscBool       flg = PETSC_FALSE;
+  PetscInt        nthreads = 1;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  nthreads = omp_get_max_threads();
+#endif
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"Triangular solve options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_solve_levels","Level scheduled triangular solves of the factors","None",flg,&flg,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_solve_levels_threads","Number of threads sharing the rows of each level","None",nthreads,&nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (!flg) PetscFunctionReturn(0);
+  if (nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",nthreads);
+
+  ierr = PetscNew(&lv);CHKERRQ(ierr);
+  lv->nthreads = nthreads;
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,lv);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,MatSolveLevelsDestroy_Private);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)B,"MatSolveLevels",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+
+  lv->lufactorsymbolic       = B->ops->lufactorsymbolic;
+  lv->ilufactorsymbolic      = B->ops->ilufactorsymbolic;
+  lv->choleskyfactorsymbolic = B->ops->choleskyfactorsymbolic;
+  lv->iccfactorsymbolic      = B->ops->iccfactorsymbolic;
+  if (lv->lufactorsymbolic)       B->ops->lufactorsymbolic       = MatLUFactorSymbolic_SeqAIJ_Levels;
+  if (lv->ilufactorsymbolic)      B->ops->ilufactorsymbolic      = MatILUFactorSymbolic_SeqAIJ_Levels;
+  if (lv->choleskyfactorsymbolic) B->ops->choleskyfactorsymbolic = MatCholeskyFactorSymbolic_SeqAIJ_Levels;
+  if (lv->iccfactorsymbolic)      B->ops->iccfactorsymbolic      = MatICCFactorSymbolic_SeqAIJ_Levels;
+  PetscFunctionReturn(0);
+}
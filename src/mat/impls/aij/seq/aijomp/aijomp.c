@@ -0,0 +1,434 @@
+/*
+  Defines basic operations for the MATSEQAIJOMP matrix class.
+  This class is derived from the MATSEQAIJ class and uses the same compressed row
+  storage, but the matrix-vector products are shared among OpenMP threads. The rows
+  are split into contiguous blocks with about the same number of nonzeros, and the
+  matrix arrays can be placed so that each thread touches its own block first.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+typedef struct {
+  PetscInt         nthreads;     /* number of threads sharing the products */
+  PetscInt         *rstart;      /* thread t handles rows [rstart[t],rstart[t+1]) of the (possibly compressed) row structure */
+  PetscBool        firsttouch;   /* reallocate the matrix arrays so that each thread first touches its own rows */
+  PetscObjectState nonzerostate; /* nonzero state for which the arrays were last placed */
+  PetscScalar      *work;        /* nthreads vectors of length n used by MatMultTranspose() */
+} Mat_SeqAIJOMP;
+
+PETSC_INTERN PetscErrorCode MatMult_SeqAIJOMP(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJOMP(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJOMP(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJOMP(Mat,Vec,Vec,Vec);
+
+/* Splits the rows described by ii[0..m] in nthreads contiguous blocks with about the same number of nonzeros */
+static PetscErrorCode MatSeqAIJOMPPartition_Private(Mat_SeqAIJOMP *aijomp,PetscInt m,const PetscInt *ii)
+{
+  PetscInt t,r = 0,nt = aijomp->nthreads;
+  PetscInt nz = ii[m] - ii[0];
+
+  PetscFunctionBegin;
+  aijomp->rstart[0] = 0;
+  for (t=1; t<nt; t++) {
+    PetscInt target = ii[0] + (PetscInt)(((PetscInt64)nz*t)/nt);
+    while (r < m && ii[r] < target) r++;
+    aijomp->rstart[t] = r;
+  }
+  aijomp->rstart[nt] = m;
+  PetscFunctionReturn(0);
+}
+
+/* Moves the column indices and values into freshly allocated arrays that are first written by the thread that later uses them */
+static PetscErrorCode MatSeqAIJOMPFirstTouch_Private(Mat A)
+{
+  Mat_SeqAIJ     *a      = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt       m       = A->rmap->n,nz = a->nz,nt = aijomp->nthreads,t;
+  const PetscInt *ii     = a->compressedrow.use ? a->compressedrow.i : a->i;
+  const PetscInt *rstart = aijomp->rstart;
+  PetscInt       *newj,*newi;
+  MatScalar      *newa;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->free_a || !a->free_ij) PetscFunctionReturn(0); /* the arrays belong to the user */
+  ierr = PetscMalloc3(nz,&newa,nz,&newj,m+1,&newi);CHKERRQ(ierr);
+  PetscPragmaOMP(omp parallel for num_threads(nt) schedule(static,1))
+  for (t=0; t<nt; t++) {
+    PetscInt k;
+    for (k=ii[rstart[t]]; k<ii[rstart[t+1]]; k++) {
+      newa[k] = a->a[k];
+      newj[k] = a->j[k];
+    }
+  }
+  ierr = PetscMemcpy(newi,a->i,(m+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = MatSeqXAIJFreeAIJ(A,&a->a,&a->j,&a->i);CHKERRQ(ierr);
+  a->a            = newa;
+  a->j            = newj;
+  a->i            = newi;
+  a->singlemalloc = PETSC_TRUE;
+  a->free_a       = PETSC_TRUE;
+  a->free_ij      = PETSC_TRUE;
+  a->maxnz        = nz;
+  PetscFunctionReturn(0);
+}
+
+/* Computes the partition for the current structure, places the arrays if requested and installs the threaded products */
+static PetscErrorCode MatSeqAIJOMPSetUp_Private(Mat A)
+{
+  Mat_SeqAIJ     *a      = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->compressedrow.use) {
+    ierr = MatSeqAIJOMPPartition_Private(aijomp,a->compressedrow.nrows,a->compressedrow.i);CHKERRQ(ierr);
+  } else {
+    ierr = MatSeqAIJOMPPartition_Private(aijomp,A->rmap->n,a->i);CHKERRQ(ierr);
+  }
+  if (aijomp->firsttouch && aijomp->nthreads > 1 && aijomp->nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJOMPFirstTouch_Private(A);CHKERRQ(ierr);
+    aijomp->nonzerostate = A->nonzerostate;
+  }
+  /* the inode routines installed by the assembly are kept for everything but the products */
+  A->ops->mult             = MatMult_SeqAIJOMP;
+  A->ops->multadd          = MatMultAdd_SeqAIJOMP;
+  A->ops->multtranspose    = MatMultTranspose_SeqAIJOMP;
+  A->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJOMP;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJOMP(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJOMPSetUp_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a      = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt          m       = A->rmap->n,nt = aijomp->nthreads,t;
+  const PetscInt    *ii     = a->i,*ridx = NULL,*rstart = aijomp->rstart;
+  const PetscScalar *x;
+  PetscScalar       *y;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    ierr = PetscMemzero(y,m*sizeof(PetscScalar));CHKERRQ(ierr);
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  PetscPragmaOMP(omp parallel for num_threads(nt) schedule(static,1))
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj;
+    const MatScalar *aa;
+    PetscScalar     sum;
+    PetscInt        i,n;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      n   = ii[i+1] - ii[i];
+      aj  = a->j + ii[i];
+      aa  = a->a + ii[i];
+      sum = 0.0;
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      y[ridx ? ridx[i] : i] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJOMP(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a      = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt          m       = A->rmap->n,nt = aijomp->nthreads,t;
+  const PetscInt    *ii     = a->i,*ridx = NULL,*rstart = aijomp->rstart;
+  const PetscScalar *x;
+  PetscScalar       *y,*z;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    if (zz != yy) {ierr = PetscMemcpy(z,y,m*sizeof(PetscScalar));CHKERRQ(ierr);}
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  PetscPragmaOMP(omp parallel for num_threads(nt) schedule(static,1))
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj;
+    const MatScalar *aa;
+    PetscScalar     sum;
+    PetscInt        i,n,r;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      n    = ii[i+1] - ii[i];
+      aj   = a->j + ii[i];
+      aa   = a->a + ii[i];
+      r    = ridx ? ridx[i] : i;
+      sum  = y[r];
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      z[r] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Each thread scatters its rows into a private vector; the vectors are then summed column by column */
+PetscErrorCode MatMultTransposeAdd_SeqAIJOMP(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a      = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt          n       = A->cmap->n,nt = aijomp->nthreads,t,c;
+  const PetscInt    *ii     = a->i,*ridx = NULL,*rstart = aijomp->rstart;
+  const PetscScalar *x;
+  PetscScalar       *y = NULL,*z,*work;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (nt == 1) {
+    if (yy) {ierr = MatMultTransposeAdd_SeqAIJ(A,xx,yy,zz);CHKERRQ(ierr);}
+    else {ierr = MatMultTranspose_SeqAIJ(A,xx,zz);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  if (!aijomp->work) {
+    ierr = PetscMalloc1(nt*n,&aijomp->work);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,nt*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  work = aijomp->work;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);}
+  else {ierr = VecGetArray(zz,&z);CHKERRQ(ierr);}
+  if (a->compressedrow.use) {
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  PetscPragmaOMP(omp parallel for num_threads(nt) schedule(static,1))
+  for (t=0; t<nt; t++) {
+    PetscScalar     *w = work + t*n,alpha;
+    const PetscInt  *aj;
+    const MatScalar *aa;
+    PetscInt        i,j,nz;
+
+    for (j=0; j<n; j++) w[j] = 0.0;
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      nz    = ii[i+1] - ii[i];
+      aj    = a->j + ii[i];
+      aa    = a->a + ii[i];
+      alpha = x[ridx ? ridx[i] : i];
+      for (j=0; j<nz; j++) w[aj[j]] += alpha*aa[j];
+    }
+  }
+  PetscPragmaOMP(omp parallel for num_threads(nt) schedule(static))
+  for (c=0; c<n; c++) {
+    PetscScalar sum = y ? y[c] : 0.0;
+    PetscInt    s;
+    for (s=0; s<nt; s++) sum += work[s*n+c];
+    z[c] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz + (nt-1)*n);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);}
+  else {ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultTransposeAdd_SeqAIJOMP(A,xx,NULL,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJOMP matrix will not have an spptr pointer. */
+  if (aijomp) {
+    ierr = PetscFree(aijomp->rstart);CHKERRQ(ierr);
+    ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaijomp_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJOMP(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr,*aijomp_dest;
+
+  PetscFunctionBegin;
+  ierr        = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  aijomp_dest = (Mat_SeqAIJOMP*)(*M)->spptr;
+  if (aijomp_dest->nthreads != aijomp->nthreads) {
+    ierr = PetscFree(aijomp_dest->work);CHKERRQ(ierr);
+    ierr = PetscFree(aijomp_dest->rstart);CHKERRQ(ierr);
+    ierr = PetscMalloc1(aijomp->nthreads+1,&aijomp_dest->rstart);CHKERRQ(ierr);
+    aijomp_dest->nthreads = aijomp->nthreads;
+  }
+  aijomp_dest->firsttouch = aijomp->firsttouch;
+  ierr = MatSeqAIJOMPSetUp_Private(*M);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJOMP_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATSEQAIJOMP to its base PETSc type, so 'type' is ignored. */
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJOMP  *aijomp;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  aijomp = (Mat_SeqAIJOMP*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = MatDestroy_SeqAIJ;
+  B->ops->mult             = MatMult_SeqAIJ;
+  B->ops->multadd          = MatMultAdd_SeqAIJ;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscFree(aijomp->rstart);CHKERRQ(ierr);
+  ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJOMP converts a SeqAIJ matrix into a SeqAIJOMP matrix. This routine is called by
+ * MatCreate_SeqAIJOMP(), but can also be used to convert an assembled SeqAIJ matrix. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJOMP(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJOMP  *aijomp;
+  PetscInt       nthreads = 1;
+  PetscBool      sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+#if defined(PETSC_HAVE_OPENMP)
+  nthreads = omp_get_max_threads();
+#endif
+  ierr     = PetscNewLog(B,&aijomp);CHKERRQ(ierr);
+  B->spptr = (void*)aijomp;
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"AIJOMP Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijomp_threads","Number of threads used in the matrix-vector products","None",nthreads,&nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_aijomp_first_touch","Place the matrix arrays with the threads that use them","None",aijomp->firsttouch,&aijomp->firsttouch,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",nthreads);
+  aijomp->nthreads     = nthreads;
+  aijomp->nonzerostate = -1;
+  ierr = PetscCalloc1(nthreads+1,&aijomp->rstart);CHKERRQ(ierr);
+
+  B->ops->duplicate   = MatDuplicate_SeqAIJOMP;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJOMP;
+  B->ops->destroy     = MatDestroy_SeqAIJOMP;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",MatConvert_SeqAIJOMP_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJOMP);CHKERRQ(ierr);
+
+  /* an assembled matrix gets its partition and products right away */
+  if (B->assembled) {
+    ierr = MatSeqAIJOMPSetUp_Private(B);CHKERRQ(ierr);
+  }
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJOMP - Creates a sparse matrix of type SEQAIJOMP.
+   This type inherits from AIJ and is largely identical, but shares MatMult(), MatMultAdd(),
+   MatMultTranspose() and MatMultTransposeAdd() among OpenMP threads. The rows are split in
+   contiguous blocks with about the same number of nonzeros, one per thread.
+   Because SEQAIJOMP is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijomp" can be used to make
+   sequential AIJ matrices default to being instances of MATSEQAIJOMP.
+
+   Collective on MPI_Comm
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
++  -mat_aijomp_threads <n> - number of threads, defaults to the OpenMP maximum (one if PETSc is configured without OpenMP)
+-  -mat_aijomp_first_touch - after each change of the nonzero structure, copy the matrix arrays so that each thread touches its rows first (NUMA placement)
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   MatMultTranspose() uses one work vector with as many entries as the matrix has columns per thread.
+
+   Level: intermediate
+
+.keywords: matrix, sparse, OpenMP, threads
+
+.seealso: MatCreate(), MatCreateMPIAIJOMP(), MatSetValues()
+@*/
+PetscErrorCode MatCreateSeqAIJOMP(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJOMP);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJOMP(A,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,658 @@
+/*
+  Defines basic operations for the MATSEQAIJSINGLE matrix class.
+  This class is derived from the MATSEQAIJ class and keeps the same compressed row
+  storage, but in addition stores a single precision copy of the matrix values. The
+  products, the SOR sweeps and the triangular solves of the LU and ILU factors read
+  the single precision values and accumulate in the precision of PetscScalar, which
+  halves the memory traffic for the values of matrices that are only used to precondition.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef float MatScalarSingle;
+
+typedef struct {
+  MatScalarSingle  *a;        /* single precision copy of the values (of the factors for a factored matrix) */
+  PetscInt         nz;        /* length of the copy */
+  PetscObjectState state;     /* object state for which the copy was made */
+  PetscBool        identity;  /* factored matrix: the row and column orderings are the identity */
+  PetscErrorCode   (*destroy)(Mat);
+  PetscErrorCode   (*lufactornumeric)(Mat,Mat,const MatFactorInfo*);
+} Mat_SeqAIJSingle;
+
+PETSC_INTERN PetscErrorCode MatMult_SeqAIJSingle(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJSingle(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJSingle(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJSingle(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSOR_SeqAIJSingle(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatSolve_SeqAIJSingle(Mat,Vec,Vec);
+
+/* sum -= v[k]*x[idx[k]] and sum += v[k]*x[idx[k]] for single precision v */
+#define MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n) do {PetscInt _k; for (_k=0; _k<(n); _k++) (sum) -= (PetscScalar)(v)[_k]*(x)[(idx)[_k]];} while (0)
+#define MatSeqAIJSinglePlusDot_Private(sum,x,v,idx,n)  do {PetscInt _k; for (_k=0; _k<(n); _k++) (sum) += (PetscScalar)(v)[_k]*(x)[(idx)[_k]];} while (0)
+
+/* Copies the first nz values of the matrix into the single precision array */
+static PetscErrorCode MatSeqAIJSingleCopyValues_Private(Mat A,PetscInt nz)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         k;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (nz != s->nz) {
+    ierr  = PetscFree(s->a);CHKERRQ(ierr);
+    ierr  = PetscMalloc1(nz,&s->a);CHKERRQ(ierr);
+    ierr  = PetscLogObjectMemory((PetscObject)A,(nz-s->nz)*sizeof(MatScalarSingle));CHKERRQ(ierr);
+    s->nz = nz;
+  }
+  for (k=0; k<nz; k++) s->a[k] = (MatScalarSingle)PetscRealPart(a->a[k]);
+  s->state = ((PetscObject)A)->state;
+  PetscFunctionReturn(0);
+}
+
+/* Refreshes the single precision values if the matrix changed since they were copied */
+PETSC_STATIC_INLINE PetscErrorCode MatSeqAIJSingleGetValues_Private(Mat A,const MatScalarSingle **v)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (s->state != ((PetscObject)A)->state || s->nz != a->i[A->rmap->n]) {
+    ierr = MatSeqAIJSingleCopyValues_Private(A,a->i[A->rmap->n]);CHKERRQ(ierr);
+  }
+  *v = s->a;
+  PetscFunctionReturn(0);
+}
+
+/* Installs the single precision kernels; the inode routines installed by the assembly are kept for everything else */
+static PetscErrorCode MatSeqAIJSingleSetUp_Private(Mat A)
+{
+  PetscFunctionBegin;
+  A->ops->mult             = MatMult_SeqAIJSingle;
+  A->ops->multadd          = MatMultAdd_SeqAIJSingle;
+  A->ops->multtranspose    = MatMultTranspose_SeqAIJSingle;
+  A->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJSingle;
+  A->ops->sor              = MatSOR_SeqAIJSingle;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJSingle(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJSingleSetUp_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJSingle(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  PetscInt              m  = A->rmap->n,mr = m,i,n;
+  const PetscInt        *ii = a->i,*ridx = NULL,*aj;
+  const MatScalarSingle *av,*aa;
+  const PetscScalar     *x;
+  PetscScalar           *y,sum;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleGetValues_Private(A,&av);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    ierr = PetscMemzero(y,m*sizeof(PetscScalar));CHKERRQ(ierr);
+    mr   = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<mr; i++) {
+    n   = ii[i+1] - ii[i];
+    aj  = a->j + ii[i];
+    aa  = av + ii[i];
+    sum = 0.0;
+    MatSeqAIJSinglePlusDot_Private(sum,x,aa,aj,n);
+    y[ridx ? ridx[i] : i] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJSingle(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  PetscInt              m  = A->rmap->n,mr = m,i,n,r;
+  const PetscInt        *ii = a->i,*ridx = NULL,*aj;
+  const MatScalarSingle *av,*aa;
+  const PetscScalar     *x;
+  PetscScalar           *y,*z,sum;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleGetValues_Private(A,&av);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    if (zz != yy) {ierr = PetscMemcpy(z,y,m*sizeof(PetscScalar));CHKERRQ(ierr);}
+    mr   = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<mr; i++) {
+    n    = ii[i+1] - ii[i];
+    aj   = a->j + ii[i];
+    aa   = av + ii[i];
+    r    = ridx ? ridx[i] : i;
+    sum  = y[r];
+    MatSeqAIJSinglePlusDot_Private(sum,x,aa,aj,n);
+    z[r] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTransposeAdd_SeqAIJSingle(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  PetscInt              m  = A->rmap->n,mr = m,i,j,n;
+  const PetscInt        *ii = a->i,*ridx = NULL,*aj;
+  const MatScalarSingle *av,*aa;
+  const PetscScalar     *x;
+  PetscScalar           *z,alpha;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleGetValues_Private(A,&av);CHKERRQ(ierr);
+  if (yy) {
+    if (zz != yy) {ierr = VecCopy(yy,zz);CHKERRQ(ierr);}
+  } else {
+    ierr = VecSet(zz,0.0);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    mr   = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<mr; i++) {
+    n     = ii[i+1] - ii[i];
+    aj    = a->j + ii[i];
+    aa    = av + ii[i];
+    alpha = x[ridx ? ridx[i] : i];
+    for (j=0; j<n; j++) z[aj[j]] += alpha*(PetscScalar)aa[j];
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJSingle(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultTransposeAdd_SeqAIJSingle(A,xx,NULL,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The sweeps of MatSOR_SeqAIJ() with single precision off-diagonal values; the (inverted) diagonal
+   is kept in full precision. SOR_APPLY_UPPER and Eisenstat's trick use the full precision routine.
+*/
+PetscErrorCode MatSOR_SeqAIJSingle(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar           *x,sum,*t;
+  const MatScalarSingle *av,*v;
+  const PetscScalar     *b,*xb,*idiag;
+  PetscErrorCode        ierr;
+  PetscInt              n,m = A->rmap->n,i;
+  const PetscInt        *idx,*diag,*ai = a->i;
+
+  PetscFunctionBegin;
+  if (flag == SOR_APPLY_UPPER || flag == SOR_APPLY_LOWER || (flag & SOR_EISENSTAT)) {
+    ierr = MatSOR_SeqAIJ(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  its = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+
+  ierr  = MatSeqAIJSingleGetValues_Private(A,&av);CHKERRQ(ierr);
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        n   = diag[i] - ai[i];
+        idx = a->j + ai[i];
+        v   = av + ai[i];
+        sum = b[i];
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        t[i] = sum;
+        x[i] = sum*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        n   = ai[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = av + diag[i] + 1;
+        sum = xb[i];
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        if (xb == b) {
+          x[i] = sum*idiag[i];
+        } else {
+          x[i] = (1-omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        /* lower */
+        n   = diag[i] - ai[i];
+        idx = a->j + ai[i];
+        v   = av + ai[i];
+        sum = b[i];
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        t[i] = sum;             /* save application of the lower-triangular part */
+        /* upper */
+        n   = ai[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = av + diag[i] + 1;
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        x[i] = (1. - omega)*x[i] + sum*idiag[i]; /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        if (xb == b) {
+          /* whole matrix (no checkpointing available), the diagonal is skipped rather than added back */
+          n   = diag[i] - ai[i];
+          idx = a->j + ai[i];
+          v   = av + ai[i];
+          MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+          n   = ai[i+1] - diag[i] - 1;
+          idx = a->j + diag[i] + 1;
+          v   = av + diag[i] + 1;
+          MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+          x[i] = (1. - omega)*x[i] + sum*idiag[i];
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          n   = ai[i+1] - diag[i] - 1;
+          idx = a->j + diag[i] + 1;
+          v   = av + diag[i] + 1;
+          MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+          x[i] = (1. - omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Triangular solves with the single precision copy of the factors computed by MatLUFactorNumeric_SeqAIJ()
+   (or its inode variant); the layout is the one used by MatSolve_SeqAIJ().
+*/
+PetscErrorCode MatSolve_SeqAIJSingle(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *s = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode        ierr;
+  PetscInt              i,n = A->rmap->n,nz;
+  const PetscInt        *ai = a->i,*aj = a->j,*adiag = a->diag,*vi,*r = NULL,*c = NULL;
+  PetscScalar           *x,*tmp,sum;
+  const PetscScalar     *b;
+  const MatScalarSingle *aa = s->a,*v;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  if (s->identity) tmp = x;
+  else {
+    tmp  = a->solve_work;
+    ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+    ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  }
+
+  /* forward solve the lower triangular */
+  tmp[0] = r ? b[r[0]] : b[0];
+  v      = aa;
+  vi     = aj;
+  for (i=1; i<n; i++) {
+    nz  = ai[i+1] - ai[i];
+    sum = r ? b[r[i]] : b[i];
+    MatSeqAIJSingleMinusDot_Private(sum,tmp,v,vi,nz);
+    tmp[i] = sum;
+    v     += nz; vi += nz;
+  }
+
+  /* backward solve the upper triangular */
+  for (i=n-1; i>=0; i--) {
+    v   = aa + adiag[i+1]+1;
+    vi  = aj + adiag[i+1]+1;
+    nz  = adiag[i]-adiag[i+1]-1;
+    sum = tmp[i];
+    MatSeqAIJSingleMinusDot_Private(sum,tmp,v,vi,nz);
+    tmp[i] = sum*(PetscScalar)v[nz]; /* v[nz] = aa[adiag[i]] */
+    if (c) x[c[i]] = tmp[i];
+  }
+
+  if (!s->identity) {
+    ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Factors in full precision and keeps a single precision copy of the factors for the solves */
+static PetscErrorCode MatLUFactorNumeric_SeqAIJSingle(Mat B,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ       *b = (Mat_SeqAIJ*)B->data;
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)B->spptr;
+  PetscBool        row_identity,col_identity;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = (*s->lufactornumeric)(B,A,info);CHKERRQ(ierr);
+  /* the in-place factorizations use a different layout and keep their full precision solves */
+  if (B->ops->solve != MatSolve_SeqAIJ && B->ops->solve != MatSolve_SeqAIJ_NaturalOrdering && B->ops->solve != MatSolve_SeqAIJ_Inode) PetscFunctionReturn(0);
+  ierr = MatSeqAIJSingleCopyValues_Private(B,B->rmap->n ? b->diag[0]+1 : 0);CHKERRQ(ierr);
+  ierr = ISIdentity(b->row,&row_identity);CHKERRQ(ierr);
+  ierr = ISIdentity(b->col,&col_identity);CHKERRQ(ierr);
+  s->identity    = (PetscBool)(row_identity && col_identity);
+  B->ops->solve  = MatSolve_SeqAIJSingle;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLUFactorSymbolic_SeqAIJSingle(Mat B,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)B->spptr;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = MatLUFactorSymbolic_SeqAIJ(B,A,isrow,iscol,info);CHKERRQ(ierr);
+  s->lufactornumeric      = B->ops->lufactornumeric;
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJSingle(Mat B,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)B->spptr;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = MatILUFactorSymbolic_SeqAIJ(B,A,isrow,iscol,info);CHKERRQ(ierr);
+  s->lufactornumeric      = B->ops->lufactornumeric;
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  PetscFunctionReturn(0);
+}
+
+/* LU and ILU factors of a MATSEQAIJSINGLE matrix are solved with single precision factors, the other factorizations are those of MATSEQAIJ */
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaijsingle_petsc(Mat A,MatFactorType ftype,Mat *B)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetFactor_seqaij_petsc(A,ftype,B);CHKERRQ(ierr);
+  if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU) {
+    PetscObject levels;
+
+    /* the single precision MatSolve() would replace the level scheduled one */
+    ierr = PetscObjectQuery((PetscObject)*B,"MatSolveLevels",&levels);CHKERRQ(ierr);
+    if (levels) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"-mat_solve_levels is not supported for the LU and ILU factors of MATSEQAIJSINGLE");
+    ierr = MatConvert_SeqAIJ_SeqAIJSingle(*B,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,B);CHKERRQ(ierr);
+    (*B)->ops->lufactorsymbolic  = MatLUFactorSymbolic_SeqAIJSingle;
+    (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJSingle;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* The Galerkin product of a MATSEQAIJSINGLE matrix is again stored with single precision values */
+PETSC_INTERN PetscErrorCode MatPtAP_SeqAIJSingle_SeqAIJ(Mat A,Mat P,MatReuse scall,PetscReal fill,Mat *C)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatPtAP_SeqAIJ_SeqAIJ(A,P,scall,fill,C);CHKERRQ(ierr);
+  if (scall == MAT_INITIAL_MATRIX) {
+    ierr = MatConvert_SeqAIJ_SeqAIJSingle(*C,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,C);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode   (*destroy)(Mat) = MatDestroy_SeqAIJ;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJSingle matrix will not have an spptr pointer. */
+  if (s) {
+    destroy = s->destroy;
+    ierr    = PetscFree(s->a);CHKERRQ(ierr);
+    ierr    = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaijsingle_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatPtAP_seqaij_seqaijsingle_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJRestoreArray_C",MatSeqAIJRestoreArray_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatRetrieveValues_C",MatRetrieveValues_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = (*destroy)(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* The values can change through the array without a change of the object state, so the copy is made again */
+static PetscErrorCode MatSeqAIJRestoreArray_SeqAIJSingle(Mat A,PetscScalar *array[])
+{
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr     = MatSeqAIJRestoreArray_SeqAIJ(A,array);CHKERRQ(ierr);
+  s->state = -1;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatRetrieveValues_SeqAIJSingle(Mat A)
+{
+  Mat_SeqAIJSingle *s = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr     = MatRetrieveValues_SeqAIJ(A);CHKERRQ(ierr);
+  s->state = -1;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJSingle(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  ierr = MatSeqAIJSingleSetUp_Private(*M);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJSingle_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATSEQAIJSINGLE to its base PETSc type, so 'type' is ignored. */
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJSingle *s;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  s = (Mat_SeqAIJSingle*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = s->destroy;
+  B->ops->mult             = MatMult_SeqAIJ;
+  B->ops->multadd          = MatMultAdd_SeqAIJ;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ;
+  B->ops->sor              = MatSOR_SeqAIJ;
+  B->ops->ptap             = MatPtAP_SeqAIJ_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_seqaij_seqaijsingle_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJRestoreArray_C",MatSeqAIJRestoreArray_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscFree(s->a);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJSingle converts a SeqAIJ matrix into a SeqAIJSingle matrix. This routine is called by
+ * MatCreate_SeqAIJSingle(), but can also be used to convert an assembled SeqAIJ matrix. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJSingle *s;
+  PetscBool        sametype;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_COMPLEX)
+  SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"MATSEQAIJSINGLE is only available for real scalars");
+#endif
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&s);CHKERRQ(ierr);
+  B->spptr = (void*)s;
+  s->state = -1;
+  /* the destroy routine of a Galerkin product also frees the product data, so it is kept */
+  s->destroy = B->ops->destroy;
+
+  B->ops->duplicate   = MatDuplicate_SeqAIJSingle;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJSingle;
+  B->ops->destroy     = MatDestroy_SeqAIJSingle;
+  B->ops->ptap        = MatPtAP_SeqAIJSingle_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",MatConvert_SeqAIJSingle_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_seqaij_seqaijsingle_C",MatPtAP_SeqAIJ_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJRestoreArray_C",MatSeqAIJRestoreArray_SeqAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_SeqAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJSINGLE);CHKERRQ(ierr);
+
+  /* an assembled matrix gets its products right away, the values are copied at their first use */
+  if (B->assembled) {
+    ierr = MatSeqAIJSingleSetUp_Private(B);CHKERRQ(ierr);
+  }
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJSingle - Creates a sparse matrix of type SEQAIJSINGLE.
+   This type inherits from AIJ and is largely identical, but keeps in addition a single precision copy
+   of the matrix values that is used by MatMult(), MatMultAdd(), MatMultTranspose(), MatMultTransposeAdd()
+   and MatSOR(); the sums are accumulated in the precision of PetscScalar. The LU and ILU factors of
+   the matrix are computed in full precision and stored in single precision for MatSolve().
+   Because SEQAIJSINGLE is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijsingle" can be used to make
+   sequential AIJ matrices default to being instances of MATSEQAIJSINGLE.
+
+   Collective on MPI_Comm
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   The type is meant for matrices that only define preconditioners (the smoothers of PCMG and PCGAMG,
+   or PCILU and PCSOR); the Galerkin products MatPtAP() of a SEQAIJSINGLE matrix are again of this type.
+   The products lose accuracy at the level of single precision, so the Krylov method should use the
+   full precision operator.
+
+   The level scheduled triangular solves of -mat_solve_levels are not available for the single precision
+   LU and ILU factors, MatGetFactor() generates an error when the option is given.
+
+   MatSOR() uses point relaxation, also when the matrix has inodes. The single precision values are
+   copied from the full precision ones whenever the matrix changed, so they cost one extra pass after each assembly.
+
+   Level: intermediate
+
+.keywords: matrix, sparse, single precision, preconditioner
+
+.seealso: MatCreate(), MatCreateMPIAIJSingle(), MatSetValues()
+@*/
+PetscErrorCode MatCreateSeqAIJSingle(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJSingle(A,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -9,6 +9,9 @@
  #include <petscbt.h>
  #include <petsc/private/isimpl.h>
  #include <../src/mat/impls/dense/seq/dense.h>
+ #if defined(PETSC_HAVE_OPENMP)
+ #include <omp.h>
+ #endif
 
 
  PETSC_INTERN PetscErrorCode MatMatMult_SeqAIJ_SeqAIJ(Mat A,Mat B,MatReuse scall,PetscReal fill,Mat *C)
@@ -45,11 +48,11 @@
  {
    PetscErrorCode ierr;
  #if !defined(PETSC_HAVE_HYPRE)
-   const char     *algTypes[8] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge"};
-   PetscInt       nalg = 8;
- #else
-   const char     *algTypes[9] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","hypre"};
+   const char     *algTypes[9] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","hash"};
    PetscInt       nalg = 9;
+ #else
+   const char     *algTypes[10] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","hash","hypre"};
+   PetscInt       nalg = 10;
  #endif
    PetscInt       alg = 0; /* set default algorithm */
 
@@ -79,8 +82,11 @@
    case 7:
      ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(A,B,fill,C);CHKERRQ(ierr);
      break;
- #if defined(PETSC_HAVE_HYPRE)
    case 8:
+     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Hash(A,B,fill,C);CHKERRQ(ierr);
+     break;
+ #if defined(PETSC_HAVE_HYPRE)
+   case 9:
      ierr = MatMatMultSymbolic_AIJ_AIJ_wHYPRE(A,B,fill,C);CHKERRQ(ierr);
      break;
  #endif
@@ -1016,6 +1022,198 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(Mat A,Mat B,PetscReal f
   PetscFunctionReturn(0);
 }
 
+/*
+   Hash accumulator product: the columns of each row of C are collected in an open addressing (linear probing) hash table
+   sized from an upper bound of the row length. Rows are independent and are shared among OpenMP threads when available.
+*/
+#if defined(PETSC_HAVE_OPENMP)
+#define MatMatMultHashNThreads_Private() omp_get_max_threads()
+#define MatMatMultHashThread_Private()   omp_get_thread_num()
+#else
+#define MatMatMultHashNThreads_Private() 1
+#define MatMatMultHashThread_Private()   0
+#endif
+
+/* Fibonacci hashing: the top log2(table size) bits of the 32 bit product col*2654435761, with shift = 32 - log2(table size) */
+#define MatMatMultHashSlot_Private(col,shift) ((PetscInt)(((unsigned int)(col)*2654435761U) >> (shift)))
+
+/* Smallest power of two table with at least 2*nz (and 2) slots, and the shift used by MatMatMultHashSlot_Private() */
+PETSC_STATIC_INLINE void MatMatMultHashTableSize_Private(PetscInt nz,PetscInt *size,PetscInt *shift)
+{
+  PetscInt l = 1;
+
+  while (((PetscInt)1 << l) < 2*nz) l++;
+  *size  = (PetscInt)1 << l;
+  *shift = 32 - l;
+}
+
+PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Hash(Mat A,Mat B,PetscReal fill,Mat *C)
+{
+  PetscErrorCode ierr,serr = 0;
+  Mat_SeqAIJ     *a  = (Mat_SeqAIJ*)A->data,*b=(Mat_SeqAIJ*)B->data,*c;
+  const PetscInt *ai = a->i,*bi=b->i,*aj=a->j,*bj=b->j;
+  PetscInt       *ci,*cj,*ub,*htable;
+  PetscInt       am = A->rmap->N,bn=B->cmap->N,bm=B->rmap->N;
+  PetscInt       i,nthreads,tmax = 2,size,shift;
+  PetscReal      afill;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(am+1,&ci);CHKERRQ(ierr);
+  ierr = PetscMalloc1(am,&ub);CHKERRQ(ierr);
+
+  /* Pass 1: an upper bound of the length of each row of C, which sizes its hash table */
+  PetscPragmaOMP(omp parallel for schedule(static))
+  for (i=0; i<am; i++) {
+    PetscInt k,nz = 0;
+
+    for (k=ai[i]; k<ai[i+1]; k++) {
+      nz += bi[aj[k]+1] - bi[aj[k]];
+      if (nz >= bn) {nz = bn; break;}
+    }
+    ub[i] = nz;
+  }
+  for (i=0; i<am; i++) {
+    MatMatMultHashTableSize_Private(ub[i],&size,&shift);
+    tmax = PetscMax(tmax,size);
+  }
+  nthreads = MatMatMultHashNThreads_Private();
+  ierr     = PetscMalloc1(nthreads*tmax,&htable);CHKERRQ(ierr);
+
+  /* Pass 2: the exact length of each row of C */
+  PetscPragmaOMP(omp parallel for schedule(dynamic,64))
+  for (i=0; i<am; i++) {
+    PetscInt *table = htable + MatMatMultHashThread_Private()*tmax,k,l,col,h,hsize,hshift,cnz = 0;
+
+    MatMatMultHashTableSize_Private(ub[i],&hsize,&hshift);
+    for (h=0; h<hsize; h++) table[h] = -1;
+    for (k=ai[i]; k<ai[i+1]; k++) {
+      for (l=bi[aj[k]]; l<bi[aj[k]+1]; l++) {
+        col = bj[l];
+        h   = MatMatMultHashSlot_Private(col,hshift);
+        while (table[h] != -1 && table[h] != col) h = (h+1) & (hsize-1);
+        if (table[h] == -1) {table[h] = col; cnz++;}
+      }
+    }
+    ci[i+1] = cnz;
+  }
+  ci[0] = 0;
+  for (i=0; i<am; i++) ci[i+1] += ci[i];
+  ierr = PetscMalloc1(ci[am]+1,&cj);CHKERRQ(ierr);
+
+  /* Pass 3: collect and sort the columns of each row of C */
+  PetscPragmaOMP(omp parallel for schedule(dynamic,64) reduction(|:serr))
+  for (i=0; i<am; i++) {
+    PetscInt *table = htable + MatMatMultHashThread_Private()*tmax,*cjj = cj + ci[i],k,l,col,h,hsize,hshift,cnz = 0;
+
+    MatMatMultHashTableSize_Private(ub[i],&hsize,&hshift);
+    for (h=0; h<hsize; h++) table[h] = -1;
+    for (k=ai[i]; k<ai[i+1]; k++) {
+      for (l=bi[aj[k]]; l<bi[aj[k]+1]; l++) {
+        col = bj[l];
+        h   = MatMatMultHashSlot_Private(col,hshift);
+        while (table[h] != -1 && table[h] != col) h = (h+1) & (hsize-1);
+        if (table[h] == -1) {table[h] = col; cjj[cnz++] = col;}
+      }
+    }
+    serr |= PetscSortInt(cnz,cjj);
+  }
+  CHKERRQ(serr);
+  ierr = PetscFree(htable);CHKERRQ(ierr);
+  ierr = PetscFree(ub);CHKERRQ(ierr);
+
+  /* put together the new symbolic matrix */
+  ierr = MatCreateSeqAIJWithArrays(PetscObjectComm((PetscObject)A),am,bn,ci,cj,NULL,C);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(*C,A,B);CHKERRQ(ierr);
+  ierr = MatSetType(*C,((PetscObject)A)->type_name);CHKERRQ(ierr);
+
+  /* MatCreateSeqAIJWithArrays flags matrix so PETSc doesn't free the user's arrays. */
+  /* These are PETSc arrays, so change flags so arrays can be deleted by PETSc */
+  c          = (Mat_SeqAIJ*)((*C)->data);
+  c->free_a  = PETSC_TRUE;
+  c->free_ij = PETSC_TRUE;
+  c->nonew   = 0;
+
+  (*C)->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqAIJ_Hash;
+
+  /* set MatInfo */
+  afill = (PetscReal)ci[am]/(ai[am]+bi[bm]) + 1.e-5;
+  if (afill < 1.0) afill = 1.0;
+  c->maxnz                     = ci[am];
+  c->nz                        = ci[am];
+  (*C)->info.mallocs           = 0;
+  (*C)->info.fill_ratio_given  = fill;
+  (*C)->info.fill_ratio_needed = afill;
+
+#if defined(PETSC_USE_INFO)
+  if (ci[am]) {
+    ierr = PetscInfo3((*C),"Hash tables of up to %D entries for each of %D threads; fill ratio needed %g\n",tmax,nthreads,(double)afill);CHKERRQ(ierr);
+  } else {
+    ierr = PetscInfo((*C),"Empty matrix product\n");CHKERRQ(ierr);
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+   The numeric product finds the position of each column in the (fixed) row of C through a hash table built from that row,
+   so it needs no dense work array of length B->cmap->n
+*/
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Hash(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode ierr;
+  PetscLogDouble flops = 0.0;
+  Mat_SeqAIJ     *a  = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  const PetscInt *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*ci = c->i,*cj = c->j;
+  PetscInt       am  = A->rmap->n,i,nthreads,tmax = 2,size,shift,*htable;
+  MatScalar      *aa = a->a,*ba = b->a,*ca = c->a;
+
+  PetscFunctionBegin;
+  if (!ca) { /* first call of MatMatMultNumeric_SeqAIJ_SeqAIJ_Hash() */
+    ierr      = PetscMalloc1(ci[am]+1,&ca);CHKERRQ(ierr);
+    c->a      = ca;
+    c->free_a = PETSC_TRUE;
+  }
+  for (i=0; i<am; i++) {
+    MatMatMultHashTableSize_Private(ci[i+1]-ci[i],&size,&shift);
+    tmax = PetscMax(tmax,size);
+  }
+  nthreads = MatMatMultHashNThreads_Private();
+  ierr     = PetscMalloc1(2*nthreads*tmax,&htable);CHKERRQ(ierr);
+
+  PetscPragmaOMP(omp parallel for schedule(dynamic,64) reduction(+:flops))
+  for (i=0; i<am; i++) {
+    PetscInt  *table = htable + 2*MatMatMultHashThread_Private()*tmax,*pos = table + tmax,k,l,col,h,hsize,hshift;
+    MatScalar *caa = ca + ci[i],aval;
+
+    /* table maps the columns of row i of C to their positions pos in the row */
+    MatMatMultHashTableSize_Private(ci[i+1]-ci[i],&hsize,&hshift);
+    for (h=0; h<hsize; h++) table[h] = -1;
+    for (k=ci[i]; k<ci[i+1]; k++) {
+      h = MatMatMultHashSlot_Private(cj[k],hshift);
+      while (table[h] != -1) h = (h+1) & (hsize-1);
+      table[h] = cj[k];
+      pos[h]   = k - ci[i];
+      caa[pos[h]] = 0.0;
+    }
+    for (k=ai[i]; k<ai[i+1]; k++) {
+      aval = aa[k];
+      for (l=bi[aj[k]]; l<bi[aj[k]+1]; l++) {
+        col = bj[l];
+        h   = MatMatMultHashSlot_Private(col,hshift);
+        while (table[h] != col && table[h] != -1) h = (h+1) & (hsize-1);
+        if (table[h] == col) caa[pos[h]] += aval*ba[l]; /* entries outside the nonzero pattern of C are dropped */
+      }
+      flops += 2*(bi[aj[k]+1]-bi[aj[k]]);
+    }
+  }
+  ierr = PetscFree(htable);CHKERRQ(ierr);
+
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* concatenate unique entries and then sort */
 PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Sorted(Mat A,Mat B,PetscReal fill,Mat *C)
 {
@@ -139,7 +139,7 @@ PetscErrorCode MatSOR_SeqBAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
   PetscScalar       *x,*work,*w,*workt,*t;
   const MatScalar   *v,*aa = a->a, *idiag;
   const PetscScalar *b,*xb;
-  PetscScalar       s[7], xw[7]={0}; /* avoid some compilers thinking xw is uninitialized */
+  PetscScalar       s[8], xw[8]={0}; /* avoid some compilers thinking xw is uninitialized */
   PetscErrorCode    ierr;
   PetscInt          m = a->mbs,i,i2,nz,bs = A->rmap->bs,bs2 = bs*bs,k,j,idx,it;
   const PetscInt    *diag,*ai = a->i,*aj = a->j,*vi;
@@ -343,6 +343,34 @@ PetscErrorCode MatSOR_SeqBAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
           i2     += 7;
         }
         break;
+      case 8:
+        PetscKernel_v_gets_A_times_w_8(x,idiag,b);
+        t[0] = b[0]; t[1] = b[1]; t[2] = b[2];
+        t[3] = b[3]; t[4] = b[4]; t[5] = b[5]; t[6] = b[6]; t[7] = b[7];
+        i2     = 8;
+        idiag += 64;
+        for (i=1; i<m; i++) {
+          v  = aa + 64*ai[i];
+          vi = aj + ai[i];
+          nz = diag[i] - ai[i];
+          s[0] = b[i2];   s[1] = b[i2+1]; s[2] = b[i2+2];
+          s[3] = b[i2+3]; s[4] = b[i2+4]; s[5] = b[i2+5]; s[6] = b[i2+6]; s[7] = b[i2+7];
+          while (nz--) {
+            idx = 8*(*vi++);
+            xw[0] = x[idx];   xw[1] = x[1+idx]; xw[2] = x[2+idx];
+            xw[3] = x[3+idx]; xw[4] = x[4+idx]; xw[5] = x[5+idx]; xw[6] = x[6+idx]; xw[7] = x[7+idx];
+            PetscKernel_v_gets_v_minus_A_times_w_8(s,v,xw);
+            v  += 64;
+          }
+          t[i2]   = s[0]; t[i2+1] = s[1]; t[i2+2] = s[2];
+          t[i2+3] = s[3]; t[i2+4] = s[4]; t[i2+5] = s[5]; t[i2+6] = s[6]; t[i2+7] = s[7];
+          PetscKernel_v_gets_A_times_w_8(xw,idiag,s);
+          x[i2] =   xw[0]; x[i2+1] = xw[1]; x[i2+2] = xw[2];
+          x[i2+3] = xw[3]; x[i2+4] = xw[4]; x[i2+5] = xw[5]; x[i2+6] = xw[6]; x[i2+7] = xw[7];
+          idiag  += 64;
+          i2     += 8;
+        }
+        break;
       default:
         PetscKernel_w_gets_Ar_times_v(bs,bs,b,idiag,x);
         ierr = PetscMemcpy(t,b,bs*sizeof(PetscScalar));CHKERRQ(ierr);
@@ -517,7 +545,7 @@ PetscErrorCode MatSOR_SeqBAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
       case 7:
         s[0] = xb[i2];   s[1] = xb[i2+1]; s[2] = xb[i2+2];
         s[3] = xb[i2+3]; s[4] = xb[i2+4]; s[5] = xb[i2+5]; s[6] = xb[i2+6];
-        PetscKernel_v_gets_A_times_w_7(x,idiag,b);
+        PetscKernel_v_gets_A_times_w_7(xw,idiag,s);
         x[i2]   = xw[0]; x[i2+1] = xw[1]; x[i2+2] = xw[2];
         x[i2+3] = xw[3]; x[i2+4] = xw[4]; x[i2+5] = xw[5]; x[i2+6] = xw[6];
         i2    -= 7;
@@ -542,6 +570,34 @@ PetscErrorCode MatSOR_SeqBAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
           i2     -= 7;
         }
         break;
+      case 8:
+        s[0] = xb[i2];   s[1] = xb[i2+1]; s[2] = xb[i2+2];
+        s[3] = xb[i2+3]; s[4] = xb[i2+4]; s[5] = xb[i2+5]; s[6] = xb[i2+6]; s[7] = xb[i2+7];
+        PetscKernel_v_gets_A_times_w_8(xw,idiag,s);
+        x[i2]   = xw[0]; x[i2+1] = xw[1]; x[i2+2] = xw[2];
+        x[i2+3] = xw[3]; x[i2+4] = xw[4]; x[i2+5] = xw[5]; x[i2+6] = xw[6]; x[i2+7] = xw[7];
+        i2    -= 8;
+        idiag -= 64;
+        for (i=m-2; i>=0; i--) {
+          v  = aa + 64*(diag[i]+1);
+          vi = aj + diag[i] + 1;
+          nz = ai[i+1] - diag[i] - 1;
+          s[0] = xb[i2];   s[1] = xb[i2+1]; s[2] = xb[i2+2];
+          s[3] = xb[i2+3]; s[4] = xb[i2+4]; s[5] = xb[i2+5]; s[6] = xb[i2+6]; s[7] = xb[i2+7];
+          while (nz--) {
+            idx = 8*(*vi++);
+            xw[0] = x[idx];   xw[1] = x[1+idx]; xw[2] = x[2+idx];
+            xw[3] = x[3+idx]; xw[4] = x[4+idx]; xw[5] = x[5+idx]; xw[6] = x[6+idx]; xw[7] = x[7+idx];
+            PetscKernel_v_gets_v_minus_A_times_w_8(s,v,xw);
+            v  += 64;
+          }
+          PetscKernel_v_gets_A_times_w_8(xw,idiag,s);
+          x[i2] =   xw[0]; x[i2+1] = xw[1]; x[i2+2] = xw[2];
+          x[i2+3] = xw[3]; x[i2+4] = xw[4]; x[i2+5] = xw[5]; x[i2+6] = xw[6]; x[i2+7] = xw[7];
+          idiag  -= 64;
+          i2     -= 8;
+        }
+        break;
       default:
         ierr  = PetscMemcpy(w,xb+i2,bs*sizeof(PetscScalar));CHKERRQ(ierr);
         PetscKernel_w_gets_Ar_times_v(bs,bs,w,idiag,x+i2);
@@ -705,6 +761,27 @@ PetscErrorCode MatSOR_SeqBAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
           i2     += 7;
         }
         break;
+      case 8:
+        for (i=0; i<m; i++) {
+          v  = aa + 64*ai[i];
+          vi = aj + ai[i];
+          nz = ai[i+1] - ai[i];
+          s[0] = b[i2];   s[1] = b[i2+1]; s[2] = b[i2+2];
+          s[3] = b[i2+3]; s[4] = b[i2+4]; s[5] = b[i2+5]; s[6] = b[i2+6]; s[7] = b[i2+7];
+          while (nz--) {
+            idx = 8*(*vi++);
+            xw[0] = x[idx];   xw[1] = x[1+idx]; xw[2] = x[2+idx];
+            xw[3] = x[3+idx]; xw[4] = x[4+idx]; xw[5] = x[5+idx]; xw[6] = x[6+idx]; xw[7] = x[7+idx];
+            PetscKernel_v_gets_v_minus_A_times_w_8(s,v,xw);
+            v  += 64;
+          }
+          PetscKernel_v_gets_A_times_w_8(xw,idiag,s);
+          x[i2]   += xw[0]; x[i2+1] += xw[1]; x[i2+2] += xw[2];
+          x[i2+3] += xw[3]; x[i2+4] += xw[4]; x[i2+5] += xw[5]; x[i2+6] += xw[6]; x[i2+7] += xw[7];
+          idiag  += 64;
+          i2     += 8;
+        }
+        break;
       default:
         for (i=0; i<m; i++) {
           v  = aa + bs2*ai[i];
@@ -861,6 +938,27 @@ PetscErrorCode MatSOR_SeqBAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
           i2     -= 7;
         }
         break;
+      case 8:
+        for (i=m-1; i>=0; i--) {
+          v  = aa + 64*ai[i];
+          vi = aj + ai[i];
+          nz = ai[i+1] - ai[i];
+          s[0] = b[i2];   s[1] = b[i2+1]; s[2] = b[i2+2];
+          s[3] = b[i2+3]; s[4] = b[i2+4]; s[5] = b[i2+5]; s[6] = b[i2+6]; s[7] = b[i2+7];
+          while (nz--) {
+            idx = 8*(*vi++);
+            xw[0] = x[idx];   xw[1] = x[1+idx]; xw[2] = x[2+idx];
+            xw[3] = x[3+idx]; xw[4] = x[4+idx]; xw[5] = x[5+idx]; xw[6] = x[6+idx]; xw[7] = x[7+idx];
+            PetscKernel_v_gets_v_minus_A_times_w_8(s,v,xw);
+            v  += 64;
+          }
+          PetscKernel_v_gets_A_times_w_8(xw,idiag,s);
+          x[i2] +=   xw[0]; x[i2+1] += xw[1]; x[i2+2] += xw[2];
+          x[i2+3] += xw[3]; x[i2+4] += xw[4]; x[i2+5] += xw[5]; x[i2+6] += xw[6]; x[i2+7] += xw[7];
+          idiag  -= 64;
+          i2     -= 8;
+        }
+        break;
       default:
         for (i=m-1; i>=0; i--) {
           v  = aa + bs2*ai[i];
@@ -2825,35 +2923,90 @@ PetscErrorCode  MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B,PetscInt bs,PetscInt nz
   ierr = PetscOptionsBool("-mat_no_unroll","Do not optimize for block size (slow)",NULL,flg,&flg,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
 
+  B->ops->multtranspose    = MatMultTranspose_SeqBAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ;
   if (!flg) {
+    /* the block size specialized (SIMD) kernels replace the hand unrolled ones when AVX-512 kernels are used */
     switch (bs) {
     case 1:
       B->ops->mult    = MatMult_SeqBAIJ_1;
       B->ops->multadd = MatMultAdd_SeqBAIJ_1;
       break;
     case 2:
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+      B->ops->mult             = MatMult_SeqBAIJ_2_SIMD;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_2_SIMD;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_2_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_2_SIMD;
+#else
       B->ops->mult    = MatMult_SeqBAIJ_2;
       B->ops->multadd = MatMultAdd_SeqBAIJ_2;
+#endif
       break;
     case 3:
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+      B->ops->mult             = MatMult_SeqBAIJ_3_SIMD;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_3_SIMD;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_3_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_3_SIMD;
+#else
       B->ops->mult    = MatMult_SeqBAIJ_3;
       B->ops->multadd = MatMultAdd_SeqBAIJ_3;
+#endif
       break;
     case 4:
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+      B->ops->mult             = MatMult_SeqBAIJ_4_SIMD;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_4_SIMD;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_4_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_4_SIMD;
+#else
       B->ops->mult    = MatMult_SeqBAIJ_4;
       B->ops->multadd = MatMultAdd_SeqBAIJ_4;
+#endif
       break;
     case 5:
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+      B->ops->mult             = MatMult_SeqBAIJ_5_SIMD;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_5_SIMD;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_5_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_5_SIMD;
+#else
       B->ops->mult    = MatMult_SeqBAIJ_5;
       B->ops->multadd = MatMultAdd_SeqBAIJ_5;
+#endif
       break;
     case 6:
-      B->ops->mult    = MatMult_SeqBAIJ_6;
-      B->ops->multadd = MatMultAdd_SeqBAIJ_6;
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+      B->ops->mult             = MatMult_SeqBAIJ_6_SIMD;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_6_SIMD;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_6_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_6_SIMD;
+#else
+      B->ops->mult             = MatMult_SeqBAIJ_6;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_6;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_6_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_6_SIMD;
+#endif
       break;
     case 7:
-      B->ops->mult    = MatMult_SeqBAIJ_7;
-      B->ops->multadd = MatMultAdd_SeqBAIJ_7;
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+      B->ops->mult             = MatMult_SeqBAIJ_7_SIMD;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_7_SIMD;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_7_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_7_SIMD;
+#else
+      B->ops->mult             = MatMult_SeqBAIJ_7;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_7;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_7_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_7_SIMD;
+#endif
+      break;
+    case 8:
+      B->ops->mult             = MatMult_SeqBAIJ_8_SIMD;
+      B->ops->multadd          = MatMultAdd_SeqBAIJ_8_SIMD;
+      B->ops->multtranspose    = MatMultTranspose_SeqBAIJ_8_SIMD;
+      B->ops->multtransposeadd = MatMultTransposeAdd_SeqBAIJ_8_SIMD;
       break;
     case 9:
 #if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
@@ -234,6 +234,38 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_7(Mat,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_9_AVX2(Mat,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_11(Mat,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_N(Mat,Vec,Vec,Vec);
+
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_2_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_3_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_4_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_5_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_6_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_7_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_8_SIMD(Mat,Vec,Vec);
+
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_2_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_3_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_4_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_5_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_6_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_7_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_8_SIMD(Mat,Vec,Vec,Vec);
+
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqBAIJ_2_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqBAIJ_3_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqBAIJ_4_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqBAIJ_5_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqBAIJ_6_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqBAIJ_7_SIMD(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqBAIJ_8_SIMD(Mat,Vec,Vec);
+
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqBAIJ_2_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqBAIJ_3_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqBAIJ_4_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqBAIJ_5_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqBAIJ_6_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqBAIJ_7_SIMD(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqBAIJ_8_SIMD(Mat,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatLoad_SeqBAIJ(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetNumericFactorization_inplace(Mat,PetscBool);
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetNumericFactorization(Mat,PetscBool);
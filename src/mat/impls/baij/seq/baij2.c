@@ -1,6 +1,7 @@
 
 #include <../src/mat/impls/baij/seq/baij.h>
 #include <petsc/private/kernels/blockinvert.h>
+#include <petsc/private/kernels/blockmatmult.h>
 #include <petscbt.h>
 #include <petscblaslapack.h>
 
@@ -1927,6 +1928,197 @@ PetscErrorCode MatMultAdd_SeqBAIJ_N(Mat A,Vec xx,Vec yy,Vec zz)
   PetscFunctionReturn(0);
 }
 
+/*
+   Block size specialized products for block sizes 2 to 8. The block size is a compile time constant in each
+   instantiation below, so the loops over the block are fully unrolled (and vectorized) by the compiler. With
+   PETSC_USE_AVX512_KERNELS one column of a block is held in a single masked AVX-512 register.
+
+   MatMultAdd_SeqBAIJ_BS_Private() computes z = y + A x, or z = A x if yy is NULL
+*/
+PETSC_STATIC_INLINE PetscErrorCode MatMultAdd_SeqBAIJ_BS_Private(Mat A,const PetscInt bs,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;
+  PetscScalar       *yarray = NULL,*zarray,*z;
+  const PetscScalar *x,*xb,*y;
+  const MatScalar   *v = a->a;
+  const PetscInt    *idx = a->j,*ii,*ridx = NULL,bs2 = bs*bs;
+  PetscInt          mbs = a->mbs,i,j,n,c;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+  const __mmask8    mask = (__mmask8)((1<<bs)-1);
+  __m512d           vec_z;
+#else
+  PetscScalar       sum[8];
+  PetscInt          r;
+#endif
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {
+    ierr = VecGetArrayPair(yy,zz,&yarray,&zarray);CHKERRQ(ierr);
+  } else {
+    ierr = VecGetArray(zz,&zarray);CHKERRQ(ierr);
+  }
+  if (usecprow) {
+    /* block rows without entries are not visited */
+    if (!yy) {
+      ierr = PetscMemzero(zarray,bs*mbs*sizeof(PetscScalar));CHKERRQ(ierr);
+    } else if (zz != yy) {
+      ierr = PetscMemcpy(zarray,yarray,bs*mbs*sizeof(PetscScalar));CHKERRQ(ierr);
+    }
+    mbs  = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else {
+    ii = a->i;
+  }
+
+  for (i=0; i<mbs; i++) {
+    n = ii[i+1] - ii[i];
+    z = zarray + bs*(usecprow ? ridx[i] : i);
+    y = yarray ? yarray + bs*(usecprow ? ridx[i] : i) : NULL;
+    PetscPrefetchBlock(idx+n,n,0,PETSC_PREFETCH_HINT_NTA);   /* Indices for the next row (assumes same size as this one) */
+    PetscPrefetchBlock(v+bs2*n,bs2*n,0,PETSC_PREFETCH_HINT_NTA); /* Entries for the next row */
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+    vec_z = y ? _mm512_maskz_loadu_pd(mask,y) : _mm512_setzero_pd();
+    for (j=0; j<n; j++) {
+      xb = x + bs*idx[j];
+      for (c=0; c<bs; c++) vec_z = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask,v+c*bs),_mm512_set1_pd(xb[c]),vec_z);
+      v += bs2;
+    }
+    _mm512_mask_storeu_pd(z,mask,vec_z);
+#else
+    for (r=0; r<bs; r++) sum[r] = y ? y[r] : 0.0;
+    for (j=0; j<n; j++) {
+      xb = x + bs*idx[j];
+      for (c=0; c<bs; c++) {
+        for (r=0; r<bs; r++) sum[r] += v[c*bs+r]*xb[c];
+      }
+      v += bs2;
+    }
+    for (r=0; r<bs; r++) z[r] = sum[r];
+#endif
+    idx += n;
+  }
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {
+    ierr = VecRestoreArrayPair(yy,zz,&yarray,&zarray);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*bs2*a->nz);CHKERRQ(ierr);
+  } else {
+    ierr = VecRestoreArray(zz,&zarray);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*bs2*a->nz - bs*a->nonzerorowcnt);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* z = y + A^T x, or z = A^T x if yy is NULL */
+PETSC_STATIC_INLINE PetscErrorCode MatMultTransposeAdd_SeqBAIJ_BS_Private(Mat A,const PetscInt bs,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;
+  PetscScalar       *z,*zb;
+  const PetscScalar *x,*xb;
+  const MatScalar   *v = a->a;
+  const PetscInt    *idx = a->j,*ii,*ridx = NULL,bs2 = bs*bs;
+  PetscInt          mbs = a->mbs,i,j,n,c;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+  const __mmask8    mask = (__mmask8)((1<<bs)-1);
+  __m512d           vec_x;
+#else
+  PetscScalar       xr[8],sum;
+  PetscInt          r;
+#endif
+
+  PetscFunctionBegin;
+  if (!yy) {
+    ierr = VecSet(zz,0.0);CHKERRQ(ierr);
+  } else if (yy != zz) {
+    ierr = VecCopy(yy,zz);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  if (usecprow) {
+    mbs  = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else {
+    ii = a->i;
+  }
+
+  for (i=0; i<mbs; i++) {
+    n  = ii[i+1] - ii[i];
+    xb = x + bs*(usecprow ? ridx[i] : i);
+#if defined(PETSC_KERNEL_USE_AVX512_BLOCK)
+    vec_x = _mm512_maskz_loadu_pd(mask,xb);
+    for (j=0; j<n; j++) {
+      zb = z + bs*idx[j];
+      for (c=0; c<bs; c++) zb[c] += _mm512_reduce_add_pd(_mm512_mul_pd(_mm512_maskz_loadu_pd(mask,v+c*bs),vec_x));
+      v += bs2;
+    }
+#else
+    for (r=0; r<bs; r++) xr[r] = xb[r];
+    for (j=0; j<n; j++) {
+      zb = z + bs*idx[j];
+      for (c=0; c<bs; c++) {
+        sum = 0.0;
+        for (r=0; r<bs; r++) sum += v[c*bs+r]*xr[r];
+        zb[c] += sum;
+      }
+      v += bs2;
+    }
+#endif
+    idx += n;
+  }
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*bs2*a->nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#define MatSeqBAIJDefineSIMDKernels_Private(bs)                                       \
+PetscErrorCode MatMult_SeqBAIJ_##bs##_SIMD(Mat A,Vec xx,Vec zz)                      \
+{                                                                                     \
+  PetscErrorCode ierr;                                                                \
+                                                                                      \
+  PetscFunctionBegin;                                                                 \
+  ierr = MatMultAdd_SeqBAIJ_BS_Private(A,bs,xx,NULL,zz);CHKERRQ(ierr);                \
+  PetscFunctionReturn(0);                                                             \
+}                                                                                     \
+PetscErrorCode MatMultAdd_SeqBAIJ_##bs##_SIMD(Mat A,Vec xx,Vec yy,Vec zz)            \
+{                                                                                     \
+  PetscErrorCode ierr;                                                                \
+                                                                                      \
+  PetscFunctionBegin;                                                                 \
+  ierr = MatMultAdd_SeqBAIJ_BS_Private(A,bs,xx,yy,zz);CHKERRQ(ierr);                  \
+  PetscFunctionReturn(0);                                                             \
+}                                                                                     \
+PetscErrorCode MatMultTranspose_SeqBAIJ_##bs##_SIMD(Mat A,Vec xx,Vec zz)             \
+{                                                                                     \
+  PetscErrorCode ierr;                                                                \
+                                                                                      \
+  PetscFunctionBegin;                                                                 \
+  ierr = MatMultTransposeAdd_SeqBAIJ_BS_Private(A,bs,xx,NULL,zz);CHKERRQ(ierr);       \
+  PetscFunctionReturn(0);                                                             \
+}                                                                                     \
+PetscErrorCode MatMultTransposeAdd_SeqBAIJ_##bs##_SIMD(Mat A,Vec xx,Vec yy,Vec zz)   \
+{                                                                                     \
+  PetscErrorCode ierr;                                                                \
+                                                                                      \
+  PetscFunctionBegin;                                                                 \
+  ierr = MatMultTransposeAdd_SeqBAIJ_BS_Private(A,bs,xx,yy,zz);CHKERRQ(ierr);         \
+  PetscFunctionReturn(0);                                                             \
+}
+
+MatSeqBAIJDefineSIMDKernels_Private(2)
+MatSeqBAIJDefineSIMDKernels_Private(3)
+MatSeqBAIJDefineSIMDKernels_Private(4)
+MatSeqBAIJDefineSIMDKernels_Private(5)
+MatSeqBAIJDefineSIMDKernels_Private(6)
+MatSeqBAIJDefineSIMDKernels_Private(7)
+MatSeqBAIJDefineSIMDKernels_Private(8)
+
 PetscErrorCode MatMultHermitianTranspose_SeqBAIJ(Mat A,Vec xx,Vec zz)
 {
   PetscScalar    zero = 0.0;
@@ -172,9 +172,10 @@ static PetscErrorCode VecWrapCholmodRead(Vec X,cholmod_dense *Y)
 static PetscErrorCode VecUnWrapCholmodRead(Vec X,cholmod_dense *Y)
 {
   PetscErrorCode    ierr;
+  const PetscScalar *x = (const PetscScalar*)Y->x;
 
   PetscFunctionBegin;
-  ierr = VecRestoreArrayRead(X,NULL);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -35,6 +35,7 @@ PetscLogEvent MAT_GetMultiProcBlock;
 PetscLogEvent MAT_CUSPARSECopyToGPU, MAT_SetValuesBatch;
 PetscLogEvent MAT_ViennaCLCopyToGPU;
 PetscLogEvent MAT_Merge,MAT_Residual,MAT_SetRandom;
+PetscLogEvent MAT_PreallCOO,MAT_SetVCOO;
 PetscLogEvent MATCOLORING_Apply,MATCOLORING_Comm,MATCOLORING_Local,MATCOLORING_ISCreate,MATCOLORING_SetUp,MATCOLORING_Weights;
 
 const char *const MatFactorTypes[] = {"NONE","LU","CHOLESKY","ILU","ICC","ILUDT","MatFactorType","MAT_FACTOR_",0};
@@ -4430,47 +4431,54 @@ PetscErrorCode MatSolverTypeRegister(MatSolverType package,MatType mtype,MatFact
 PetscErrorCode MatSolverTypeGet(MatSolverType package,MatType mtype,MatFactorType ftype,PetscBool *foundpackage,PetscBool *foundmtype,PetscErrorCode (**getfactor)(Mat,MatFactorType,Mat*))
 {
   PetscErrorCode                 ierr;
-  MatSolverTypeHolder         next = MatSolverTypeHolders;
+  MatSolverTypeHolder         next;
   PetscBool                      flg;
   MatSolverTypeForSpecifcType inext;
+  PetscInt                       exact;
 
   PetscFunctionBegin;
   if (foundpackage) *foundpackage = PETSC_FALSE;
   if (foundmtype)   *foundmtype   = PETSC_FALSE;
   if (getfactor)    *getfactor    = NULL;
 
-  if (package) {
-    while (next) {
-      ierr = PetscStrcasecmp(package,next->name,&flg);CHKERRQ(ierr);
-      if (flg) {
-        if (foundpackage) *foundpackage = PETSC_TRUE;
+  /* a handler registered for the matrix type itself is preferred to one registered for a type it derives from, e.g. seqaij for seqaijsingle */
+  for (exact=1; exact>=0; exact--) {
+    next = MatSolverTypeHolders;
+    if (package) {
+      while (next) {
+        ierr = PetscStrcasecmp(package,next->name,&flg);CHKERRQ(ierr);
+        if (flg) {
+          if (foundpackage) *foundpackage = PETSC_TRUE;
+          inext = next->handlers;
+          while (inext) {
+            if (exact) {ierr = PetscStrcasecmp(mtype,inext->mtype,&flg);CHKERRQ(ierr);}
+            else {ierr = PetscStrbeginswith(mtype,inext->mtype,&flg);CHKERRQ(ierr);}
+            if (flg) {
+              if (foundmtype) *foundmtype = PETSC_TRUE;
+              if (getfactor)  *getfactor  = inext->getfactor[(int)ftype-1];
+              PetscFunctionReturn(0);
+            }
+            inext = inext->next;
+          }
+        }
+        next = next->next;
+      }
+    } else {
+      while (next) {
         inext = next->handlers;
         while (inext) {
-          ierr = PetscStrbeginswith(mtype,inext->mtype,&flg);CHKERRQ(ierr);
-          if (flg) {
-            if (foundmtype) *foundmtype = PETSC_TRUE;
-            if (getfactor)  *getfactor  = inext->getfactor[(int)ftype-1];
+          if (exact) {ierr = PetscStrcasecmp(mtype,inext->mtype,&flg);CHKERRQ(ierr);}
+          else {ierr = PetscStrbeginswith(mtype,inext->mtype,&flg);CHKERRQ(ierr);}
+          if (flg && inext->getfactor[(int)ftype-1]) {
+            if (foundpackage) *foundpackage = PETSC_TRUE;
+            if (foundmtype)   *foundmtype   = PETSC_TRUE;
+            if (getfactor)    *getfactor    = inext->getfactor[(int)ftype-1];
             PetscFunctionReturn(0);
           }
           inext = inext->next;
         }
+        next = next->next;
       }
-      next = next->next;
-    }
-  } else {
-    while (next) {
-      inext = next->handlers;
-      while (inext) {
-        ierr = PetscStrbeginswith(mtype,inext->mtype,&flg);CHKERRQ(ierr);
-        if (flg && inext->getfactor[(int)ftype-1]) {
-          if (foundpackage) *foundpackage = PETSC_TRUE;
-          if (foundmtype)   *foundmtype   = PETSC_TRUE;
-          if (getfactor)    *getfactor    = inext->getfactor[(int)ftype-1];
-          PetscFunctionReturn(0);
-        }
-        inext = inext->next;
-      }
-      next = next->next;
     }
   }
   PetscFunctionReturn(0);
@@ -5567,8 +5575,12 @@ PetscErrorCode MatAssemblyEnd(Mat mat,MatAssemblyType type)
    is created during the first Matrix Assembly. This hash table is
    used the next time through, during MatSetVaules()/MatSetVaulesBlocked()
    to improve the searching of indices. MAT_NEW_NONZERO_LOCATIONS flag
-   should be used with MAT_USE_HASH_TABLE flag. This option is currently
-   supported by MATMPIBAIJ format only.
+   should be used with MAT_USE_HASH_TABLE flag for MATMPIBAIJ.
+   For MATSEQAIJ and MATMPIAIJ, MAT_USE_HASH_TABLE set before the first assembly
+   collects all entries in a hash table instead of the preallocated storage;
+   the first final MatAssemblyEnd() then builds the exact nonzero structure in a
+   single pass, so no preallocation is needed and no mallocs take place in
+   MatSetValues(). It is ignored after the first assembly.
 
    MAT_KEEP_NONZERO_PATTERN indicates when MatZeroRows() is called the zeroed entries
    are kept in the nonzero structure
@@ -7968,6 +7980,27 @@ M*/
 M*/
 
 
+/*
+   The stride index set with the indices of is if they are evenly spaced, otherwise a new reference to is. The block
+   index sets of ISCreateCompressed() are not used since they could change the block sizes of the submatrix.
+*/
+static PetscErrorCode MatCreateSubMatrixCompressIS_Private(IS is,IS *cis)
+{
+  PetscErrorCode ierr;
+  PetscBool      stride;
+
+  PetscFunctionBegin;
+  ierr = ISCreateCompressed(is,cis);CHKERRQ(ierr);
+  if (*cis == is) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)*cis,ISSTRIDE,&stride);CHKERRQ(ierr);
+  if (!stride) {
+    ierr = ISDestroy(cis);CHKERRQ(ierr);
+    ierr = PetscObjectReference((PetscObject)is);CHKERRQ(ierr);
+    *cis = is;
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
     MatCreateSubMatrix - Gets a single submatrix on the same number of processors
                       as the original matrix.
@@ -8004,6 +8037,8 @@ M*/
 
     If iscol is NULL then all columns are obtained (not supported in Fortran).
 
+    Index sets whose indices are evenly spaced are handled as ISSTRIDE, see ISCreateCompressed().
+
    Example usage:
    Consider the following 8x8 matrix with 34 non-zero values, that is
    assembled across 3 processors. Let's assume that proc0 owns 3 rows,
@@ -8045,7 +8080,7 @@ PetscErrorCode MatCreateSubMatrix(Mat mat,IS isrow,IS iscol,MatReuse cll,Mat *ne
   PetscErrorCode ierr;
   PetscMPIInt    size;
   Mat            *local;
-  IS             iscoltmp;
+  IS             iscoltmp,isrowc,iscolc;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
@@ -8088,18 +8123,28 @@ PetscErrorCode MatCreateSubMatrix(Mat mat,IS isrow,IS iscol,MatReuse cll,Mat *ne
     }
   }
 
-  if (!iscol) {
+  /* from here on index sets with evenly spaced indices are taken as ISSTRIDE, for which the implementations need no
+     index arrays; the entire matrix is only returned above for index sets that were created as ISSTRIDE */
+  ierr = MatCreateSubMatrixCompressIS_Private(isrow,&isrowc);CHKERRQ(ierr);
+  if (iscol == isrow) {
+    ierr   = PetscObjectReference((PetscObject)isrowc);CHKERRQ(ierr);
+    iscolc = isrowc;
+  } else if (iscol) {
+    ierr = MatCreateSubMatrixCompressIS_Private(iscol,&iscolc);CHKERRQ(ierr);
+  } else iscolc = NULL;
+
+  if (!iscolc) {
     ierr = ISCreateStride(PetscObjectComm((PetscObject)mat),mat->cmap->n,mat->cmap->rstart,1,&iscoltmp);CHKERRQ(ierr);
   } else {
-    iscoltmp = iscol;
+    iscoltmp = iscolc;
   }
 
   /* if original matrix is on just one processor then use submatrix generated */
   if (mat->ops->createsubmatrices && !mat->ops->createsubmatrix && size == 1 && cll == MAT_REUSE_MATRIX) {
-    ierr = MatCreateSubMatrices(mat,1,&isrow,&iscoltmp,MAT_REUSE_MATRIX,&newmat);CHKERRQ(ierr);
+    ierr = MatCreateSubMatrices(mat,1,&isrowc,&iscoltmp,MAT_REUSE_MATRIX,&newmat);CHKERRQ(ierr);
     goto setproperties;
   } else if (mat->ops->createsubmatrices && !mat->ops->createsubmatrix && size == 1) {
-    ierr    = MatCreateSubMatrices(mat,1,&isrow,&iscoltmp,MAT_INITIAL_MATRIX,&local);CHKERRQ(ierr);
+    ierr    = MatCreateSubMatrices(mat,1,&isrowc,&iscoltmp,MAT_INITIAL_MATRIX,&local);CHKERRQ(ierr);
     *newmat = *local;
     ierr    = PetscFree(local);CHKERRQ(ierr);
     goto setproperties;
@@ -8108,10 +8153,10 @@ PetscErrorCode MatCreateSubMatrix(Mat mat,IS isrow,IS iscol,MatReuse cll,Mat *ne
     ierr = PetscLogEventBegin(MAT_CreateSubMat,mat,0,0,0);CHKERRQ(ierr);
     switch (cll) {
     case MAT_INITIAL_MATRIX:
-      ierr = MatCreateSubMatrixVirtual(mat,isrow,iscoltmp,newmat);CHKERRQ(ierr);
+      ierr = MatCreateSubMatrixVirtual(mat,isrowc,iscoltmp,newmat);CHKERRQ(ierr);
       break;
     case MAT_REUSE_MATRIX:
-      ierr = MatSubMatrixVirtualUpdate(*newmat,mat,isrow,iscoltmp);CHKERRQ(ierr);
+      ierr = MatSubMatrixVirtualUpdate(*newmat,mat,isrowc,iscoltmp);CHKERRQ(ierr);
       break;
     default: SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_OUTOFRANGE,"Invalid MatReuse, must be either MAT_INITIAL_MATRIX or MAT_REUSE_MATRIX");
     }
@@ -8121,12 +8166,12 @@ PetscErrorCode MatCreateSubMatrix(Mat mat,IS isrow,IS iscol,MatReuse cll,Mat *ne
 
   if (!mat->ops->createsubmatrix) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Mat type %s",((PetscObject)mat)->type_name);
   ierr = PetscLogEventBegin(MAT_CreateSubMat,mat,0,0,0);CHKERRQ(ierr);
-  ierr = (*mat->ops->createsubmatrix)(mat,isrow,iscoltmp,cll,newmat);CHKERRQ(ierr);
+  ierr = (*mat->ops->createsubmatrix)(mat,isrowc,iscoltmp,cll,newmat);CHKERRQ(ierr);
   ierr = PetscLogEventEnd(MAT_CreateSubMat,mat,0,0,0);CHKERRQ(ierr);
 
   /* Propagate symmetry information for diagonal blocks */
 setproperties:
-  if (isrow == iscoltmp) {
+  if (isrowc == iscoltmp) {
     if (mat->symmetric_set && mat->symmetric) {
       ierr = MatSetOption(*newmat,MAT_SYMMETRIC,PETSC_TRUE);CHKERRQ(ierr);
     }
@@ -8141,7 +8186,9 @@ setproperties:
     }
   }
 
-  if (!iscol) {ierr = ISDestroy(&iscoltmp);CHKERRQ(ierr);}
+  if (!iscolc) {ierr = ISDestroy(&iscoltmp);CHKERRQ(ierr);}
+  ierr = ISDestroy(&isrowc);CHKERRQ(ierr);
+  ierr = ISDestroy(&iscolc);CHKERRQ(ierr);
   if (*newmat && cll == MAT_INITIAL_MATRIX) {ierr = PetscObjectStateIncrease((PetscObject)*newmat);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
@@ -9392,9 +9439,13 @@ PetscErrorCode MatFactorFactorizeSchurComplement(Mat F)
    This routine is currently only implemented for pairs of sequential dense matrices, AIJ matrices and classes
    which inherit from AIJ.
 
+   For MPIAIJ matrices the algorithm is selected with -matptap_via <scalable,nonscalable,allatonce,allatonce_merged>.
+   The allatonce algorithms never form A*P and use the least memory. The memory used by each phase, measured when
+   PETSc's tracing malloc is in use (-malloc or a debug build), is reported with -info and by MatView() with -mat_view ::ascii_info_detail.
+
    Level: intermediate
 
-.seealso: MatPtAPSymbolic(), MatPtAPNumeric(), MatMatMult(), MatRARt()
+.seealso: MatPtAPSymbolic(), MatPtAPNumeric(), MatMatMult(), MatRARt(), PetscMallocPushMaximumUsage()
 @*/
 PetscErrorCode MatPtAP(Mat A,Mat P,MatReuse scall,PetscReal fill,Mat *C)
 {
@@ -0,0 +1,79 @@
+static char help[] = "Tests the page placement policies of the large allocations (PetscMallocSetPagesPolicy()).\n\
+  -n <n>    : number of entries of the arrays\n\
+  -type <t> : type of pages of the arrays of the test class\n\n";
+
+#include <petscsys.h>
+
+/* fills a with i+shift, reallocates it to 2n entries and counts the first n entries kept */
+static PetscErrorCode FillAndCheck(const char name[],PetscInt n,PetscInt shift)
+{
+  PetscErrorCode ierr;
+  PetscScalar    *a;
+  PetscInt       i,nkept = 0;
+
+  PetscFunctionBeginUser;
+  ierr = PetscMalloc1(n,&a);CHKERRQ(ierr);
+  for (i=0; i<n; i++) a[i] = (PetscScalar)(i+shift);
+  ierr = PetscRealloc(2*n*sizeof(PetscScalar),&a);CHKERRQ(ierr);
+  for (i=0; i<n; i++) if (a[i] == (PetscScalar)(i+shift)) nkept++;
+  for (i=n; i<2*n; i++) a[i] = 0.0;
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%s: %D of %D entries kept by PetscRealloc() to %D entries\n",name,nkept,n,2*n);CHKERRQ(ierr);
+  ierr = PetscFree(a);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode       ierr;
+  PetscClassId         classid;
+  PetscMallocPagesType type = PETSC_MALLOC_PAGES_TRANSPARENT;
+  PetscInt             n = 400000,i,k,nok;
+  PetscScalar          *b[3];
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-type",PetscMallocPagesTypes,(PetscEnum*)&type,NULL);CHKERRQ(ierr);
+  ierr = PetscClassIdRegister("Test",&classid);CHKERRQ(ierr);
+  ierr = PetscMallocSetPagesPolicy(classid,type,PETSC_TRUE);CHKERRQ(ierr);
+
+  /* allocations outside of the class follow the policy set with -malloc_pages */
+  ierr = FillAndCheck("Outside the class",n,1);CHKERRQ(ierr);
+
+  /* allocations of the class, several live at once and freed out of order */
+  ierr = PetscMallocPushClass(classid);CHKERRQ(ierr);
+  for (k=0; k<3; k++) {ierr = PetscCalloc1(n,&b[k]);CHKERRQ(ierr);}
+  ierr = FillAndCheck("Class Test",n,2);CHKERRQ(ierr);
+  ierr = PetscMallocPopClass();CHKERRQ(ierr);
+  for (k=0; k<3; k++) {
+    for (i=0,nok=0; i<n; i++) if (b[k][i] == 0.0) nok++;
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Array %D of class Test: %D of %D entries zeroed by PetscCalloc1()\n",k,nok,n);CHKERRQ(ierr);
+    for (i=0; i<n; i++) b[k][i] = (PetscScalar)(i+k);
+  }
+  ierr = PetscFree(b[1]);CHKERRQ(ierr);
+  for (k=0; k<3; k+=2) {
+    for (i=0,nok=0; i<n; i++) if (b[k][i] == (PetscScalar)(i+k)) nok++;
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Array %D of class Test: %D of %D entries intact after freeing array 1\n",k,nok,n);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(b[0]);CHKERRQ(ierr);
+  ierr = PetscFree(b[2]);CHKERRQ(ierr);
+
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      output_file: output/ex52_1.out
+
+   test:
+      suffix: hugetlb
+      args: -type hugetlb -malloc_pages transparent -malloc_pages_threshold 65536
+      output_file: output/ex52_1.out
+
+   test:
+      suffix: default_pages
+      args: -type default -malloc_first_touch -malloc no
+      output_file: output/ex52_1.out
+
+TEST*/
@@ -205,4 +205,25 @@ int main(int argc,char **argv)
       args: -verbose -build_twosided redscatter
       output_file: output/ex8_1.out
 
+   test:
+      suffix: hierarchical
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      nsize: 4
+      args: -verbose -build_twosided hierarchical
+      output_file: output/ex8_1.out
+
+   test:
+      suffix: hierarchical_noshared
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      nsize: 4
+      args: -verbose -build_twosided hierarchical -noshared
+      output_file: output/ex8_1.out
+
+   test:
+      suffix: f_hierarchical
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      nsize: 4
+      args: -verbose -build_twosided_f -build_twosided hierarchical
+      output_file: output/ex8_1.out
+
 TEST*/
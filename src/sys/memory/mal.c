@@ -23,6 +23,15 @@ PetscMemkindType previousmktype = PETSC_MK_HBW_PREFERRED;
 */
 #define SHIFT_CLASSID 456123
 
+/*
+   These are defined in mpages.c and map the large allocations with the page placement policy of their class
+*/
+PETSC_INTERN PetscBool      PetscMallocPagesActive;
+PETSC_INTERN size_t         PetscMallocNumPagesBlocks;
+PETSC_INTERN PetscErrorCode PetscMallocPages_Private(size_t,void**);
+PETSC_INTERN PetscErrorCode PetscMallocPagesFind_Private(void*,size_t*);
+PETSC_INTERN PetscErrorCode PetscFreePages_Private(void*,PetscBool*);
+
 PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,int line,const char func[],const char file[],void **result)
 {
   if (!mem) { *result = NULL; return 0; }
@@ -35,6 +44,11 @@ PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,int line,const char func
     if (ierr == ENOMEM) PetscInfo1(0,"Memkind: fail to request HBW memory %.0f, falling back to normal memory\n",(PetscLogDouble)mem);
   }
 #else
+  if (PetscMallocPagesActive) {
+    PetscErrorCode ierr = PetscMallocPages_Private(mem,result);
+    if (ierr) return ierr;
+    if (*result) return 0;
+  }
 #  if defined(PETSC_HAVE_DOUBLE_ALIGN_MALLOC) && (PETSC_MEMALIGN == 8)
   *result = malloc(mem);
 #  elif defined(PETSC_HAVE_MEMALIGN)
@@ -67,6 +81,12 @@ PETSC_EXTERN PetscErrorCode PetscFreeAlign(void *ptr,int line,const char func[],
 #if defined(PETSC_HAVE_MEMKIND)
   memkind_free(0,ptr); /* specify the kind to 0 so that memkind will look up for the right type */
 #else
+  if (PetscMallocNumPagesBlocks) {
+    PetscBool      found;
+    PetscErrorCode ierr = PetscFreePages_Private(ptr,&found);
+    if (ierr) return ierr;
+    if (found) return 0;
+  }
 #  if (!(defined(PETSC_HAVE_DOUBLE_ALIGN_MALLOC) && (PETSC_MEMALIGN == 8)) && !defined(PETSC_HAVE_MEMALIGN))
   {
     /*
@@ -100,6 +120,26 @@ PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t mem, int line, const char f
     *result = NULL;
     return 0;
   }
+#if !defined(PETSC_HAVE_MEMKIND)
+  if (PetscMallocNumPagesBlocks) {
+    /* a mapping with a page placement policy is moved to a new allocation */
+    size_t len;
+    void   *newResult;
+
+    ierr = PetscMallocPagesFind_Private(*result,&len);
+    if (ierr) return ierr;
+    if (len) {
+      ierr = PetscMallocAlign(mem,line,func,file,&newResult);
+      if (ierr) return ierr;
+      ierr = PetscMemcpy(newResult,*result,PetscMin(len,mem));
+      if (ierr) return ierr;
+      ierr = PetscFreeAlign(*result,line,func,file);
+      if (ierr) return ierr;
+      *result = newResult;
+      return 0;
+    }
+  }
+#endif
 #if defined(PETSC_HAVE_MEMKIND)
   if (!currentmktype) *result = memkind_realloc(MEMKIND_DEFAULT,*result,mem);
   else *result = memkind_realloc(MEMKIND_HBW_PREFERRED,*result,mem);
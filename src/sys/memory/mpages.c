@@ -0,0 +1,396 @@
+/*
+    Page placement of large allocations: transparent or explicit huge pages, and parallel first touch.
+
+    PetscMallocAlign() hands the allocations of at least PetscMallocPagesThreshold bytes to PetscMallocPages_Private()
+    when a policy other than the default one is selected for the object class that does the allocation. These are
+    mapped with mmap() and recorded, sorted by address, so that PetscFreeAlign() and PetscReallocAlign() recognize them.
+*/
+#include <petscsys.h>             /*I   "petscsys.h"   I*/
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+const char *const PetscMallocPagesTypes[] = {"DEFAULT","TRANSPARENT","HUGETLB","PetscMallocPagesType","PETSC_MALLOC_PAGES_",0};
+
+#define PETSC_HUGE_PAGE_SIZE      2097152
+#define PETSC_MALLOC_MAX_POLICIES 8
+#define PETSC_MALLOC_MAX_CLASSES  16
+
+typedef struct {
+  PetscClassId         classid;   /* 0 for the allocations outside PetscMallocPushClass()/PetscMallocPopClass() */
+  PetscMallocPagesType type;
+  PetscBool            firsttouch;
+} PetscMallocPolicy;
+
+typedef struct {
+  char   *ptr;
+  size_t len;                     /* length of the mapping */
+} PetscMallocPagesBlock;
+
+static PetscMallocPolicy     PetscMallocPolicies[PETSC_MALLOC_MAX_POLICIES] = {{0,PETSC_MALLOC_PAGES_DEFAULT,PETSC_FALSE}};
+static int                   PetscMallocNumPolicies = 1;
+static PetscClassId          PetscMallocClasses[PETSC_MALLOC_MAX_CLASSES];
+static int                   PetscMallocNumClasses = 0;
+static size_t                PetscMallocPagesThreshold = PETSC_HUGE_PAGE_SIZE;
+static PetscMallocPagesBlock *PetscMallocPagesBlocks = NULL;
+static size_t                PetscMallocMaxPagesBlocks = 0;
+
+/* statistics shown by PetscMallocDumpLog() */
+static PetscInt       PetscMallocPagesCount[3] = {0,0,0},PetscMallocPagesTouched = 0,PetscMallocPagesFallbacks = 0;
+static PetscLogDouble PetscMallocPagesBytes[3] = {0,0,0};
+
+PETSC_INTERN PetscBool PetscMallocPagesActive;
+PETSC_INTERN size_t    PetscMallocNumPagesBlocks;
+PetscBool              PetscMallocPagesActive = PETSC_FALSE;   /* some policy differs from the default one */
+size_t                 PetscMallocNumPagesBlocks = 0;
+
+static size_t PetscMallocBasePageSize(void)
+{
+#if defined(PETSC_HAVE_GETPAGESIZE)
+  return (size_t)getpagesize();
+#else
+  return 4096;
+#endif
+}
+
+/* the first index whose block does not start before ptr */
+static size_t PetscMallocPagesLocate(const char *ptr)
+{
+  size_t lo = 0,hi = PetscMallocNumPagesBlocks;
+
+  while (lo < hi) {
+    size_t mid = lo + (hi-lo)/2;
+    if (PetscMallocPagesBlocks[mid].ptr < ptr) lo = mid+1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+/*
+   The pages are touched with the static schedule of OpenMP used by the vector and matrix kernels, so that each thread
+   first touches, and thus gets on its NUMA domain, the pages of the part of the array it later works on.
+*/
+static void PetscMallocPagesTouch(char *p,size_t len)
+{
+  size_t   pagesize = PetscMallocBasePageSize();
+  PetscInt i,npages = (PetscInt)(len/pagesize);
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (i=0; i<npages; i++) p[i*pagesize] = 0;
+}
+
+/*
+   PetscMallocPages_Private - Maps mem bytes with the page placement policy of the current class, if that policy is
+   not the default one and mem is at least the threshold; otherwise *result is left NULL
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPages_Private(size_t mem,void **result)
+{
+#if defined(PETSC_HAVE_MMAP)
+  PetscErrorCode       ierr;
+  PetscClassId         classid = PetscMallocNumClasses ? PetscMallocClasses[PetscMallocNumClasses-1] : 0;
+  PetscMallocPagesType type = PetscMallocPolicies[0].type;
+  PetscBool            firsttouch = PetscMallocPolicies[0].firsttouch;
+  char                 *p = (char*)MAP_FAILED;
+  size_t               len = 0,pos;
+  int                  i;
+
+  PetscFunctionBegin;
+  *result = NULL;
+  if (mem < PetscMallocPagesThreshold) PetscFunctionReturn(0);
+  for (i=1; i<PetscMallocNumPolicies; i++) {
+    if (PetscMallocPolicies[i].classid == classid) {
+      type       = PetscMallocPolicies[i].type;
+      firsttouch = PetscMallocPolicies[i].firsttouch;
+      break;
+    }
+  }
+  if (type == PETSC_MALLOC_PAGES_DEFAULT && !firsttouch) PetscFunctionReturn(0);
+
+  if (type == PETSC_MALLOC_PAGES_HUGETLB) {
+#if defined(MAP_HUGETLB)
+    len = (mem + PETSC_HUGE_PAGE_SIZE-1)/PETSC_HUGE_PAGE_SIZE*PETSC_HUGE_PAGE_SIZE;
+    p   = (char*)mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+#endif
+    if (p == (char*)MAP_FAILED) {
+      ierr = PetscInfo1(NULL,"Could not map %.0f bytes with huge pages, are enough of them reserved? Using transparent huge pages\n",(PetscLogDouble)mem);CHKERRQ(ierr);
+      PetscMallocPagesFallbacks++;
+      type = PETSC_MALLOC_PAGES_TRANSPARENT;
+    }
+  }
+  if (type == PETSC_MALLOC_PAGES_TRANSPARENT) {
+#if defined(MADV_HUGEPAGE)
+    /* map one more huge page and trim the mapping to a range aligned to the huge pages */
+    size_t head;
+
+    len = (mem + PETSC_HUGE_PAGE_SIZE-1)/PETSC_HUGE_PAGE_SIZE*PETSC_HUGE_PAGE_SIZE;
+    p   = (char*)mmap(NULL,len+PETSC_HUGE_PAGE_SIZE,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (p != (char*)MAP_FAILED) {
+      head = (PETSC_HUGE_PAGE_SIZE - (size_t)((PETSC_UINTPTR_T)p % PETSC_HUGE_PAGE_SIZE)) % PETSC_HUGE_PAGE_SIZE;
+      if (head) munmap(p,head);
+      munmap(p+head+len,PETSC_HUGE_PAGE_SIZE-head);
+      p += head;
+      if (madvise(p,len,MADV_HUGEPAGE)) {
+        ierr = PetscInfo(NULL,"The kernel does not support transparent huge pages, using the default pages\n");CHKERRQ(ierr);
+        PetscMallocPagesFallbacks++;
+        type = PETSC_MALLOC_PAGES_DEFAULT;
+      }
+    }
+#else
+    ierr = PetscInfo(NULL,"Transparent huge pages are not available, using the default pages\n");CHKERRQ(ierr);
+    PetscMallocPagesFallbacks++;
+    type = PETSC_MALLOC_PAGES_DEFAULT;
+#endif
+  }
+  if (p == (char*)MAP_FAILED) {
+    size_t pagesize = PetscMallocBasePageSize();
+
+    type = PETSC_MALLOC_PAGES_DEFAULT;
+    len  = (mem + pagesize-1)/pagesize*pagesize;
+    p    = (char*)mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (p == (char*)MAP_FAILED) PetscFunctionReturn(0);
+  }
+  if (firsttouch) {
+    PetscMallocPagesTouch(p,len);
+    PetscMallocPagesTouched++;
+  }
+
+  if (PetscMallocNumPagesBlocks == PetscMallocMaxPagesBlocks) {
+    size_t                newmax = PetscMax(2*PetscMallocMaxPagesBlocks,16);
+    PetscMallocPagesBlock *blocks = (PetscMallocPagesBlock*)realloc(PetscMallocPagesBlocks,newmax*sizeof(PetscMallocPagesBlock));
+    if (!blocks) {munmap(p,len); SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Out of memory recording the allocations with a page placement policy");}
+    PetscMallocPagesBlocks    = blocks;
+    PetscMallocMaxPagesBlocks = newmax;
+  }
+  pos = PetscMallocPagesLocate(p);
+  memmove(PetscMallocPagesBlocks+pos+1,PetscMallocPagesBlocks+pos,(PetscMallocNumPagesBlocks-pos)*sizeof(PetscMallocPagesBlock));
+  PetscMallocPagesBlocks[pos].ptr = p;
+  PetscMallocPagesBlocks[pos].len = len;
+  PetscMallocNumPagesBlocks++;
+  PetscMallocPagesCount[type]++;
+  PetscMallocPagesBytes[type] += (PetscLogDouble)len;
+  *result = (void*)p;
+  PetscFunctionReturn(0);
+#else
+  *result = NULL;
+  return 0;
+#endif
+}
+
+/*
+   PetscMallocPagesFind_Private - Gives the length of the mapping of ptr if it was obtained with PetscMallocPages_Private(), 0 otherwise
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPagesFind_Private(void *ptr,size_t *len)
+{
+  size_t pos = PetscMallocPagesLocate((char*)ptr);
+
+  *len = (pos < PetscMallocNumPagesBlocks && PetscMallocPagesBlocks[pos].ptr == (char*)ptr) ? PetscMallocPagesBlocks[pos].len : 0;
+  return 0;
+}
+
+/*
+   PetscFreePages_Private - Unmaps ptr if it was obtained with PetscMallocPages_Private(), sets *found accordingly
+*/
+PETSC_INTERN PetscErrorCode PetscFreePages_Private(void *ptr,PetscBool *found)
+{
+  size_t pos = PetscMallocPagesLocate((char*)ptr);
+
+  *found = PETSC_FALSE;
+  if (pos == PetscMallocNumPagesBlocks || PetscMallocPagesBlocks[pos].ptr != (char*)ptr) return 0;
+#if defined(PETSC_HAVE_MMAP)
+  if (munmap(ptr,PetscMallocPagesBlocks[pos].len)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"munmap() failed");
+#endif
+  memmove(PetscMallocPagesBlocks+pos,PetscMallocPagesBlocks+pos+1,(PetscMallocNumPagesBlocks-pos-1)*sizeof(PetscMallocPagesBlock));
+  PetscMallocNumPagesBlocks--;
+  *found = PETSC_TRUE;
+  return 0;
+}
+
+/*
+   PetscMallocPagesView_Private - Shows how the large allocations were placed, called by PetscMallocDumpLog()
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPagesView_Private(FILE *fp,PetscMPIInt rank)
+{
+  PetscErrorCode ierr;
+  int            nthreads = 1;
+
+  PetscFunctionBegin;
+  if (!PetscMallocPagesActive) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_OPENMP)
+  nthreads = omp_get_max_threads();
+#endif
+  ierr = PetscFPrintf(MPI_COMM_WORLD,fp,"[%d] Allocations of at least %.0f bytes with a page placement policy\n",rank,(PetscLogDouble)PetscMallocPagesThreshold);CHKERRQ(ierr);
+  ierr = PetscFPrintf(MPI_COMM_WORLD,fp,"[%d]   %D with huge pages %.0f bytes, %D with transparent huge pages %.0f bytes, %D with default pages %.0f bytes\n",rank,
+                      PetscMallocPagesCount[PETSC_MALLOC_PAGES_HUGETLB],PetscMallocPagesBytes[PETSC_MALLOC_PAGES_HUGETLB],
+                      PetscMallocPagesCount[PETSC_MALLOC_PAGES_TRANSPARENT],PetscMallocPagesBytes[PETSC_MALLOC_PAGES_TRANSPARENT],
+                      PetscMallocPagesCount[PETSC_MALLOC_PAGES_DEFAULT],PetscMallocPagesBytes[PETSC_MALLOC_PAGES_DEFAULT]);CHKERRQ(ierr);
+  ierr = PetscFPrintf(MPI_COMM_WORLD,fp,"[%d]   %D first touched by %d threads, %D fell back to smaller pages\n",rank,PetscMallocPagesTouched,nthreads,PetscMallocPagesFallbacks);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocSetPagesPolicy - Sets how the pages of the large arrays allocated by a class of objects are placed
+
+   Not Collective
+
+   Input Parameters:
++  classid - the class of objects, for example VEC_CLASSID or MAT_CLASSID, or 0 for all the other allocations
+.  type - PETSC_MALLOC_PAGES_DEFAULT, PETSC_MALLOC_PAGES_TRANSPARENT for transparent huge pages or PETSC_MALLOC_PAGES_HUGETLB for
+          explicit 2MB pages
+-  firsttouch - touch the pages at the allocation with the OpenMP threads, in the static partition used by the kernels
+
+   Options Database Keys:
++  -malloc_pages <default,transparent,hugetlb> - sets the type of pages of the allocations outside of the classes below
+.  -malloc_first_touch - touches these pages at their allocation
+.  -malloc_pages_threshold <bytes> - smallest allocation given a policy, by default the size of a huge page
+.  -vec_malloc_pages <default,transparent,hugetlb> - sets the type of pages of the vector arrays
+.  -vec_malloc_first_touch - touches the pages of the vector arrays at their allocation
+.  -mat_malloc_pages <default,transparent,hugetlb> - sets the type of pages of the matrix arrays
+-  -mat_malloc_first_touch - touches the pages of the matrix arrays at their allocation
+
+   Notes:
+   Only the allocations of at least the threshold (see PetscMallocSetPagesThreshold()) are concerned. They are mapped
+   with mmap() rather than taken from the heap. Explicit huge pages must be reserved by the system administrator, when
+   there are not enough of them the allocation falls back to transparent huge pages. The number of allocations with each
+   type of pages is shown by -malloc_log.
+
+   The classes that use a policy of their own bracket their allocations with PetscMallocPushClass() and PetscMallocPopClass().
+   Without OpenMP the pages are touched by the allocating process, which matters for explicit huge pages that are
+   otherwise reserved at their first access.
+
+   Level: advanced
+
+.seealso: PetscMallocPushClass(), PetscMallocSetPagesThreshold(), PetscMallocDumpLog()
+@*/
+PetscErrorCode PetscMallocSetPagesPolicy(PetscClassId classid,PetscMallocPagesType type,PetscBool firsttouch)
+{
+  int i;
+
+  PetscFunctionBegin;
+#if !defined(PETSC_HAVE_MMAP)
+  if (type != PETSC_MALLOC_PAGES_DEFAULT || firsttouch) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Page placement policies require mmap()");
+#endif
+  for (i=0; i<PetscMallocNumPolicies; i++) if (PetscMallocPolicies[i].classid == classid) break;
+  if (i == PetscMallocNumPolicies) {
+    if (i == PETSC_MALLOC_MAX_POLICIES) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Only %d classes can have a page placement policy",PETSC_MALLOC_MAX_POLICIES-1);
+    PetscMallocNumPolicies++;
+  }
+  PetscMallocPolicies[i].classid    = classid;
+  PetscMallocPolicies[i].type       = type;
+  PetscMallocPolicies[i].firsttouch = firsttouch;
+  for (i=0; i<PetscMallocNumPolicies; i++) {
+    if (PetscMallocPolicies[i].type != PETSC_MALLOC_PAGES_DEFAULT || PetscMallocPolicies[i].firsttouch) PetscMallocPagesActive = PETSC_TRUE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocSetPagesThreshold - Sets the size from which the allocations follow the page placement policies
+
+   Not Collective
+
+   Input Parameter:
+.  threshold - the size in bytes, by default 2MB
+
+   Options Database Key:
+.  -malloc_pages_threshold <bytes> - sets the threshold
+
+   Level: advanced
+
+.seealso: PetscMallocSetPagesPolicy()
+@*/
+PetscErrorCode PetscMallocSetPagesThreshold(size_t threshold)
+{
+  PetscFunctionBegin;
+  PetscMallocPagesThreshold = PetscMax(threshold,1);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPagesSetFromOptions - Sets the page placement policy of a class of objects from the options database
+
+   Not Collective
+
+   Input Parameters:
++  classid - the class of objects, or 0 for the allocations outside of the classes
+-  prefix - the prefix of the options of the class, for example "vec_", or NULL
+
+   Notes:
+   Called by PetscInitialize() and by the initialization of the packages that allocate large arrays.
+   A class without options of its own keeps the policy of the other allocations.
+
+   Level: developer
+
+.seealso: PetscMallocSetPagesPolicy()
+@*/
+PetscErrorCode PetscMallocPagesSetFromOptions(PetscClassId classid,const char prefix[])
+{
+  PetscErrorCode       ierr;
+  PetscMallocPagesType type = PetscMallocPolicies[0].type;
+  PetscBool            firsttouch = PetscMallocPolicies[0].firsttouch,flg1,flg2;
+  PetscInt             threshold;
+  int                  i;
+
+  PetscFunctionBegin;
+  for (i=1; i<PetscMallocNumPolicies; i++) {
+    if (PetscMallocPolicies[i].classid == classid) {
+      type       = PetscMallocPolicies[i].type;
+      firsttouch = PetscMallocPolicies[i].firsttouch;
+    }
+  }
+  ierr = PetscOptionsGetEnum(NULL,prefix,"-malloc_pages",PetscMallocPagesTypes,(PetscEnum*)&type,&flg1);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,prefix,"-malloc_first_touch",&firsttouch,&flg2);CHKERRQ(ierr);
+  if (flg1 || flg2) {ierr = PetscMallocSetPagesPolicy(classid,type,firsttouch);CHKERRQ(ierr);}
+  if (!classid) {
+    ierr = PetscOptionsGetInt(NULL,prefix,"-malloc_pages_threshold",&threshold,&flg1);CHKERRQ(ierr);
+    if (flg1) {ierr = PetscMallocSetPagesThreshold((size_t)threshold);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPushClass - Attributes the following allocations to a class of objects, for its page placement policy
+
+   Not Collective
+
+   Input Parameter:
+.  classid - the class of objects
+
+   Notes:
+   Must be followed by PetscMallocPopClass() once the arrays of the object are allocated.
+
+   Level: developer
+
+.seealso: PetscMallocPopClass(), PetscMallocSetPagesPolicy()
+@*/
+PetscErrorCode PetscMallocPushClass(PetscClassId classid)
+{
+  PetscFunctionBegin;
+  if (PetscMallocNumClasses == PETSC_MALLOC_MAX_CLASSES) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Too many nested calls to PetscMallocPushClass(), maximum is %d",PETSC_MALLOC_MAX_CLASSES);
+  PetscMallocClasses[PetscMallocNumClasses++] = classid;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPopClass - Ends the attribution of the allocations started by PetscMallocPushClass()
+
+   Not Collective
+
+   Level: developer
+
+.seealso: PetscMallocPushClass()
+@*/
+PetscErrorCode PetscMallocPopClass(void)
+{
+  PetscFunctionBegin;
+  if (!PetscMallocNumClasses) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"PetscMallocPopClass() without PetscMallocPushClass()");
+  PetscMallocNumClasses--;
+  PetscFunctionReturn(0);
+}
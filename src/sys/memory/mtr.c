@@ -19,6 +19,7 @@ PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t,int,const char[],const char
 PETSC_EXTERN PetscErrorCode PetscTrMallocDefault(size_t,int,const char[],const char[],void**);
 PETSC_EXTERN PetscErrorCode PetscTrFreeDefault(void*,int,const char[],const char[]);
 PETSC_EXTERN PetscErrorCode PetscTrReallocDefault(size_t,int,const char[],const char[],void**);
+PETSC_INTERN PetscErrorCode PetscMallocPagesView_Private(FILE*,PetscMPIInt);
 
 
 #define CLASSID_VALUE  ((PetscClassId) 0xf0e0d0c9)
@@ -59,6 +60,13 @@ static TRSPACE   *TRhead      = NULL;
 static int       TRid         = 0;
 static PetscBool TRdebugLevel = PETSC_FALSE;
 static size_t    TRMaxMem     = 0;
+/*
+      Stack of maximums used by PetscMallocPushMaximumUsage()/PetscMallocPopMaximumUsage()
+*/
+#define MAXTRMAXMEMS 50
+static int        NumTRMaxMems = 0;
+static size_t     TRMaxMems[MAXTRMAXMEMS];
+static int        TRMaxMemsEvents[MAXTRMAXMEMS];
 /*
       Arrays to log information on all Mallocs
 */
@@ -82,6 +90,7 @@ PETSC_INTERN PetscErrorCode PetscSetUseTrMalloc_Private(void)
   TRid              = 0;
   TRdebugLevel      = PETSC_FALSE;
   TRMaxMem          = 0;
+  NumTRMaxMems      = 0;
   PetscLogMallocMax = 10000;
   PetscLogMalloc    = -1;
   PetscFunctionReturn(0);
@@ -200,6 +209,12 @@ PetscErrorCode  PetscTrMallocDefault(size_t a,int lineno,const char function[],c
 
   TRallocated += nsize;
   if (TRallocated > TRMaxMem) TRMaxMem = TRallocated;
+  if (NumTRMaxMems) {
+    int i;
+    for (i=0; i<PetscMin(NumTRMaxMems,MAXTRMAXMEMS); i++) {
+      if (TRallocated > TRMaxMems[i]) TRMaxMems[i] = TRallocated;
+    }
+  }
   TRfrags++;
 
 #if defined(PETSC_USE_DEBUG)
@@ -409,6 +424,12 @@ PetscErrorCode PetscTrReallocDefault(size_t len, int lineno, const char function
 
   TRallocated += nsize;
   if (TRallocated > TRMaxMem) TRMaxMem = TRallocated;
+  if (NumTRMaxMems) {
+    int i;
+    for (i=0; i<PetscMin(NumTRMaxMems,MAXTRMAXMEMS); i++) {
+      if (TRallocated > TRMaxMems[i]) TRMaxMems[i] = TRallocated;
+    }
+  }
   TRfrags++;
 
 #if defined(PETSC_USE_DEBUG)
@@ -575,6 +596,63 @@ PetscErrorCode  PetscMallocGetMaximumUsage(PetscLogDouble *space)
   PetscFunctionReturn(0);
 }
 
+/*@
+    PetscMallocPushMaximumUsage - starts tracking the maximum amount of memory PetscMalloc()ed from now on,
+        independently of the maximum over the whole run
+
+    Not Collective
+
+    Input Parameter:
+.   event - an identifier, for example a PetscLogEvent, that must be passed to the matching PetscMallocPopMaximumUsage()
+
+    Notes:
+    The calls may be nested. The memory is only tracked when PETSc's tracing malloc is used, that is
+    with -malloc or in a debug build; otherwise PetscMallocPopMaximumUsage() returns zero.
+
+    Level: developer
+
+    Concepts: memory usage
+
+.seealso: PetscMallocPopMaximumUsage(), PetscMallocGetMaximumUsage(), PetscMallocGetCurrentUsage()
+ @*/
+PetscErrorCode PetscMallocPushMaximumUsage(int event)
+{
+  PetscFunctionBegin;
+  if (NumTRMaxMems++ >= MAXTRMAXMEMS) PetscFunctionReturn(0);
+  TRMaxMems[NumTRMaxMems-1]       = TRallocated;
+  TRMaxMemsEvents[NumTRMaxMems-1] = event;
+  PetscFunctionReturn(0);
+}
+
+/*@
+    PetscMallocPopMaximumUsage - gets the maximum amount of memory PetscMalloc()ed since the matching
+        PetscMallocPushMaximumUsage()
+
+    Not Collective
+
+    Input Parameter:
+.   event - the identifier passed to PetscMallocPushMaximumUsage()
+
+    Output Parameter:
+.   mu - maximum number of bytes allocated at one time since the push, including what was allocated before it
+
+    Level: developer
+
+    Concepts: memory usage
+
+.seealso: PetscMallocPushMaximumUsage(), PetscMallocGetMaximumUsage(), PetscMallocGetCurrentUsage()
+ @*/
+PetscErrorCode PetscMallocPopMaximumUsage(int event,PetscLogDouble *mu)
+{
+  PetscFunctionBegin;
+  *mu = 0;
+  if (!NumTRMaxMems) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"PetscMallocPopMaximumUsage() called without a matching PetscMallocPushMaximumUsage()");
+  if (NumTRMaxMems-- > MAXTRMAXMEMS) PetscFunctionReturn(0);
+  if (TRMaxMemsEvents[NumTRMaxMems] != event) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"PetscMallocPopMaximumUsage() event does not match the last PetscMallocPushMaximumUsage()");
+  *mu = (PetscLogDouble) TRMaxMems[NumTRMaxMems];
+  PetscFunctionReturn(0);
+}
+
 #if defined(PETSC_USE_DEBUG)
 /*@C
    PetscMallocGetStack - returns a pointer to the stack for the location in the program a call to PetscMalloc() was used to obtain that memory
@@ -836,6 +914,7 @@ foundit:;
   free(shortlength);
   free(shortcount);
   free((char**)shortfunction);
+  ierr = PetscMallocPagesView_Private(fp,rank);CHKERRQ(ierr);
   err = fflush(fp);
   if (err) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"fflush() failed on file");
   if (rank != size-1) {
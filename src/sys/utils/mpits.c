@@ -8,6 +8,7 @@ const char *const PetscBuildTwoSidedTypes[] = {
   "ALLREDUCE",
   "IBARRIER",
   "REDSCATTER",
+  "HIERARCHICAL",
   "PetscBuildTwoSidedType",
   "PETSC_BUILDTWOSIDED_",
   0
@@ -238,6 +239,151 @@ static PetscErrorCode PetscCommBuildTwoSided_RedScatter(MPI_Comm comm,PetscMPIIn
 }
 #endif
 
+#if (defined(PETSC_HAVE_MPI_IBARRIER) || defined(PETSC_HAVE_MPIX_IBARRIER)) && defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+/*
+   The ranks hand their messages to the first rank of their shared memory node. This leader scatters the messages
+   addressed to its node and combines the others into one message per destination rank, which go through the
+   MPI_Ibarrier rendezvous. Only the leaders hold more than their own messages, those of their node.
+*/
+static PetscErrorCode PetscCommBuildTwoSided_Hierarchical(MPI_Comm comm,PetscMPIInt count,MPI_Datatype dtype,PetscMPIInt nto,const PetscMPIInt *toranks,const void *todata,PetscMPIInt *nfrom,PetscMPIInt **fromranks,void *fromdata)
+{
+  PetscErrorCode ierr;
+  PetscShmComm   pshmcomm;
+  MPI_Comm       nodecomm;
+  PetscMPIInt    rank,tag,noderank,nodesize,nrecs = 0,noff = 0,nsends = 0,nrecvs,done,i,j,k,n;
+  PetscMPIInt    *counts = NULL,*displs = NULL,*dest = NULL,*perm = NULL,*lrank = NULL,*franks;
+  MPI_Aint       lb,unitbytes;
+  size_t         datbytes,fwdbytes,recbytes;
+  char           *tobuf,*nodebuf = NULL,*localbuf = NULL,*offbuf = NULL,*buf,*fdata;
+  MPI_Request    *sendreqs = NULL,barrier;
+  PetscSegBuffer segrec;
+  PetscBool      barrier_started;
+
+  PetscFunctionBegin;
+  ierr = PetscCommDuplicate(comm,&comm,&tag);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Type_get_extent(dtype,&lb,&unitbytes);CHKERRQ(ierr);
+  if (lb != 0) SETERRQ1(comm,PETSC_ERR_SUP,"Datatype with nonzero lower bound %ld\n",(long)lb);
+  ierr = PetscShmCommGet(comm,&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&nodecomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(nodecomm,&noderank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(nodecomm,&nodesize);CHKERRQ(ierr);
+  /* A record is the destination rank, the source rank and the data; the destination is dropped when it is forwarded */
+  datbytes = count*unitbytes;
+  fwdbytes = sizeof(PetscMPIInt)+datbytes;
+  recbytes = sizeof(PetscMPIInt)+fwdbytes;
+
+  /* Gather the records of the node on the leader */
+  ierr = PetscMalloc(nto*recbytes,&tobuf);CHKERRQ(ierr);
+  for (i=0; i<nto; i++) {
+    buf  = tobuf+i*recbytes;
+    ierr = PetscMemcpy(buf,&toranks[i],sizeof(PetscMPIInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(buf+sizeof(PetscMPIInt),&rank,sizeof(PetscMPIInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(buf+2*sizeof(PetscMPIInt),(const char*)todata+i*datbytes,datbytes);CHKERRQ(ierr);
+  }
+  ierr = PetscMPIIntCast(nto*recbytes,&n);CHKERRQ(ierr);
+  if (!noderank) {ierr = PetscMalloc2(nodesize,&counts,nodesize+1,&displs);CHKERRQ(ierr);}
+  ierr = MPI_Gather(&n,1,MPI_INT,counts,1,MPI_INT,0,nodecomm);CHKERRQ(ierr);
+  if (!noderank) {
+    displs[0] = 0;
+    for (i=0; i<nodesize; i++) {ierr = PetscMPIIntCast((PetscInt64)displs[i]+counts[i],&displs[i+1]);CHKERRQ(ierr);}
+    nrecs = displs[nodesize]/recbytes;
+    ierr  = PetscMalloc(displs[nodesize],&nodebuf);CHKERRQ(ierr);
+  }
+  ierr = MPI_Gatherv(tobuf,n,MPI_BYTE,nodebuf,counts,displs,MPI_BYTE,0,nodecomm);CHKERRQ(ierr);
+  ierr = PetscFree(tobuf);CHKERRQ(ierr);
+
+  /* The leader sorts the records into those for its node, by node rank, and the others, by destination rank */
+  if (!noderank) {
+    ierr = PetscMalloc3(nrecs,&dest,nrecs,&perm,nrecs,&lrank);CHKERRQ(ierr);
+    ierr = PetscMemzero(counts,nodesize*sizeof(PetscMPIInt));CHKERRQ(ierr);
+    for (i=0; i<nrecs; i++) {
+      PetscMPIInt d;
+      ierr = PetscMemcpy(&d,nodebuf+i*recbytes,sizeof(PetscMPIInt));CHKERRQ(ierr);
+      ierr = PetscShmCommGlobalToLocal(pshmcomm,d,&lrank[i]);CHKERRQ(ierr);
+      if (lrank[i] != MPI_PROC_NULL) counts[lrank[i]] += fwdbytes;
+      else {dest[noff] = d; perm[noff++] = i;}
+    }
+    displs[0] = 0;
+    for (i=0; i<nodesize; i++) {displs[i+1] = displs[i]+counts[i]; counts[i] = 0;}
+    ierr = PetscMalloc2(displs[nodesize],&localbuf,noff*fwdbytes,&offbuf);CHKERRQ(ierr);
+    for (i=0; i<nrecs; i++) {
+      if (lrank[i] == MPI_PROC_NULL) continue;
+      ierr = PetscMemcpy(localbuf+displs[lrank[i]]+counts[lrank[i]],nodebuf+i*recbytes+sizeof(PetscMPIInt),fwdbytes);CHKERRQ(ierr);
+      counts[lrank[i]] += fwdbytes;
+    }
+    ierr = PetscSortMPIIntWithArray(noff,dest,perm);CHKERRQ(ierr);
+    for (i=0; i<noff; i++) {
+      ierr = PetscMemcpy(offbuf+i*fwdbytes,nodebuf+perm[i]*recbytes+sizeof(PetscMPIInt),fwdbytes);CHKERRQ(ierr);
+      if (!i || dest[i] != dest[i-1]) nsends++;
+    }
+    ierr = PetscFree(nodebuf);CHKERRQ(ierr);
+  }
+
+  /* Deliver the records within the node */
+  ierr = PetscSegBufferCreate(fwdbytes,4,&segrec);CHKERRQ(ierr);
+  ierr = MPI_Scatter(counts,1,MPI_INT,&n,1,MPI_INT,0,nodecomm);CHKERRQ(ierr);
+  nrecvs = n/fwdbytes;
+  ierr = PetscSegBufferGet(segrec,nrecvs,&buf);CHKERRQ(ierr);
+  ierr = MPI_Scatterv(localbuf,counts,displs,MPI_BYTE,buf,n,MPI_BYTE,0,nodecomm);CHKERRQ(ierr);
+
+  /* The leaders send one message to each destination rank off the node, all ranks take part in the rendezvous */
+  ierr = PetscMalloc1(nsends,&sendreqs);CHKERRQ(ierr);
+  for (i=0,k=0; i<noff; i=j,k++) {
+    for (j=i+1; j<noff && dest[j] == dest[i]; j++) ;
+    ierr = PetscMPIIntCast((j-i)*fwdbytes,&n);CHKERRQ(ierr);
+    ierr = MPI_Issend(offbuf+i*fwdbytes,n,MPI_BYTE,dest[i],tag,comm,sendreqs+k);CHKERRQ(ierr);
+  }
+  barrier = MPI_REQUEST_NULL;
+  barrier_started = PETSC_FALSE;
+  for (done=0; !done; ) {
+    PetscMPIInt flag;
+    MPI_Status  status;
+    ierr = MPI_Iprobe(MPI_ANY_SOURCE,tag,comm,&flag,&status);CHKERRQ(ierr);
+    if (flag) {                 /* incoming message */
+      ierr    = MPI_Get_count(&status,MPI_BYTE,&n);CHKERRQ(ierr);
+      ierr    = PetscSegBufferGet(segrec,n/fwdbytes,&buf);CHKERRQ(ierr);
+      ierr    = MPI_Recv(buf,n,MPI_BYTE,status.MPI_SOURCE,tag,comm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+      nrecvs += n/fwdbytes;
+    }
+    if (!barrier_started) {
+      PetscMPIInt sent;
+      ierr = MPI_Testall(nsends,sendreqs,&sent,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+      if (sent) {
+#if defined(PETSC_HAVE_MPI_IBARRIER)
+        ierr = MPI_Ibarrier(comm,&barrier);CHKERRQ(ierr);
+#elif defined(PETSC_HAVE_MPIX_IBARRIER)
+        ierr = MPIX_Ibarrier(comm,&barrier);CHKERRQ(ierr);
+#endif
+        barrier_started = PETSC_TRUE;
+      }
+    } else {
+      ierr = MPI_Test(&barrier,&done,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFree(sendreqs);CHKERRQ(ierr);
+  ierr = PetscFree2(localbuf,offbuf);CHKERRQ(ierr);
+  ierr = PetscFree3(dest,perm,lrank);CHKERRQ(ierr);
+  ierr = PetscFree2(counts,displs);CHKERRQ(ierr);
+
+  /* Split the records into the source ranks and their data */
+  ierr = PetscSegBufferExtractInPlace(segrec,&buf);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nrecvs,&franks);CHKERRQ(ierr);
+  ierr = PetscMalloc(nrecvs*datbytes,&fdata);CHKERRQ(ierr);
+  for (i=0; i<nrecvs; i++) {
+    ierr = PetscMemcpy(&franks[i],buf+i*fwdbytes,sizeof(PetscMPIInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(fdata+i*datbytes,buf+i*fwdbytes+sizeof(PetscMPIInt),datbytes);CHKERRQ(ierr);
+  }
+  ierr = PetscSegBufferDestroy(&segrec);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
+
+  *nfrom            = nrecvs;
+  *fromranks        = franks;
+  *(void**)fromdata = fdata;
+  PetscFunctionReturn(0);
+}
+#endif
+
 /*@C
    PetscCommBuildTwoSided - discovers communicating ranks given one-sided information, moving constant-sized data in the process (often message lengths)
 
@@ -259,12 +405,16 @@ static PetscErrorCode PetscCommBuildTwoSided_RedScatter(MPI_Comm comm,PetscMPIIn
    Level: developer
 
    Options Database Keys:
-.  -build_twosided <allreduce|ibarrier|redscatter> - algorithm to set up two-sided communication
+.  -build_twosided <allreduce|ibarrier|redscatter|hierarchical> - algorithm to set up two-sided communication
 
    Notes:
    This memory-scalable interface is an alternative to calling PetscGatherNumberOfMessages() and
    PetscGatherMessageLengths(), possibly with a subsequent round of communication to send other constant-size data.
 
+   With hierarchical, the messages go through the first rank of each shared memory node (see PetscShmCommGet()), which
+   sends at most one message to each rank off the node; this reduces the number of messages in the rendezvous when
+   many ranks share a node.
+
    Basic data types as well as contiguous types are supported, but non-contiguous (e.g., strided) types are not.
 
    References:
@@ -299,6 +449,13 @@ PetscErrorCode PetscCommBuildTwoSided(MPI_Comm comm,PetscMPIInt count,MPI_Dataty
     ierr = PetscCommBuildTwoSided_RedScatter(comm,count,dtype,nto,toranks,todata,nfrom,fromranks,fromdata);CHKERRQ(ierr);
 #else
     SETERRQ(comm,PETSC_ERR_PLIB,"MPI implementation does not provide MPI_Reduce_scatter_block (part of MPI-2.2)");
+#endif
+    break;
+  case PETSC_BUILDTWOSIDED_HIERARCHICAL:
+#if (defined(PETSC_HAVE_MPI_IBARRIER) || defined(PETSC_HAVE_MPIX_IBARRIER)) && defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    ierr = PetscCommBuildTwoSided_Hierarchical(comm,count,dtype,nto,toranks,todata,nfrom,fromranks,fromdata);CHKERRQ(ierr);
+#else
+    SETERRQ(comm,PETSC_ERR_PLIB,"MPI implementation does not provide MPI_Ibarrier and shared memory communicators (part of MPI-3)");
 #endif
     break;
   default: SETERRQ(comm,PETSC_ERR_PLIB,"Unknown method for building two-sided communication");
@@ -567,6 +724,7 @@ PetscErrorCode PetscCommBuildTwoSidedFReq(MPI_Comm comm,PetscMPIInt count,MPI_Da
     break;
   case PETSC_BUILDTWOSIDED_ALLREDUCE:
   case PETSC_BUILDTWOSIDED_REDSCATTER:
+  case PETSC_BUILDTWOSIDED_HIERARCHICAL:
     f = PetscCommBuildTwoSidedFReq_Reference;
     break;
   default: SETERRQ(comm,PETSC_ERR_PLIB,"Unknown method for building two-sided communication");
@@ -676,4 +676,26 @@ PetscErrorCode IJacobian(TS ts,PetscReal t,Vec U,Vec Udot,PetscReal a,Mat A,Mat
       args: -ts_max_steps 10 -ts_monitor -ts_adjoint_monitor -ts_trajectory_type memory -ts_trajectory_solution_only 0 -dm_mat_type sell -pc_type jacobi
       output_file: output/ex5adj_sell_6.out
 
+   test:
+      suffix: aijsellauto
+      nsize: 4
+      args: -forwardonly -ts_max_steps 10 -ts_monitor -snes_monitor_short -mat_aij_sell_padding 1 -pc_type none
+      output_file: output/ex5adj_sell_1.out
+
+   test:
+      suffix: aijsellauto6
+      args: -ts_max_steps 10 -ts_monitor -ts_adjoint_monitor -ts_trajectory_type memory -ts_trajectory_solution_only 0 -mat_aij_sell_padding 1 -pc_type jacobi
+      output_file: output/ex5adj_sell_6.out
+
+   test:
+      suffix: aijomp
+      nsize: 4
+      args: -forwardonly -ts_max_steps 10 -ts_monitor -snes_monitor_short -dm_mat_type aijomp -mat_aijomp_threads 3 -pc_type none
+      output_file: output/ex5adj_sell_1.out
+
+   test:
+      suffix: aijomp2
+      args: -ts_max_steps 10 -ts_monitor -ts_adjoint_monitor -da_grid_x 16 -da_grid_y 16 -dm_mat_type aijomp -mat_aijomp_threads 3 -mat_aijomp_first_touch
+      output_file: output/ex5adj_1.out
+
 TEST*/
@@ -0,0 +1,77 @@
+
+static char help[] = "Tests ISCompress() and ISCreateCompressed().\n\n";
+
+/*T
+    Concepts: index sets^compressing
+    Description:  Creates general index sets with stride, block and no structure and converts them.
+T*/
+
+#include <petscis.h>
+#include <petscviewer.h>
+
+/* creates a general index set with the indices idx, compresses it and views it */
+static PetscErrorCode TestCompress(PetscInt n,const PetscInt idx[],PetscInt bs)
+{
+  PetscErrorCode ierr;
+  IS             is,cis;
+  ISType         type;
+  PetscBool      equal;
+
+  PetscFunctionBeginUser;
+  ierr = ISCreateGeneral(PETSC_COMM_WORLD,n,idx,PETSC_COPY_VALUES,&is);CHKERRQ(ierr);
+  if (bs > 1) {ierr = ISSetBlockSize(is,bs);CHKERRQ(ierr);}
+  ierr = ISCreateCompressed(is,&cis);CHKERRQ(ierr);
+  ierr = ISCompress(is);CHKERRQ(ierr);
+  ierr = ISEqual(is,cis,&equal);CHKERRQ(ierr);
+  if (!equal) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"ISCompress() and ISCreateCompressed() give different indices");
+  ierr = ISGetType(is,&type);CHKERRQ(ierr);
+  ierr = ISGetBlockSize(is,&bs);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Type %s block size %D\n",type,bs);CHKERRQ(ierr);
+  ierr = ISView(is,PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+  ierr = ISDestroy(&cis);CHKERRQ(ierr);
+  ierr = ISDestroy(&is);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank;
+  PetscInt       i,idx[8];
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+
+  /* evenly spaced: a stride */
+  for (i=0; i<4; i++) idx[i] = 3*(4*rank+i)+1;
+  ierr = TestCompress(4,idx,1);CHKERRQ(ierr);
+
+  /* consecutive with a block size: a stride that keeps it */
+  for (i=0; i<4; i++) idx[i] = 4*rank+i;
+  ierr = TestCompress(4,idx,2);CHKERRQ(ierr);
+
+  /* the first two components of an interlaced vector with four components per node: blocks of 2 */
+  for (i=0; i<8; i++) idx[i] = 16*rank+4*(i/2)+i%2;
+  ierr = TestCompress(8,idx,1);CHKERRQ(ierr);
+
+  /* a stride on the first process only: blocks of 4 on all of them */
+  for (i=0; i<8; i++) idx[i] = rank ? 16*rank+8*(i/4)+i%4 : i;
+  ierr = TestCompress(rank ? 8 : 4,idx,1);CHKERRQ(ierr);
+
+  /* no structure: unchanged */
+  idx[0] = 8*rank; idx[1] = 8*rank+1; idx[2] = 8*rank+2; idx[3] = 8*rank+5;
+  ierr = TestCompress(4,idx,1);CHKERRQ(ierr);
+
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 2
+
+TEST*/
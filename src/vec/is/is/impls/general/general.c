@@ -565,6 +565,64 @@ PetscErrorCode  ISToGeneral_General(IS is)
   PetscFunctionReturn(0);
 }
 
+PETSC_STATIC_INLINE PetscInt ISGCD_Private(PetscInt a,PetscInt b)
+{
+  while (b) {PetscInt t = a % b; a = b; b = t;}
+  return a;
+}
+
+/*
+   The indices become a stride when they are one on all processes, otherwise blocks when they are made of runs of
+   consecutive indices aligned to a common block size. The block size of the index set is kept if it is larger than 1.
+*/
+static PetscErrorCode ISCompress_General(IS is,IS *cis)
+{
+  PetscErrorCode ierr;
+  IS_General     *sub = (IS_General*)is->data;
+  const PetscInt *idx = sub->idx;
+  PetscInt       n = is->map->n,bs = is->map->bs,step = 1,g = 0,i,j,vals[3];
+  PetscBool      stride = PETSC_TRUE;
+  PetscMPIInt    size;
+  MPI_Comm       comm;
+
+  PetscFunctionBegin;
+  *cis = NULL;
+  ierr = PetscObjectGetComm((PetscObject)is,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (n > 1) {
+    step = idx[1] - idx[0];
+    if (!step || (bs > 1 && step != 1)) stride = PETSC_FALSE;
+    for (i=2; stride && i<n; i++) if (idx[i] != idx[0] + i*step) stride = PETSC_FALSE;
+  }
+  /* largest block size dividing the length and the first index of every run */
+  if (!stride || size > 1) {
+    for (i=0; i<n && g != 1; i=j) {
+      if (idx[i] < 0) {g = 1; break;}
+      for (j=i+1; j<n && idx[j] == idx[j-1]+1; j++) ;
+      g = ISGCD_Private(ISGCD_Private(g,j-i),idx[i]);
+    }
+    if (bs > 1) g = (g % bs) ? 1 : bs;
+  }
+  vals[0] = stride ? 0 : 1;
+  vals[1] = n ? g : 0;
+  vals[2] = n ? -g : -PETSC_MAX_INT;
+  if (size > 1) {ierr = MPIU_Allreduce(MPI_IN_PLACE,vals,3,MPIU_INT,MPI_MAX,comm);CHKERRQ(ierr);}
+  if (!vals[0]) {
+    ierr = ISCreateStride(comm,n,n ? idx[0] : 0,step,cis);CHKERRQ(ierr);
+    if (bs > 1) {ierr = ISSetBlockSize(*cis,bs);CHKERRQ(ierr);}
+  } else if (vals[1] > 1 && vals[1] == -vals[2]) {
+    PetscInt *bidx;
+
+    bs   = vals[1];
+    ierr = PetscMalloc1(n/bs,&bidx);CHKERRQ(ierr);
+    for (i=0; i<n/bs; i++) bidx[i] = idx[i*bs]/bs;
+    ierr = ISCreateBlock(comm,bs,n/bs,bidx,PETSC_OWN_POINTER,cis);CHKERRQ(ierr);
+  } else PetscFunctionReturn(0);
+  (*cis)->isperm     = is->isperm;
+  (*cis)->isidentity = is->isidentity;
+  PetscFunctionReturn(0);
+}
+
 static struct _ISOps myops = { ISGetSize_General,
                                ISGetLocalSize_General,
                                ISGetIndices_General,
@@ -583,7 +641,8 @@ static struct _ISOps myops = { ISGetSize_General,
                                ISOnComm_General,
                                ISSetBlockSize_General,
                                ISContiguousLocal_General,
-                               ISLocate_General};
+                               ISLocate_General,
+                               ISCompress_General};
 
 PETSC_INTERN PetscErrorCode ISSetUp_General(IS);
 
@@ -1129,6 +1129,101 @@ PetscErrorCode  ISToGeneral(IS is)
   PetscFunctionReturn(0);
 }
 
+/*@
+   ISCompress - Converts an index set to a stride or block index set when its indices have this structure
+
+   Collective on IS
+
+   Input Parameter:
+.  is - the index set
+
+   Notes:
+   An ISGENERAL becomes an ISSTRIDE when its indices are evenly spaced on all processes, otherwise an ISBLOCK when
+   they are made of runs of consecutive indices that start at a multiple of a common block size, for example the
+   fields of an interlaced vector or the index sets of a DMDA. Otherwise, and for the other types, nothing changes. The
+   conversion keeps the block size of the index set if it is larger than 1.
+
+   The index array is then no longer stored, and VecScatterCreate() and MatCreateSubMatrix() take their special cases
+   for these types. VecScatterCreate() also detects this structure by itself for the scatters involving parallel
+   vectors, and MatCreateSubMatrix() detects strides, see ISCreateCompressed().
+
+   Level: intermediate
+
+   Concepts: index sets^compressing
+
+.seealso: ISCreateCompressed(), ISToGeneral(), ISCreateStride(), ISCreateBlock()
+@*/
+PetscErrorCode ISCompress(IS is)
+{
+  PetscErrorCode ierr;
+  IS             cis;
+  PetscInt       n,bs,first,step;
+  PetscBool      stride,isperm,isidentity;
+  const PetscInt *bidx;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(is,IS_CLASSID,1);
+  if (!is->ops->compress) PetscFunctionReturn(0);
+  ierr = (*is->ops->compress)(is,&cis);CHKERRQ(ierr);
+  if (!cis) PetscFunctionReturn(0);
+  isperm     = is->isperm;
+  isidentity = is->isidentity;
+  ierr = PetscObjectTypeCompare((PetscObject)cis,ISSTRIDE,&stride);CHKERRQ(ierr);
+  if (stride) {
+    ierr = ISGetLocalSize(cis,&n);CHKERRQ(ierr);
+    ierr = ISStrideGetInfo(cis,&first,&step);CHKERRQ(ierr);
+    ierr = ISSetType(is,ISSTRIDE);CHKERRQ(ierr);
+    ierr = ISStrideSetStride(is,n,first,step);CHKERRQ(ierr);
+  } else {
+    ierr = ISGetBlockSize(cis,&bs);CHKERRQ(ierr);
+    ierr = ISBlockGetLocalSize(cis,&n);CHKERRQ(ierr);
+    ierr = ISBlockGetIndices(cis,&bidx);CHKERRQ(ierr);
+    ierr = ISSetType(is,ISBLOCK);CHKERRQ(ierr);
+    ierr = ISBlockSetIndices(is,bs,n,bidx,PETSC_COPY_VALUES);CHKERRQ(ierr);
+    ierr = ISBlockRestoreIndices(cis,&bidx);CHKERRQ(ierr);
+  }
+  is->isperm     = isperm;
+  is->isidentity = isidentity;
+  ierr = ISDestroy(&cis);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   ISCreateCompressed - Creates a stride or block index set with the same indices as an index set that has this structure
+
+   Collective on IS
+
+   Input Parameter:
+.  is - the index set
+
+   Output Parameter:
+.  cis - the stride or block index set, or a new reference to is when its indices have neither structure
+
+   Notes:
+   The structure is detected as in ISCompress() but is is not changed. Destroy cis with ISDestroy() in all cases.
+
+   Level: developer
+
+   Concepts: index sets^compressing
+
+.seealso: ISCompress()
+@*/
+PetscErrorCode ISCreateCompressed(IS is,IS *cis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(is,IS_CLASSID,1);
+  PetscValidPointer(cis,2);
+  *cis = NULL;
+  if (is->ops->compress) {ierr = (*is->ops->compress)(is,cis);CHKERRQ(ierr);}
+  if (!*cis) {
+    ierr = PetscObjectReference((PetscObject)is);CHKERRQ(ierr);
+    *cis = is;
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
    ISSorted - Checks the indices to determine whether they have been sorted.
 
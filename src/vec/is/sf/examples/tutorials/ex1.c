@@ -568,4 +568,100 @@ int main(int argc,char **argv)
       suffix: 9_char
       nsize: 4
       args: -sf_type basic -test_bcast -test_reduce -test_op max -test_char
+   test:
+      suffix: 1_neighbor
+      nsize: 4
+      args: -test_bcast -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 2_neighbor
+      nsize: 4
+      args: -test_reduce -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 4_neighbor
+      nsize: 4
+      args: -test_gather -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 5_neighbor
+      nsize: 4
+      args: -test_scatter -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: bcastop_neighbor
+      nsize: 4
+      args: -test_bcastop -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 8_neighbor
+      nsize: 3
+      args: -test_bcast -test_sf_distribute -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 9_char_neighbor
+      nsize: 4
+      args: -sf_type neighbor -test_bcast -test_reduce -test_op max -test_char
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 1_node
+      nsize: 4
+      args: -test_bcast -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 1_node_coalesce
+      nsize: 4
+      args: -test_bcast -sf_type node -sf_node_size 2 -malloc_coalesce 1
+      output_file: output/ex1_1_node.out
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 2_node
+      nsize: 4
+      args: -test_reduce -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 3_node
+      nsize: 4
+      args: -test_degree -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 4_node
+      nsize: 4
+      args: -test_gather -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 5_node
+      nsize: 4
+      args: -test_scatter -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: bcastop_node
+      nsize: 4
+      args: -test_bcastop -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 8_node
+      nsize: 3
+      args: -test_bcast -test_sf_distribute -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 9_char_node
+      nsize: 4
+      args: -test_bcast -test_reduce -test_op max -test_char -sf_type node -sf_node_size 2
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
 TEST*/
@@ -0,0 +1,224 @@
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFNEIGHBOR shares the graph setup, the pack links and the unpacking with PETSCSFBASIC. The messages to all the
+   remote ranks are exchanged by a single MPI_Ineighbor_alltoallv() on a distributed graph communicator, instead of one
+   persistent request per rank.
+*/
+typedef struct {
+  SFBASICHEADER;
+  MPI_Comm    comms[2];     /* Distributed graph communicators, from the roots to the leaves (bcast) and the reverse (reduce) */
+  PetscMPIInt *rootcounts;  /* Number of units exchanged with each non-distinguished incoming rank */
+  PetscMPIInt *rootdispls;  /* Offset of each non-distinguished incoming rank in the remote part of the root buffer */
+  PetscMPIInt *leafcounts;  /* Number of units exchanged with each non-distinguished root owning rank */
+  PetscMPIInt *leafdispls;  /* Offset of each non-distinguished root owning rank in the leaf buffer */
+} PetscSF_Neighbor;
+
+static PetscErrorCode PetscSFSetUp_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor  *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode    ierr;
+  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt    *rootoffset,*leafoffset;
+  const PetscMPIInt *rootranks,*leafranks,*inranks,*outranks,*inweights,*outweights;
+  PetscMPIInt       indegree,outdegree,empty = 0;
+  MPI_Comm          comm;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(nleafranks-ndleafranks,&indegree);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(nrootranks-ndrootranks,&outdegree);CHKERRQ(ierr);
+
+  ierr = PetscMalloc4(outdegree,&dat->rootcounts,outdegree,&dat->rootdispls,indegree,&dat->leafcounts,indegree,&dat->leafdispls);CHKERRQ(ierr);
+  for (i=ndrootranks; i<nrootranks; i++) {
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&dat->rootcounts[i-ndrootranks]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(rootoffset[i]-rootoffset[ndrootranks],&dat->rootdispls[i-ndrootranks]);CHKERRQ(ierr);
+  }
+  for (i=ndleafranks; i<nleafranks; i++) {
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&dat->leafcounts[i-ndleafranks]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(leafoffset[i]-leafoffset[ndleafranks],&dat->leafdispls[i-ndleafranks]);CHKERRQ(ierr);
+  }
+
+  /*
+     The arrays are NULL when there are no ranks, but MPI expects valid arrays even for a zero degree. The weights of the
+     edges are the numbers of units exchanged, instead of MPI_UNWEIGHTED, which some MPI implementations define as an
+     invalid pointer the compiler warns about.
+  */
+  inranks    = indegree  ? leafranks+ndleafranks : &empty;
+  outranks   = outdegree ? rootranks+ndrootranks : &empty;
+  inweights  = indegree  ? dat->leafcounts : &empty;
+  outweights = outdegree ? dat->rootcounts : &empty;
+
+  /* The roots send to the ranks referencing them and receive from them, the distinguished rank communicates through memory */
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = MPI_Dist_graph_create_adjacent(comm,indegree,inranks,inweights,outdegree,outranks,outweights,MPI_INFO_NULL,0,&dat->comms[0]);CHKERRQ(ierr);
+  ierr = MPI_Dist_graph_create_adjacent(comm,outdegree,outranks,outweights,indegree,inranks,inweights,MPI_INFO_NULL,0,&dat->comms[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscInt         i;
+
+  PetscFunctionBegin;
+  for (i=0; i<2; i++) {
+    if (dat->comms[i] != MPI_COMM_NULL) {ierr = MPI_Comm_free(&dat->comms[i]);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree4(dat->rootcounts,dat->rootdispls,dat->leafcounts,dat->leafdispls);CHKERRQ(ierr);
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Neighbor(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Neighbor(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Starts the exchange of the remote part of the packed buffers of link in the given direction */
+static PetscErrorCode PetscSFNeighborPackStart(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  char             *rootbuf = link->rootbuf + dat->ioffset[dat->ndiranks]*link->unitbytes; /* skips the distinguished rank */
+
+  PetscFunctionBegin;
+  if (direction == PETSC_SF_ROOT2LEAF_BCAST) {
+    ierr = MPI_Ineighbor_alltoallv(rootbuf,dat->rootcounts,dat->rootdispls,link->unit,link->leafbuf,dat->leafcounts,dat->leafdispls,link->unit,dat->comms[0],&link->request);CHKERRQ(ierr);
+  } else {
+    ierr = MPI_Ineighbor_alltoallv(link->leafbuf,dat->leafcounts,dat->leafdispls,link->unit,rootbuf,dat->rootcounts,dat->rootdispls,link->unit,dat->comms[1],&link->request);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nrootranks;
+  const PetscInt   *rootoffset,*rootloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    ierr = PetscSFBasicPackData(link,rootoffset[i+1]-rootoffset[i],rootloc+rootoffset[i],&dat->rootopt[i],rootdata,link->root[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscSFNeighborPackStart(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_Neighbor(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nleafranks;
+  const PetscInt   *leafoffset,*leafloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPack(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) {
+    ierr = PetscSFBasicPackData(link,leafoffset[i+1]-leafoffset[i],leafloc+leafoffset[i],&dat->leafopt[i],leafdata,link->leaf[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscSFNeighborPackStart(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_Neighbor(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Neighbor(sf,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Neighbor(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  void             (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nrootranks,nleafranks;
+  const PetscInt   *rootoffset,*leafoffset,*rootloc,*leafloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+  /* Process local fetch-and-op, send the previous root values back to the leaves */
+  ierr = PetscSFBasicPackGetFetchAndOp(sf,link,op,&FetchAndOp);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    ierr = PetscSFBasicFetchAndOpData(link,FetchAndOp,rootoffset[i+1]-rootoffset[i],rootloc+rootoffset[i],&dat->rootopt[i],rootdata,link->root[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscSFNeighborPackStart(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) {
+    ierr = PetscSFBasicUnpackData(link,link->UnpackInsert,leafoffset[i+1]-leafoffset[i],leafloc+leafoffset[i],&dat->leafopt[i],leafupdate,link->leaf[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFNEIGHBOR - PetscSF implementation that communicates with MPI-3 neighborhood collectives
+
+   Notes:
+   The graph, the buffers and the packing are those of PETSCSFBASIC, but each operation exchanges the messages
+   of all the ranks with a single MPI_Ineighbor_alltoallv() on a distributed graph communicator created by
+   PetscSFSetUp(). This leaves the scheduling of the messages to the MPI implementation and avoids the cost
+   of starting and completing one request per rank.
+
+   Level: advanced
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PETSCSFWINDOW
+M*/
+
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Neighbor;
+  sf->ops->Reset           = PetscSFReset_Neighbor;
+  sf->ops->Destroy         = PetscSFDestroy_Neighbor;
+  sf->ops->View            = PetscSFView_Basic;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_Neighbor;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_Basic;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_Neighbor;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_Basic;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Neighbor;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Basic;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Neighbor;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Neighbor;
+  sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  dat->persistent = PETSC_FALSE;
+  dat->comms[0]   = MPI_COMM_NULL;
+  dat->comms[1]   = MPI_COMM_NULL;
+  sf->data        = (void*)dat;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,474 @@
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFNODE routes the graph in two levels. The edges between ranks of the same node go through PETSCSFBASIC on the
+   node communicator. The data of the other edges is gathered on the leader (rank 0) of the node of the root, sent in
+   one message per pair of nodes to the leader of the node of the leaf, and scattered there to the leaves:
+
+     roots --gather--> send buffer of the leader --leaders--> receive buffer of the leader --scatter--> leaves
+     roots --local-------------------------------------------------------------------------------------> leaves
+
+   Each buffer entry carries exactly one edge, so the reductions are applied once, by the gather stage at the roots.
+*/
+
+typedef struct _n_PetscSFNodeLink *PetscSFNodeLink;
+struct _n_PetscSFNodeLink {
+  MPI_Datatype    unit;
+  PetscBool       isbuiltin;
+  const void      *key;
+  char            *sendbuf;      /* Off-node data leaving the node, on the leader */
+  char            *recvbuf;      /* Off-node data arriving at the node, on the leader */
+  PetscSFNodeLink next;
+};
+
+typedef struct {
+  SFBASICHEADER;
+  PetscMPIInt     nodesize;      /* Size of the emulated nodes, or 0 for the nodes of PetscShmComm */
+  MPI_Comm        nodecomm;      /* The ranks of my node */
+  PetscBool       ownnodecomm;
+  PetscSF         gather;        /* Roots of the node to the send buffer of the leader, on nodecomm */
+  PetscSF         leaders;       /* Send buffers to receive buffers of the leaders */
+  PetscSF         scatter;       /* Receive buffer of the leader to leaves of the node, on nodecomm */
+  PetscSF         local;         /* Edges within the node, on nodecomm */
+  PetscSF         flat;          /* PETSCSFBASIC on the whole graph, for fetch-and-op */
+  PetscInt        nsend,nrecv;   /* Lengths of the leader buffers, 0 on the other ranks */
+  PetscSFNodeLink links,linksinuse; /* Leader buffers, available and in use */
+} PetscSF_Node;
+
+static PetscErrorCode PetscSFNodeCreateStage(MPI_Comm comm,PetscInt nroots,PetscInt nleaves,PetscInt *ilocal,PetscSFNode *iremote,PetscSF *stage)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFCreate(comm,stage);CHKERRQ(ierr);
+  ierr = PetscSFSetType(*stage,PETSCSFBASIC);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(*stage,nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(*stage);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetUp_Node(PetscSF sf)
+{
+  PetscSF_Node      *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode    ierr;
+  MPI_Comm          comm;
+  MPI_Group         group,nodegroup;
+  MPI_Request       *reqs;
+  PetscMPIInt       rank,nodesize,noderank,*globranks,*lranks,*leaflrank,*counts = NULL,*displs = NULL,tag,n,nreqs = 0,cnt;
+  PetscInt          i,j,k,nrootranks,nleafranks,nlocal = 0,noffleaf = 0,noffroot = 0,nmsgroot = 0,nmsgleaf = 0,sendoff = 0,recvoff = 0,nsend = 0,nrecv = 0;
+  PetscInt          *sbuf,*rbuf,*ilocal,*cilocal;
+  const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
+  const PetscMPIInt *rootranks,*leafranks;
+  PetscSFNode       *remote,*cremote,*bremote,*aremote,*gremote = NULL;
+  PetscBool         *rootoff;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+
+  /* The node communicator and the global ranks of the node, sorted for lookup */
+  if (dat->nodesize > 0) {
+    ierr = MPI_Comm_split(comm,rank/dat->nodesize,rank,&dat->nodecomm);CHKERRQ(ierr);
+    dat->ownnodecomm = PETSC_TRUE;
+  } else {
+    PetscShmComm shmcomm;
+    ierr = PetscShmCommGet(comm,&shmcomm);CHKERRQ(ierr);
+    ierr = PetscShmCommGetMpiShmComm(shmcomm,&dat->nodecomm);CHKERRQ(ierr);
+    dat->ownnodecomm = PETSC_FALSE;
+  }
+  ierr = MPI_Comm_size(dat->nodecomm,&nodesize);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(dat->nodecomm,&noderank);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nodesize,&globranks,nodesize,&lranks);CHKERRQ(ierr);
+  for (i=0; i<nodesize; i++) lranks[i] = i;
+  ierr = MPI_Comm_group(comm,&group);CHKERRQ(ierr);
+  ierr = MPI_Comm_group(dat->nodecomm,&nodegroup);CHKERRQ(ierr);
+  ierr = MPI_Group_translate_ranks(nodegroup,nodesize,lranks,group,globranks);CHKERRQ(ierr);
+  ierr = MPI_Group_free(&group);CHKERRQ(ierr);
+  ierr = MPI_Group_free(&nodegroup);CHKERRQ(ierr);
+  ierr = PetscSortMPIIntWithArray(nodesize,globranks,lranks);CHKERRQ(ierr);
+
+  /* Classify the ranks of the leaves and the roots as on or off the node */
+  ierr = PetscMalloc2(nleafranks,&leaflrank,nrootranks,&rootoff);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) {
+    ierr = PetscFindMPIInt(leafranks[i],nodesize,globranks,&k);CHKERRQ(ierr);
+    leaflrank[i] = (k < 0) ? MPI_PROC_NULL : lranks[k];
+    if (k < 0) {noffleaf += leafoffset[i+1]-leafoffset[i]; nmsgleaf++;}
+    else nlocal += leafoffset[i+1]-leafoffset[i];
+  }
+  for (i=0; i<nrootranks; i++) {
+    ierr = PetscFindMPIInt(rootranks[i],nodesize,globranks,&k);CHKERRQ(ierr);
+    rootoff[i] = (k < 0) ? PETSC_TRUE : PETSC_FALSE;
+    if (k < 0) {noffroot += rootoffset[i+1]-rootoffset[i]; nmsgroot++;}
+  }
+
+  /* Place the off-node entries of the ranks consecutively in the leader buffers */
+  ierr = MPI_Exscan(&noffroot,&sendoff,1,MPIU_INT,MPI_SUM,dat->nodecomm);CHKERRQ(ierr);
+  ierr = MPI_Exscan(&noffleaf,&recvoff,1,MPIU_INT,MPI_SUM,dat->nodecomm);CHKERRQ(ierr);
+  if (!noderank) {sendoff = 0; recvoff = 0;}
+  ierr = MPI_Reduce(&noffroot,&nsend,1,MPIU_INT,MPI_SUM,0,dat->nodecomm);CHKERRQ(ierr);
+  ierr = MPI_Reduce(&noffleaf,&nrecv,1,MPIU_INT,MPI_SUM,0,dat->nodecomm);CHKERRQ(ierr);
+  dat->nsend = noderank ? 0 : nsend;
+  dat->nrecv = noderank ? 0 : nrecv;
+
+  /* Tell the off-node leaves the leader of the root and the slot of the edge in its send buffer */
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&tag);CHKERRQ(ierr);
+  ierr = PetscMalloc3(noffroot+nmsgroot,&sbuf,noffleaf+nmsgleaf,&rbuf,nmsgroot+nmsgleaf,&reqs);CHKERRQ(ierr);
+  for (i=0,j=0,k=0; i<nleafranks; i++) {
+    if (leaflrank[i] != MPI_PROC_NULL) continue;
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i]+1,&n);CHKERRQ(ierr);
+    ierr = MPI_Irecv(rbuf+j,n,MPIU_INT,leafranks[i],tag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+    j   += n;
+  }
+  for (i=0,j=0,k=sendoff; i<nrootranks; i++) {
+    PetscInt l;
+    if (!rootoff[i]) continue;
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i]+1,&n);CHKERRQ(ierr);
+    sbuf[j] = globranks[0];
+    for (l=1; l<n; l++) sbuf[j+l] = k++;
+    ierr = MPI_Isend(sbuf+j,n,MPIU_INT,rootranks[i],tag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+    j   += n;
+  }
+  ierr = MPI_Waitall(nreqs,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+
+  /* The edges within the node, and the scatter from the receive buffer of the leader; the stages own their arrays */
+  ierr = PetscMalloc1(nlocal,&ilocal);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nlocal,&remote);CHKERRQ(ierr);
+  ierr = PetscMalloc1(noffleaf,&cilocal);CHKERRQ(ierr);
+  ierr = PetscMalloc1(noffleaf,&cremote);CHKERRQ(ierr);
+  ierr = PetscMalloc1(noffleaf,&bremote);CHKERRQ(ierr);
+  for (i=0,j=0,k=0,n=0; i<nleafranks; i++) {
+    PetscInt l;
+    if (leaflrank[i] != MPI_PROC_NULL) {
+      for (l=leafoffset[i]; l<leafoffset[i+1]; l++,j++) {
+        ilocal[j]       = leafloc[l];
+        remote[j].rank  = leaflrank[i];
+        remote[j].index = sf->rremote[l];
+      }
+    } else {
+      PetscInt leader = rbuf[n++];
+      for (l=leafoffset[i]; l<leafoffset[i+1]; l++,k++) {
+        cilocal[k]       = leafloc[l];
+        cremote[k].rank  = 0;
+        cremote[k].index = recvoff+k;
+        bremote[k].rank  = leader;
+        bremote[k].index = rbuf[n++];
+      }
+    }
+  }
+  ierr = PetscSFNodeCreateStage(dat->nodecomm,sf->nroots,nlocal,ilocal,remote,&dat->local);CHKERRQ(ierr);
+  ierr = PetscSFNodeCreateStage(dat->nodecomm,dat->nrecv,noffleaf,cilocal,cremote,&dat->scatter);CHKERRQ(ierr);
+
+  /* The leaders collect the edges of their node for the exchange between leaders */
+  if (!noderank) {ierr = PetscMalloc2(nodesize,&counts,nodesize+1,&displs);CHKERRQ(ierr);}
+  ierr = PetscMPIIntCast(noffleaf,&cnt);CHKERRQ(ierr);
+  ierr = MPI_Gather(&cnt,1,MPI_INT,counts,1,MPI_INT,0,dat->nodecomm);CHKERRQ(ierr);
+  if (!noderank) {
+    displs[0] = 0;
+    for (i=0; i<nodesize; i++) {ierr = PetscMPIIntCast(displs[i]+(PetscInt)counts[i],&displs[i+1]);CHKERRQ(ierr);}
+    ierr = PetscMalloc1(dat->nrecv,&gremote);CHKERRQ(ierr);
+  }
+  ierr = MPI_Gatherv(bremote,cnt,MPIU_2INT,gremote,counts,displs,MPIU_2INT,0,dat->nodecomm);CHKERRQ(ierr);
+  ierr = PetscSFNodeCreateStage(comm,dat->nsend,dat->nrecv,NULL,gremote,&dat->leaders);CHKERRQ(ierr);
+
+  /* The roots of the off-node edges, in the order of the send buffer */
+  ierr = PetscMalloc1(noffroot,&aremote);CHKERRQ(ierr);
+  for (i=0,j=0; i<nrootranks; i++) {
+    PetscInt l;
+    if (!rootoff[i]) continue;
+    for (l=rootoffset[i]; l<rootoffset[i+1]; l++,j++) {
+      aremote[j].rank  = noderank;
+      aremote[j].index = rootloc[l];
+    }
+  }
+  gremote = NULL;
+  ierr = PetscMPIIntCast(noffroot,&cnt);CHKERRQ(ierr);
+  ierr = MPI_Gather(&cnt,1,MPI_INT,counts,1,MPI_INT,0,dat->nodecomm);CHKERRQ(ierr);
+  if (!noderank) {
+    for (i=0; i<nodesize; i++) {ierr = PetscMPIIntCast(displs[i]+(PetscInt)counts[i],&displs[i+1]);CHKERRQ(ierr);}
+    ierr = PetscMalloc1(dat->nsend,&gremote);CHKERRQ(ierr);
+  }
+  ierr = MPI_Gatherv(aremote,cnt,MPIU_2INT,gremote,counts,displs,MPIU_2INT,0,dat->nodecomm);CHKERRQ(ierr);
+  ierr = PetscSFNodeCreateStage(dat->nodecomm,sf->nroots,dat->nsend,NULL,gremote,&dat->gather);CHKERRQ(ierr);
+
+  ierr = PetscInfo4(sf,"Node of %d ranks, %D local edges, %D edges leaving and %D arriving through the leader\n",nodesize,nlocal,noffroot,noffleaf);CHKERRQ(ierr);
+  ierr = PetscFree(aremote);CHKERRQ(ierr);
+  ierr = PetscFree2(counts,displs);CHKERRQ(ierr);
+  ierr = PetscFree(bremote);CHKERRQ(ierr);
+  ierr = PetscFree3(sbuf,rbuf,reqs);CHKERRQ(ierr);
+  ierr = PetscFree2(leaflrank,rootoff);CHKERRQ(ierr);
+  ierr = PetscFree2(globranks,lranks);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Node(PetscSF sf)
+{
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link,next;
+
+  PetscFunctionBegin;
+  if (dat->linksinuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  for (link=dat->links; link; link=next) {
+    next = link->next;
+    if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
+    ierr = PetscFree2(link->sendbuf,link->recvbuf);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  dat->links = NULL;
+  ierr = PetscSFDestroy(&dat->gather);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&dat->leaders);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&dat->scatter);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&dat->local);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&dat->flat);CHKERRQ(ierr);
+  if (dat->ownnodecomm) {ierr = MPI_Comm_free(&dat->nodecomm);CHKERRQ(ierr);}
+  dat->nodecomm    = MPI_COMM_NULL;
+  dat->ownnodecomm = PETSC_FALSE;
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Node(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Node(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Node(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+  PetscInt       nodesize = dat->nodesize;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Node options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-sf_node_size","Group this many consecutive ranks as a node instead of the ranks sharing memory","PetscSFSetType",nodesize,&nodesize,NULL);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(nodesize,&dat->nodesize);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Gets the buffers of the leader for an operation on data identified by key */
+static PetscErrorCode PetscSFNodeGetLink(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFNodeLink *mylink)
+{
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link,*p;
+  PetscMPIInt     ni,na,nd,combiner;
+  MPI_Aint        lb,extent;
+
+  PetscFunctionBegin;
+  for (p=&dat->links; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
+    if (match) {
+      *p = link->next;
+      goto found;
+    }
+  }
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = MPI_Type_get_extent(unit,&lb,&extent);CHKERRQ(ierr);
+  /* Never empty, so that the buffers are distinct keys for the operations of the stages */
+  ierr = PetscMalloc2(PetscMax(dat->nsend,1)*extent,&link->sendbuf,PetscMax(dat->nrecv,1)*extent,&link->recvbuf);CHKERRQ(ierr);
+  ierr = MPI_Type_get_envelope(unit,&ni,&na,&nd,&combiner);CHKERRQ(ierr);
+  link->isbuiltin = (combiner == MPI_COMBINER_NAMED) ? PETSC_TRUE : PETSC_FALSE;
+  if (link->isbuiltin) link->unit = unit;
+  else {ierr = MPI_Type_dup(unit,&link->unit);CHKERRQ(ierr);}
+found:
+  link->key       = key;
+  link->next      = dat->linksinuse;
+  dat->linksinuse = link;
+  *mylink         = link;
+  PetscFunctionReturn(0);
+}
+
+/* Takes the link of the operation on key off the list of those in use */
+static PetscErrorCode PetscSFNodeGetLinkInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFNodeLink *mylink)
+{
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link,*p;
+
+  PetscFunctionBegin;
+  for (p=&dat->linksinuse; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
+    if (match && key == link->key) {
+      *p      = link->next;
+      *mylink = link;
+      PetscFunctionReturn(0);
+    }
+  }
+  SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Could not find the buffers of the operation");
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNodeReclaimLink(PetscSF sf,PetscSFNodeLink *link)
+{
+  PetscSF_Node *dat = (PetscSF_Node*)sf->data;
+
+  PetscFunctionBegin;
+  (*link)->key  = NULL;
+  (*link)->next = dat->links;
+  dat->links    = *link;
+  *link         = NULL;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Node(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFNodeGetLink(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(dat->gather,unit,rootdata,link->sendbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(dat->gather,unit,rootdata,link->sendbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(dat->leaders,unit,link->sendbuf,link->recvbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpBegin(dat->local,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Node(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFNodeGetLinkInUse(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(dat->leaders,unit,link->sendbuf,link->recvbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpBegin(dat->scatter,unit,link->recvbuf,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(dat->scatter,unit,link->recvbuf,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(dat->local,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFNodeReclaimLink(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Node(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_Node(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Node(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpEnd_Node(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Node(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFNodeGetLink(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(dat->scatter,unit,leafdata,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(dat->scatter,unit,leafdata,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(dat->leaders,unit,link->recvbuf,link->sendbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(dat->local,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Node(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFNodeGetLinkInUse(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(dat->leaders,unit,link->recvbuf,link->sendbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(dat->gather,unit,link->sendbuf,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(dat->gather,unit,link->sendbuf,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(dat->local,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFNodeReclaimLink(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Fetch-and-op needs the edges in the order of the leaves at each root, it goes through a flat PETSCSFBASIC */
+static PetscErrorCode PetscSFFetchAndOpBegin_Node(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!dat->flat) {
+    ierr = PetscSFCreate(PetscObjectComm((PetscObject)sf),&dat->flat);CHKERRQ(ierr);
+    ierr = PetscSFSetType(dat->flat,PETSCSFBASIC);CHKERRQ(ierr);
+    ierr = PetscSFSetGraph(dat->flat,sf->nroots,sf->nleaves,sf->mine,PETSC_COPY_VALUES,sf->remote,PETSC_COPY_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscSFFetchAndOpBegin(dat->flat,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Node(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFFetchAndOpEnd(dat->flat,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFNODE - PetscSF implementation that aggregates the messages between nodes
+
+   Options Database Keys:
+.  -sf_node_size <n> - group n consecutive ranks as a node, instead of the ranks sharing memory (for testing)
+
+   Notes:
+   The edges between ranks of the same node (those of the communicator of PetscShmCommGet()) are handled by
+   PETSCSFBASIC on the node communicator. The data of the other edges is gathered on the first rank of the node of
+   the root, exchanged between these leaders with a single message per pair of nodes, and distributed to the leaves
+   by the leader of their node. With many ranks per node this replaces the many small messages between the same
+   nodes by one larger message, at the cost of two on-node copies.
+
+   Level: advanced
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PetscShmCommGet()
+M*/
+
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Node(PetscSF sf)
+{
+  PetscSF_Node   *dat;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Node;
+  sf->ops->SetFromOptions  = PetscSFSetFromOptions_Node;
+  sf->ops->Reset           = PetscSFReset_Node;
+  sf->ops->Destroy         = PetscSFDestroy_Node;
+  sf->ops->View            = PetscSFView_Basic;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_Node;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_Node;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_Node;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_Node;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Node;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Node;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Node;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Node;
+  sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  dat->persistent = PETSC_FALSE;
+  dat->nodecomm   = MPI_COMM_NULL;
+  sf->data        = (void*)dat;
+  PetscFunctionReturn(0);
+}
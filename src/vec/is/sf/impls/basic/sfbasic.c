@@ -1,58 +1,5 @@
 
-#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
-
-typedef struct _n_PetscSFBasicPack *PetscSFBasicPack;
-struct _n_PetscSFBasicPack {
-  void (*Pack)(PetscInt,PetscInt,const PetscInt*,const void*,void*);
-  void (*UnpackInsert)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackAdd)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMin)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMax)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMinloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMult)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*FetchAndInsert)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndAdd)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMin)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMax)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMinloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMult)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-
-  MPI_Datatype     unit;
-  PetscBool        isbuiltin;   /* Is unit an MPI builtin datatype? */
-  size_t           unitbytes;   /* Number of bytes in a unit */
-  PetscInt         bs;          /* Number of basic units in a unit */
-  const void       *key;        /* Array used as key for operation */
-  char             **root;      /* Packed root data, indexed by leaf rank */
-  char             **leaf;      /* Packed leaf data, indexed by root rank */
-  MPI_Request      *requests;   /* Array of root requests followed by leaf requests */
-  PetscSFBasicPack next;
-};
-
-typedef struct {
-  PetscMPIInt      tag;
-  PetscMPIInt      niranks;     /* Number of incoming ranks (ranks accessing my roots) */
-  PetscMPIInt      ndiranks;    /* Number of incoming ranks (ranks accessing my roots) in distinguished set */
-  PetscMPIInt      *iranks;     /* Array of ranks that reference my roots */
-  PetscInt         itotal;      /* Total number of graph edges referencing my roots */
-  PetscInt         *ioffset;    /* Array of length niranks+1 holding offset in irootloc[] for each rank */
-  PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */
-  PetscSFBasicPack avail;       /* One or more entries per MPI Datatype, lazily constructed */
-  PetscSFBasicPack inuse;       /* Buffers being used for transactions that have not yet completed */
-} PetscSF_Basic;
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
 
 #if !defined(PETSC_HAVE_MPI_TYPE_DUP)
 PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype)
@@ -74,12 +21,16 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
 #define CPPJoin3_exp_(a,b,c) a ## b ## _ ## c
 #define CPPJoin3_(a,b,c) CPPJoin3_exp_(a,b,c)
 
+/* The kernels take idx = NULL for a contiguous range of entries, see PetscSFBasicPackOpt; the caller then shifts the unpacked pointer */
+#define PackIdx(idx,i) ((idx) ? (idx)[i] : (i))
+
 /* Basic types without addition */
 #define DEF_PackNoInit(type,BS)                                         \
   static void CPPJoin3_(Pack_,type,BS)(PetscInt n,PetscInt bs,const PetscInt *idx,const void *unpacked,void *packed) { \
     const type *u = (const type*)unpacked;                              \
     type *p = (type*)packed;                                            \
     PetscInt i,j,k;                                                     \
+    if (!idx) {PetscMemcpy(p,u,n*bs*sizeof(type)); return;}             \
     for (i=0; i<n; i++)                                                 \
       for (j=0; j<bs; j+=BS)                                            \
         for (k=j; k<j+BS; k++)                                          \
@@ -89,6 +40,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *u = (type*)unpacked;                                          \
     const type *p = (const type*)packed;                                \
     PetscInt i,j,k;                                                     \
+    if (!idx) {PetscMemcpy(u,p,n*bs*sizeof(type)); return;}             \
     for (i=0; i<n; i++)                                                 \
       for (j=0; j<bs; j+=BS)                                            \
         for (k=j; k<j+BS; k++)                                          \
@@ -99,7 +51,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i,j,k;                                                     \
     for (i=0; i<n; i++) {                                               \
-      PetscInt ii = idx[i];                                             \
+      PetscInt ii = PackIdx(idx,i);                                     \
       for (j=0; j<bs; j+=BS)                                            \
         for (k=j; k<j+BS; k++) {                                        \
           type t = u[ii*bs+k];                                          \
@@ -119,14 +71,14 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     for (i=0; i<n; i++)                                                 \
       for (j=0; j<bs; j+=BS)                                            \
         for (k=j; k<j+BS; k++)                                          \
-          u[idx[i]*bs+k] += p[i*bs+k];                                  \
+          u[PackIdx(idx,i)*bs+k] += p[i*bs+k];                          \
   }                                                                     \
   static void CPPJoin3_(FetchAndAdd_,type,BS)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,void *packed) { \
     type *u = (type*)unpacked;                                          \
     type *p = (type*)packed;                                            \
     PetscInt i,j,k;                                                     \
     for (i=0; i<n; i++) {                                               \
-      PetscInt ii = idx[i];                                             \
+      PetscInt ii = PackIdx(idx,i);                                     \
       for (j=0; j<bs; j+=BS)                                            \
         for (k=j; k<j+BS; k++) {                                        \
           type t = u[ii*bs+k];                                          \
@@ -142,14 +94,14 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     for (i=0; i<n; i++)                                                 \
       for (j=0; j<bs; j+=BS)                                            \
         for (k=j; k<j+BS; k++)                                          \
-          u[idx[i]*bs+k] *= p[i*bs+k];                                  \
+          u[PackIdx(idx,i)*bs+k] *= p[i*bs+k];                          \
   }                                                                     \
   static void CPPJoin3_(FetchAndMult_,type,BS)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,void *packed) { \
     type *u = (type*)unpacked;                                          \
     type *p = (type*)packed;                                            \
     PetscInt i,j,k;                                                     \
     for (i=0; i<n; i++) {                                               \
-      PetscInt ii = idx[i];                                             \
+      PetscInt ii = PackIdx(idx,i);                                     \
       for (j=0; j<bs; j+=BS)                                            \
         for (k=j; k<j+BS; k++) {                                        \
           type t = u[ii*bs+k];                                          \
@@ -178,8 +130,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = PetscMax(v,p[i]);                                     \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = PetscMax(v,p[i]);                             \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(UnpackMin_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,const void *packed) { \
@@ -187,8 +139,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = PetscMin(v,p[i]);                                     \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = PetscMin(v,p[i]);                             \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(FetchAndMax_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,void *packed) { \
@@ -196,7 +148,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = PetscMax(v,p[i]);                                          \
       p[i] = v;                                                         \
@@ -207,7 +159,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = PetscMin(v,p[i]);                                          \
       p[i] = v;                                                         \
@@ -235,8 +187,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = v && p[i];                                            \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = v && p[i];                                    \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(UnpackLOR_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,const void *packed) { \
@@ -244,8 +196,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = v || p[i];                                            \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = v || p[i];                                    \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(UnpackLXOR_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,const void *packed) { \
@@ -253,8 +205,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = (!v)!=(!p[i]);                                        \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = (!v)!=(!p[i]);                                \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(FetchAndLAND_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,void *packed) { \
@@ -262,7 +214,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = v && p[i];                                                 \
       p[i] = v;                                                         \
@@ -273,7 +225,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = v || p[i];                                                 \
       p[i] = v;                                                         \
@@ -284,7 +236,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = (!v)!=(!p[i]);                                             \
       p[i] = v;                                                         \
@@ -307,8 +259,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = v & p[i];                                             \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = v & p[i];                                     \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(UnpackBOR_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,const void *packed) { \
@@ -316,8 +268,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = v | p[i];                                             \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = v | p[i];                                     \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(UnpackBXOR_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,const void *packed) { \
@@ -325,8 +277,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const type *p = (const type*)packed;                                \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      type v = u[idx[i]];                                               \
-      u[idx[i]] = v^p[i];                                               \
+      type v = u[PackIdx(idx,i)];                                       \
+      u[PackIdx(idx,i)] = v^p[i];                                       \
     }                                                                   \
   }                                                                     \
   static void CPPJoin2(FetchAndBAND_,type)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,void *packed) { \
@@ -334,7 +286,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = v & p[i];                                                  \
       p[i] = v;                                                         \
@@ -345,7 +297,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = v | p[i];                                                  \
       p[i] = v;                                                         \
@@ -356,7 +308,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     type *p = (type*)packed;                                            \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       type v = u[j];                                                    \
       u[j] = v^p[i];                                                    \
       p[i] = v;                                                         \
@@ -381,7 +333,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const PairType(type1,type2) *p = (const PairType(type1,type2)*)packed; \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       if (p[i].a op u[j].a) {                                           \
         u[j].a = p[i].a;                                                \
         u[j].b = p[i].b;                                                \
@@ -395,7 +347,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     PairType(type1,type2) *p = (PairType(type1,type2)*)packed;          \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       PairType(type1,type2) v;                                          \
       v.a = u[j].a;                                                     \
       v.b = u[j].b;                                                     \
@@ -415,6 +367,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const PairType(type1,type2) *u = (const PairType(type1,type2)*)unpacked; \
     PairType(type1,type2) *p = (PairType(type1,type2)*)packed;          \
     PetscInt i;                                                         \
+    if (!idx) {PetscMemcpy(p,u,n*sizeof(*p)); return;}                  \
     for (i=0; i<n; i++) {                                               \
       p[i].a = u[idx[i]].a;                                             \
       p[i].b = u[idx[i]].b;                                             \
@@ -424,6 +377,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     PairType(type1,type2) *u = (PairType(type1,type2)*)unpacked;       \
     const PairType(type1,type2) *p = (const PairType(type1,type2)*)packed; \
     PetscInt i;                                                         \
+    if (!idx) {PetscMemcpy(u,p,n*sizeof(*p)); return;}                  \
     for (i=0; i<n; i++) {                                               \
       u[idx[i]].a = p[i].a;                                             \
       u[idx[i]].b = p[i].b;                                             \
@@ -434,8 +388,8 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     const PairType(type1,type2) *p = (const PairType(type1,type2)*)packed; \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      u[idx[i]].a += p[i].a;                                            \
-      u[idx[i]].b += p[i].b;                                            \
+      u[PackIdx(idx,i)].a += p[i].a;                                    \
+      u[PackIdx(idx,i)].b += p[i].b;                                    \
     }                                                                   \
   }                                                                     \
   static void CPPJoin3_(FetchAndInsert_,type1,type2)(PetscInt n,PetscInt bs,const PetscInt *idx,void *unpacked,void *packed) { \
@@ -443,7 +397,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     PairType(type1,type2) *p = (PairType(type1,type2)*)packed;          \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       PairType(type1,type2) v;                                          \
       v.a = u[j].a;                                                     \
       v.b = u[j].b;                                                     \
@@ -458,7 +412,7 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
     PairType(type1,type2) *p = (PairType(type1,type2)*)packed;         \
     PetscInt i;                                                         \
     for (i=0; i<n; i++) {                                               \
-      PetscInt j = idx[i];                                              \
+      PetscInt j = PackIdx(idx,i);                                      \
       PairType(type1,type2) v;                                          \
       v.a = u[j].a;                                                     \
       v.b = u[j].b;                                                     \
@@ -551,7 +505,33 @@ DEF_Block(char,6)
 DEF_Block(char,7)
 #endif
 
-static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
+/* Finds the array section formed by the n indices idx[], if any. Sections made of short runs are left to the indexed kernels */
+static void PetscSFBasicPackOptSetUp(PetscInt n,const PetscInt *idx,PetscSFBasicPackOpt *opt)
+{
+  PetscInt i,j,k,start,dx,dy,dz,X,Y;
+
+  opt->dx = 0;
+  if (!n) return;
+  start = idx[0];
+  for (dx=1; dx<n && idx[dx] == start+dx; dx++) ;
+  if (n%dx) return;
+  X = (n > dx) ? idx[dx]-start : dx;
+  for (dy=1; dy*dx<n && idx[dy*dx] == start+dy*X; dy++) ;
+  if (n%(dx*dy)) return;
+  Y  = (n > dx*dy) ? idx[dx*dy]-start : dy*X;
+  dz = n/(dx*dy);
+  if (dx < 4 && dx < n) return;
+  for (k=0; k<dz; k++) {
+    for (j=0; j<dy; j++) {
+      for (i=0; i<dx; i++) {
+        if (idx[(k*dy+j)*dx+i] != start+i+j*X+k*Y) return;
+      }
+    }
+  }
+  opt->start = start; opt->dx = dx; opt->dy = dy; opt->dz = dz; opt->X = X; opt->Y = Y;
+}
+
+PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
@@ -628,6 +608,11 @@ static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
   }
   ierr = MPI_Waitall(nreqs,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
   ierr = PetscFree(reqs);CHKERRQ(ierr);
+
+  /* Look for ranks whose roots or leaves need not be gathered through the index arrays */
+  ierr = PetscMalloc2(bas->niranks,&bas->rootopt,sf->nranks,&bas->leafopt);CHKERRQ(ierr);
+  for (i=0; i<bas->niranks; i++) PetscSFBasicPackOptSetUp(bas->ioffset[i+1]-bas->ioffset[i],bas->irootloc+bas->ioffset[i],&bas->rootopt[i]);
+  for (i=0; i<sf->nranks; i++) PetscSFBasicPackOptSetUp(sf->roffset[i+1]-sf->roffset[i],sf->rmine+sf->roffset[i],&bas->leafopt[i]);
   PetscFunctionReturn(0);
 }
 
@@ -754,7 +739,7 @@ static PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack li
   else *UnpackOp = NULL;
   PetscFunctionReturn(0);
 }
-static PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
+PETSC_INTERN PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
 {
   PetscFunctionBegin;
   *FetchAndOp = NULL;
@@ -775,7 +760,48 @@ static PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack
   PetscFunctionReturn(0);
 }
 
-typedef enum {PETSC_SF_LEAF2ROOT_REDUCE, PETSC_SF_ROOT2LEAF_BCAST} PetscSFDirection;
+/* Packs the n entries idx[] of a rank, by contiguous copies if the rank has an array section */
+PETSC_INTERN PetscErrorCode PetscSFBasicPackData(PetscSFBasicPack link,PetscInt n,const PetscInt *idx,const PetscSFBasicPackOpt *opt,const void *unpacked,void *packed)
+{
+  PetscInt j,k;
+
+  PetscFunctionBegin;
+  if (!opt->dx) {(*link->Pack)(n,link->bs,idx,unpacked,packed); PetscFunctionReturn(0);}
+  for (k=0; k<opt->dz; k++) {
+    for (j=0; j<opt->dy; j++) {
+      (*link->Pack)(opt->dx,link->bs,NULL,(const char*)unpacked+(opt->start+j*opt->X+k*opt->Y)*link->unitbytes,(char*)packed+(k*opt->dy+j)*opt->dx*link->unitbytes);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode PetscSFBasicUnpackData(PetscSFBasicPack link,void (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*),PetscInt n,const PetscInt *idx,const PetscSFBasicPackOpt *opt,void *unpacked,const void *packed)
+{
+  PetscInt j,k;
+
+  PetscFunctionBegin;
+  if (!opt->dx) {(*UnpackOp)(n,link->bs,idx,unpacked,packed); PetscFunctionReturn(0);}
+  for (k=0; k<opt->dz; k++) {
+    for (j=0; j<opt->dy; j++) {
+      (*UnpackOp)(opt->dx,link->bs,NULL,(char*)unpacked+(opt->start+j*opt->X+k*opt->Y)*link->unitbytes,(const char*)packed+(k*opt->dy+j)*opt->dx*link->unitbytes);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode PetscSFBasicFetchAndOpData(PetscSFBasicPack link,void (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*),PetscInt n,const PetscInt *idx,const PetscSFBasicPackOpt *opt,void *unpacked,void *packed)
+{
+  PetscInt j,k;
+
+  PetscFunctionBegin;
+  if (!opt->dx) {(*FetchAndOp)(n,link->bs,idx,unpacked,packed); PetscFunctionReturn(0);}
+  for (k=0; k<opt->dz; k++) {
+    for (j=0; j<opt->dy; j++) {
+      (*FetchAndOp)(opt->dx,link->bs,NULL,(char*)unpacked+(opt->start+j*opt->X+k*opt->Y)*link->unitbytes,(char*)packed+(k*opt->dy+j)*opt->dx*link->unitbytes);
+    }
+  }
+  PetscFunctionReturn(0);
+}
 
 static PetscErrorCode PetscSFBasicPackGetReqs(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction,MPI_Request **rootreqs,MPI_Request **leafreqs)
 {
@@ -788,18 +814,19 @@ static PetscErrorCode PetscSFBasicPackGetReqs(PetscSF sf,PetscSFBasicPack link,P
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicPackWaitall(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction)
+PETSC_INTERN PetscErrorCode PetscSFBasicPackWaitall(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction)
 {
   PetscSF_Basic  *bas  = (PetscSF_Basic*)sf->data;
   PetscInt       shift = (direction == PETSC_SF_LEAF2ROOT_REDUCE)? 0 : (sf->nranks + bas->niranks);
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = MPI_Waitall(bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks),link->requests+shift,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  if (bas->persistent) {ierr = MPI_Waitall(bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks),link->requests+shift,MPI_STATUSES_IGNORE);CHKERRQ(ierr);}
+  else {ierr = MPI_Wait(&link->request,MPI_STATUS_IGNORE);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
+PETSC_INTERN PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -812,7 +839,7 @@ static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,Pe
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
+PETSC_INTERN PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
 {
   PetscFunctionBegin;
   if (nleafranks)  *nleafranks  = sf->nranks;
@@ -823,7 +850,7 @@ static PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,Pe
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
+PETSC_INTERN PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -851,32 +878,39 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
   ierr = PetscNew(&link);CHKERRQ(ierr);
   ierr = PetscSFBasicPackTypeSetup(link,unit);CHKERRQ(ierr);
   ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
-  /* Double the requests. First half are used for reduce (leaf to root) communication, second half for bcast (root to leaf) communication */
-  half     = nrootranks + nleafranks;
-  ierr     = PetscCalloc1(half*2,&link->requests);CHKERRQ(ierr);
-  rootreqs = link->requests;
-  leafreqs = link->requests + bas->niranks - bas->ndiranks;
-  comm     = PetscObjectComm((PetscObject)sf);
-
-  /* Allocate buffer and then init the persistent communcation */
-  for (i=0; i<nrootranks; i++) {
-    ierr = PetscMalloc((rootoffset[i+1]-rootoffset[i])*link->unitbytes,&link->root[i]);CHKERRQ(ierr);
-    if (i >= ndrootranks) {
-      ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
-      ierr = MPI_Recv_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);      /* reduce */
-      ierr = MPI_Send_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks+half]);CHKERRQ(ierr); /* bcast  */
-    }
-  }
+  /* The buffers of the ranks are consecutive, so the remote ones can also be sent with a single neighborhood collective */
+  ierr = PetscMalloc(rootoffset[nrootranks]*link->unitbytes,&link->rootbuf);CHKERRQ(ierr);
+  ierr = PetscMalloc((leafoffset[nleafranks]-leafoffset[ndleafranks])*link->unitbytes,&link->leafbuf);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) link->root[i] = link->rootbuf + rootoffset[i]*link->unitbytes;
   for (i=0; i<nleafranks; i++) {
     if (i < ndleafranks) {      /* Leaf buffers for distinguished ranks are pointers directly into root buffers */
       if (ndrootranks != 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Cannot match distinguished ranks");
       link->leaf[i] = link->root[0];
-      continue;
+    } else link->leaf[i] = link->leafbuf + (leafoffset[i]-leafoffset[ndleafranks])*link->unitbytes;
+  }
+  link->request = MPI_REQUEST_NULL;
+
+  if (bas->persistent) {
+    /* Double the requests. First half are used for reduce (leaf to root) communication, second half for bcast (root to leaf) communication */
+    half     = nrootranks + nleafranks;
+    ierr     = PetscCalloc1(half*2,&link->requests);CHKERRQ(ierr);
+    rootreqs = link->requests;
+    leafreqs = link->requests + bas->niranks - bas->ndiranks;
+    comm     = PetscObjectComm((PetscObject)sf);
+
+    /* Init the persistent communication. Contiguous data is sent from the user buffer, with requests created at each send */
+    for (i=ndrootranks; i<nrootranks; i++) {
+      ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Recv_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);        /* reduce */
+      if (PetscSFBasicPackOptContiguous(&bas->rootopt[i])) rootreqs[i-ndrootranks+half] = MPI_REQUEST_NULL;
+      else {ierr = MPI_Send_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks+half]);CHKERRQ(ierr);} /* bcast  */
+    }
+    for (i=ndleafranks; i<nleafranks; i++) {
+      ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+      if (PetscSFBasicPackOptContiguous(&bas->leafopt[i])) leafreqs[i-ndleafranks] = MPI_REQUEST_NULL;
+      else {ierr = MPI_Send_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);}   /* reduce */
+      ierr = MPI_Recv_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks+half]);CHKERRQ(ierr);     /* bcast  */
     }
-    ierr = PetscMalloc((leafoffset[i+1]-leafoffset[i])*link->unitbytes,&link->leaf[i]);CHKERRQ(ierr);
-    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-    ierr = MPI_Send_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);      /* reduce */
-    ierr = MPI_Recv_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks+half]);CHKERRQ(ierr); /* bcast  */
   }
 
 found:
@@ -888,7 +922,7 @@ found:
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscCopyMode cmode,PetscSFBasicPack *mylink)
+PETSC_INTERN PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscCopyMode cmode,PetscSFBasicPack *mylink)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -913,7 +947,7 @@ static PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,cons
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
+PETSC_INTERN PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -935,7 +969,7 @@ static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptions
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
+PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF sf)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -945,17 +979,20 @@ static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
   if (bas->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
   ierr = PetscFree2(bas->iranks,bas->ioffset);CHKERRQ(ierr);
   ierr = PetscFree(bas->irootloc);CHKERRQ(ierr);
+  ierr = PetscFree2(bas->rootopt,bas->leafopt);CHKERRQ(ierr);
   for (link=bas->avail; link; link=next) {
     PetscInt i;
     next = link->next;
     if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
-    for (i=0; i<bas->niranks; i++) {ierr = PetscFree(link->root[i]);CHKERRQ(ierr);}
-    for (i=sf->ndranks; i<sf->nranks; i++) {ierr = PetscFree(link->leaf[i]);CHKERRQ(ierr);} /* Free only non-distinguished leaf buffers */
+    ierr = PetscFree(link->rootbuf);CHKERRQ(ierr);
+    ierr = PetscFree(link->leafbuf);CHKERRQ(ierr);
     ierr = PetscFree2(link->root,link->leaf);CHKERRQ(ierr);
     /* Free persistent requests using MPI_Request_free */
-    for (i=0; i<sf->nranks+bas->niranks-(sf->ndranks+bas->ndiranks); i++) {
-      ierr = MPI_Request_free(&link->requests[i]);CHKERRQ(ierr); /* used in reduce */
-      ierr = MPI_Request_free(&link->requests[sf->nranks+bas->niranks+i]);CHKERRQ(ierr); /* used in bcast */
+    if (bas->persistent) {
+      for (i=0; i<sf->nranks+bas->niranks-(sf->ndranks+bas->ndiranks); i++) {
+        if (link->requests[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->requests[i]);CHKERRQ(ierr);} /* used in reduce */
+        if (link->requests[sf->nranks+bas->niranks+i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->requests[sf->nranks+bas->niranks+i]);CHKERRQ(ierr);} /* used in bcast */
+      }
     }
     ierr = PetscFree(link->requests);CHKERRQ(ierr);
     ierr = PetscFree(link);CHKERRQ(ierr);
@@ -974,7 +1011,7 @@ static PetscErrorCode PetscSFDestroy_Basic(PetscSF sf)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
+PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
 {
   /* PetscSF_Basic *bas = (PetscSF_Basic*)sf->data; */
   PetscErrorCode ierr;
@@ -990,6 +1027,7 @@ static PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
 
 static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode    ierr;
   PetscSFBasicPack  link;
   PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
@@ -1012,15 +1050,20 @@ static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
   for (i=0; i<nrootranks; i++) {
     void *packstart = link->root[i];
     ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
-    (*link->Pack)(n,link->bs,rootloc+rootoffset[i],rootdata,packstart);
+    if (i >= ndrootranks && PetscSFBasicPackOptContiguous(&bas->rootopt[i])) { /* no packing */
+      ierr = MPI_Isend((const char*)rootdata+bas->rootopt[i].start*link->unitbytes,n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+      continue;
+    }
+    ierr = PetscSFBasicPackData(link,n,rootloc+rootoffset[i],&bas->rootopt[i],rootdata,packstart);CHKERRQ(ierr);
     if (i < ndrootranks) continue; /* shared memory */
     ierr = MPI_Start_isend(n,unit,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
 {
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
   PetscSFBasicPack link;
   PetscInt         i,nleafranks,ndleafranks;
@@ -1040,7 +1083,7 @@ PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const voi
   for (i=0; i<nleafranks; i++) {
     PetscMPIInt n   = leafoffset[i+1] - leafoffset[i];
     char *packstart = (char *) link->leaf[i];
-    if (UnpackOp) { (*UnpackOp)(n,link->bs,leafloc+leafoffset[i],leafdata,(const void *)packstart); }
+    if (UnpackOp) {ierr = PetscSFBasicUnpackData(link,UnpackOp,n,leafloc+leafoffset[i],&bas->leafopt[i],leafdata,(const void *)packstart);CHKERRQ(ierr);}
 #if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
     else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
       PetscInt j;
@@ -1065,7 +1108,7 @@ static PetscErrorCode PetscSFBcastBegin_Basic(PetscSF sf,MPI_Datatype unit,const
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode PetscSFBcastEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+PETSC_INTERN PetscErrorCode PetscSFBcastEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
 {
   PetscErrorCode   ierr;
 
@@ -1075,8 +1118,9 @@ PetscErrorCode PetscSFBcastEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *ro
 }
 
 /* leaf -> root with reduction */
-PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+static PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   PetscSFBasicPack  link;
   PetscErrorCode    ierr;
   PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
@@ -1099,15 +1143,20 @@ PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void
   for (i=0; i<nleafranks; i++) {
     void *packstart = link->leaf[i];
     ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-    (*link->Pack)(n,link->bs,leafloc+leafoffset[i],leafdata,packstart);
+    if (i >= ndleafranks && PetscSFBasicPackOptContiguous(&bas->leafopt[i])) { /* no packing */
+      ierr = MPI_Isend((const char*)leafdata+bas->leafopt[i].start*link->unitbytes,n,unit,leafranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+      continue;
+    }
+    ierr = PetscSFBasicPackData(link,n,leafloc+leafoffset[i],&bas->leafopt[i],leafdata,packstart);CHKERRQ(ierr);
     if (i < ndleafranks) continue; /* shared memory */
     ierr = MPI_Start_isend(n,unit,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
 {
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   void             (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
   PetscErrorCode   ierr;
   PetscSFBasicPack link;
@@ -1132,7 +1181,7 @@ static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const
     char *packstart = (char *) link->root[i];
 
     if (UnpackOp) {
-      (*UnpackOp)(n,link->bs,rootloc+rootoffset[i],rootdata,(const void *)packstart);
+      ierr = PetscSFBasicUnpackData(link,UnpackOp,n,rootloc+rootoffset[i],&bas->rootopt[i],rootdata,(const void *)packstart);CHKERRQ(ierr);
     }
 #if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
     else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
@@ -1161,6 +1210,7 @@ static PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
 
 static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   void              (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
   PetscErrorCode    ierr;
   PetscSFBasicPack  link;
@@ -1186,21 +1236,22 @@ static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,vo
   for (i=0; i<nrootranks; i++) {
     void *packstart = link->root[i];
     ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
-    (*FetchAndOp)(n,link->bs,rootloc+rootoffset[i],rootdata,packstart);
+    ierr = PetscSFBasicFetchAndOpData(link,FetchAndOp,n,rootloc+rootoffset[i],&bas->rootopt[i],rootdata,packstart);CHKERRQ(ierr);
     if (i < ndrootranks) continue; /* shared memory */
-    ierr = MPI_Start_isend(n,unit,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    if (PetscSFBasicPackOptContiguous(&bas->rootopt[i])) {ierr = MPI_Isend(packstart,n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);}
+    else {ierr = MPI_Start_isend(n,unit,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);}
   }
   ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   for (i=0; i<nleafranks; i++) {
     const void  *packstart = link->leaf[i];
     ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-    (*link->UnpackInsert)(n,link->bs,leafloc+leafoffset[i],leafupdate,packstart);
+    ierr = PetscSFBasicUnpackData(link,link->UnpackInsert,n,leafloc+leafoffset[i],&bas->leafopt[i],leafupdate,packstart);CHKERRQ(ierr);
   }
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
+PETSC_INTERN PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -1234,6 +1285,7 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
 
   ierr = PetscNewLog(sf,&bas);CHKERRQ(ierr);
+  bas->persistent = PETSC_TRUE;
   sf->data = (void*)bas;
   PetscFunctionReturn(0);
 }
@@ -0,0 +1,102 @@
+#if !defined(__SFBASIC_H)
+#define __SFBASIC_H
+
+#include <petsc/private/sfimpl.h>
+
+/*
+   The indices of a rank that form the array section start + i + j*X + k*Y, 0 <= i < dx, 0 <= j < dy, 0 <= k < dz, as
+   for the faces of a structured grid. The rank is then packed by dy*dz contiguous copies without the index array,
+   and, when the section is a single contiguous range, sent directly from the user buffer. dx = 0 if the indices
+   have no such structure.
+*/
+typedef struct {
+  PetscInt start,dx,dy,dz,X,Y;
+} PetscSFBasicPackOpt;
+
+typedef struct _n_PetscSFBasicPack *PetscSFBasicPack;
+struct _n_PetscSFBasicPack {
+  void (*Pack)(PetscInt,PetscInt,const PetscInt*,const void*,void*);
+  void (*UnpackInsert)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackAdd)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMin)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMax)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMinloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMult)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*FetchAndInsert)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndAdd)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMin)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMax)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMinloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMult)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+
+  MPI_Datatype     unit;
+  PetscBool        isbuiltin;   /* Is unit an MPI builtin datatype? */
+  size_t           unitbytes;   /* Number of bytes in a unit */
+  PetscInt         bs;          /* Number of basic units in a unit */
+  const void       *key;        /* Array used as key for operation */
+  char             *rootbuf;    /* Contiguous storage of root[], in the order of the root ranks */
+  char             *leafbuf;    /* Contiguous storage of leaf[] of the non-distinguished ranks */
+  char             **root;      /* Packed root data, indexed by leaf rank */
+  char             **leaf;      /* Packed leaf data, indexed by root rank */
+  MPI_Request      *requests;   /* Array of persistent root requests followed by leaf requests, if bas->persistent */
+  MPI_Request      request;     /* Request of the neighborhood collective in progress, otherwise */
+  PetscSFBasicPack next;
+};
+
+#define SFBASICHEADER \
+  PetscMPIInt      tag;                                                                         \
+  PetscMPIInt      niranks;     /* Number of incoming ranks (ranks accessing my roots) */        \
+  PetscMPIInt      ndiranks;    /* Number of incoming ranks (ranks accessing my roots) in distinguished set */ \
+  PetscMPIInt      *iranks;     /* Array of ranks that reference my roots */                     \
+  PetscInt         itotal;      /* Total number of graph edges referencing my roots */           \
+  PetscInt         *ioffset;    /* Array of length niranks+1 holding offset in irootloc[] for each rank */ \
+  PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */ \
+  PetscSFBasicPackOpt *rootopt; /* Array section of the roots of each incoming rank */           \
+  PetscSFBasicPackOpt *leafopt; /* Array section of the leaves of each root owning rank */       \
+  PetscBool        persistent;  /* The pack links carry persistent requests for each remote rank */ \
+  PetscSFBasicPack avail;       /* One or more entries per MPI Datatype, lazily constructed */   \
+  PetscSFBasicPack inuse        /* Buffers being used for transactions that have not yet completed */
+
+typedef struct {
+  SFBASICHEADER;
+} PetscSF_Basic;
+
+typedef enum {PETSC_SF_LEAF2ROOT_REDUCE, PETSC_SF_ROOT2LEAF_BCAST} PetscSFDirection;
+
+PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF,PetscViewer);
+PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF,MPI_Datatype,const void*,void*,MPI_Op);
+PETSC_INTERN PetscErrorCode PetscSFBcastEnd_Basic(PetscSF,MPI_Datatype,const void*,void*);
+PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic(PetscSF,MPI_Datatype,const void*,void*,MPI_Op);
+PETSC_INTERN PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+
+PETSC_INTERN PetscErrorCode PetscSFBasicGetRootInfo(PetscSF,PetscInt*,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF,PetscInt*,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicGetPack(PetscSF,MPI_Datatype,const void*,PetscSFBasicPack*);
+PETSC_INTERN PetscErrorCode PetscSFBasicGetPackInUse(PetscSF,MPI_Datatype,const void*,PetscCopyMode,PetscSFBasicPack*);
+PETSC_INTERN PetscErrorCode PetscSFBasicReclaimPack(PetscSF,PetscSFBasicPack*);
+PETSC_INTERN PetscErrorCode PetscSFBasicPackWaitall(PetscSF,PetscSFBasicPack,PetscSFDirection);
+PETSC_INTERN PetscErrorCode PetscSFBasicPackData(PetscSFBasicPack,PetscInt,const PetscInt*,const PetscSFBasicPackOpt*,const void*,void*);
+PETSC_INTERN PetscErrorCode PetscSFBasicUnpackData(PetscSFBasicPack,void (*)(PetscInt,PetscInt,const PetscInt*,void*,const void*),PetscInt,const PetscInt*,const PetscSFBasicPackOpt*,void*,const void*);
+PETSC_INTERN PetscErrorCode PetscSFBasicFetchAndOpData(PetscSFBasicPack,void (*)(PetscInt,PetscInt,const PetscInt*,void*,void*),PetscInt,const PetscInt*,const PetscSFBasicPackOpt*,void*,void*);
+PETSC_INTERN PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF,PetscSFBasicPack,MPI_Op,void (**)(PetscInt,PetscInt,const PetscInt*,void*,void*));
+
+/* Whether the rank is a single contiguous range, so its data can be sent from the user buffer */
+#define PetscSFBasicPackOptContiguous(opt) ((opt)->dx && (opt)->dy == 1 && (opt)->dz == 1)
+
+#endif
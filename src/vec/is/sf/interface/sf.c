@@ -107,7 +107,9 @@ PetscErrorCode PetscSFReset(PetscSF sf)
    Notes:
    See "include/petscsf.h" for available methods (for instance)
 +    PETSCSFWINDOW - MPI-2/3 one-sided
--    PETSCSFBASIC - basic implementation using MPI-1 two-sided
+.    PETSCSFBASIC - basic implementation using MPI-1 two-sided
+.    PETSCSFNEIGHBOR - MPI-3 neighborhood collectives on the communication pattern of PETSCSFBASIC
+-    PETSCSFNODE - messages between nodes combined by the first rank of each shared-memory node
 
   Level: intermediate
 
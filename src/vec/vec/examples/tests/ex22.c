@@ -76,6 +76,10 @@ int main(int argc,char **argv)
        requires: cuda
         suffix: cuda_sf
         args: -vec_type cuda -vecscatter_type sf
+      test:
+        requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+        suffix: sf_neighbor
+        args: -vecscatter_type sf -sf_type neighbor
       test:
         requires: viennacl
         suffix:  viennacl
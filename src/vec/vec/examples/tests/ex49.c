@@ -0,0 +1,113 @@
+static char help[] = "Tests VecMDot() and VecMAXPY() with the vectors of VecDuplicateVecs() -vec_duplicatevecs_contiguous.\n\
+  -n <n> : local size of the vectors\n\
+  -m <m> : number of vectors\n\n";
+
+#include <petscvec.h>
+
+/* sets the entries of x to sin(f*(i+1)) for the global indices i */
+static PetscErrorCode SetSines(Vec x,PetscReal f)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,rstart,rend;
+  PetscScalar    *a;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetOwnershipRange(x,&rstart,&rend);CHKERRQ(ierr);
+  ierr = VecGetArray(x,&a);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) a[i-rstart] = PetscSinReal(f*(i+1));
+  ierr = VecRestoreArray(x,&a);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            x,y,r,*V,*W,*Vsel,*Wsel;
+  PetscInt       n = 37,m = 11,i,j,k,nsel,ncontig = 0;
+  PetscScalar    *zv,*zw,*alpha;
+  PetscScalar    *a,*a0;
+  PetscReal      nrm,err;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&r);CHKERRQ(ierr);
+  ierr = SetSines(x,0.5);CHKERRQ(ierr);
+
+  /* the option is read by VecDuplicateVecs(), W are the separately stored vectors */
+  ierr = PetscOptionsClearValue(NULL,"-vec_duplicatevecs_contiguous");CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,m,&W);CHKERRQ(ierr);
+  ierr = PetscOptionsSetValue(NULL,"-vec_duplicatevecs_contiguous",NULL);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,m,&V);CHKERRQ(ierr);
+  ierr = VecGetArray(V[0],&a0);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecGetArray(V[i],&a);CHKERRQ(ierr);
+    if (a == a0+i*n) ncontig++;
+    ierr = VecRestoreArray(V[i],&a);CHKERRQ(ierr);
+    ierr = SetSines(V[i],1.0+i);CHKERRQ(ierr);
+    ierr = VecCopy(V[i],W[i]);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(V[0],&a0);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&ncontig,1,MPIU_INT,MPI_MIN,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%D of %D vectors stored after the previous one\n",ncontig,m);CHKERRQ(ierr);
+
+  ierr = PetscMalloc5(m,&zv,m,&zw,m,&alpha,m,&Vsel,m,&Wsel);CHKERRQ(ierr);
+  for (i=0; i<m; i++) alpha[i] = 1.0/(i+1.0);
+
+  /* all the vectors but the last one, then runs broken by skipping every third vector and by swapping pairs */
+  for (k=0; k<3; k++) {
+    nsel = 0;
+    for (i=0; i<m-1; i++) {
+      if (k == 1 && i % 3 == 2) continue;
+      j = (k == 2 && (i^1) < m-1) ? (i^1) : i;
+      Vsel[nsel] = V[j]; Wsel[nsel++] = W[j];
+    }
+    ierr = VecMDot(V[m-1],nsel,Vsel,zv);CHKERRQ(ierr);
+    ierr = VecMDot(W[m-1],nsel,Wsel,zw);CHKERRQ(ierr);
+    for (i=0,nrm=0.0,err=0.0; i<nsel; i++) {
+      nrm += PetscRealPart(zv[i]*PetscConj(zv[i]));
+      err  = PetscMax(err,PetscAbsScalar(zv[i]-zw[i])/PetscMax(PetscAbsScalar(zw[i]),1.0));
+    }
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Selection %D of %D vectors: VecMDot() norm %g, %s\n",k,nsel,(double)PetscSqrtReal(nrm),err > 1000*PETSC_MACHINE_EPSILON ? "DIFFERENT from separate storage" : "equal to separate storage");CHKERRQ(ierr);
+
+    ierr = VecCopy(x,V[m-1]);CHKERRQ(ierr);
+    ierr = VecCopy(x,y);CHKERRQ(ierr);
+    ierr = VecMAXPY(V[m-1],nsel,alpha,Vsel);CHKERRQ(ierr);
+    ierr = VecMAXPY(y,nsel,alpha,Wsel);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = VecWAXPY(r,-1.0,V[m-1],y);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_INFINITY,&err);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Selection %D of %D vectors: VecMAXPY() norm %g, %s\n",k,nsel,(double)nrm,err > 1000*PETSC_MACHINE_EPSILON*PetscMax(nrm,1.0) ? "DIFFERENT from separate storage" : "equal to separate storage");CHKERRQ(ierr);
+    ierr = VecCopy(V[m-1],W[m-1]);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree5(zv,zw,alpha,Vsel,Wsel);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(m,&V);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(m,&W);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -m 140
+
+   test:
+      suffix: 3
+      nsize: 3
+      args: -n 0
+
+TEST*/
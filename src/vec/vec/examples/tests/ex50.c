@@ -0,0 +1,211 @@
+static char help[] = "Tests the deferred evaluation of the vector operations (VecSetLazyEvaluation()) against the direct one,\n\
+also on a ghosted vector and its local form.\n\
+  -n <n> : local size of the vectors\n\n";
+
+#include <petscvec.h>
+
+#define NV 10
+
+/* entries independent of the number of processes */
+static PetscErrorCode SetSines(Vec v,PetscInt k)
+{
+  PetscErrorCode ierr;
+  PetscInt       row,end,Ii;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetOwnershipRange(v,&row,&end);CHKERRQ(ierr);
+  for (Ii=row; Ii<end; Ii++) {ierr = VecSetValue(v,Ii,PetscSinReal((PetscReal)(Ii+1)*(k+1)),INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(v);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static const char *Compare(PetscReal err,PetscReal nrm)
+{
+  return err <= 1000*PETSC_MACHINE_EPSILON*nrm ? "equal to the direct evaluation" : "DIFFERENT from the direct evaluation";
+}
+
+/*
+   A sequence of operations with the special values of the coefficients, more vectors and operations than
+   are recorded at once, reductions, and accesses to the arrays in between
+*/
+static PetscErrorCode Sequence(Vec v[],PetscReal nrm[],PetscScalar dot[])
+{
+  PetscErrorCode ierr;
+  Vec            t;
+  PetscScalar    *a;
+  PetscInt       i,row,end;
+
+  PetscFunctionBeginUser;
+  ierr = VecSet(v[2],2.0);CHKERRQ(ierr);
+  ierr = VecSet(v[3],0.0);CHKERRQ(ierr);
+  ierr = VecAXPY(v[3],0.5,v[0]);CHKERRQ(ierr);
+  ierr = VecScale(v[3],-3.0);CHKERRQ(ierr);
+  ierr = VecAYPX(v[2],-1.0,v[1]);CHKERRQ(ierr);
+  ierr = VecAYPX(v[4],0.25,v[3]);CHKERRQ(ierr);
+  ierr = VecAYPX(v[5],0.0,v[0]);CHKERRQ(ierr);
+  ierr = VecAXPBY(v[6],0.0,2.0,v[1]);CHKERRQ(ierr);
+  ierr = VecAXPBY(v[6],0.5,1.0,v[1]);CHKERRQ(ierr);
+  ierr = VecAXPBY(v[6],1.0,-2.0,v[2]);CHKERRQ(ierr);
+  ierr = VecAXPBY(v[7],3.0,0.0,v[2]);CHKERRQ(ierr);
+  ierr = VecAXPBY(v[7],3.0,0.5,v[3]);CHKERRQ(ierr);
+  ierr = VecNorm(v[7],NORM_2,&nrm[0]);CHKERRQ(ierr);
+  ierr = VecAXPBYPCZ(v[8],1.0,2.0,0.5,v[0],v[1]);CHKERRQ(ierr);
+  ierr = VecAXPBYPCZ(v[8],2.0,2.0,1.0,v[2],v[3]);CHKERRQ(ierr);
+  ierr = VecAXPBYPCZ(v[9],2.0,-1.0,0.0,v[4],v[5]);CHKERRQ(ierr);
+  ierr = VecAXPBYPCZ(v[9],0.5,-1.0,3.0,v[6],v[7]);CHKERRQ(ierr);
+  ierr = VecWAXPY(v[2],1.0,v[8],v[9]);CHKERRQ(ierr);
+  ierr = VecWAXPY(v[3],-1.0,v[8],v[9]);CHKERRQ(ierr);
+  ierr = VecWAXPY(v[4],0.0,v[8],v[9]);CHKERRQ(ierr);
+  ierr = VecWAXPY(v[5],0.3,v[8],v[9]);CHKERRQ(ierr);
+  ierr = VecDot(v[5],v[4],&dot[0]);CHKERRQ(ierr);
+  ierr = VecPointwiseMult(v[6],v[2],v[3]);CHKERRQ(ierr);
+  ierr = VecPointwiseMult(v[6],v[6],v[0]);CHKERRQ(ierr);
+  ierr = VecCopy(v[6],v[7]);CHKERRQ(ierr);
+  ierr = VecScale(v[7],0.0);CHKERRQ(ierr);
+  ierr = VecAXPY(v[7],1.5,v[5]);CHKERRQ(ierr);
+  ierr = VecNormBegin(v[7],NORM_2,&nrm[1]);CHKERRQ(ierr);
+  ierr = VecDotBegin(v[7],v[6],&dot[1]);CHKERRQ(ierr);
+  ierr = VecNormEnd(v[7],NORM_2,&nrm[1]);CHKERRQ(ierr);
+  ierr = VecDotEnd(v[7],v[6],&dot[1]);CHKERRQ(ierr);
+
+  /* more than 16 operations */
+  for (i=0; i<20; i++) {ierr = VecAXPY(v[8],0.1,v[i%8]);CHKERRQ(ierr);}
+  ierr = VecNorm(v[8],NORM_1,&nrm[2]);CHKERRQ(ierr);
+
+  /* the arrays are current when they are accessed */
+  ierr = VecAXPY(v[9],1.0,v[8]);CHKERRQ(ierr);
+  ierr = VecGetArray(v[9],&a);CHKERRQ(ierr);
+  if (a) a[0] += 1.0;
+  ierr = VecRestoreArray(v[9],&a);CHKERRQ(ierr);
+  ierr = VecScale(v[9],2.0);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(v[9],&row,&end);CHKERRQ(ierr);
+  if (end > row) {ierr = VecSetValue(v[9],row,1.0,ADD_VALUES);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(v[9]);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(v[9]);CHKERRQ(ierr);
+
+  /* a destroyed vector with a pending operation */
+  ierr = VecDuplicate(v[0],&t);CHKERRQ(ierr);
+  ierr = VecCopy(v[9],t);CHKERRQ(ierr);
+  ierr = VecAXPY(t,2.0,v[1]);CHKERRQ(ierr);
+  ierr = VecAXPY(v[0],1.0,t);CHKERRQ(ierr);
+  ierr = VecDestroy(&t);CHKERRQ(ierr);
+  ierr = VecNorm(v[0],NORM_2,&nrm[3]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Operations on a ghosted vector and on its local form, which share the array but belong to different
+   communicators, with the values added to the ghost entries sent back to their owners
+*/
+static PetscErrorCode Ghost(PetscInt n,PetscReal *nrm)
+{
+  PetscErrorCode ierr;
+  Vec            g,l;
+  PetscMPIInt    size;
+  PetscInt       N,row,end,ghost = 0,nghost = 0;
+
+  PetscFunctionBeginUser;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  N    = size*n;
+  ierr = MPI_Scan(&n,&end,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  row  = end-n;
+  /* the first entry of the next process */
+  if (size > 1 && n) {ghost = end%N; nghost = 1;}
+  ierr = VecCreateGhost(PETSC_COMM_WORLD,n,N,nghost,&ghost,&g);CHKERRQ(ierr);
+  ierr = VecGhostGetLocalForm(g,&l);CHKERRQ(ierr);
+  ierr = VecSet(l,1.0);CHKERRQ(ierr);
+  ierr = VecGhostRestoreLocalForm(g,&l);CHKERRQ(ierr);
+  ierr = VecScale(g,3.0);CHKERRQ(ierr);
+  ierr = VecGhostGetLocalForm(g,&l);CHKERRQ(ierr);
+  if (n) {ierr = VecSetValue(l,0,(PetscScalar)(row+1),ADD_VALUES);CHKERRQ(ierr);}
+  if (nghost) {ierr = VecSetValue(l,n,2.0,ADD_VALUES);CHKERRQ(ierr);}
+  ierr = VecGhostRestoreLocalForm(g,&l);CHKERRQ(ierr);
+  ierr = VecGhostUpdateBegin(g,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = VecGhostUpdateEnd(g,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = VecNorm(g,NORM_2,nrm);CHKERRQ(ierr);
+  ierr = VecDestroy(&g);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            V[NV],W[NV],r,s[2];
+  PetscInt       n = 2500,i;
+  PetscReal      nrmv[4],nrmw[4],err,nrm,snrm[2],gnrm[2];
+  PetscScalar    dotv[2],dotw[2];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  for (i=0; i<NV; i++) {
+    ierr = VecCreate(PETSC_COMM_WORLD,&V[i]);CHKERRQ(ierr);
+    ierr = VecSetSizes(V[i],n,PETSC_DECIDE);CHKERRQ(ierr);
+    ierr = VecSetFromOptions(V[i]);CHKERRQ(ierr);
+    ierr = SetSines(V[i],i);CHKERRQ(ierr);
+    ierr = VecDuplicate(V[i],&W[i]);CHKERRQ(ierr);
+    ierr = VecCopy(V[i],W[i]);CHKERRQ(ierr);
+  }
+  ierr = VecDuplicate(V[0],&r);CHKERRQ(ierr);
+  for (i=0; i<2; i++) {
+    ierr = VecCreateSeq(PETSC_COMM_SELF,n,&s[i]);CHKERRQ(ierr);
+    ierr = SetSines(s[i],i);CHKERRQ(ierr);
+  }
+
+  ierr = Sequence(W,nrmw,dotw);CHKERRQ(ierr);
+  ierr = VecSetLazyEvaluation(PETSC_COMM_WORLD,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = Sequence(V,nrmv,dotv);CHKERRQ(ierr);
+  /* the operations on the vectors of PETSC_COMM_SELF are not deferred, and do not apply those recorded on PETSC_COMM_WORLD */
+  ierr = VecAXPY(V[1],2.0,V[2]);CHKERRQ(ierr);
+  ierr = VecAXPY(s[0],2.0,s[1]);CHKERRQ(ierr);
+  ierr = VecNorm(s[0],NORM_1,&snrm[0]);CHKERRQ(ierr);
+  ierr = VecSetLazyEvaluation(PETSC_COMM_SELF,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = Ghost(n,&gnrm[0]);CHKERRQ(ierr);
+  ierr = VecSetLazyEvaluation(PETSC_COMM_SELF,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = VecSetLazyEvaluation(PETSC_COMM_WORLD,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = Ghost(n,&gnrm[1]);CHKERRQ(ierr);
+  ierr = VecAXPY(W[1],2.0,W[2]);CHKERRQ(ierr);
+  ierr = SetSines(s[0],0);CHKERRQ(ierr);
+  ierr = VecAXPY(s[0],2.0,s[1]);CHKERRQ(ierr);
+  ierr = VecNorm(s[0],NORM_1,&snrm[1]);CHKERRQ(ierr);
+
+  for (i=0; i<4; i++) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm %D: %g, %s\n",i,(double)nrmv[i],Compare(PetscAbsReal(nrmv[i]-nrmw[i]),nrmw[i]));CHKERRQ(ierr);
+  }
+  for (i=0; i<2; i++) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Dot %D: %g, %s\n",i,(double)PetscRealPart(dotv[i]),Compare(PetscAbsScalar(dotv[i]-dotw[i]),PetscAbsScalar(dotw[i])));CHKERRQ(ierr);
+  }
+  for (i=0; i<NV; i++) {
+    ierr = VecNorm(W[i],NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = VecWAXPY(r,-1.0,V[i],W[i]);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&err);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Vector %D: norm %g, %s\n",i,(double)nrm,Compare(err,nrm));CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Sequential vector: norm %g, %s\n",(double)snrm[1],Compare(PetscAbsReal(snrm[0]-snrm[1]),snrm[1]));CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Ghosted vector: norm %g, %s\n",(double)gnrm[1],Compare(PetscAbsReal(gnrm[0]-gnrm[1]),gnrm[1]));CHKERRQ(ierr);
+
+  for (i=0; i<NV; i++) {
+    ierr = VecDestroy(&V[i]);CHKERRQ(ierr);
+    ierr = VecDestroy(&W[i]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&s[0]);CHKERRQ(ierr);
+  ierr = VecDestroy(&s[1]);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+
+   test:
+      suffix: 3
+      nsize: 2
+      args: -n 0
+
+TEST*/
@@ -0,0 +1,96 @@
+static char help[] = "Tests the reuse of the arrays of destroyed vectors (VecSetArrayPoolSize()).\n\
+  -n <n> : local size of the vectors\n\n";
+
+#include <petscvec.h>
+
+#define NV 3
+
+int main(int argc,char **argv)
+{
+  Vec               x,y,*V;
+  PetscInt          n = 20,i,j,k,nreused,ncontiguous,nother;
+  const PetscScalar *a,*a0;
+  const void        *arrays[NV];
+  PetscReal         nrm,maxnrm;
+  PetscBool         contiguous = PETSC_FALSE;
+  PetscErrorCode    ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_duplicatevecs_contiguous",&contiguous,NULL);CHKERRQ(ierr);
+  ierr = VecSetArrayPoolSize(NV);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+
+  for (k=0; k<3; k++) {
+    ierr = VecDuplicateVecs(x,NV,&V);CHKERRQ(ierr);
+    nreused = ncontiguous = 0;
+    maxnrm  = 0.0;
+    for (i=0; i<NV; i++) {
+      /* the arrays of the destroyed vectors come back zeroed */
+      ierr   = VecNorm(V[i],NORM_INFINITY,&nrm);CHKERRQ(ierr);
+      maxnrm = PetscMax(maxnrm,nrm);
+      ierr   = VecGetArrayRead(V[i],&a);CHKERRQ(ierr);
+      for (j=0; k && a && j<NV; j++) if (arrays[j] == (const void*)a) nreused++;
+      if (!i) a0 = a;
+      if (a && a == a0+i*n) ncontiguous++;
+      ierr = VecRestoreArrayRead(V[i],&a);CHKERRQ(ierr);
+      ierr = VecSet(V[i],(PetscScalar)(i+1));CHKERRQ(ierr);
+    }
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&nreused,1,MPIU_INT,MPI_MIN,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&ncontiguous,1,MPIU_INT,MPI_MIN,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Round %D: the vectors are %s\n",k,maxnrm == 0.0 ? "zero" : "NOT zero");CHKERRQ(ierr);
+    if (contiguous) {
+      /* the vectors share one array that does not come from the pool, its address may or may not be reused by the allocator */
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Round %D: %D of %D vectors stored one after the other\n",k,ncontiguous,NV);CHKERRQ(ierr);
+    } else {
+      /* every vector of the later rounds takes an array of the previous round from the pool */
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Round %D: %D of %D arrays reused from the previous round\n",k,nreused,NV);CHKERRQ(ierr);
+    }
+    for (i=0; i<NV; i++) {
+      ierr = VecGetArrayRead(V[i],&a);CHKERRQ(ierr);
+      arrays[i] = (const void*)a;
+      ierr = VecRestoreArrayRead(V[i],&a);CHKERRQ(ierr);
+    }
+    ierr = VecDestroyVecs(NV,&V);CHKERRQ(ierr);
+
+    /* a vector of another length does not take these arrays, which stay in the full pool */
+    ierr = VecCreate(PETSC_COMM_WORLD,&y);CHKERRQ(ierr);
+    ierr = VecSetSizes(y,n+1,PETSC_DECIDE);CHKERRQ(ierr);
+    ierr = VecSetFromOptions(y);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(y,&a);CHKERRQ(ierr);
+    nother = 0;
+    for (j=0; !contiguous && a && j<NV; j++) if (arrays[j] == (const void*)a) nother++;
+    ierr = VecRestoreArrayRead(y,&a);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&nother,1,MPIU_INT,MPI_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    if (!contiguous) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Round %D: %D arrays reused by a vector of another length\n",k,nother);CHKERRQ(ierr);}
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecSetArrayPoolSize(0);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+      output_file: output/ex51_1.out
+
+   test:
+      suffix: contiguous
+      nsize: 2
+      args: -vec_duplicatevecs_contiguous
+
+   test:
+      suffix: empty
+      nsize: 2
+      args: -n 0
+
+TEST*/
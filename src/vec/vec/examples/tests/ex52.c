@@ -0,0 +1,108 @@
+
+static char help[] = "Tests VecGhostGetInteriorIS() and VecGhostUpdateCompute() with a 1d Laplacian.\n\n";
+
+#include <petscvec.h>
+
+typedef struct {
+  Vec      f;
+  PetscInt n;   /* number of owned entries */
+  PetscInt gl;  /* index in the local form of the left neighbor of the first owned entry, -1 if none */
+  PetscInt gr;  /* index in the local form of the right neighbor of the last owned entry, -1 if none */
+} AppCtx;
+
+/* f_i = 2 x_i - x_{i-1} - x_{i+1} on the entries of is */
+static PetscErrorCode Laplacian(Vec l,IS is,void *ctx)
+{
+  AppCtx            *user = (AppCtx*)ctx;
+  PetscErrorCode    ierr;
+  const PetscScalar *x;
+  PetscScalar       *f,xl,xr;
+  const PetscInt    *idx;
+  PetscInt          k,m,i;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetArrayRead(l,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(user->f,&f);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(is,&m);CHKERRQ(ierr);
+  ierr = ISGetIndices(is,&idx);CHKERRQ(ierr);
+  for (k=0; k<m; k++) {
+    i    = idx[k];
+    xl   = i > 0 ? x[i-1] : (user->gl >= 0 ? x[user->gl] : 0.0);
+    xr   = i < user->n-1 ? x[i+1] : (user->gr >= 0 ? x[user->gr] : 0.0);
+    f[i] = 2.0*x[i] - xl - xr;
+  }
+  ierr = ISRestoreIndices(is,&idx);CHKERRQ(ierr);
+  ierr = VecRestoreArray(user->f,&f);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(l,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       n = 6,nghost = 0,ghosts[2],rstart,i,ni,nb,sizes[2];
+  AppCtx         user;
+  Vec            x,xl,f;
+  IS             interior,boundary;
+  PetscReal      norm;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  rstart  = rank*n;
+  user.n  = n;
+  user.gl = user.gr = -1;
+  if (rank > 0)      {user.gl = n+nghost; ghosts[nghost++] = rstart-1;}
+  if (rank < size-1) {user.gr = n+nghost; ghosts[nghost++] = rstart+n;}
+  ierr = VecCreateGhost(PETSC_COMM_WORLD,n,PETSC_DECIDE,nghost,ghosts,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&f);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&user.f);CHKERRQ(ierr);
+  for (i=rstart; i<rstart+n; i++) {ierr = VecSetValue(x,i,(PetscScalar)(i*i),INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+
+  ierr = VecGhostGetInteriorIS(x,&interior,&boundary);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(interior,&ni);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(boundary,&nb);CHKERRQ(ierr);
+  ierr = PetscSynchronizedPrintf(PETSC_COMM_WORLD,"[%d] interior %D boundary %D\n",rank,ni,nb);CHKERRQ(ierr);
+  ierr = PetscSynchronizedFlush(PETSC_COMM_WORLD,PETSC_STDOUT);CHKERRQ(ierr);
+
+  /* the overlapped evaluation, then the one after the complete update */
+  ierr = VecGhostUpdateCompute(x,INSERT_VALUES,SCATTER_FORWARD,Laplacian,&user);CHKERRQ(ierr);
+  ierr = VecCopy(user.f,f);CHKERRQ(ierr);
+  ierr = VecSet(user.f,0.0);CHKERRQ(ierr);
+  ierr = VecGhostUpdateBegin(x,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecGhostUpdateEnd(x,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecGhostGetLocalForm(x,&xl);CHKERRQ(ierr);
+  ierr = Laplacian(xl,interior,&user);CHKERRQ(ierr);
+  ierr = Laplacian(xl,boundary,&user);CHKERRQ(ierr);
+  ierr = VecGhostRestoreLocalForm(x,&xl);CHKERRQ(ierr);
+  ierr = VecAXPY(f,-1.0,user.f);CHKERRQ(ierr);
+  ierr = VecNorm(f,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Difference of the residuals %g\n",(double)norm);CHKERRQ(ierr);
+
+  /* the vectors duplicated from x have the same index sets */
+  ierr = VecGhostGetInteriorIS(f,&interior,NULL);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(interior,&sizes[0]);CHKERRQ(ierr);
+  ierr = VecGhostGetInteriorIS(user.f,&interior,NULL);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(interior,&sizes[1]);CHKERRQ(ierr);
+  if (sizes[0] != ni || sizes[1] != ni) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Duplicated vectors have different interiors");
+
+  ierr = VecDestroy(&user.f);CHKERRQ(ierr);
+  ierr = VecDestroy(&f);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+
+TEST*/
@@ -291,3 +291,162 @@ PetscErrorCode  VecGhostUpdateEnd(Vec g,InsertMode insertmode,ScatterMode scatte
   }
   PetscFunctionReturn(0);
 }
+
+/*
+   The owned entries that are ghost points of other processes are those into which a reverse ghost update adds
+*/
+static PetscErrorCode VecGhostSetUpInteriorIS_Private(Vec g,IS *interior,IS *boundary)
+{
+  PetscErrorCode    ierr;
+  Vec               w,wl;
+  PetscScalar       *la;
+  const PetscScalar *a;
+  PetscInt          n,nl,i,ni = 0,nb = 0,*iidx,*bidx;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(g,&n);CHKERRQ(ierr);
+  ierr = VecDuplicate(g,&w);CHKERRQ(ierr);
+  ierr = VecGhostGetLocalForm(w,&wl);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(wl,&nl);CHKERRQ(ierr);
+  ierr = VecGetArray(wl,&la);CHKERRQ(ierr);
+  for (i=0; i<n; i++)  la[i] = 0.0;
+  for (i=n; i<nl; i++) la[i] = 1.0;
+  ierr = VecRestoreArray(wl,&la);CHKERRQ(ierr);
+  ierr = VecGhostRestoreLocalForm(w,&wl);CHKERRQ(ierr);
+  ierr = VecGhostUpdateBegin(w,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = VecGhostUpdateEnd(w,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+
+  ierr = VecGetArrayRead(w,&a);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    if (PetscRealPart(a[i]) > 0.0) nb++;
+  }
+  ierr = PetscMalloc1(n-nb,&iidx);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nb,&bidx);CHKERRQ(ierr);
+  for (i=0,nb=0; i<n; i++) {
+    if (PetscRealPart(a[i]) > 0.0) bidx[nb++] = i;
+    else iidx[ni++] = i;
+  }
+  ierr = VecRestoreArrayRead(w,&a);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,ni,iidx,PETSC_OWN_POINTER,interior);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,nb,bidx,PETSC_OWN_POINTER,boundary);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecGhostGetInteriorIS - Gets the entries owned by this process that are not ghost points of other processes, the
+   interior, and those that are, the boundary
+
+   Collective on Vec the first time it is called
+
+   Input Parameter:
+.  g - the vector (obtained with VecCreateGhost() or VecDuplicate())
+
+   Output Parameters:
++  interior - the indices in the local form of the interior entries, or NULL
+-  boundary - the indices in the local form of the boundary entries, or NULL
+
+   Notes:
+   The index sets are computed from the pattern of the ghost update when first requested and belong to the vector,
+   and to the vectors duplicated from it; do not destroy them.
+
+   When the coupling between the entries is symmetric, as it is for ghost points taken from a stencil or from the
+   neighbors in a mesh, the interior entries do not depend on any ghost value. They can then be computed while the
+   ghost values are updated, see VecGhostUpdateCompute().
+
+   For a sequential vector all the entries are interior.
+
+   Level: advanced
+
+   Concepts: vectors^ghost point access
+
+.seealso: VecGhostUpdateCompute(), VecCreateGhost(), VecGhostGetLocalForm(), VecGhostUpdateBegin()
+@*/
+PetscErrorCode VecGhostGetInteriorIS(Vec g,IS *interior,IS *boundary)
+{
+  PetscErrorCode ierr;
+  PetscBool      ismpi,isseq;
+  IS             iis,bis;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(g,VEC_CLASSID,1);
+  ierr = PetscObjectTypeCompare((PetscObject)g,VECMPI,&ismpi);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)g,VECSEQ,&isseq);CHKERRQ(ierr);
+  if (ismpi) {
+    Vec_MPI *v = (Vec_MPI*)g->data;
+
+    if (!v->localrep) SETERRQ(PetscObjectComm((PetscObject)g),PETSC_ERR_ARG_WRONG,"Vector is not ghosted");
+    if (!v->ghostinterior) {ierr = VecGhostSetUpInteriorIS_Private(g,&v->ghostinterior,&v->ghostboundary);CHKERRQ(ierr);}
+    iis = v->ghostinterior;
+    bis = v->ghostboundary;
+  } else if (isseq) {
+    ierr = PetscObjectQuery((PetscObject)g,"VecGhostInteriorIS",(PetscObject*)&iis);CHKERRQ(ierr);
+    ierr = PetscObjectQuery((PetscObject)g,"VecGhostBoundaryIS",(PetscObject*)&bis);CHKERRQ(ierr);
+    if (!iis) {
+      ierr = ISCreateStride(PETSC_COMM_SELF,g->map->n,0,1,&iis);CHKERRQ(ierr);
+      ierr = ISCreateGeneral(PETSC_COMM_SELF,0,NULL,PETSC_OWN_POINTER,&bis);CHKERRQ(ierr);
+      ierr = PetscObjectCompose((PetscObject)g,"VecGhostInteriorIS",(PetscObject)iis);CHKERRQ(ierr);
+      ierr = PetscObjectCompose((PetscObject)g,"VecGhostBoundaryIS",(PetscObject)bis);CHKERRQ(ierr);
+      ierr = PetscObjectDereference((PetscObject)iis);CHKERRQ(ierr);
+      ierr = PetscObjectDereference((PetscObject)bis);CHKERRQ(ierr);
+    }
+  } else SETERRQ(PetscObjectComm((PetscObject)g),PETSC_ERR_ARG_WRONG,"Vector is not ghosted");
+  if (interior) *interior = iis;
+  if (boundary) *boundary = bis;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecGhostUpdateCompute - Updates the ghost values of a vector, or accumulates them onto their owners, while a
+   computation runs on the entries that do not take part in the update
+
+   Neighbor-wise Collective on Vec
+
+   Input Parameters:
++  g - the vector (obtained with VecCreateGhost() or VecDuplicate())
+.  insertmode - one of ADD_VALUES or INSERT_VALUES
+.  scattermode - one of SCATTER_FORWARD or SCATTER_REVERSE
+.  compute - the computation on a subset of the entries
+-  ctx - the context of compute, or NULL
+
+   Calling sequence of compute:
+$     PetscErrorCode compute(Vec l,IS is,void *ctx)
+
++  l - the local form of g
+.  is - the indices in l of the entries to compute
+-  ctx - the context
+
+   Notes:
+   compute is called on the interior entries, see VecGhostGetInteriorIS(), between VecGhostUpdateBegin() and
+   VecGhostUpdateEnd(), then on the boundary entries. It must not change the entries of g that take part in the
+   update; usually it reads l and writes into another vector given in ctx. For example a residual evaluation is
+.vb
+       VecGhostUpdateCompute(x,INSERT_VALUES,SCATTER_FORWARD,Residual,&user);
+.ve
+   where Residual() computes the entries of user.f indexed by is from the values of l at these entries and at their
+   neighbors. The ghost values of l may only be used in the second call.
+
+   Level: advanced
+
+   Concepts: vectors^ghost point access
+
+.seealso: VecGhostGetInteriorIS(), VecGhostUpdateBegin(), VecGhostUpdateEnd(), VecGhostGetLocalForm()
+@*/
+PetscErrorCode VecGhostUpdateCompute(Vec g,InsertMode insertmode,ScatterMode scattermode,PetscErrorCode (*compute)(Vec,IS,void*),void *ctx)
+{
+  PetscErrorCode ierr;
+  IS             interior,boundary;
+  Vec            l;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(g,VEC_CLASSID,1);
+  PetscValidFunction(compute,4);
+  ierr = VecGhostGetInteriorIS(g,&interior,&boundary);CHKERRQ(ierr);
+  ierr = VecGhostUpdateBegin(g,insertmode,scattermode);CHKERRQ(ierr);
+  ierr = VecGhostGetLocalForm(g,&l);CHKERRQ(ierr);
+  ierr = (*compute)(l,interior,ctx);CHKERRQ(ierr);
+  ierr = VecGhostUpdateEnd(g,insertmode,scattermode);CHKERRQ(ierr);
+  ierr = (*compute)(l,boundary,ctx);CHKERRQ(ierr);
+  ierr = VecGhostRestoreLocalForm(g,&l);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -72,6 +72,12 @@ static PetscErrorCode VecDuplicate_MPI(Vec win,Vec *v)
     if (vw->localupdate) {
       ierr = PetscObjectReference((PetscObject)vw->localupdate);CHKERRQ(ierr);
     }
+    vw->ghostinterior = w->ghostinterior;
+    vw->ghostboundary = w->ghostboundary;
+    if (vw->ghostinterior) {
+      ierr = PetscObjectReference((PetscObject)vw->ghostinterior);CHKERRQ(ierr);
+      ierr = PetscObjectReference((PetscObject)vw->ghostboundary);CHKERRQ(ierr);
+    }
   }
 
   /* New vector should inherit stashing property of parent */
@@ -401,7 +407,7 @@ static PetscErrorCode VecSetFromOptions_MPI(PetscOptionItems *PetscOptionsObject
 
 
 static struct _VecOps DvOps = { VecDuplicate_MPI, /* 1 */
-                                VecDuplicateVecs_Default,
+                                VecDuplicateVecs_Seq,
                                 VecDestroyVecs_Default,
                                 VecDot_MPI,
                                 VecMDot_MPI,
@@ -498,10 +504,11 @@ PetscErrorCode VecCreate_MPI_Private(Vec v,PetscBool alloc,PetscInt nghost,const
   s->array_allocated = 0;
   if (alloc && !array) {
     PetscInt n = v->map->n+nghost;
-    ierr               = PetscMalloc1(n,&s->array);CHKERRQ(ierr);
+    ierr               = VecPoolGet_Private(n,&s->array);CHKERRQ(ierr);
     ierr               = PetscLogObjectMemory((PetscObject)v,n*sizeof(PetscScalar));CHKERRQ(ierr);
     ierr               = PetscMemzero(s->array,n*sizeof(PetscScalar));CHKERRQ(ierr);
     s->array_allocated = s->array;
+    s->array_pooled    = n;
   }
 
   /* By default parallel vectors do not have local representation */
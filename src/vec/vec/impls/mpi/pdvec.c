@@ -17,13 +17,15 @@ PetscErrorCode VecDestroy_MPI(Vec v)
   PetscLogObjectState((PetscObject)v,"Length=%D",v->map->N);
 #endif
   if (!x) PetscFunctionReturn(0);
-  ierr = PetscFree(x->array_allocated);CHKERRQ(ierr);
+  ierr = VecPoolRestore_Private(x->array_pooled,&x->array_allocated);CHKERRQ(ierr);
 
   /* Destroy local representation of vector if it exists */
   if (x->localrep) {
     ierr = VecDestroy(&x->localrep);CHKERRQ(ierr);
     ierr = VecScatterDestroy(&x->localupdate);CHKERRQ(ierr);
   }
+  ierr = ISDestroy(&x->ghostinterior);CHKERRQ(ierr);
+  ierr = ISDestroy(&x->ghostboundary);CHKERRQ(ierr);
   ierr = VecAssemblyReset_MPI(v);CHKERRQ(ierr);
 
   /* Destroy the stashes: note the order - so that the tags are freed properly */
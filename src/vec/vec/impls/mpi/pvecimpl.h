@@ -24,6 +24,8 @@ typedef struct {
   PetscInt    nghost;                   /* number of ghost points on this process */
   Vec         localrep;                 /* local representation of vector */
   VecScatter  localupdate;              /* scatter to update ghost values */
+  IS          ghostinterior;            /* owned entries that are not ghost points of other processes */
+  IS          ghostboundary;            /* owned entries that are ghost points of other processes */
 
   PetscBool   assembly_subset;          /* Subsequent assemblies will set a subset (perhaps equal) of off-process entries set on first assembly */
   PetscBool   use_status;               /* Use MPI_Status to determine number of items in each message */
@@ -42,6 +44,7 @@ typedef struct {
 
 PETSC_INTERN PetscErrorCode VecDot_MPI(Vec,Vec,PetscScalar*);
 PETSC_INTERN PetscErrorCode VecMDot_MPI(Vec,PetscInt,const Vec[],PetscScalar*);
+PETSC_INTERN PetscErrorCode VecMDot_MPI_GEMV(Vec,PetscInt,const Vec[],PetscScalar*);
 PETSC_INTERN PetscErrorCode VecTDot_MPI(Vec,Vec,PetscScalar*);
 PETSC_INTERN PetscErrorCode VecMTDot_MPI(Vec,PetscInt,const Vec[],PetscScalar*);
 PETSC_INTERN PetscErrorCode VecNorm_MPI(Vec,NormType,PetscReal*);
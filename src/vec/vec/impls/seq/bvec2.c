@@ -793,7 +793,7 @@ PetscErrorCode VecDestroy_Seq(Vec v)
 #if defined(PETSC_USE_LOG)
   PetscLogObjectState((PetscObject)v,"Length=%D",v->map->n);
 #endif
-  ierr = PetscFree(vs->array_allocated);CHKERRQ(ierr);
+  ierr = VecPoolRestore_Private(vs->array_pooled,&vs->array_allocated);CHKERRQ(ierr);
   ierr = PetscFree(v->data);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -823,7 +823,7 @@ PetscErrorCode VecDuplicate_Seq(Vec win,Vec *V)
 }
 
 static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
-                               VecDuplicateVecs_Default,
+                               VecDuplicateVecs_Seq,
                                VecDestroyVecs_Default,
                                VecDot_Seq,
                                VecMDot_Seq,
@@ -3,8 +3,9 @@
    Defines some vector operation functions that are shared by
    sequential and parallel vectors.
 */
-#include <../src/vec/vec/impls/dvecimpl.h>
+#include <../src/vec/vec/impls/mpi/pvecimpl.h>
 #include <petsc/private/kernels/petscaxpy.h>
+#include <petscblaslapack.h>
 
 
 
@@ -752,7 +753,170 @@ PetscErrorCode VecReplaceArray_Seq(Vec vin,const PetscScalar *a)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = PetscFree(v->array_allocated);CHKERRQ(ierr);
+  ierr = VecPoolRestore_Private(v->array_pooled,&v->array_allocated);CHKERRQ(ierr);
   v->array_allocated = v->array = (PetscScalar*)a;
+  v->array_pooled    = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Gets the arrays of the vectors y[] for the GEMV kernels below. Only the addresses are kept, so the
+   arrays are returned at once; the vectors are all native.
+*/
+static PetscErrorCode VecGetArraysRead_GEMV_Private(PetscInt nv,const Vec y[],const PetscScalar **ya)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i;
+  const PetscScalar *a;
+
+  PetscFunctionBegin;
+  for (i=0; i<nv; i++) {
+    ierr  = VecGetArrayRead(y[i],&a);CHKERRQ(ierr);
+    ya[i] = a;
+    ierr  = VecRestoreArrayRead(y[i],&a);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Returns in *end the end of the run of vectors starting at start whose arrays follow one another with
+   stride n; if that run has only one vector, *end is instead the end of the run of vectors that do not
+   start such a run, which are handled by the unrolled kernels.
+*/
+PETSC_STATIC_INLINE void VecGEMVRun_Private(PetscInt nv,PetscInt n,const PetscScalar **ya,PetscInt start,PetscInt *end,PetscBool *contiguous)
+{
+  PetscInt j;
+
+  for (j=start+1; j<nv && ya[j] == ya[j-1]+n; j++) ;
+  if (j-start > 1) {*end = j; *contiguous = PETSC_TRUE; return;}
+  for (j=start+1; j<nv && !(j+1 < nv && ya[j+1] == ya[j]+n); j++) ;
+  *end = j; *contiguous = PETSC_FALSE;
+}
+
+/*
+   VecMDot_Seq_GEMV - VecMDot_Seq() that computes the products with each run of vectors stored one after
+   another, as obtained from VecDuplicateVecs() with -vec_duplicatevecs_contiguous, with one BLAS gemv
+   so that x is read once per run instead of once per four vectors.
+*/
+PetscErrorCode VecMDot_Seq_GEMV(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,i,j;
+  const PetscScalar *x,*yawork[128],**ya = yawork;
+  PetscScalar       one = 1.0,zero = 0.0;
+  PetscBLASInt      bn,bm,ione = 1;
+  PetscBool         contiguous;
+#if defined(PETSC_USE_COMPLEX)
+  const char        *trans = "C";
+#else
+  const char        *trans = "T";
+#endif
+
+  PetscFunctionBegin;
+  if (!n || nv < 2) {
+    ierr = VecMDot_Seq(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (nv > 128) {
+    ierr = PetscMalloc1(nv,&ya);CHKERRQ(ierr);
+  }
+  ierr = VecGetArraysRead_GEMV_Private(nv,yin,ya);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  for (i=0; i<nv; i=j) {
+    VecGEMVRun_Private(nv,n,ya,i,&j,&contiguous);
+    if (contiguous) {
+      ierr = PetscBLASIntCast(j-i,&bm);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemv",BLASgemv_(trans,&bn,&bm,&one,ya[i],&bn,x,&ione,&zero,z+i,&ione));
+      ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+      ierr = PetscLogFlops((j-i)*(2.0*n-1));CHKERRQ(ierr);
+    } else {
+      ierr = VecMDot_Seq(xin,j-i,yin+i,z+i);CHKERRQ(ierr);
+    }
+  }
+  if (nv > 128) {
+    ierr = PetscFree(ya);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecMAXPY_Seq_GEMV - VecMAXPY_Seq() that adds each run of vectors stored one after another with one
+   BLAS gemv, so that x is read and written once per run instead of once per four vectors.
+*/
+PetscErrorCode VecMAXPY_Seq_GEMV(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,i,j;
+  const PetscScalar *yawork[128],**ya = yawork;
+  PetscScalar       *xx,one = 1.0;
+  PetscBLASInt      bn,bm,ione = 1;
+  PetscBool         contiguous;
+
+  PetscFunctionBegin;
+  if (!n || nv < 2) {
+    ierr = VecMAXPY_Seq(xin,nv,alpha,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (nv > 128) {
+    ierr = PetscMalloc1(nv,&ya);CHKERRQ(ierr);
+  }
+  ierr = VecGetArraysRead_GEMV_Private(nv,y,ya);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  for (i=0; i<nv; i=j) {
+    VecGEMVRun_Private(nv,n,ya,i,&j,&contiguous);
+    if (contiguous) {
+      ierr = PetscBLASIntCast(j-i,&bm);CHKERRQ(ierr);
+      ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&bn,&bm,&one,ya[i],&bn,alpha+i,&ione,&one,xx,&ione));
+      ierr = VecRestoreArray(xin,&xx);CHKERRQ(ierr);
+      ierr = PetscLogFlops((j-i)*2.0*n);CHKERRQ(ierr);
+    } else {
+      ierr = VecMAXPY_Seq(xin,j-i,alpha+i,y+i);CHKERRQ(ierr);
+    }
+  }
+  if (nv > 128) {
+    ierr = PetscFree(ya);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecDuplicateVecs_Seq - VecDuplicateVecs() for VECSEQ and VECMPI. With -vec_duplicatevecs_contiguous
+   the local arrays of the new vectors are the consecutive columns of one block of leading dimension n,
+   owned by the first vector, and VecMDot()/VecMAXPY() with these vectors use BLAS gemv.
+*/
+PetscErrorCode VecDuplicateVecs_Seq(Vec w,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  PetscBool      contiguous = PETSC_FALSE,isseq,ismpi;
+  PetscInt       i,n = w->map->n;
+  PetscScalar    *array;
+  Vec_Seq        *v;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsGetBool(((PetscObject)w)->options,((PetscObject)w)->prefix,"-vec_duplicatevecs_contiguous",&contiguous,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)w,VECSEQ,&isseq);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)w,VECMPI,&ismpi);CHKERRQ(ierr);
+  /* ghosted vectors keep their ghost values after the owned ones, and derived types manage their own arrays */
+  if (ismpi && ((Vec_MPI*)w->data)->nghost) contiguous = PETSC_FALSE;
+  if (!contiguous || !(isseq || ismpi)) {
+    ierr = VecDuplicateVecs_Default(w,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (m <= 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"m must be > 0: m = %D",m);
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  ierr = PetscCalloc1(m*n,&array);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecDuplicate(w,*V+i);CHKERRQ(ierr);
+    v    = (Vec_Seq*)(*V)[i]->data;
+    ierr = VecPoolRestore_Private(v->array_pooled,&v->array_allocated);CHKERRQ(ierr);
+    v->array_pooled     = 0;
+    v->array            = array + i*n;
+    v->array_allocated  = i ? NULL : array;
+    (*V)[i]->ops->mdot  = isseq ? VecMDot_Seq_GEMV : VecMDot_MPI_GEMV;
+    (*V)[i]->ops->maxpy = VecMAXPY_Seq_GEMV;
+  }
+  ierr = PetscLogObjectMemory((PetscObject)(*V)[0],(m-1)*n*sizeof(PetscScalar));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -151,7 +151,7 @@ PetscErrorCode  VecInitializePackage(void)
   char           logList[256];
   PetscBool      opt,pkg;
   PetscErrorCode ierr;
-  PetscInt       i;
+  PetscInt       i,poolsize;
 
   PetscFunctionBegin;
   if (VecPackageInitialized) PetscFunctionReturn(0);
@@ -193,6 +193,9 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = PetscLogEventRegister("VecReduceBegin",   VEC_CLASSID,&VEC_ReduceBegin);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecReduceEnd",     VEC_CLASSID,&VEC_ReduceEnd);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecNormalize",     VEC_CLASSID,&VEC_Normalize);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecLazyApply",     VEC_CLASSID,&VEC_LazyApply);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecPoolHit",       VEC_CLASSID,&VEC_PoolHit);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecPoolMiss",      VEC_CLASSID,&VEC_PoolMiss);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_VIENNACL)
   ierr = PetscLogEventRegister("VecViennaCLCopyTo",   VEC_CLASSID,&VEC_ViennaCLCopyToGPU);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecViennaCLCopyFrom", VEC_CLASSID,&VEC_ViennaCLCopyFromGPU);CHKERRQ(ierr);
@@ -235,6 +238,18 @@ PetscErrorCode  VecInitializePackage(void)
     if (pkg) {ierr = PetscLogEventExcludeClass(VEC_SCATTER_CLASSID);CHKERRQ(ierr);}
   }
 
+  /* Deferred evaluation of the vector operations */
+  opt  = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_lazy_evaluation",&opt,NULL);CHKERRQ(ierr);
+  if (opt) {ierr = VecSetLazyEvaluation(PETSC_COMM_WORLD,PETSC_TRUE);CHKERRQ(ierr);}
+
+  /* Reuse of the arrays of destroyed vectors */
+  ierr = PetscOptionsGetInt(NULL,NULL,"-vec_array_pool_size",&poolsize,&opt);CHKERRQ(ierr);
+  if (opt) {ierr = VecSetArrayPoolSize(poolsize);CHKERRQ(ierr);}
+
+  /* Page placement of the vector arrays */
+  ierr = PetscMallocPagesSetFromOptions(VEC_CLASSID,"vec_");CHKERRQ(ierr);
+
   /*
     Create the special MPI reduction operation that may be used by VecNorm/DotBegin()
   */
@@ -266,6 +281,7 @@ PetscErrorCode  VecFinalizePackage(void)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = VecSetArrayPoolSize(0);CHKERRQ(ierr);
   ierr = PetscFunctionListDestroy(&VecList);CHKERRQ(ierr);
   ierr = PetscFunctionListDestroy(&VecScatterList);CHKERRQ(ierr);
   ierr = MPI_Op_free(&PetscSplitReduction_Op);CHKERRQ(ierr);
@@ -274,6 +290,11 @@ PetscErrorCode  VecFinalizePackage(void)
   if (Petsc_Reduction_keyval != MPI_KEYVAL_INVALID) {
     ierr = MPI_Comm_free_keyval(&Petsc_Reduction_keyval);CHKERRQ(ierr);
   }
+  if (Petsc_VecLazy_keyval != MPI_KEYVAL_INVALID) {
+    ierr = VecSetLazyEvaluation(PETSC_COMM_WORLD,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = VecSetLazyEvaluation(PETSC_COMM_SELF,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = MPI_Comm_free_keyval(&Petsc_VecLazy_keyval);CHKERRQ(ierr);
+  }
   VecPackageInitialized = PETSC_FALSE;
   VecRegisterAllCalled  = PETSC_FALSE;
   PetscFunctionReturn(0);
@@ -108,6 +108,7 @@ $     val = (x,y) = y^T x,
 PetscErrorCode  VecDot(Vec x,Vec y,PetscScalar *val)
 {
   PetscErrorCode ierr;
+  PetscBool      lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
@@ -119,7 +120,8 @@ PetscErrorCode  VecDot(Vec x,Vec y,PetscScalar *val)
   VecCheckSameSize(x,1,y,2);
 
   ierr = PetscLogEventBegin(VEC_Dot,x,y,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->dot)(x,y,val);CHKERRQ(ierr);
+  ierr = VecLazyDot_Private(x,y,val,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*x->ops->dot)(x,y,val);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_Dot,x,y,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -208,7 +210,7 @@ $    work load inbalance that causes certain processes to arrive much earlier th
 @*/
 PetscErrorCode  VecNorm(Vec x,NormType type,PetscReal *val)
 {
-  PetscBool      flg;
+  PetscBool      flg,lazy;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -224,7 +226,8 @@ PetscErrorCode  VecNorm(Vec x,NormType type,PetscReal *val)
     if (flg) PetscFunctionReturn(0);
   }
   ierr = PetscLogEventBegin(VEC_Norm,x,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->norm)(x,type,val);CHKERRQ(ierr);
+  ierr = VecLazyNorm_Private(x,type,val,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*x->ops->norm)(x,type,val);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_Norm,x,0,0,0);CHKERRQ(ierr);
 
   if (type!=NORM_1_AND_2) {
@@ -475,7 +478,7 @@ $      x[i] = alpha * x[i], for i=1,...,n.
 PetscErrorCode  VecScale(Vec x, PetscScalar alpha)
 {
   PetscReal      norms[4] = {0.0,0.0,0.0, 0.0};
-  PetscBool      flgs[4];
+  PetscBool      flgs[4],lazy;
   PetscErrorCode ierr;
   PetscInt       i;
 
@@ -489,7 +492,8 @@ PetscErrorCode  VecScale(Vec x, PetscScalar alpha)
     for (i=0; i<4; i++) {
       ierr = PetscObjectComposedDataGetReal((PetscObject)x,NormIds[i],norms[i],flgs[i]);CHKERRQ(ierr);
     }
-    ierr = (*x->ops->scale)(x,alpha);CHKERRQ(ierr);
+    ierr = VecLazyRecord_Private(VEC_LAZY_SCALE,x,NULL,NULL,alpha,0.0,0.0,&lazy);CHKERRQ(ierr);
+    if (!lazy) {ierr = (*x->ops->scale)(x,alpha);CHKERRQ(ierr);}
     ierr = PetscObjectStateIncrease((PetscObject)x);CHKERRQ(ierr);
     /* put the scaled stashed norms back into the Vec */
     for (i=0; i<4; i++) {
@@ -534,6 +538,7 @@ $     x[i] = alpha, for i=1,...,n,
 PetscErrorCode  VecSet(Vec x,PetscScalar alpha)
 {
   PetscReal      val;
+  PetscBool      lazy;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -544,7 +549,8 @@ PetscErrorCode  VecSet(Vec x,PetscScalar alpha)
   ierr = VecSetErrorIfLocked(x,1);CHKERRQ(ierr);
 
   ierr = PetscLogEventBegin(VEC_Set,x,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->set)(x,alpha);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_SET,x,NULL,NULL,alpha,0.0,0.0,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*x->ops->set)(x,alpha);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_Set,x,0,0,0);CHKERRQ(ierr);
   ierr = PetscObjectStateIncrease((PetscObject)x);CHKERRQ(ierr);
 
@@ -593,6 +599,7 @@ PetscErrorCode  VecSet(Vec x,PetscScalar alpha)
 PetscErrorCode  VecAXPY(Vec y,PetscScalar alpha,Vec x)
 {
   PetscErrorCode ierr;
+  PetscBool      lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,3);
@@ -607,7 +614,8 @@ PetscErrorCode  VecAXPY(Vec y,PetscScalar alpha,Vec x)
 
   ierr = VecLockReadPush(x);CHKERRQ(ierr);
   ierr = PetscLogEventBegin(VEC_AXPY,x,y,0,0);CHKERRQ(ierr);
-  ierr = (*y->ops->axpy)(y,alpha,x);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_AXPY,y,x,NULL,alpha,0.0,0.0,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*y->ops->axpy)(y,alpha,x);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_AXPY,x,y,0,0);CHKERRQ(ierr);
   ierr = VecLockReadPop(x);CHKERRQ(ierr);
   ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
@@ -639,6 +647,7 @@ PetscErrorCode  VecAXPY(Vec y,PetscScalar alpha,Vec x)
 PetscErrorCode  VecAXPBY(Vec y,PetscScalar alpha,PetscScalar beta,Vec x)
 {
   PetscErrorCode ierr;
+  PetscBool      lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,4);
@@ -652,7 +661,8 @@ PetscErrorCode  VecAXPBY(Vec y,PetscScalar alpha,PetscScalar beta,Vec x)
   PetscValidLogicalCollectiveScalar(y,beta,3);
 
   ierr = PetscLogEventBegin(VEC_AXPY,x,y,0,0);CHKERRQ(ierr);
-  ierr = (*y->ops->axpby)(y,alpha,beta,x);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_AXPBY,y,x,NULL,alpha,beta,0.0,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*y->ops->axpby)(y,alpha,beta,x);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_AXPY,x,y,0,0);CHKERRQ(ierr);
   ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -685,6 +695,7 @@ PetscErrorCode  VecAXPBY(Vec y,PetscScalar alpha,PetscScalar beta,Vec x)
 PetscErrorCode  VecAXPBYPCZ(Vec z,PetscScalar alpha,PetscScalar beta,PetscScalar gamma,Vec x,Vec y)
 {
   PetscErrorCode ierr;
+  PetscBool      lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,5);
@@ -704,7 +715,8 @@ PetscErrorCode  VecAXPBYPCZ(Vec z,PetscScalar alpha,PetscScalar beta,PetscScalar
   PetscValidLogicalCollectiveScalar(z,gamma,4);
 
   ierr = PetscLogEventBegin(VEC_AXPBYPCZ,x,y,z,0);CHKERRQ(ierr);
-  ierr = (*y->ops->axpbypcz)(z,alpha,beta,gamma,x,y);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_AXPBYPCZ,z,x,y,alpha,beta,gamma,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*y->ops->axpbypcz)(z,alpha,beta,gamma,x,y);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_AXPBYPCZ,x,y,z,0);CHKERRQ(ierr);
   ierr = PetscObjectStateIncrease((PetscObject)z);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -735,6 +747,7 @@ PetscErrorCode  VecAXPBYPCZ(Vec z,PetscScalar alpha,PetscScalar beta,PetscScalar
 PetscErrorCode  VecAYPX(Vec y,PetscScalar alpha,Vec x)
 {
   PetscErrorCode ierr;
+  PetscBool      lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,3);
@@ -747,7 +760,8 @@ PetscErrorCode  VecAYPX(Vec y,PetscScalar alpha,Vec x)
   PetscValidLogicalCollectiveScalar(y,alpha,2);
 
   ierr = PetscLogEventBegin(VEC_AYPX,x,y,0,0);CHKERRQ(ierr);
-  ierr =  (*y->ops->aypx)(y,alpha,x);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_AYPX,y,x,NULL,alpha,0.0,0.0,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*y->ops->aypx)(y,alpha,x);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_AYPX,x,y,0,0);CHKERRQ(ierr);
   ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -779,6 +793,7 @@ PetscErrorCode  VecAYPX(Vec y,PetscScalar alpha,Vec x)
 PetscErrorCode  VecWAXPY(Vec w,PetscScalar alpha,Vec x,Vec y)
 {
   PetscErrorCode ierr;
+  PetscBool      lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(w,VEC_CLASSID,1);
@@ -796,7 +811,8 @@ PetscErrorCode  VecWAXPY(Vec w,PetscScalar alpha,Vec x,Vec y)
   PetscValidLogicalCollectiveScalar(y,alpha,2);
 
   ierr = PetscLogEventBegin(VEC_WAXPY,x,y,w,0);CHKERRQ(ierr);
-  ierr =  (*w->ops->waxpy)(w,alpha,x,y);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_WAXPY,w,x,y,alpha,0.0,0.0,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*w->ops->waxpy)(w,alpha,x,y);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_WAXPY,x,y,w,0);CHKERRQ(ierr);
   ierr = PetscObjectStateIncrease((PetscObject)w);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1583,6 +1599,7 @@ PetscErrorCode VecGetArray(Vec x,PetscScalar **a)
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   ierr = VecSetErrorIfLocked(x,1);CHKERRQ(ierr);
+  ierr = VecLazyFlush(x);CHKERRQ(ierr);
   if (x->petscnative) {
 #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
     if (x->valid_GPU_array == PETSC_OFFLOAD_GPU) {
@@ -1617,6 +1634,7 @@ PetscErrorCode VecGetArray(Vec x,PetscScalar **a)
       ierr = (*x->ops->getarray)(x,a);CHKERRQ(ierr);
     } else SETERRQ1(PetscObjectComm((PetscObject)x),PETSC_ERR_SUP,"Cannot get array for vector type \"%s\"",((PetscObject)x)->type_name);
   }
+  x->narrays++;
   PetscFunctionReturn(0);
 }
 
@@ -1653,6 +1671,7 @@ PetscErrorCode VecGetArrayRead(Vec x,const PetscScalar **a)
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
+  ierr = VecLazyFlush(x);CHKERRQ(ierr);
   if (x->petscnative) {
 #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
     if (x->valid_GPU_array == PETSC_OFFLOAD_GPU) {
@@ -1675,6 +1694,7 @@ PetscErrorCode VecGetArrayRead(Vec x,const PetscScalar **a)
   } else {
     ierr = (*x->ops->getarray)(x,(PetscScalar**)a);CHKERRQ(ierr);
   }
+  x->narrays++;
   PetscFunctionReturn(0);
 }
 
@@ -1779,7 +1799,8 @@ PetscErrorCode  VecRestoreArrays(const Vec x[],PetscInt n,PetscScalar **a[])
 
    This routine actually zeros out the a pointer. This is to prevent accidental
    use of the array after it has been restored. If you pass null for a it will
-   not zero the array pointer a.
+   not zero the array pointer a; the caller is then assumed to keep using the array
+   of a regular PETSc vector, so its operations are never deferred by VecSetLazyEvaluation().
 
    Fortran Note:
    This routine is used differently from Fortran 77
@@ -1815,6 +1836,8 @@ PetscErrorCode VecRestoreArray(Vec x,PetscScalar **a)
   } else {
     ierr = (*x->ops->restorearray)(x,a);CHKERRQ(ierr);
   }
+  /* a regular vector restored with NULL keeps its array in the hands of the caller */
+  if (x->narrays && (a || !x->petscnative)) x->narrays--;
   if (a) *a = NULL;
   ierr = PetscObjectStateIncrease((PetscObject)x);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1831,6 +1854,9 @@ PetscErrorCode VecRestoreArray(Vec x,PetscScalar **a)
 
    Level: beginner
 
+   Notes:
+   As with VecRestoreArray(), a null array keeps the array of a regular PETSc vector in the hands of the caller.
+
 .seealso: VecGetArray(), VecRestoreArray(), VecGetArrayPair(), VecRestoreArrayPair()
 @*/
 PetscErrorCode VecRestoreArrayRead(Vec x,const PetscScalar **a)
@@ -1846,6 +1872,8 @@ PetscErrorCode VecRestoreArrayRead(Vec x,const PetscScalar **a)
   } else {
     ierr = (*x->ops->restorearray)(x,(PetscScalar**)a);CHKERRQ(ierr);
   }
+  /* a regular vector restored with NULL keeps its array in the hands of the caller */
+  if (x->narrays && (a || !x->petscnative)) x->narrays--;
   if (a) *a = NULL;
   PetscFunctionReturn(0);
 }
@@ -1877,6 +1905,7 @@ PetscErrorCode  VecPlaceArray(Vec vec,const PetscScalar array[])
   PetscValidHeaderSpecific(vec,VEC_CLASSID,1);
   PetscValidType(vec,1);
   if (array) PetscValidScalarPointer(array,2);
+  ierr = VecLazyFlush(vec);CHKERRQ(ierr);
   if (vec->ops->placearray) {
     ierr = (*vec->ops->placearray)(vec,array);CHKERRQ(ierr);
   } else SETERRQ(PetscObjectComm((PetscObject)vec),PETSC_ERR_SUP,"Cannot place array in this type of vector");
@@ -1916,6 +1945,7 @@ PetscErrorCode  VecReplaceArray(Vec vec,const PetscScalar array[])
   PetscFunctionBegin;
   PetscValidHeaderSpecific(vec,VEC_CLASSID,1);
   PetscValidType(vec,1);
+  ierr = VecLazyFlush(vec);CHKERRQ(ierr);
   if (vec->ops->replacearray) {
     ierr = (*vec->ops->replacearray)(vec,array);CHKERRQ(ierr);
   } else SETERRQ(PetscObjectComm((PetscObject)vec),PETSC_ERR_SUP,"Cannot replace array in this type of vector");
@@ -2218,14 +2248,16 @@ PetscErrorCode  VecRestoreArray2d(Vec x,PetscInt m,PetscInt n,PetscInt mstart,Pe
 {
   PetscErrorCode ierr;
   void           *dummy;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidPointer(a,6);
   PetscValidType(x,1);
+  aa    = (m && n) ? (*a)[mstart] + nstart : NULL;
   dummy = (void*)(*a + mstart);
   ierr  = PetscFree(dummy);CHKERRQ(ierr);
-  ierr  = VecRestoreArray(x,NULL);CHKERRQ(ierr);
+  ierr  = VecRestoreArray(x,&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2303,11 +2335,13 @@ PetscErrorCode  VecGetArray1d(Vec x,PetscInt m,PetscInt mstart,PetscScalar *a[])
 PetscErrorCode  VecRestoreArray1d(Vec x,PetscInt m,PetscInt mstart,PetscScalar *a[])
 {
   PetscErrorCode ierr;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidType(x,1);
-  ierr = VecRestoreArray(x,NULL);CHKERRQ(ierr);
+  aa   = *a + mstart;
+  ierr = VecRestoreArray(x,&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2405,14 +2439,16 @@ PetscErrorCode  VecRestoreArray3d(Vec x,PetscInt m,PetscInt n,PetscInt p,PetscIn
 {
   PetscErrorCode ierr;
   void           *dummy;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidPointer(a,8);
   PetscValidType(x,1);
+  aa    = (m && n && p) ? (*a)[mstart][nstart] + pstart : NULL;
   dummy = (void*)(*a + mstart);
   ierr  = PetscFree(dummy);CHKERRQ(ierr);
-  ierr  = VecRestoreArray(x,NULL);CHKERRQ(ierr);
+  ierr  = VecRestoreArray(x,&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2517,14 +2553,16 @@ PetscErrorCode  VecRestoreArray4d(Vec x,PetscInt m,PetscInt n,PetscInt p,PetscIn
 {
   PetscErrorCode ierr;
   void           *dummy;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidPointer(a,8);
   PetscValidType(x,1);
+  aa    = (m && n && p && q) ? (*a)[mstart][nstart][pstart] + qstart : NULL;
   dummy = (void*)(*a + mstart);
   ierr  = PetscFree(dummy);CHKERRQ(ierr);
-  ierr  = VecRestoreArray(x,NULL);CHKERRQ(ierr);
+  ierr  = VecRestoreArray(x,&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2612,14 +2650,16 @@ PetscErrorCode  VecRestoreArray2dRead(Vec x,PetscInt m,PetscInt n,PetscInt mstar
 {
   PetscErrorCode ierr;
   void           *dummy;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidPointer(a,6);
   PetscValidType(x,1);
+  aa    = (m && n) ? (*a)[mstart] + nstart : NULL;
   dummy = (void*)(*a + mstart);
   ierr  = PetscFree(dummy);CHKERRQ(ierr);
-  ierr  = VecRestoreArrayRead(x,NULL);CHKERRQ(ierr);
+  ierr  = VecRestoreArrayRead(x,(const PetscScalar**)&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2697,11 +2737,13 @@ PetscErrorCode  VecGetArray1dRead(Vec x,PetscInt m,PetscInt mstart,PetscScalar *
 PetscErrorCode  VecRestoreArray1dRead(Vec x,PetscInt m,PetscInt mstart,PetscScalar *a[])
 {
   PetscErrorCode ierr;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidType(x,1);
-  ierr = VecRestoreArrayRead(x,NULL);CHKERRQ(ierr);
+  aa   = *a + mstart;
+  ierr = VecRestoreArrayRead(x,(const PetscScalar**)&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2800,14 +2842,16 @@ PetscErrorCode  VecRestoreArray3dRead(Vec x,PetscInt m,PetscInt n,PetscInt p,Pet
 {
   PetscErrorCode ierr;
   void           *dummy;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidPointer(a,8);
   PetscValidType(x,1);
+  aa    = (m && n && p) ? (*a)[mstart][nstart] + pstart : NULL;
   dummy = (void*)(*a + mstart);
   ierr  = PetscFree(dummy);CHKERRQ(ierr);
-  ierr  = VecRestoreArrayRead(x,NULL);CHKERRQ(ierr);
+  ierr  = VecRestoreArrayRead(x,(const PetscScalar**)&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2913,14 +2957,16 @@ PetscErrorCode  VecRestoreArray4dRead(Vec x,PetscInt m,PetscInt n,PetscInt p,Pet
 {
   PetscErrorCode ierr;
   void           *dummy;
+  PetscScalar    *aa;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
   PetscValidPointer(a,8);
   PetscValidType(x,1);
+  aa    = (m && n && p && q) ? (*a)[mstart][nstart][pstart] + qstart : NULL;
   dummy = (void*)(*a + mstart);
   ierr  = PetscFree(dummy);CHKERRQ(ierr);
-  ierr  = VecRestoreArrayRead(x,NULL);CHKERRQ(ierr);
+  ierr  = VecRestoreArrayRead(x,(const PetscScalar**)&aa);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
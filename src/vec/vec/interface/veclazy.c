@@ -0,0 +1,537 @@
+/*
+   Deferred evaluation of the pointwise vector operations. When it is turned on, VecSet(), VecScale(), VecCopy(),
+   VecAXPY(), VecAYPX(), VecAXPBY(), VecAXPBYPCZ(), VecWAXPY() and VecPointwiseMult() on standard vectors only
+   record the operation; the recorded operations are applied in one pass over the vectors, strip by strip, at
+   the first access to the array of any vector. VecNorm(), VecDot() and their split forms VecNormBegin() and
+   VecDotBegin() compute their local part in the same pass.
+
+   Each communicator on which the deferred evaluation is turned on has its own queue of operations, attached to
+   the communicator as an attribute, so only vectors of the same communicator are applied together. A vector can
+   share its array with a vector of another communicator, such as the local form of a ghosted vector, so the
+   access to the array of a vector also applies the queues of the other communicators that hold this array.
+*/
+#include <../src/vec/vec/impls/mpi/pvecimpl.h>    /*I  "petscvec.h"   I*/
+
+#define VEC_LAZY_MAX_OPS  16
+#define VEC_LAZY_MAX_VECS 8
+/* length of the strips, all the vectors of one strip should fit in the cache */
+#define VEC_LAZY_STRIP    1024
+
+typedef struct {
+  VecLazyOpType type;
+  PetscInt      w,x,y;              /* positions in the vectors of the queue of the output and the inputs */
+  PetscScalar   alpha,beta,gamma;
+  PetscLogDouble flops;
+} VecLazyOp;
+
+typedef enum {VEC_LAZY_REDUCE_NONE,VEC_LAZY_REDUCE_NORM2,VEC_LAZY_REDUCE_DOT} VecLazyReduceType;
+
+typedef struct _n_VecLazy VecLazy;
+struct _n_VecLazy {
+  MPI_Comm  comm;                   /* the PETSc communicator of the vectors, referenced while the queue exists */
+  PetscInt  numops,numvecs,localsize;
+  Vec       vecs[VEC_LAZY_MAX_VECS];
+  VecLazyOp ops[VEC_LAZY_MAX_OPS];
+  VecLazy   *next;                  /* the queues of all the communicators are linked together */
+};
+
+PetscInt        VecLazyNumOps = 0;    /* number of operations recorded on all the communicators */
+static PetscInt VecLazyNumComms = 0;  /* number of communicators with deferred evaluation */
+static VecLazy  *VecLazyQueues = NULL;
+PetscMPIInt     Petsc_VecLazy_keyval = MPI_KEYVAL_INVALID;
+
+/* Private routine to delete the queue when the attribute is deleted, called by MPI */
+PETSC_EXTERN int MPIAPI Petsc_DelVecLazy(MPI_Comm comm,int keyval,void *attr_val,void *extra_state)
+{
+  VecLazy        *lz = (VecLazy*)attr_val,**q;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (q=&VecLazyQueues; *q; q=&(*q)->next) if (*q == lz) {*q = lz->next; break;}
+  VecLazyNumOps -= lz->numops;
+  VecLazyNumComms--;
+  ierr = PetscFree(lz);CHKERRMPI(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the queue of the communicator, NULL if the deferred evaluation is off on it */
+PETSC_STATIC_INLINE PetscErrorCode VecLazyGet_Private(MPI_Comm comm,VecLazy **lz)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    flag;
+
+  PetscFunctionBegin;
+  *lz = NULL;
+  if (!VecLazyNumComms) PetscFunctionReturn(0);
+  ierr = MPI_Comm_get_attr(comm,Petsc_VecLazy_keyval,(void**)lz,&flag);CHKERRQ(ierr);
+  if (!flag) *lz = NULL;
+  PetscFunctionReturn(0);
+}
+
+/*
+   the recorded operations only handle the standard sequential and parallel vectors, and not the vectors whose
+   array the caller holds, since the caller expects the array to change as soon as the operation is called
+*/
+PETSC_STATIC_INLINE PetscBool VecLazyIsStandard(Vec v)
+{
+  return (PetscBool)(v->petscnative && v->ops->axpy == VecAXPY_Seq && !v->narrays);
+}
+
+/* returns the position of v in lz->vecs[], adding it if there is room; -1 if v cannot be used */
+static PetscInt VecLazyAddVec_Private(VecLazy *lz,Vec v)
+{
+  PetscInt i;
+
+  for (i=0; i<lz->numvecs; i++) if (lz->vecs[i] == v) return i;
+  if (lz->numvecs == VEC_LAZY_MAX_VECS || !VecLazyIsStandard(v) || PetscObjectComm((PetscObject)v) != lz->comm) return -1;
+  if (lz->numvecs && v->map->n != lz->localsize) return -1;
+  if (!lz->numvecs) lz->localsize = v->map->n;
+  lz->vecs[lz->numvecs] = v;
+  return lz->numvecs++;
+}
+
+/* adds w and, if they are not NULL, x and y; nothing is added if one of them cannot be used */
+static PetscBool VecLazyAddVecs_Private(VecLazy *lz,Vec w,Vec x,Vec y,PetscInt *iw,PetscInt *ix,PetscInt *iy)
+{
+  PetscInt nvecs = lz->numvecs;
+
+  *ix = *iy = -1;
+  *iw = VecLazyAddVec_Private(lz,w);
+  if (*iw >= 0 && x) *ix = VecLazyAddVec_Private(lz,x);
+  if (*iw >= 0 && (!x || *ix >= 0) && y) *iy = VecLazyAddVec_Private(lz,y);
+  if (*iw < 0 || (x && *ix < 0) || (y && *iy < 0)) {
+    lz->numvecs = nvecs;
+    return PETSC_FALSE;
+  }
+  return PETSC_TRUE;
+}
+
+/*
+   Applies the recorded operations, strip by strip, and computes in the same pass the local part of the
+   reduction rtype of the vectors in the positions rx and ry.
+*/
+static PetscErrorCode VecLazyApply_Private(VecLazy *lz,VecLazyReduceType rtype,PetscInt rx,PetscInt ry,PetscScalar *result)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = lz->localsize,s,e,i,k;
+  PetscScalar       *a[VEC_LAZY_MAX_VECS],*w,alpha,beta,gamma,sum = 0.0;
+  const PetscScalar *x,*y;
+  PetscReal         sumr = 0.0;
+  PetscLogDouble    flops = 0.0;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(VEC_LazyApply,0,0,0,0);CHKERRQ(ierr);
+  for (k=0; k<lz->numvecs; k++) a[k] = *((PetscScalar**)lz->vecs[k]->data);
+  for (s=0; s<n; s=e) {
+    e = PetscMin(n,s+VEC_LAZY_STRIP);
+    for (k=0; k<lz->numops; k++) {
+      w     = a[lz->ops[k].w];
+      x     = lz->ops[k].x >= 0 ? a[lz->ops[k].x] : NULL;
+      y     = lz->ops[k].y >= 0 ? a[lz->ops[k].y] : NULL;
+      alpha = lz->ops[k].alpha; beta = lz->ops[k].beta; gamma = lz->ops[k].gamma;
+      switch (lz->ops[k].type) {
+      case VEC_LAZY_SET:
+        if (alpha == (PetscScalar)0.0) {ierr = PetscMemzero(w+s,(e-s)*sizeof(PetscScalar));CHKERRQ(ierr);}
+        else for (i=s; i<e; i++) w[i] = alpha;
+        break;
+      case VEC_LAZY_SCALE:
+        for (i=s; i<e; i++) w[i] *= alpha;
+        break;
+      case VEC_LAZY_COPY:
+        if (w != x) {ierr = PetscMemcpy(w+s,x+s,(e-s)*sizeof(PetscScalar));CHKERRQ(ierr);}
+        break;
+      case VEC_LAZY_AXPY:
+        for (i=s; i<e; i++) w[i] += alpha*x[i];
+        break;
+      case VEC_LAZY_AYPX:
+        if (alpha == (PetscScalar)-1.0) for (i=s; i<e; i++) w[i] = x[i] - w[i];
+        else                            for (i=s; i<e; i++) w[i] = x[i] + alpha*w[i];
+        break;
+      case VEC_LAZY_AXPBY:
+        if (beta == (PetscScalar)0.0) for (i=s; i<e; i++) w[i] = alpha*x[i];
+        else                          for (i=s; i<e; i++) w[i] = alpha*x[i] + beta*w[i];
+        break;
+      case VEC_LAZY_AXPBYPCZ:
+        if (alpha == (PetscScalar)1.0)      for (i=s; i<e; i++) w[i] = x[i] + beta*y[i] + gamma*w[i];
+        else if (gamma == (PetscScalar)1.0) for (i=s; i<e; i++) w[i] = alpha*x[i] + beta*y[i] + w[i];
+        else if (gamma == (PetscScalar)0.0) for (i=s; i<e; i++) w[i] = alpha*x[i] + beta*y[i];
+        else                                for (i=s; i<e; i++) w[i] = alpha*x[i] + beta*y[i] + gamma*w[i];
+        break;
+      case VEC_LAZY_WAXPY:
+        if (alpha == (PetscScalar)1.0)       for (i=s; i<e; i++) w[i] = y[i] + x[i];
+        else if (alpha == (PetscScalar)-1.0) for (i=s; i<e; i++) w[i] = y[i] - x[i];
+        else                                 for (i=s; i<e; i++) w[i] = y[i] + alpha*x[i];
+        break;
+      case VEC_LAZY_POINTWISEMULT:
+        for (i=s; i<e; i++) w[i] = x[i]*y[i];
+        break;
+      }
+    }
+    if (rtype == VEC_LAZY_REDUCE_NORM2) {
+      x = a[rx];
+      for (i=s; i<e; i++) sumr += PetscRealPart(x[i]*PetscConj(x[i]));
+    } else if (rtype == VEC_LAZY_REDUCE_DOT) {
+      x = a[rx]; y = a[ry];
+      for (i=s; i<e; i++) sum += x[i]*PetscConj(y[i]);
+    }
+  }
+  for (k=0; k<lz->numops; k++) flops += lz->ops[k].flops;
+  if (rtype != VEC_LAZY_REDUCE_NONE) flops += PetscMax(2.0*n-1,0.0);
+  ierr = PetscInfo3(NULL,"Applied %D vector operations on %D vectors of local length %D in one pass\n",lz->numops,lz->numvecs,n);CHKERRQ(ierr);
+  VecLazyNumOps -= lz->numops;
+  lz->numops     = lz->numvecs = 0;
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_LazyApply,0,0,0,0);CHKERRQ(ierr);
+  if (result) *result = rtype == VEC_LAZY_REDUCE_NORM2 ? (PetscScalar)sumr : sum;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecLazyFlushQueue_Private(VecLazy *lz)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!lz->numops) {lz->numvecs = 0; PetscFunctionReturn(0);}
+  ierr = VecLazyApply_Private(lz,VEC_LAZY_REDUCE_NONE,-1,-1,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* whether one of the vectors of the queue may share its array with v; any vector may if v is not standard */
+static PetscBool VecLazyHoldsArray_Private(VecLazy *lz,Vec v)
+{
+  const PetscScalar *a,*b;
+  PetscInt          k;
+
+  if (!v->petscnative) return PETSC_TRUE;
+  a = *((PetscScalar**)v->data);
+  if (!a) return PETSC_FALSE;
+  for (k=0; k<lz->numvecs; k++) {
+    b = *((PetscScalar**)lz->vecs[k]->data);
+    if (a < b + lz->localsize && b < a + v->map->n) return PETSC_TRUE;
+  }
+  return PETSC_FALSE;
+}
+
+/* applies the queues, other than lz, that hold the array of v */
+static PetscErrorCode VecLazyFlushShared_Private(VecLazy *lz,Vec v)
+{
+  PetscErrorCode ierr;
+  VecLazy        *q;
+
+  PetscFunctionBegin;
+  if (!v) PetscFunctionReturn(0);
+  for (q=VecLazyQueues; q && VecLazyNumOps; q=q->next) {
+    if (q != lz && q->numops && VecLazyHoldsArray_Private(q,v)) {ierr = VecLazyFlushQueue_Private(q);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecLazyFlush_Private - Applies the operations recorded on the communicator of v, and those of the other
+   communicators that hold the array of v. Called by the routines that give access to the array of v, or change
+   it, when VecLazyNumOps is nonzero.
+*/
+PetscErrorCode VecLazyFlush_Private(Vec v)
+{
+  PetscErrorCode ierr;
+  VecLazy        *lz;
+
+  PetscFunctionBegin;
+  ierr = VecLazyGet_Private(PetscObjectComm((PetscObject)v),&lz);CHKERRQ(ierr);
+  if (lz) {ierr = VecLazyFlushQueue_Private(lz);CHKERRQ(ierr);}
+  ierr = VecLazyFlushShared_Private(lz,v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecLazyRecord_Private - Records the operation type with the output w and the inputs x and y (which may be NULL),
+   instead of computing it, if deferred evaluation is on for the communicator of w and the vectors are standard
+   vectors of this communicator with the local size of the other recorded vectors. Otherwise recorded is PETSC_FALSE, and the recorded operations are applied when the
+   caller accesses the arrays.
+
+   The caller does everything else that the operation does, such as logging and increasing the object state.
+*/
+PetscErrorCode VecLazyRecord_Private(VecLazyOpType type,Vec w,Vec x,Vec y,PetscScalar alpha,PetscScalar beta,PetscScalar gamma,PetscBool *recorded)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = w->map->n,iw,ix,iy;
+  VecLazy        *lz;
+  VecLazyOp      *op;
+
+  PetscFunctionBegin;
+  *recorded = PETSC_FALSE;
+  ierr = VecLazyGet_Private(PetscObjectComm((PetscObject)w),&lz);CHKERRQ(ierr);
+  if (!lz) PetscFunctionReturn(0);
+  /* each operation type is recorded only if the vector would have used the standard implementation */
+  switch (type) {
+  case VEC_LAZY_SET:           if (w->ops->set != VecSet_Seq) PetscFunctionReturn(0); break;
+  case VEC_LAZY_SCALE:         if (w->ops->scale != VecScale_Seq) PetscFunctionReturn(0); break;
+  case VEC_LAZY_COPY:          if (x->ops->copy != VecCopy_Seq) PetscFunctionReturn(0); break;
+  case VEC_LAZY_AXPY:          break;
+  case VEC_LAZY_AYPX:          if (w->ops->aypx != VecAYPX_Seq) PetscFunctionReturn(0); break;
+  case VEC_LAZY_AXPBY:         if (w->ops->axpby != VecAXPBY_Seq) PetscFunctionReturn(0); break;
+  case VEC_LAZY_AXPBYPCZ:      if (y->ops->axpbypcz != VecAXPBYPCZ_Seq) PetscFunctionReturn(0); break;
+  case VEC_LAZY_WAXPY:         if (w->ops->waxpy != VecWAXPY_Seq) PetscFunctionReturn(0); break;
+  case VEC_LAZY_POINTWISEMULT: if (w->ops->pointwisemult != VecPointwiseMult_Seq) PetscFunctionReturn(0); break;
+  }
+  /* the operations recorded on other communicators for the same arrays come first */
+  if (VecLazyNumOps > lz->numops) {
+    ierr = VecLazyFlushShared_Private(lz,w);CHKERRQ(ierr);
+    ierr = VecLazyFlushShared_Private(lz,x);CHKERRQ(ierr);
+    ierr = VecLazyFlushShared_Private(lz,y);CHKERRQ(ierr);
+  }
+  if (lz->numops == VEC_LAZY_MAX_OPS) {ierr = VecLazyFlushQueue_Private(lz);CHKERRQ(ierr);}
+  if (!VecLazyAddVecs_Private(lz,w,x,y,&iw,&ix,&iy)) {
+    /* apply the recorded operations and start again with these vectors */
+    if (!lz->numops) PetscFunctionReturn(0);
+    ierr = VecLazyFlushQueue_Private(lz);CHKERRQ(ierr);
+    if (!VecLazyAddVecs_Private(lz,w,x,y,&iw,&ix,&iy)) PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(w,1);CHKERRQ(ierr);
+
+  /* the special values of the coefficients follow the sequential implementations */
+  op        = lz->ops + lz->numops;
+  op->type  = type; op->w = iw; op->x = ix; op->y = iy;
+  op->alpha = alpha; op->beta = beta; op->gamma = gamma;
+  switch (type) {
+  case VEC_LAZY_SET:
+    op->flops = 0.0;
+    break;
+  case VEC_LAZY_SCALE:
+    if (alpha == (PetscScalar)0.0) op->type = VEC_LAZY_SET;
+    op->flops = n;
+    break;
+  case VEC_LAZY_COPY:
+    op->flops = 0.0;
+    break;
+  case VEC_LAZY_AXPY:
+    op->flops = 2.0*n;
+    break;
+  case VEC_LAZY_AYPX:
+    if (alpha == (PetscScalar)0.0) op->type = VEC_LAZY_COPY;
+    op->flops = alpha == (PetscScalar)0.0 ? 0.0 : (alpha == (PetscScalar)-1.0 ? 1.0*n : 2.0*n);
+    break;
+  case VEC_LAZY_AXPBY:
+    if (alpha == (PetscScalar)0.0) {
+      op->type  = beta == (PetscScalar)0.0 ? VEC_LAZY_SET : VEC_LAZY_SCALE;
+      op->alpha = beta;
+      op->flops = n;
+    } else if (beta == (PetscScalar)1.0) {
+      op->type  = VEC_LAZY_AXPY;
+      op->flops = 2.0*n;
+    } else if (alpha == (PetscScalar)1.0) {
+      op->type  = beta == (PetscScalar)0.0 ? VEC_LAZY_COPY : VEC_LAZY_AYPX;
+      op->alpha = beta;
+      op->flops = beta == (PetscScalar)0.0 ? 0.0 : 2.0*n;
+    } else op->flops = beta == (PetscScalar)0.0 ? 1.0*n : 3.0*n;
+    break;
+  case VEC_LAZY_AXPBYPCZ:
+    op->flops = (alpha == (PetscScalar)1.0 || gamma == (PetscScalar)1.0) ? 4.0*n : (gamma == (PetscScalar)0.0 ? 3.0*n : 5.0*n);
+    break;
+  case VEC_LAZY_WAXPY:
+    if (alpha == (PetscScalar)0.0) {op->type = VEC_LAZY_COPY; op->x = iy;}
+    op->flops = alpha == (PetscScalar)0.0 ? 0.0 : ((alpha == (PetscScalar)1.0 || alpha == (PetscScalar)-1.0) ? 1.0*n : 2.0*n);
+    break;
+  case VEC_LAZY_POINTWISEMULT:
+    op->flops = n;
+    break;
+  }
+  lz->numops++;
+  VecLazyNumOps++;
+  *recorded = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecLazyNormLocal_Private - If operations are recorded, applies them and computes in the same pass the local
+   sum of the squares of the entries of x. done is PETSC_FALSE, and nothing is computed, if x cannot take part.
+*/
+PetscErrorCode VecLazyNormLocal_Private(Vec x,PetscReal *sumsq,PetscBool *done)
+{
+  PetscErrorCode ierr;
+  PetscInt       ix;
+  PetscScalar    result;
+  VecLazy        *lz;
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+  if (!VecLazyNumOps || x->ops->norm_local != VecNorm_Seq) PetscFunctionReturn(0);
+  ierr = VecLazyGet_Private(PetscObjectComm((PetscObject)x),&lz);CHKERRQ(ierr);
+  if (!lz || !lz->numops) PetscFunctionReturn(0);
+  ierr = VecLazyFlushShared_Private(lz,x);CHKERRQ(ierr);
+  ix   = VecLazyAddVec_Private(lz,x);
+  if (ix < 0) PetscFunctionReturn(0);
+  ierr   = VecLazyApply_Private(lz,VEC_LAZY_REDUCE_NORM2,ix,-1,&result);CHKERRQ(ierr);
+  *sumsq = PetscRealPart(result);
+  *done  = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecLazyDotLocal_Private - If operations are recorded, applies them and computes in the same pass the local
+   part of y^H x. done is PETSC_FALSE, and nothing is computed, if x or y cannot take part.
+*/
+PetscErrorCode VecLazyDotLocal_Private(Vec x,Vec y,PetscScalar *val,PetscBool *done)
+{
+  PetscErrorCode ierr;
+  PetscInt       nvecs,ix,iy = -1;
+  VecLazy        *lz;
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+  if (!VecLazyNumOps || x->ops->dot_local != VecDot_Seq) PetscFunctionReturn(0);
+  ierr = VecLazyGet_Private(PetscObjectComm((PetscObject)x),&lz);CHKERRQ(ierr);
+  if (!lz || !lz->numops) PetscFunctionReturn(0);
+  ierr  = VecLazyFlushShared_Private(lz,x);CHKERRQ(ierr);
+  ierr  = VecLazyFlushShared_Private(lz,y);CHKERRQ(ierr);
+  nvecs = lz->numvecs;
+  ix    = VecLazyAddVec_Private(lz,x);
+  if (ix >= 0) iy = VecLazyAddVec_Private(lz,y);
+  if (iy < 0) {lz->numvecs = nvecs; PetscFunctionReturn(0);}
+  ierr  = VecLazyApply_Private(lz,VEC_LAZY_REDUCE_DOT,ix,iy,val);CHKERRQ(ierr);
+  *done = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecLazyNorm_Private - VecLazyNormLocal_Private() followed by the reduction of VecNorm(), for the 2-norm of
+   the standard vectors
+*/
+PetscErrorCode VecLazyNorm_Private(Vec x,NormType type,PetscReal *val,PetscBool *done)
+{
+  PetscErrorCode ierr;
+  PetscReal      work,sum;
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+  if (!VecLazyNumOps || (type != NORM_2 && type != NORM_FROBENIUS) || (x->ops->norm != VecNorm_Seq && x->ops->norm != VecNorm_MPI)) PetscFunctionReturn(0);
+  ierr = VecLazyNormLocal_Private(x,&work,done);CHKERRQ(ierr);
+  if (!*done) PetscFunctionReturn(0);
+  if (x->ops->norm == VecNorm_MPI) {
+    ierr = MPIU_Allreduce(&work,&sum,1,MPIU_REAL,MPIU_SUM,PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  } else sum = work;
+  *val = PetscSqrtReal(sum);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecLazyDot_Private - VecLazyDotLocal_Private() followed by the reduction of VecDot(), for the standard vectors
+*/
+PetscErrorCode VecLazyDot_Private(Vec x,Vec y,PetscScalar *val,PetscBool *done)
+{
+  PetscErrorCode ierr;
+  PetscScalar    work;
+
+  PetscFunctionBegin;
+  *done = PETSC_FALSE;
+  if (!VecLazyNumOps || (x->ops->dot != VecDot_Seq && x->ops->dot != VecDot_MPI)) PetscFunctionReturn(0);
+  ierr = VecLazyDotLocal_Private(x,y,&work,done);CHKERRQ(ierr);
+  if (!*done) PetscFunctionReturn(0);
+  if (x->ops->dot == VecDot_MPI) {
+    ierr = MPIU_Allreduce(&work,val,1,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  } else *val = work;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecSetLazyEvaluation - Turns on or off the deferred evaluation of the pointwise vector operations on a communicator
+
+   Logically Collective on MPI_Comm
+
+   Input Parameters:
++  comm - the communicator of the vectors
+-  flg - PETSC_TRUE to defer the operations
+
+   Options Database Key:
+.  -vec_lazy_evaluation - defer the operations on PETSC_COMM_WORLD
+
+   Notes:
+   With deferred evaluation VecSet(), VecScale(), VecCopy(), VecAXPY(), VecAYPX(), VecAXPBY(), VecAXPBYPCZ(),
+   VecWAXPY() and VecPointwiseMult() on VECSEQ and VECMPI vectors of comm with the same local size only record
+   the operation, unless the array of one of the vectors has been obtained and not yet restored, or restored with
+   a null pointer (see VecRestoreArray()). The recorded
+   operations are applied together, in a single pass over the vectors, when the array of any of these vectors, or
+   of a vector sharing its array such as the local form of a ghosted vector, is
+   accessed (VecGetArray(), VecGetArrayRead(), and thus by all other vector and matrix operations), when one of
+   them is destroyed, or before a VecScatterBegin(). VecNorm() with NORM_2, VecDot(), VecNormBegin() with NORM_2
+   and VecDotBegin() compute their local part in the same pass. Up to 16 operations on 8 vectors are recorded.
+   Turning the deferred evaluation off applies the recorded operations.
+
+   Each communicator has its own queue of recorded operations; the vectors of other communicators, for instance
+   the sequential vectors on PETSC_COMM_SELF of a parallel run, are not deferred unless the evaluation is turned
+   on for their communicator as well.
+
+   The results can differ from those without deferred evaluation: the reductions computed in the pass sum the
+   entries in a different order, so norms and inner products change in the last digits, and the iterates of a
+   Krylov method and its convergence history may change slightly (for instance those of KSPLSQR on two processes).
+
+   Turn the deferred evaluation off before the communicator is freed.
+
+   Level: advanced
+
+.seealso: VecLazyEvaluationFlush(), VecAXPY(), VecNormBegin()
+@*/
+PetscErrorCode VecSetLazyEvaluation(MPI_Comm comm,PetscBool flg)
+{
+  PetscErrorCode ierr;
+  MPI_Comm       icomm,held;
+  VecLazy        *lz;
+  PetscMPIInt    flag;
+
+  PetscFunctionBegin;
+  if (Petsc_VecLazy_keyval == MPI_KEYVAL_INVALID) {
+    if (!flg) PetscFunctionReturn(0);
+    ierr = MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,Petsc_DelVecLazy,&Petsc_VecLazy_keyval,NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscCommDuplicate(comm,&icomm,NULL);CHKERRQ(ierr);
+  ierr = MPI_Comm_get_attr(icomm,Petsc_VecLazy_keyval,(void**)&lz,&flag);CHKERRQ(ierr);
+  if (flg && !flag) {
+    /* the reference to icomm is kept until the deferred evaluation is turned off */
+    ierr     = PetscNew(&lz);CHKERRQ(ierr);
+    lz->comm = icomm;
+    ierr     = MPI_Comm_set_attr(icomm,Petsc_VecLazy_keyval,lz);CHKERRQ(ierr);
+    lz->next      = VecLazyQueues;
+    VecLazyQueues = lz;
+    VecLazyNumComms++;
+    PetscFunctionReturn(0);
+  }
+  if (!flg && flag) {
+    ierr = VecLazyFlushQueue_Private(lz);CHKERRQ(ierr);
+    held = lz->comm;
+    ierr = MPI_Comm_delete_attr(icomm,Petsc_VecLazy_keyval);CHKERRQ(ierr);
+    ierr = PetscCommDestroy(&held);CHKERRQ(ierr);
+  }
+  ierr = PetscCommDestroy(&icomm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecLazyEvaluationFlush - Applies the vector operations recorded with the deferred evaluation on a communicator
+
+   Not Collective
+
+   Input Parameter:
+.  comm - the communicator of the vectors
+
+   Notes:
+   This is only needed to time the operations, or before reading the array of a vector directly; the recorded
+   operations are applied whenever their results are accessed.
+
+   Level: advanced
+
+.seealso: VecSetLazyEvaluation()
+@*/
+PetscErrorCode VecLazyEvaluationFlush(MPI_Comm comm)
+{
+  PetscErrorCode ierr;
+  MPI_Comm       icomm;
+  VecLazy        *lz;
+
+  PetscFunctionBegin;
+  if (!VecLazyNumOps) PetscFunctionReturn(0);
+  ierr = PetscCommDuplicate(comm,&icomm,NULL);CHKERRQ(ierr);
+  ierr = VecLazyGet_Private(icomm,&lz);CHKERRQ(ierr);
+  if (lz) {ierr = VecLazyFlushQueue_Private(lz);CHKERRQ(ierr);}
+  ierr = PetscCommDestroy(&icomm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,117 @@
+/*
+   Pool of the arrays of destroyed VECSEQ and VECMPI vectors. VecDuplicate() and the creation of these vectors take an
+   array of the same local length from the pool, when there is one, instead of allocating a new array, so solvers that
+   are created and destroyed repeatedly reuse the same, already mapped, memory for their work vectors.
+*/
+#include <petsc/private/vecimpl.h>    /*I  "petscvec.h"   I*/
+
+typedef struct {
+  PetscInt    n;
+  PetscScalar *array;
+} VecPoolEntry;
+
+static PetscInt     VecPoolSize = 0,VecPoolNum = 0;    /* capacity and number of arrays in the pool */
+static VecPoolEntry *VecPoolEntries = NULL;
+static PetscInt64   VecPoolHits = 0,VecPoolMisses = 0;
+
+/*
+   VecPoolGet_Private - Gets an array of length n, from the pool if it holds one
+
+   The array is obtained with PetscMalloc1(), with the page placement policy of the vectors, and is not zeroed. Its owner gives it back with VecPoolRestore_Private().
+*/
+PetscErrorCode VecPoolGet_Private(PetscInt n,PetscScalar **array)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  if (VecPoolSize && n > 0) {
+    /* the most recently returned arrays are the most likely to be in the cache */
+    for (i=VecPoolNum-1; i>=0; i--) {
+      if (VecPoolEntries[i].n == n) {
+        ierr   = PetscLogEventBegin(VEC_PoolHit,0,0,0,0);CHKERRQ(ierr);
+        *array = VecPoolEntries[i].array;
+        VecPoolEntries[i] = VecPoolEntries[--VecPoolNum];
+        VecPoolHits++;
+        ierr   = PetscLogEventEnd(VEC_PoolHit,0,0,0,0);CHKERRQ(ierr);
+        PetscFunctionReturn(0);
+      }
+    }
+    ierr = PetscLogEventBegin(VEC_PoolMiss,0,0,0,0);CHKERRQ(ierr);
+    ierr = PetscMallocPushClass(VEC_CLASSID);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n,array);CHKERRQ(ierr);
+    ierr = PetscMallocPopClass();CHKERRQ(ierr);
+    VecPoolMisses++;
+    ierr = PetscLogEventEnd(VEC_PoolMiss,0,0,0,0);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMallocPushClass(VEC_CLASSID);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,array);CHKERRQ(ierr);
+  ierr = PetscMallocPopClass();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecPoolRestore_Private - Gives back an array of length n obtained with VecPoolGet_Private(), or frees it
+
+   n = 0 marks arrays that do not come from VecPoolGet_Private(), they are always freed.
+*/
+PetscErrorCode VecPoolRestore_Private(PetscInt n,PetscScalar **array)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (n > 0 && *array && VecPoolNum < VecPoolSize) {
+    VecPoolEntries[VecPoolNum].n       = n;
+    VecPoolEntries[VecPoolNum++].array = *array;
+    *array = NULL;
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscFree(*array);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecSetArrayPoolSize - Sets how many arrays of destroyed vectors are kept for reuse by new vectors
+
+   Not Collective
+
+   Input Parameter:
+.  size - the maximum number of arrays kept, 0 frees them and turns off the pool
+
+   Options Database Keys:
+.  -vec_array_pool_size <size> - sets the number of arrays kept
+
+   Notes:
+   The arrays of destroyed VECSEQ and VECMPI vectors, other than those provided by the user, go into the pool as
+   long as it holds fewer than size arrays. A new vector of one of these types, in particular from VecDuplicate(),
+   VecDuplicateVecs() and thus KSPCreateVecs() or the work vectors of the solvers, takes an array of the same local
+   length (including ghost points) from the pool when there is one. This saves the allocation, and the page faults
+   at the first access, when solvers are repeatedly destroyed and created. The reused array is zeroed like a new one.
+
+   The events VecPoolHit and VecPoolMiss in -log_view count the vectors that got their array from the pool and those
+   that had to allocate it.
+
+   Level: advanced
+
+.seealso: VecDuplicate(), VecDuplicateVecs(), VecDestroy()
+@*/
+PetscErrorCode VecSetArrayPoolSize(PetscInt size)
+{
+  PetscErrorCode ierr;
+  VecPoolEntry   *entries;
+
+  PetscFunctionBegin;
+  if (size < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Size of the pool %D cannot be negative",size);
+  for (; VecPoolNum>size; VecPoolNum--) {ierr = PetscFree(VecPoolEntries[VecPoolNum-1].array);CHKERRQ(ierr);}
+  if (size == VecPoolSize) PetscFunctionReturn(0);
+  ierr = PetscMalloc1(size,&entries);CHKERRQ(ierr);
+  if (VecPoolNum) {ierr = PetscMemcpy(entries,VecPoolEntries,VecPoolNum*sizeof(VecPoolEntry));CHKERRQ(ierr);}
+  ierr = PetscFree(VecPoolEntries);CHKERRQ(ierr);
+  VecPoolEntries = entries;
+  VecPoolSize    = size;
+  if (!size) {
+    ierr = PetscInfo2(NULL,"Vector array pool: %lld arrays reused, %lld allocated\n",(long long)VecPoolHits,(long long)VecPoolMisses);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
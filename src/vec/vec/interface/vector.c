@@ -16,6 +16,8 @@ PetscLogEvent VEC_DotNorm2, VEC_AXPBYPCZ;
 PetscLogEvent VEC_ViennaCLCopyFromGPU, VEC_ViennaCLCopyToGPU;
 PetscLogEvent VEC_CUDACopyFromGPU, VEC_CUDACopyToGPU;
 PetscLogEvent VEC_CUDACopyFromGPUSome, VEC_CUDACopyToGPUSome;
+PetscLogEvent VEC_LazyApply;
+PetscLogEvent VEC_PoolHit, VEC_PoolMiss;
 
 /*@
    VecStashGetInfo - Gets how many values are currently in the vector stash, i.e. need
@@ -402,6 +404,7 @@ PetscErrorCode  VecDestroy(Vec *v)
   PetscValidHeaderSpecific((*v),VEC_CLASSID,1);
   if (--((PetscObject)(*v))->refct > 0) {*v = 0; PetscFunctionReturn(0);}
 
+  ierr = VecLazyFlush(*v);CHKERRQ(ierr);
   ierr = PetscObjectSAWsViewOff((PetscObject)*v);CHKERRQ(ierr);
   /* destroy the internal part */
   if ((*v)->ops->destroy) {
@@ -425,10 +428,17 @@ PetscErrorCode  VecDestroy(Vec *v)
    Output Parameter:
 .  V - location to put pointer to array of vectors
 
+   Options Database Key:
+.  -vec_duplicatevecs_contiguous - for VECSEQ and VECMPI (without ghost points), store the local parts of the new vectors
+      one after another in a single array, so that VecMDot() and VecMAXPY() with consecutive vectors of V use BLAS gemv
+
    Notes:
    Use VecDestroyVecs() to free the space. Use VecDuplicate() to form a single
    vector.
 
+   With -vec_duplicatevecs_contiguous the array is owned by the first vector, which must not be destroyed,
+   nor have its array replaced with VecReplaceArray(), before the other vectors are no longer used.
+
    Fortran Note:
    The Fortran interface is slightly different from that given below, it
    requires one to pass in V a Vec (integer) array of size at least m.
@@ -844,6 +854,7 @@ PetscErrorCode  VecResetArray(Vec vec)
   PetscFunctionBegin;
   PetscValidHeaderSpecific(vec,VEC_CLASSID,1);
   PetscValidType(vec,1);
+  ierr = VecLazyFlush(vec);CHKERRQ(ierr);
   if (vec->ops->resetarray) {
     ierr = (*vec->ops->resetarray)(vec);CHKERRQ(ierr);
   } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Cannot reset array in this type of vector");
@@ -1111,6 +1122,7 @@ PetscErrorCode  VecConjugate(Vec x)
 PetscErrorCode  VecPointwiseMult(Vec w, Vec x,Vec y)
 {
   PetscErrorCode ierr;
+  PetscBool      lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(w,VEC_CLASSID,1);
@@ -1124,7 +1136,8 @@ PetscErrorCode  VecPointwiseMult(Vec w, Vec x,Vec y)
   VecCheckSameSize(w,1,x,2);
   VecCheckSameSize(w,2,y,3);
   ierr = PetscLogEventBegin(VEC_PointwiseMult,x,y,w,0);CHKERRQ(ierr);
-  ierr = (*w->ops->pointwisemult)(w,x,y);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_POINTWISEMULT,w,x,y,0.0,0.0,0.0,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*w->ops->pointwisemult)(w,x,y);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_PointwiseMult,x,y,w,0);CHKERRQ(ierr);
   ierr = PetscObjectStateIncrease((PetscObject)w);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1556,7 +1569,7 @@ PetscErrorCode  VecSetUp(Vec v)
 @*/
 PetscErrorCode  VecCopy(Vec x,Vec y)
 {
-  PetscBool      flgs[4];
+  PetscBool      flgs[4],lazy;
   PetscReal      norms[4] = {0.0,0.0,0.0,0.0};
   PetscErrorCode ierr;
   PetscInt       i;
@@ -1608,10 +1621,12 @@ PetscErrorCode  VecCopy(Vec x,Vec y)
     ierr = VecRestoreArrayRead(x,&xx);CHKERRQ(ierr);
     ierr = VecRestoreArray(y,&yy);CHKERRQ(ierr);
   } else {
-    ierr = (*x->ops->copy)(x,y);CHKERRQ(ierr);
+    ierr = VecLazyRecord_Private(VEC_LAZY_COPY,y,x,NULL,0.0,0.0,0.0,&lazy);CHKERRQ(ierr);
+    if (!lazy) {ierr = (*x->ops->copy)(x,y);CHKERRQ(ierr);}
   }
 #else
-  ierr = (*x->ops->copy)(x,y);CHKERRQ(ierr);
+  ierr = VecLazyRecord_Private(VEC_LAZY_COPY,y,x,NULL,0.0,0.0,0.0,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*x->ops->copy)(x,y);CHKERRQ(ierr);}
 #endif
 
   ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
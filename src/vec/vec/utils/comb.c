@@ -355,6 +355,7 @@ PetscErrorCode  VecDotBegin(Vec x,Vec y,PetscScalar *result)
   PetscErrorCode      ierr;
   PetscSplitReduction *sr;
   MPI_Comm            comm;
+  PetscBool           lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
@@ -369,7 +370,9 @@ PetscErrorCode  VecDotBegin(Vec x,Vec y,PetscScalar *result)
   sr->invecs[sr->numopsbegin]     = (void*)x;
   if (!x->ops->dot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not suppport local dots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->dot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  ierr = VecLazyDotLocal_Private(x,y,sr->lvalues+sr->numopsbegin,&lazy);CHKERRQ(ierr);
+  if (!lazy) {ierr = (*x->ops->dot_local)(x,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);}
+  sr->numopsbegin++;
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -509,6 +512,7 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
   PetscSplitReduction *sr;
   PetscReal           lresult[2];
   MPI_Comm            comm;
+  PetscBool           lazy;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
@@ -522,9 +526,12 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
   sr->invecs[sr->numopsbegin] = (void*)x;
   if (!x->ops->norm_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local norms");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->norm_local)(x,ntype,lresult);CHKERRQ(ierr);
+  lazy = PETSC_FALSE;
+  if (ntype == NORM_2) {ierr = VecLazyNormLocal_Private(x,lresult,&lazy);CHKERRQ(ierr);}
+  if (!lazy) {ierr = (*x->ops->norm_local)(x,ntype,lresult);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  if (ntype == NORM_2)         lresult[0]                = lresult[0]*lresult[0];
+  /* the recorded vector operations give the sum of the squares */
+  if (ntype == NORM_2 && !lazy) lresult[0]                = lresult[0]*lresult[0];
   if (ntype == NORM_1_AND_2)   lresult[1]                = lresult[1]*lresult[1];
   if (ntype == NORM_MAX) sr->reducetype[sr->numopsbegin] = PETSC_SR_REDUCE_MAX;
   else                   sr->reducetype[sr->numopsbegin] = PETSC_SR_REDUCE_SUM;
@@ -138,33 +138,48 @@ static PetscErrorCode VecScatterView_SF(VecScatter vscat,PetscViewer viewer)
  */
 static PetscErrorCode VecScatterRemap_SF(VecScatter vscat,const PetscInt *tomap,const PetscInt *frommap)
 {
-  VecScatter_SF  *data = (VecScatter_SF *)vscat->data;
-  PetscSF        sfs[2],sf;
-  PetscInt       i,j;
-  PetscBool      ident;
-  PetscErrorCode ierr;
+  VecScatter_SF     *data = (VecScatter_SF *)vscat->data;
+  PetscSF           sfs[2],sf;
+  PetscInt          i,j,bs = data->bs,nroots,nleaves,leaf,*mine;
+  const PetscInt    *ilocal;
+  const PetscSFNode *iremote;
+  PetscSFNode       *remote;
+  PetscBool         ident;
+  PetscErrorCode    ierr;
 
   PetscFunctionBegin;
   sfs[0] = data->sf;
   sfs[1] = data->lsf;
 
   if (tomap) {
-    /* check if it is an identity map. If it is, do nothing */
+    /* check if it is an identity map on the leaves of all processes. If it is, do nothing */
     ident = PETSC_TRUE;
-    for (i=0; i<data->sf->nleaves; i++) {if (i != tomap[i]) {ident = PETSC_FALSE; break; } }
+    for (j=0; j<2 && ident; j++) {
+      ierr = PetscSFGetGraph(sfs[j],NULL,&nleaves,&ilocal,NULL);CHKERRQ(ierr);
+      for (i=0; i<nleaves; i++) {
+        leaf = ilocal ? ilocal[i] : i;
+        if (tomap[leaf*bs] != leaf*bs) {ident = PETSC_FALSE; break;}
+      }
+    }
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&ident,1,MPIU_BOOL,MPI_LAND,PetscObjectComm((PetscObject)vscat));CHKERRQ(ierr);
     if (ident) PetscFunctionReturn(0);
 
+    /* The leaves are blocks of bs entries of x, whose first entries tomap must map to the first entries of blocks.
+       The setup of the SF derives the packing of each rank and the communication from the leaves, so the SF is
+       reset with the remapped graph and set up again. */
     for (j=0; j<2; j++) {
       sf   = sfs[j];
-      ierr = PetscSFSetUp(sf);CHKERRQ(ierr); /* to bulid sf->rmine if SetUp is not yet called */
-      if (!sf->mine) { /* the old SF uses contiguous ilocal. After the remapping, it may not be true */
-        ierr = PetscMalloc1(sf->nleaves,&sf->mine);CHKERRQ(ierr);
-        ierr = PetscMemcpy(sf->mine,tomap,sizeof(PetscInt)*sf->nleaves);CHKERRQ(ierr);
-        sf->mine_alloc = sf->mine;
-      } else {
-        for (i=0; i<sf->nleaves; i++)             sf->mine[i]   = tomap[sf->mine[i]];
+      ierr = PetscSFGetGraph(sf,&nroots,&nleaves,&ilocal,&iremote);CHKERRQ(ierr);
+      ierr = PetscMalloc1(nleaves,&mine);CHKERRQ(ierr);
+      ierr = PetscMalloc1(nleaves,&remote);CHKERRQ(ierr);
+      for (i=0; i<nleaves; i++) {
+        leaf = tomap[(ilocal ? ilocal[i] : i)*bs];
+        if (leaf%bs) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"The remapped index %D is not aligned with the block size %D of the scatter",leaf,bs);
+        mine[i] = leaf/bs;
       }
-      for (i=0; i<sf->roffset[sf->nranks]; i++)   sf->rmine[i]  = tomap[sf->rmine[i]];
+      ierr = PetscMemcpy(remote,iremote,sizeof(PetscSFNode)*nleaves);CHKERRQ(ierr);
+      ierr = PetscSFSetGraph(sf,nroots,nleaves,mine,PETSC_OWN_POINTER,remote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+      ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
     }
   }
 
@@ -221,6 +236,14 @@ static PetscErrorCode VecScatterGetRemote_SF(VecScatter vscat,PetscBool send,Pet
     if (starts)  *starts  = &offset[remote_start];
     if (indices) *indices = location; /* not &location[offset[remote_start]]. Starts[0] may point to the middle of indices[] */
     if (procs)   *procs   = &ranks[remote_start];
+    if (indices && data->bs > 1) {
+      /* the locations are in units of blocks, the indices are those of the first entries of the blocks */
+      PetscInt i,*bindices;
+
+      ierr = PetscMalloc1(offset[nranks],&bindices);CHKERRQ(ierr);
+      for (i=0; i<offset[nranks]; i++) bindices[i] = location[i]*data->bs;
+      *indices = bindices;
+    }
   } else {
     if (n)       *n       = 0;
     if (starts)  *starts  = NULL;
@@ -228,7 +251,7 @@ static PetscErrorCode VecScatterGetRemote_SF(VecScatter vscat,PetscBool send,Pet
     if (procs)   *procs   = NULL;
   }
 
-  if (bs) *bs = 1;
+  if (bs) *bs = data->bs;
   PetscFunctionReturn(0);
 }
 
@@ -243,8 +266,12 @@ static PetscErrorCode VecScatterGetRemoteOrdered_SF(VecScatter vscat,PetscBool s
 
 static PetscErrorCode VecScatterRestoreRemote_SF(VecScatter vscat,PetscBool send,PetscInt *n,const PetscInt **starts,const PetscInt **indices,const PetscMPIInt **procs,PetscInt *bs)
 {
+  VecScatter_SF  *data = (VecScatter_SF *)vscat->data;
+  PetscErrorCode ierr;
+
   PetscFunctionBegin;
   if (starts)   *starts  = NULL;
+  if (indices && data->bs > 1) {ierr = PetscFree(*indices);CHKERRQ(ierr);}
   if (indices)  *indices = NULL;
   if (procs)    *procs   = NULL;
   PetscFunctionReturn(0);
@@ -541,6 +568,7 @@ static PetscErrorCode VecScatterSetUp_SF(VecScatter vscat)
   }
 
   /* vecscatter uses eager setup */
+  ierr = PetscSFSetFromOptions(data->sf);CHKERRQ(ierr);
   ierr = PetscSFSetUp(data->sf);CHKERRQ(ierr);
   ierr = PetscSFSetUp(data->lsf);CHKERRQ(ierr);
 
@@ -84,6 +84,9 @@ PetscErrorCode  VecScatterBegin(VecScatter ctx,Vec x,Vec y,InsertMode addv,Scatt
   PetscValidHeaderSpecific(x,VEC_CLASSID,2);
   PetscValidHeaderSpecific(y,VEC_CLASSID,3);
   if (ctx->inuse) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE," Scatter ctx already in use");
+  /* some scatters read the arrays of x without VecGetArrayRead() */
+  ierr = VecLazyFlush(x);CHKERRQ(ierr);
+  ierr = VecLazyFlush(y);CHKERRQ(ierr);
 
 #if defined(PETSC_USE_DEBUG)
   /*
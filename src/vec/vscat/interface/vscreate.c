@@ -187,6 +187,54 @@ PetscErrorCode VecScatterRegister(const char sname[], PetscErrorCode (*function)
   PetscFunctionReturn(0);
 }
 
+/*
+   Stride or block index sets with the indices of ix and iy, when these have this structure, so that the setup takes
+   the special cases of these types and needs no index arrays. The types must agree on all processes of the scatter,
+   since some special cases are decided collectively, otherwise ix and iy are kept. They are also kept for sequential
+   scatters, whose memcpy plans already find the runs of indices and which VecScatterRemap() needs in general form.
+*/
+static PetscErrorCode VecScatterCompressIS_Private(MPI_Comm comm,IS ix,IS iy,IS *cix,IS *ciy)
+{
+  PetscErrorCode ierr;
+  IS             is[2],cis[2] = {NULL,NULL};
+  PetscInt       i,vals[8] = {0,0,0,0,0,0,0,0};
+  PetscBool      stride,block;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  is[0] = ix; is[1] = iy;
+  ierr  = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size == 1) {
+    if (ix) {ierr = PetscObjectReference((PetscObject)ix);CHKERRQ(ierr);}
+    if (iy) {ierr = PetscObjectReference((PetscObject)iy);CHKERRQ(ierr);}
+    *cix = ix;
+    *ciy = iy;
+    PetscFunctionReturn(0);
+  }
+  for (i=0; i<2; i++) {
+    if (!is[i]) continue;
+    ierr = ISCreateCompressed(is[i],&cis[i]);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)cis[i],ISSTRIDE,&stride);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)cis[i],ISBLOCK,&block);CHKERRQ(ierr);
+    vals[4*i]   = stride ? 1 : (block ? 2 : 0);
+    vals[4*i+1] = -vals[4*i];
+    if (block) {ierr = ISGetBlockSize(cis[i],&vals[4*i+2]);CHKERRQ(ierr);}
+    else vals[4*i+2] = 1;
+    vals[4*i+3] = -vals[4*i+2];
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,vals,8,MPIU_INT,MPI_MAX,comm);CHKERRQ(ierr);
+  for (i=0; i<2; i++) {
+    if (cis[i] != is[i] && (vals[4*i] != -vals[4*i+1] || vals[4*i+2] != -vals[4*i+3])) {
+      ierr = ISDestroy(&cis[i]);CHKERRQ(ierr);
+      ierr = PetscObjectReference((PetscObject)is[i]);CHKERRQ(ierr);
+      cis[i] = is[i];
+    }
+  }
+  *cix = cis[0];
+  *ciy = cis[1];
+  PetscFunctionReturn(0);
+}
+
 /* ---------------------------------------------------------------- */
 /*@
    VecScatterCreate - Creates a vector scatter context.
@@ -232,6 +280,9 @@ PetscErrorCode VecScatterRegister(const char sname[], PetscErrorCode (*function)
 
    Both ix and iy cannot be NULL at the same time.
 
+   For scatters involving parallel vectors, index sets of type ISGENERAL whose indices are evenly spaced, or made of
+   aligned blocks of consecutive indices, are handled as ISSTRIDE or ISBLOCK, see ISCompress().
+
    Concepts: scatter^between vectors
    Concepts: gather^between vectors
 
@@ -243,6 +294,7 @@ PetscErrorCode VecScatterCreate(Vec xin,IS ix,Vec yin,IS iy,VecScatter *newctx)
   PetscErrorCode    ierr;
   PetscMPIInt       size,xsize,ysize,result;
   MPI_Comm          comm,xcomm,ycomm;
+  IS                cix,ciy;
 
   PetscFunctionBegin;
   PetscValidPointer(newctx,5);
@@ -267,10 +319,11 @@ PetscErrorCode VecScatterCreate(Vec xin,IS ix,Vec yin,IS iy,VecScatter *newctx)
   ierr = VecScatterInitializePackage();CHKERRQ(ierr);
   ierr = PetscHeaderCreate(ctx,VEC_SCATTER_CLASSID,"VecScatter","Vector Scatter","Vec",comm,VecScatterDestroy,VecScatterView);CHKERRQ(ierr);
 
+  ierr = VecScatterCompressIS_Private(comm,ix,iy,&cix,&ciy);CHKERRQ(ierr);
   ctx->from_v  = xin;
   ctx->to_v    = yin;
-  ctx->from_is = ix;
-  ctx->to_is   = iy;
+  ctx->from_is = cix;
+  ctx->to_is   = ciy;
   ierr = VecGetLocalSize(xin,&ctx->from_n);CHKERRQ(ierr);
   ierr = VecGetLocalSize(yin,&ctx->to_n);CHKERRQ(ierr);
 
@@ -280,6 +333,10 @@ PetscErrorCode VecScatterCreate(Vec xin,IS ix,Vec yin,IS iy,VecScatter *newctx)
 
   ierr = VecScatterSetFromOptions(ctx);CHKERRQ(ierr);
   ierr = VecScatterSetUp(ctx);CHKERRQ(ierr);
+  ctx->from_is = ix;
+  ctx->to_is   = iy;
+  ierr = ISDestroy(&cix);CHKERRQ(ierr);
+  ierr = ISDestroy(&ciy);CHKERRQ(ierr);
 
   *newctx = ctx;
   PetscFunctionReturn(0);